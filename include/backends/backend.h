@@ -5,7 +5,9 @@
 #include <string>
 
 #include "utils/common.h"
+#include "utils/blitz_activation_function.h"
 #include "utils/blitz_algorithm_function.h"
+#include "utils/blitz_precision_function.h"
 #include "utils/blitz_shape_function.h"
 
 namespace blitz {
@@ -61,6 +63,12 @@ class Backend {
     const TensorType<DType>* input, const TensorType<DType>* target,
     TensorType<DType>* output);
 
+  // softmax of the logits, mean cross entropy, probability minus target
+  // and the argmax accuracy in a single pass, gradient may be NULL
+  static DType SoftmaxCrossEntropyMultiFunc(
+    const TensorType<DType>* input, const TensorType<DType>* target,
+    TensorType<DType>* output, TensorType<DType>* gradient, float* accuracy);
+
   static void BiasForwardFunc(
     const TensorType<DType>* input, const TensorType<DType>* bias,
     TensorType<DType>* output);
@@ -68,6 +76,22 @@ class Backend {
   static void BiasBackwardUpdateFunc(
     const TensorType<DType>* input, TensorType<DType>* update);
 
+  static void EpilogueForwardFunc(
+    const TensorType<DType>* input,
+    const TensorType<DType>* bias,
+    const TensorType<DType>* scale,
+    const TensorType<DType>* shift,
+    TensorType<DType>* output,
+    BLITZ_ACTIVATION activation,
+    DType slope);
+
+  static void EpilogueBackwardFunc(
+    const TensorType<DType>* forward_output,
+    TensorType<DType>* backward_input,
+    TensorType<DType>* bias_update,
+    BLITZ_ACTIVATION activation,
+    DType slope);
+
   static void BatchNormForwardFunc(
     const TensorType<DType>* input,
     const TensorType<DType>* gamma,
@@ -75,6 +99,9 @@ class Backend {
     TensorType<DType>* input_var,
     TensorType<DType>* input_hat,
     TensorType<DType>* output,
+    TensorType<DType>* running_mean,
+    TensorType<DType>* running_var,
+    DType momentum,
     DType epsilon);
 
   static void BatchNormBackwardFunc(
@@ -87,6 +114,16 @@ class Backend {
     TensorType<DType>* output,
     DType epsilon);
 
+  // fold the running statistics into per element scale and shift
+  static void BatchNormScaleShiftFunc(
+    const TensorType<DType>* gamma,
+    const TensorType<DType>* beta,
+    const TensorType<DType>* running_mean,
+    const TensorType<DType>* running_var,
+    TensorType<DType>* scale,
+    TensorType<DType>* shift,
+    DType epsilon);
+
   static void GradientdescentFunc(
     TensorType<DType>* filter,
     TensorType<DType>* gradient,
@@ -96,6 +133,45 @@ class Backend {
     DType decay,
     size_t batch_size);
 
+  // g = gradient / batch_size + decay * filter in the updates below,
+  // v' = momentum_coef * v - learning_rate * g,
+  // filter += v' + momentum_coef * (v' - v)
+  static void NesterovFunc(
+    TensorType<DType>* filter,
+    TensorType<DType>* gradient,
+    TensorType<DType>* velocity,
+    DType momentum_coef,
+    DType learning_rate,
+    DType decay,
+    size_t batch_size);
+
+  // s = rho * s + (1 - rho) * g^2,
+  // filter -= learning_rate * g / (sqrt(s) + epsilon)
+  static void RMSPropFunc(
+    TensorType<DType>* filter,
+    TensorType<DType>* gradient,
+    TensorType<DType>* mean_square,
+    DType rho,
+    DType epsilon,
+    DType learning_rate,
+    DType decay,
+    size_t batch_size);
+
+  // m = beta1 * m + (1 - beta1) * g, v = beta2 * v + (1 - beta2) * g^2,
+  // filter -= learning_rate * m / (sqrt(v) + epsilon),
+  // learning_rate already carries the bias correction of the step
+  static void AdamFunc(
+    TensorType<DType>* filter,
+    TensorType<DType>* gradient,
+    TensorType<DType>* first_moment,
+    TensorType<DType>* second_moment,
+    DType beta1,
+    DType beta2,
+    DType epsilon,
+    DType learning_rate,
+    DType decay,
+    size_t batch_size);
+
   static void MatrixMultiplyFunc(
     const TensorType<DType>* left,
     const TensorType<DType>* right,
@@ -109,6 +185,63 @@ class Backend {
   static void Transpose2DFunc(
     const TensorType<DType>* input, TensorType<DType>* output);
 
+  // NCHW and NHWC buffers or KCRS and RSCK filters, the layouts are
+  // taken from the shapes
+  static void TransformLayoutFunc(
+    const TensorType<DType>* input, TensorType<DType>* output);
+
+  // 16-bit storage of half or bfloat16 precision, rounded to nearest even
+  static void CompressFunc(
+    const TensorType<DType>* input,
+    TensorType<unsigned short>* output,
+    BLITZ_PRECISION precision);
+
+  static void DecompressFunc(
+    const TensorType<unsigned short>* input,
+    TensorType<DType>* output,
+    BLITZ_PRECISION precision);
+
+  // smallest and largest element, calibrates int8 inference
+  static void RangeFunc(
+    const TensorType<DType>* input, DType* minimum, DType* maximum);
+
+  // weight is a K * N matrix with N the last dimension, or N * K with N
+  // the first if transpose, quantized symmetrically per column and packed
+  // as in BlitzQuantizedWeightSize, weight_sum keeps the int8 column sums
+  static void QuantizeWeightFunc(
+    const TensorType<DType>* weight,
+    TensorType<signed char>* quantized_weight,
+    TensorType<DType>* weight_scale,
+    TensorType<int>* weight_sum,
+    bool transpose);
+
+  // output = input * weight with input rounded to
+  // uint8 input / input_scale + zero_point, int32 accumulation
+  static void QuantizedMatrixMultiplyFunc(
+    const TensorType<DType>* input,
+    const TensorType<signed char>* quantized_weight,
+    const TensorType<DType>* weight_scale,
+    const TensorType<int>* weight_sum,
+    TensorType<DType>* output,
+    TensorType<unsigned char>* workspace,
+    DType input_scale,
+    unsigned char zero_point);
+
+  // weight rows follow the unpacked window, CRS for NCHW and RSC for
+  // NHWC input, padding reads as the zero point
+  static void QuantizedConvolution2DForwardFunc(
+    const TensorType<DType>* input,
+    const TensorType<signed char>* quantized_weight,
+    const TensorType<DType>* weight_scale,
+    const TensorType<int>* weight_sum,
+    TensorType<DType>* output,
+    TensorType<unsigned char>* workspace,
+    DType input_scale,
+    unsigned char zero_point,
+    size_t filter_height, size_t filter_width,
+    size_t padding_height, size_t padding_width,
+    size_t stride_height, size_t stride_width);
+
   static void MaximumFunc(
     const TensorType<DType>* left, const TensorType<DType>* right,
     TensorType<DType>* output);
@@ -161,14 +294,27 @@ class Backend {
   static void MaxPooling2DForwardFunc(
     const TensorType<DType>* input,
     TensorType<DType>* output,
-    TensorType<size_t>* max_index,
+    TensorType<unsigned char>* max_index,
     size_t filter_height, size_t filter_width,
     size_t stride_height, size_t stride_width);
 
   static void MaxPooling2DBackwardFunc(
     const TensorType<DType>* output, 
     TensorType<DType>* input,
-    const TensorType<size_t>* max_index,
+    const TensorType<unsigned char>* max_index,
+    size_t filter_height, size_t filter_width,
+    size_t stride_height, size_t stride_width);
+
+  static void AvgPooling2DForwardFunc(
+    const TensorType<DType>* input,
+    TensorType<DType>* output,
+    TensorType<DType>* workspace,
+    size_t filter_height, size_t filter_width,
+    size_t stride_height, size_t stride_width);
+
+  static void AvgPooling2DBackwardFunc(
+    const TensorType<DType>* output,
+    TensorType<DType>* input,
     size_t filter_height, size_t filter_width,
     size_t stride_height, size_t stride_width);
 
@@ -186,6 +332,8 @@ class Backend {
 
   static void HostCopyToFunc(const DType* source, DType* target, size_t size);
 
+  static void HostCopyFromFunc(const DType* source, DType* target, size_t size);
+
   static float EvaluateClassifyFunc(
     const TensorType<DType>* output, const TensorType<DType>* target);
 
@@ -60,6 +60,12 @@ class Backend<CPUTensor, DType> {
     const CPUTensor<DType>* input, const CPUTensor<DType>* target,
     CPUTensor<DType>* output);
 
+  // softmax of the logits, mean cross entropy, probability minus target
+  // and the argmax accuracy in a single pass, gradient may be NULL
+  static DType SoftmaxCrossEntropyMultiFunc(
+    const CPUTensor<DType>* input, const CPUTensor<DType>* target,
+    CPUTensor<DType>* output, CPUTensor<DType>* gradient, float* accuracy);
+
   static void BiasForwardFunc(
     const CPUTensor<DType>* input, const CPUTensor<DType>* bias,
     CPUTensor<DType>* output);
@@ -67,6 +73,22 @@ class Backend<CPUTensor, DType> {
   static void BiasBackwardUpdateFunc(
     const CPUTensor<DType>* input, CPUTensor<DType>* update);
 
+  static void EpilogueForwardFunc(
+    const CPUTensor<DType>* input,
+    const CPUTensor<DType>* bias,
+    const CPUTensor<DType>* scale,
+    const CPUTensor<DType>* shift,
+    CPUTensor<DType>* output,
+    BLITZ_ACTIVATION activation,
+    DType slope);
+
+  static void EpilogueBackwardFunc(
+    const CPUTensor<DType>* forward_output,
+    CPUTensor<DType>* backward_input,
+    CPUTensor<DType>* bias_update,
+    BLITZ_ACTIVATION activation,
+    DType slope);
+
   static void BatchNormForwardFunc(
     const CPUTensor<DType>* input,
     const CPUTensor<DType>* gamma,
@@ -74,6 +96,9 @@ class Backend<CPUTensor, DType> {
     CPUTensor<DType>* input_var,
     CPUTensor<DType>* input_hat,
     CPUTensor<DType>* output,
+    CPUTensor<DType>* running_mean,
+    CPUTensor<DType>* running_var,
+    DType momentum,
     DType epsilon);
 
   static void BatchNormBackwardFunc(
@@ -86,6 +111,16 @@ class Backend<CPUTensor, DType> {
     CPUTensor<DType>* output,
     DType epsilon);
 
+  // fold the running statistics into per element scale and shift
+  static void BatchNormScaleShiftFunc(
+    const CPUTensor<DType>* gamma,
+    const CPUTensor<DType>* beta,
+    const CPUTensor<DType>* running_mean,
+    const CPUTensor<DType>* running_var,
+    CPUTensor<DType>* scale,
+    CPUTensor<DType>* shift,
+    DType epsilon);
+
   static void GradientdescentFunc(
     CPUTensor<DType>* filter,
     CPUTensor<DType>* gradient,
@@ -95,6 +130,45 @@ class Backend<CPUTensor, DType> {
     DType decay,
     size_t batch_size);
 
+  // g = gradient / batch_size + decay * filter in the updates below,
+  // v' = momentum_coef * v - learning_rate * g,
+  // filter += v' + momentum_coef * (v' - v)
+  static void NesterovFunc(
+    CPUTensor<DType>* filter,
+    CPUTensor<DType>* gradient,
+    CPUTensor<DType>* velocity,
+    DType momentum_coef,
+    DType learning_rate,
+    DType decay,
+    size_t batch_size);
+
+  // s = rho * s + (1 - rho) * g^2,
+  // filter -= learning_rate * g / (sqrt(s) + epsilon)
+  static void RMSPropFunc(
+    CPUTensor<DType>* filter,
+    CPUTensor<DType>* gradient,
+    CPUTensor<DType>* mean_square,
+    DType rho,
+    DType epsilon,
+    DType learning_rate,
+    DType decay,
+    size_t batch_size);
+
+  // m = beta1 * m + (1 - beta1) * g, v = beta2 * v + (1 - beta2) * g^2,
+  // filter -= learning_rate * m / (sqrt(v) + epsilon),
+  // learning_rate already carries the bias correction of the step
+  static void AdamFunc(
+    CPUTensor<DType>* filter,
+    CPUTensor<DType>* gradient,
+    CPUTensor<DType>* first_moment,
+    CPUTensor<DType>* second_moment,
+    DType beta1,
+    DType beta2,
+    DType epsilon,
+    DType learning_rate,
+    DType decay,
+    size_t batch_size);
+
   static void MatrixMultiplyFunc(
     const CPUTensor<DType>* left,
     const CPUTensor<DType>* right,
@@ -108,6 +182,63 @@ class Backend<CPUTensor, DType> {
   static void Transpose2DFunc(
     const CPUTensor<DType>* input, CPUTensor<DType>* output);
 
+  // NCHW and NHWC buffers or KCRS and RSCK filters, the layouts are
+  // taken from the shapes
+  static void TransformLayoutFunc(
+    const CPUTensor<DType>* input, CPUTensor<DType>* output);
+
+  // 16-bit storage of half or bfloat16 precision, rounded to nearest even
+  static void CompressFunc(
+    const CPUTensor<DType>* input,
+    CPUTensor<unsigned short>* output,
+    BLITZ_PRECISION precision);
+
+  static void DecompressFunc(
+    const CPUTensor<unsigned short>* input,
+    CPUTensor<DType>* output,
+    BLITZ_PRECISION precision);
+
+  // smallest and largest element, calibrates int8 inference
+  static void RangeFunc(
+    const CPUTensor<DType>* input, DType* minimum, DType* maximum);
+
+  // weight is a K * N matrix with N the last dimension, or N * K with N
+  // the first if transpose, quantized symmetrically per column and packed
+  // as in BlitzQuantizedWeightSize, weight_sum keeps the int8 column sums
+  static void QuantizeWeightFunc(
+    const CPUTensor<DType>* weight,
+    CPUTensor<signed char>* quantized_weight,
+    CPUTensor<DType>* weight_scale,
+    CPUTensor<int>* weight_sum,
+    bool transpose);
+
+  // output = input * weight with input rounded to
+  // uint8 input / input_scale + zero_point, int32 accumulation
+  static void QuantizedMatrixMultiplyFunc(
+    const CPUTensor<DType>* input,
+    const CPUTensor<signed char>* quantized_weight,
+    const CPUTensor<DType>* weight_scale,
+    const CPUTensor<int>* weight_sum,
+    CPUTensor<DType>* output,
+    CPUTensor<unsigned char>* workspace,
+    DType input_scale,
+    unsigned char zero_point);
+
+  // weight rows follow the unpacked window, CRS for NCHW and RSC for
+  // NHWC input, padding reads as the zero point
+  static void QuantizedConvolution2DForwardFunc(
+    const CPUTensor<DType>* input,
+    const CPUTensor<signed char>* quantized_weight,
+    const CPUTensor<DType>* weight_scale,
+    const CPUTensor<int>* weight_sum,
+    CPUTensor<DType>* output,
+    CPUTensor<unsigned char>* workspace,
+    DType input_scale,
+    unsigned char zero_point,
+    size_t filter_height, size_t filter_width,
+    size_t padding_height, size_t padding_width,
+    size_t stride_height, size_t stride_width);
+
   static void MaximumFunc(
     const CPUTensor<DType>* left, const CPUTensor<DType>* right,
     CPUTensor<DType>* output);
@@ -160,14 +291,27 @@ class Backend<CPUTensor, DType> {
   static void MaxPooling2DForwardFunc(
     const CPUTensor<DType>* input,
     CPUTensor<DType>* output,
-    CPUTensor<size_t>* max_index,
+    CPUTensor<unsigned char>* max_index,
     size_t filter_height, size_t filter_width,
     size_t stride_height, size_t stride_width);
 
   static void MaxPooling2DBackwardFunc(
     const CPUTensor<DType>* output, 
     CPUTensor<DType>* input,
-    const CPUTensor<size_t>* max_index,
+    const CPUTensor<unsigned char>* max_index,
+    size_t filter_height, size_t filter_width,
+    size_t stride_height, size_t stride_width);
+
+  static void AvgPooling2DForwardFunc(
+    const CPUTensor<DType>* input,
+    CPUTensor<DType>* output,
+    CPUTensor<DType>* workspace,
+    size_t filter_height, size_t filter_width,
+    size_t stride_height, size_t stride_width);
+
+  static void AvgPooling2DBackwardFunc(
+    const CPUTensor<DType>* output,
+    CPUTensor<DType>* input,
     size_t filter_height, size_t filter_width,
     size_t stride_height, size_t stride_width);
 
@@ -185,6 +329,8 @@ class Backend<CPUTensor, DType> {
 
   static void HostCopyToFunc(const DType* source, DType* target, size_t size);
 
+  static void HostCopyFromFunc(const DType* source, DType* target, size_t size);
+
   static float EvaluateClassifyFunc(
     const CPUTensor<DType>* output, const CPUTensor<DType>* target);
 
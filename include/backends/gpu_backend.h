@@ -60,6 +60,12 @@ class Backend<GPUTensor, DType> {
     const GPUTensor<DType>* input, const GPUTensor<DType>* target,
     GPUTensor<DType>* output);
 
+  // softmax of the logits, mean cross entropy, probability minus target
+  // and the argmax accuracy in a single pass, gradient may be NULL
+  static DType SoftmaxCrossEntropyMultiFunc(
+    const GPUTensor<DType>* input, const GPUTensor<DType>* target,
+    GPUTensor<DType>* output, GPUTensor<DType>* gradient, float* accuracy);
+
   static void BiasForwardFunc(
     const GPUTensor<DType>* input, const GPUTensor<DType>* bias,
     GPUTensor<DType>* output);
@@ -67,6 +73,22 @@ class Backend<GPUTensor, DType> {
   static void BiasBackwardUpdateFunc(
     const GPUTensor<DType>* input, GPUTensor<DType>* update);
 
+  static void EpilogueForwardFunc(
+    const GPUTensor<DType>* input,
+    const GPUTensor<DType>* bias,
+    const GPUTensor<DType>* scale,
+    const GPUTensor<DType>* shift,
+    GPUTensor<DType>* output,
+    BLITZ_ACTIVATION activation,
+    DType slope);
+
+  static void EpilogueBackwardFunc(
+    const GPUTensor<DType>* forward_output,
+    GPUTensor<DType>* backward_input,
+    GPUTensor<DType>* bias_update,
+    BLITZ_ACTIVATION activation,
+    DType slope);
+
   static void BatchNormForwardFunc(
     const GPUTensor<DType>* input,
     const GPUTensor<DType>* gamma,
@@ -74,6 +96,9 @@ class Backend<GPUTensor, DType> {
     GPUTensor<DType>* input_var,
     GPUTensor<DType>* input_hat,
     GPUTensor<DType>* output,
+    GPUTensor<DType>* running_mean,
+    GPUTensor<DType>* running_var,
+    DType momentum,
     DType epsilon);
 
   static void BatchNormBackwardFunc(
@@ -86,6 +111,16 @@ class Backend<GPUTensor, DType> {
     GPUTensor<DType>* output,
     DType epsilon);
 
+  // fold the running statistics into per element scale and shift
+  static void BatchNormScaleShiftFunc(
+    const GPUTensor<DType>* gamma,
+    const GPUTensor<DType>* beta,
+    const GPUTensor<DType>* running_mean,
+    const GPUTensor<DType>* running_var,
+    GPUTensor<DType>* scale,
+    GPUTensor<DType>* shift,
+    DType epsilon);
+
   static void GradientdescentFunc(
     GPUTensor<DType>* filter,
     GPUTensor<DType>* gradient,
@@ -95,6 +130,45 @@ class Backend<GPUTensor, DType> {
     DType decay,
     size_t batch_size);
 
+  // g = gradient / batch_size + decay * filter in the updates below,
+  // v' = momentum_coef * v - learning_rate * g,
+  // filter += v' + momentum_coef * (v' - v)
+  static void NesterovFunc(
+    GPUTensor<DType>* filter,
+    GPUTensor<DType>* gradient,
+    GPUTensor<DType>* velocity,
+    DType momentum_coef,
+    DType learning_rate,
+    DType decay,
+    size_t batch_size);
+
+  // s = rho * s + (1 - rho) * g^2,
+  // filter -= learning_rate * g / (sqrt(s) + epsilon)
+  static void RMSPropFunc(
+    GPUTensor<DType>* filter,
+    GPUTensor<DType>* gradient,
+    GPUTensor<DType>* mean_square,
+    DType rho,
+    DType epsilon,
+    DType learning_rate,
+    DType decay,
+    size_t batch_size);
+
+  // m = beta1 * m + (1 - beta1) * g, v = beta2 * v + (1 - beta2) * g^2,
+  // filter -= learning_rate * m / (sqrt(v) + epsilon),
+  // learning_rate already carries the bias correction of the step
+  static void AdamFunc(
+    GPUTensor<DType>* filter,
+    GPUTensor<DType>* gradient,
+    GPUTensor<DType>* first_moment,
+    GPUTensor<DType>* second_moment,
+    DType beta1,
+    DType beta2,
+    DType epsilon,
+    DType learning_rate,
+    DType decay,
+    size_t batch_size);
+
   static void MatrixMultiplyFunc(
     const GPUTensor<DType>* left,
     const GPUTensor<DType>* right,
@@ -108,6 +182,63 @@ class Backend<GPUTensor, DType> {
   static void Transpose2DFunc(
     const GPUTensor<DType>* input, GPUTensor<DType>* output);
 
+  // NCHW and NHWC buffers or KCRS and RSCK filters, the layouts are
+  // taken from the shapes
+  static void TransformLayoutFunc(
+    const GPUTensor<DType>* input, GPUTensor<DType>* output);
+
+  // 16-bit storage of half or bfloat16 precision, rounded to nearest even
+  static void CompressFunc(
+    const GPUTensor<DType>* input,
+    GPUTensor<unsigned short>* output,
+    BLITZ_PRECISION precision);
+
+  static void DecompressFunc(
+    const GPUTensor<unsigned short>* input,
+    GPUTensor<DType>* output,
+    BLITZ_PRECISION precision);
+
+  // smallest and largest element, calibrates int8 inference
+  static void RangeFunc(
+    const GPUTensor<DType>* input, DType* minimum, DType* maximum);
+
+  // weight is a K * N matrix with N the last dimension, or N * K with N
+  // the first if transpose, quantized symmetrically per column and packed
+  // as in BlitzQuantizedWeightSize, weight_sum keeps the int8 column sums
+  static void QuantizeWeightFunc(
+    const GPUTensor<DType>* weight,
+    GPUTensor<signed char>* quantized_weight,
+    GPUTensor<DType>* weight_scale,
+    GPUTensor<int>* weight_sum,
+    bool transpose);
+
+  // output = input * weight with input rounded to
+  // uint8 input / input_scale + zero_point, int32 accumulation
+  static void QuantizedMatrixMultiplyFunc(
+    const GPUTensor<DType>* input,
+    const GPUTensor<signed char>* quantized_weight,
+    const GPUTensor<DType>* weight_scale,
+    const GPUTensor<int>* weight_sum,
+    GPUTensor<DType>* output,
+    GPUTensor<unsigned char>* workspace,
+    DType input_scale,
+    unsigned char zero_point);
+
+  // weight rows follow the unpacked window, CRS for NCHW and RSC for
+  // NHWC input, padding reads as the zero point
+  static void QuantizedConvolution2DForwardFunc(
+    const GPUTensor<DType>* input,
+    const GPUTensor<signed char>* quantized_weight,
+    const GPUTensor<DType>* weight_scale,
+    const GPUTensor<int>* weight_sum,
+    GPUTensor<DType>* output,
+    GPUTensor<unsigned char>* workspace,
+    DType input_scale,
+    unsigned char zero_point,
+    size_t filter_height, size_t filter_width,
+    size_t padding_height, size_t padding_width,
+    size_t stride_height, size_t stride_width);
+
   static void MaximumFunc(
     const GPUTensor<DType>* left, const GPUTensor<DType>* right,
     GPUTensor<DType>* output);
@@ -160,14 +291,27 @@ class Backend<GPUTensor, DType> {
   static void MaxPooling2DForwardFunc(
     const GPUTensor<DType>* input,
     GPUTensor<DType>* output,
-    GPUTensor<size_t>* max_index,
+    GPUTensor<unsigned char>* max_index,
     size_t filter_height, size_t filter_width,
     size_t stride_height, size_t stride_width);
 
   static void MaxPooling2DBackwardFunc(
     const GPUTensor<DType>* output, 
     GPUTensor<DType>* input,
-    const GPUTensor<size_t>* max_index,
+    const GPUTensor<unsigned char>* max_index,
+    size_t filter_height, size_t filter_width,
+    size_t stride_height, size_t stride_width);
+
+  static void AvgPooling2DForwardFunc(
+    const GPUTensor<DType>* input,
+    GPUTensor<DType>* output,
+    GPUTensor<DType>* workspace,
+    size_t filter_height, size_t filter_width,
+    size_t stride_height, size_t stride_width);
+
+  static void AvgPooling2DBackwardFunc(
+    const GPUTensor<DType>* output,
+    GPUTensor<DType>* input,
     size_t filter_height, size_t filter_width,
     size_t stride_height, size_t stride_width);
 
@@ -185,6 +329,8 @@ class Backend<GPUTensor, DType> {
 
   static void HostCopyToFunc(const DType* source, DType* target, size_t size);
 
+  static void HostCopyFromFunc(const DType* source, DType* target, size_t size);
+
   static float EvaluateClassifyFunc(
     const GPUTensor<DType>* output, const GPUTensor<DType>* target);
 
@@ -60,6 +60,12 @@ class Backend<MICTensor, DType> {
     const MICTensor<DType>* input, const MICTensor<DType>* target,
     MICTensor<DType>* output);
 
+  // softmax of the logits, mean cross entropy, probability minus target
+  // and the argmax accuracy in a single pass, gradient may be NULL
+  static DType SoftmaxCrossEntropyMultiFunc(
+    const MICTensor<DType>* input, const MICTensor<DType>* target,
+    MICTensor<DType>* output, MICTensor<DType>* gradient, float* accuracy);
+
   static void BiasForwardFunc(
     const MICTensor<DType>* input, const MICTensor<DType>* bias,
     MICTensor<DType>* output);
@@ -67,6 +73,22 @@ class Backend<MICTensor, DType> {
   static void BiasBackwardUpdateFunc(
     const MICTensor<DType>* input, MICTensor<DType>* update);
 
+  static void EpilogueForwardFunc(
+    const MICTensor<DType>* input,
+    const MICTensor<DType>* bias,
+    const MICTensor<DType>* scale,
+    const MICTensor<DType>* shift,
+    MICTensor<DType>* output,
+    BLITZ_ACTIVATION activation,
+    DType slope);
+
+  static void EpilogueBackwardFunc(
+    const MICTensor<DType>* forward_output,
+    MICTensor<DType>* backward_input,
+    MICTensor<DType>* bias_update,
+    BLITZ_ACTIVATION activation,
+    DType slope);
+
   static void BatchNormForwardFunc(
     const MICTensor<DType>* input,
     const MICTensor<DType>* gamma,
@@ -74,6 +96,9 @@ class Backend<MICTensor, DType> {
     MICTensor<DType>* input_var,
     MICTensor<DType>* input_hat,
     MICTensor<DType>* output,
+    MICTensor<DType>* running_mean,
+    MICTensor<DType>* running_var,
+    DType momentum,
     DType epsilon);
 
   static void BatchNormBackwardFunc(
@@ -86,6 +111,16 @@ class Backend<MICTensor, DType> {
     MICTensor<DType>* output,
     DType epsilon);
 
+  // fold the running statistics into per element scale and shift
+  static void BatchNormScaleShiftFunc(
+    const MICTensor<DType>* gamma,
+    const MICTensor<DType>* beta,
+    const MICTensor<DType>* running_mean,
+    const MICTensor<DType>* running_var,
+    MICTensor<DType>* scale,
+    MICTensor<DType>* shift,
+    DType epsilon);
+
   static void GradientdescentFunc(
     MICTensor<DType>* filter,
     MICTensor<DType>* gradient,
@@ -95,6 +130,45 @@ class Backend<MICTensor, DType> {
     DType decay,
     size_t batch_size);
 
+  // g = gradient / batch_size + decay * filter in the updates below,
+  // v' = momentum_coef * v - learning_rate * g,
+  // filter += v' + momentum_coef * (v' - v)
+  static void NesterovFunc(
+    MICTensor<DType>* filter,
+    MICTensor<DType>* gradient,
+    MICTensor<DType>* velocity,
+    DType momentum_coef,
+    DType learning_rate,
+    DType decay,
+    size_t batch_size);
+
+  // s = rho * s + (1 - rho) * g^2,
+  // filter -= learning_rate * g / (sqrt(s) + epsilon)
+  static void RMSPropFunc(
+    MICTensor<DType>* filter,
+    MICTensor<DType>* gradient,
+    MICTensor<DType>* mean_square,
+    DType rho,
+    DType epsilon,
+    DType learning_rate,
+    DType decay,
+    size_t batch_size);
+
+  // m = beta1 * m + (1 - beta1) * g, v = beta2 * v + (1 - beta2) * g^2,
+  // filter -= learning_rate * m / (sqrt(v) + epsilon),
+  // learning_rate already carries the bias correction of the step
+  static void AdamFunc(
+    MICTensor<DType>* filter,
+    MICTensor<DType>* gradient,
+    MICTensor<DType>* first_moment,
+    MICTensor<DType>* second_moment,
+    DType beta1,
+    DType beta2,
+    DType epsilon,
+    DType learning_rate,
+    DType decay,
+    size_t batch_size);
+
   static void MatrixMultiplyFunc(
     const MICTensor<DType>* left,
     const MICTensor<DType>* right,
@@ -108,6 +182,63 @@ class Backend<MICTensor, DType> {
   static void Transpose2DFunc(
     const MICTensor<DType>* input, MICTensor<DType>* output);
 
+  // NCHW and NHWC buffers or KCRS and RSCK filters, the layouts are
+  // taken from the shapes
+  static void TransformLayoutFunc(
+    const MICTensor<DType>* input, MICTensor<DType>* output);
+
+  // 16-bit storage of half or bfloat16 precision, rounded to nearest even
+  static void CompressFunc(
+    const MICTensor<DType>* input,
+    MICTensor<unsigned short>* output,
+    BLITZ_PRECISION precision);
+
+  static void DecompressFunc(
+    const MICTensor<unsigned short>* input,
+    MICTensor<DType>* output,
+    BLITZ_PRECISION precision);
+
+  // smallest and largest element, calibrates int8 inference
+  static void RangeFunc(
+    const MICTensor<DType>* input, DType* minimum, DType* maximum);
+
+  // weight is a K * N matrix with N the last dimension, or N * K with N
+  // the first if transpose, quantized symmetrically per column and packed
+  // as in BlitzQuantizedWeightSize, weight_sum keeps the int8 column sums
+  static void QuantizeWeightFunc(
+    const MICTensor<DType>* weight,
+    MICTensor<signed char>* quantized_weight,
+    MICTensor<DType>* weight_scale,
+    MICTensor<int>* weight_sum,
+    bool transpose);
+
+  // output = input * weight with input rounded to
+  // uint8 input / input_scale + zero_point, int32 accumulation
+  static void QuantizedMatrixMultiplyFunc(
+    const MICTensor<DType>* input,
+    const MICTensor<signed char>* quantized_weight,
+    const MICTensor<DType>* weight_scale,
+    const MICTensor<int>* weight_sum,
+    MICTensor<DType>* output,
+    MICTensor<unsigned char>* workspace,
+    DType input_scale,
+    unsigned char zero_point);
+
+  // weight rows follow the unpacked window, CRS for NCHW and RSC for
+  // NHWC input, padding reads as the zero point
+  static void QuantizedConvolution2DForwardFunc(
+    const MICTensor<DType>* input,
+    const MICTensor<signed char>* quantized_weight,
+    const MICTensor<DType>* weight_scale,
+    const MICTensor<int>* weight_sum,
+    MICTensor<DType>* output,
+    MICTensor<unsigned char>* workspace,
+    DType input_scale,
+    unsigned char zero_point,
+    size_t filter_height, size_t filter_width,
+    size_t padding_height, size_t padding_width,
+    size_t stride_height, size_t stride_width);
+
   static void MaximumFunc(
     const MICTensor<DType>* left, const MICTensor<DType>* right,
     MICTensor<DType>* output);
@@ -160,14 +291,27 @@ class Backend<MICTensor, DType> {
   static void MaxPooling2DForwardFunc(
     const MICTensor<DType>* input,
     MICTensor<DType>* output,
-    MICTensor<size_t>* max_index,
+    MICTensor<unsigned char>* max_index,
     size_t filter_height, size_t filter_width,
     size_t stride_height, size_t stride_width);
 
   static void MaxPooling2DBackwardFunc(
     const MICTensor<DType>* output, 
     MICTensor<DType>* input,
-    const MICTensor<size_t>* max_index,
+    const MICTensor<unsigned char>* max_index,
+    size_t filter_height, size_t filter_width,
+    size_t stride_height, size_t stride_width);
+
+  static void AvgPooling2DForwardFunc(
+    const MICTensor<DType>* input,
+    MICTensor<DType>* output,
+    MICTensor<DType>* workspace,
+    size_t filter_height, size_t filter_width,
+    size_t stride_height, size_t stride_width);
+
+  static void AvgPooling2DBackwardFunc(
+    const MICTensor<DType>* output,
+    MICTensor<DType>* input,
     size_t filter_height, size_t filter_width,
     size_t stride_height, size_t stride_width);
 
@@ -185,6 +329,8 @@ class Backend<MICTensor, DType> {
 
   static void HostCopyToFunc(const DType* source, DType* target, size_t size);
 
+  static void HostCopyFromFunc(const DType* source, DType* target, size_t size);
+
   static float EvaluateClassifyFunc(
     const MICTensor<DType>* output, const MICTensor<DType>* target);
 
@@ -22,6 +22,8 @@ class MICTensor : public Tensor<DType> {
   virtual DType* Slice(size_t index);
   virtual const DType* Slice(size_t index) const;
   virtual void OutputCSV(ofstream* ofs) const;
+  virtual void Relocate(DType* data);
+  virtual void Attach(DType* data);
 
  protected:
   virtual void Allocate();
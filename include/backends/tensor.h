@@ -11,10 +11,11 @@ template<typename DType = float>
 class Tensor {
  public:
   explicit Tensor(const Shape& shape) :
-    shape_(shape), row_major_(true) {}
+    shape_(shape), row_major_(true), owner_(true) {}
 
+  // view over memory owned by another tensor, never freed here
   explicit Tensor(DType* data, const Shape& shape) :
-    data_(data), shape_(shape), row_major_(true) {}
+    data_(data), shape_(shape), row_major_(true), owner_(false) {}
 
   virtual ~Tensor() {}
 
@@ -40,6 +41,10 @@ class Tensor {
     return row_major_;
   }
 
+  bool owner() const {
+    return owner_;
+  }
+
   const DType* data() const {
     return data_;
   }
@@ -75,6 +80,11 @@ class Tensor {
   virtual DType* Slice(const size_t index) = 0;
   virtual const DType* Slice(const size_t index) const = 0;
   virtual void OutputCSV(ofstream* ofs) const = 0;
+  // move the contents to data owned by another tensor and become its view
+  virtual void Relocate(DType* data) = 0;
+  // take the contents of host memory that outlives the tensor, host
+  // tensors become its view without a copy, devices copy it in
+  virtual void Attach(DType* data) = 0;
 
  protected:
   virtual void Allocate() = 0;
@@ -82,6 +92,7 @@ class Tensor {
   DType* data_;
   Shape shape_;
   bool row_major_;
+  bool owner_;
 
   DISABLE_COPY_AND_ASSIGN(Tensor);
 };
@@ -92,6 +103,9 @@ class Tensor {
   template class tensor<double>; \
   template class tensor<int>; \
   template class tensor<size_t>; \
+  template class tensor<unsigned char>; \
+  template class tensor<signed char>; \
+  template class tensor<unsigned short>; \
   template class tensor<short> \
 
 }  // namespace blitz
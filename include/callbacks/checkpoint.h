@@ -0,0 +1,37 @@
+#ifndef INCLUDE_CALLBACKS_CHECKPOINT_H_
+#define INCLUDE_CALLBACKS_CHECKPOINT_H_
+
+#include <string>
+
+#include "callbacks/callback.h"
+#include "model/seralize.h"
+#include "utils/common.h"
+
+namespace blitz {
+
+// saves path_<epoch>.blitz every step epochs, the file is written in
+// the background while the next epoch trains
+template<template <typename> class TensorType, typename DType>
+class Checkpoint : public Callback {
+ public:
+  explicit Checkpoint(shared_ptr<Serializer<TensorType, DType> > serializer,
+    const string& path, const size_t step) :
+    serializer_(serializer), path_(path), step_(step) {}
+  ~Checkpoint() {}
+
+  virtual void OnEpochBegin(const size_t index) {}
+  virtual void OnEpochEnd(const size_t index);
+  virtual void OnBatchBegin(const size_t index) {}
+  virtual void OnBatchEnd(const size_t index, const float loss) {}
+
+ private:
+  shared_ptr<Serializer<TensorType, DType> > serializer_;
+  const string path_;
+  const size_t step_;
+
+  DISABLE_COPY_AND_ASSIGN(Checkpoint);
+};
+
+}  // namespace blitz
+
+#endif  // INCLUDE_CALLBACKS_CHECKPOINT_H_
@@ -1,11 +1,19 @@
 #ifndef INCLUDE_DATA_DATA_ITERATOR_H_
 #define INCLUDE_DATA_DATA_ITERATOR_H_
 
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <hdf5.h>
+#include <stdint.h>
+
+#include <deque>
 #include <string>
 #include <vector>
 
 #include "utils/common.h"
 #include "backends/shape.h"
+#include "data/sampler.h"
 
 namespace blitz {
 
@@ -13,13 +21,19 @@ template<template <typename> class TensorType, typename DType>
 class DataIterator {
  public:
   explicit DataIterator(const string& data_path, const Shape& input_shape,
-    size_t batch_size, size_t pool_size = 3000) :
+    size_t batch_size, size_t pool_size = 3000, size_t prefetch_depth = 1) :
     data_path_(data_path), input_shape_(input_shape), batch_size_(batch_size),
-    pool_size_(pool_size), current_begin_index_(0), total_(0) {}
+    total_(0), shuffle_(false), seed_(0), epoch_(0),
+    pool_size_(pool_size), prefetch_depth_(prefetch_depth),
+    current_begin_index_(0), uint8_(false),
+    next_begin_index_(0), next_epoch_(0),
+    generation_(0), stop_(false), wait_time_(0.0) {}
+
+  virtual ~DataIterator();
 
-  void Init();
+  virtual void Init();
 
-  shared_ptr<TensorType<DType> > GenerateTensor(size_t index);
+  virtual shared_ptr<TensorType<DType> > GenerateTensor(size_t index);
 
   // getters
   const Shape& input_shape() const {
@@ -38,22 +52,105 @@ class DataIterator {
     return this->total_;
   }
 
- private:
-  void CopyFileBuffer(size_t begin_offset);
+  // seconds GenerateTensor spent blocked on the loader
+  double wait_time() const {
+    return this->wait_time_;
+  }
+
+  void ResetWaitTime() {
+    this->wait_time_ = 0.0;
+  }
 
+  // setters
+  // serve a shuffled window-local order, call before Init
+  void set_shuffle(bool shuffle, size_t seed) {
+    this->shuffle_ = shuffle;
+    this->seed_ = seed;
+  }
+
+  // epoch whose order GenerateTensor serves
+  void set_epoch(size_t epoch) {
+    this->epoch_ = epoch;
+  }
+
+  // uint8 samples are handed out as (x - mean[c]) * scale[c] along
+  // the channel dimension of the data layout, one value or one per channel
+  void set_normalization(const vector<DType>& mean,
+    const vector<DType>& scale);
+
+ protected:
   const string data_path_;
 
   const Shape input_shape_;
 
   const size_t batch_size_;
 
+  size_t total_;
+
+  bool shuffle_;
+  size_t seed_;
+  size_t epoch_;
+  shared_ptr<Sampler> sampler_;
+
+  // channels and spatial size of a sample, returns whether channels are
+  // the innermost dimension
+  bool ChannelView(size_t* channel, size_t* spatial) const;
+
+  // converts rows of uint8 samples into the reused output_ tensor
+  shared_ptr<TensorType<DType> > NormalizeBatch(const uint8_t* bytes,
+    size_t rows);
+
+  vector<DType> mean_;
+  vector<DType> scale_;
+  shared_ptr<TensorType<DType> > output_;
+  vector<DType> staging_;
+
+ private:
+  // a pool window of tensors starting at batch begin_index
+  // uint8 datasets keep raw bytes instead of tensors
+  struct PrefetchWindow {
+    size_t begin_index;
+    vector<shared_ptr<TensorType<DType> > > tensors;
+    vector<shared_ptr<vector<uint8_t> > > bytes;
+  };
+
+  void CopyFileBuffer(size_t begin_offset,
+    vector<shared_ptr<TensorType<DType> > >* tensor_pool,
+    vector<shared_ptr<vector<uint8_t> > >* byte_pool);
+
+  // hyperslab read of samples [begin_row, end_row) across files
+  template<typename BufferType>
+  void ReadRows(size_t begin_row, size_t end_row, BufferType* buffer);
+
+  // loader thread body, keeps up to prefetch_depth_ windows ready
+  void Prefetch();
+
+  // window that follows begin_index in epoch, advances epoch on wrap
+  size_t NextBeginIndex(size_t begin_index, size_t* epoch) const;
+
   size_t pool_size_;
+  size_t prefetch_depth_;
   size_t current_begin_index_;
-  size_t total_;
 
   vector<string> files_;
   vector<size_t> file_row_mapping_;
+  vector<hid_t> file_ids_;
+  vector<hid_t> data_ids_;
   vector<shared_ptr<TensorType<DType> > > tensor_pool_;
+  vector<shared_ptr<vector<uint8_t> > > byte_pool_;
+  bool uint8_;
+
+  // prefetch state, guarded by prefetch_mutex_
+  std::deque<PrefetchWindow> prefetch_pool_;
+  size_t next_begin_index_;
+  size_t next_epoch_;
+  size_t generation_;
+  bool stop_;
+  boost::mutex prefetch_mutex_;
+  boost::condition_variable prefetch_cond_;
+  shared_ptr<boost::thread> loader_;
+
+  double wait_time_;
 
   DISABLE_COPY_AND_ASSIGN(DataIterator); 
 };
@@ -0,0 +1,59 @@
+#ifndef INCLUDE_DATA_MMAP_ITERATOR_H_
+#define INCLUDE_DATA_MMAP_ITERATOR_H_
+
+#include <stdint.h>
+
+#include <string>
+
+#include "data/data_iterator.h"
+#include "utils/common.h"
+
+namespace blitz {
+
+enum BLITZ_BINARY_TYPE {
+  BLITZ_BINARY_FLOAT = 0,
+  BLITZ_BINARY_UINT8 = 1
+};
+
+#define BLITZ_BINARY_MAGIC "BLITZBIN"
+#define BLITZ_BINARY_VERSION 1
+
+// flat binary dataset: this 64-byte header, then num_samples packed
+// records of sample_size elements, starting at a 64-byte aligned offset
+struct BlitzBinaryHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t data_type;
+  uint64_t num_samples;
+  uint64_t sample_size;
+  char reserved[32];
+};
+
+// serves batches straight out of a memory mapped binary dataset,
+// float records are handed to CPUTensor without a copy,
+// uint8 records are normalized on handout
+template<template <typename> class TensorType, typename DType>
+class MmapDataIterator : public DataIterator<TensorType, DType> {
+ public:
+  explicit MmapDataIterator(const string& data_path, const Shape& input_shape,
+    size_t batch_size) :
+    DataIterator<TensorType, DType>(data_path, input_shape, batch_size, 0, 0),
+    mapping_(NULL), mapping_size_(0) {}
+
+  virtual ~MmapDataIterator();
+
+  virtual void Init();
+
+  virtual shared_ptr<TensorType<DType> > GenerateTensor(size_t index);
+
+ private:
+  char* mapping_;
+  size_t mapping_size_;
+  BlitzBinaryHeader header_;
+
+  DISABLE_COPY_AND_ASSIGN(MmapDataIterator);
+};
+
+}  // namespace blitz
+
+#endif  // INCLUDE_DATA_MMAP_ITERATOR_H_
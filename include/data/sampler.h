@@ -0,0 +1,49 @@
+#ifndef INCLUDE_DATA_SAMPLER_H_
+#define INCLUDE_DATA_SAMPLER_H_
+
+#include <vector>
+
+#include "utils/common.h"
+
+namespace blitz {
+
+// per-epoch batch order that keeps pool window locality:
+// the window order is shuffled, then the batches inside each window,
+// so every window is still read once and consumed contiguously.
+// all functions are pure in (seed, epoch), iterators built with the
+// same seed over the same rows (data and label) serve the same order
+class Sampler {
+ public:
+  explicit Sampler(size_t num_batches, size_t window_size, size_t seed) :
+    num_batches_(num_batches), window_size_(window_size), seed_(seed),
+    num_windows_((num_batches + window_size - 1) / window_size) {}
+
+  // batch served at position of epoch
+  size_t Index(size_t epoch, size_t position) const;
+
+  // window served at position of epoch
+  size_t Window(size_t epoch, size_t position) const;
+
+  // position of window in epoch
+  size_t WindowPosition(size_t epoch, size_t window) const;
+
+  size_t num_windows() const {
+    return num_windows_;
+  }
+
+ private:
+  // uniform permutation of [0, size) from one rng stream
+  void Permutation(size_t epoch, size_t stream, size_t size,
+    vector<size_t>* permutation) const;
+
+  const size_t num_batches_;
+  const size_t window_size_;
+  const size_t seed_;
+  const size_t num_windows_;
+
+  DISABLE_COPY_AND_ASSIGN(Sampler);
+};
+
+}  // namespace blitz
+
+#endif  // INCLUDE_DATA_SAMPLER_H_
@@ -3,6 +3,7 @@
 
 #include <yaml-cpp/yaml.h>
 
+#include <ctime>
 #include <list>
 #include <map>
 #include <string>
@@ -11,6 +12,7 @@
 #include "callbacks/callback.h"
 #include "callbacks/callback_wrapper.h"
 #include "data/data_iterator.h"
+#include "data/mmap_iterator.h"
 #include "layers/layer_wrapper.h"
 #include "scheduler/scheduler.h"
 #include "scheduler/optimizer.h"
@@ -75,6 +77,118 @@ class Parser {
     return *eval_type_;
   }
 
+  // shuffle the training batches every epoch
+  bool shuffle() const {
+    if (shuffle_ == 0) {
+      if (config_["shuffle"]) {
+        shuffle_ = make_shared<bool>(config_["shuffle"].as<bool>());
+      } else {
+        shuffle_ = make_shared<bool>(false);
+      }
+    }
+    return *shuffle_;
+  }
+
+  size_t seed() const {
+    if (seed_ == 0) {
+      if (config_["seed"]) {
+        seed_ = make_shared<size_t>(config_["seed"].as<size_t>());
+      } else {
+        seed_ = make_shared<size_t>(0);
+      }
+    }
+    return *seed_;
+  }
+
+  // fillers and dropout masks, reproducible only when 'seed' is given
+  size_t random_seed() const {
+    if (random_seed_ == 0) {
+      if (config_["seed"]) {
+        random_seed_ = make_shared<size_t>(config_["seed"].as<size_t>());
+      } else {
+        random_seed_ = make_shared<size_t>(time(NULL));
+      }
+    }
+    return *random_seed_;
+  }
+
+  // reductions independent of the number of threads
+  bool deterministic() const {
+    if (deterministic_ == 0) {
+      if (config_["deterministic"]) {
+        deterministic_ = make_shared<bool>(
+          config_["deterministic"].as<bool>());
+      } else {
+        deterministic_ = make_shared<bool>(false);
+      }
+    }
+    return *deterministic_;
+  }
+
+  // per layer timings reported when the run ends
+  bool profile() const {
+    if (profile_ == 0) {
+      if (config_["profile"]) {
+        profile_ = make_shared<bool>(config_["profile"].as<bool>());
+      } else {
+        profile_ = make_shared<bool>(false);
+      }
+    }
+    return *profile_;
+  }
+
+  // chrome trace of a profiled run, empty writes none
+  const string& profile_path() const {
+    if (profile_path_ == 0) {
+      if (config_["profile_path"]) {
+        profile_path_ = make_shared<string>(
+          config_["profile_path"].as<string>());
+      } else {
+        profile_path_ = make_shared<string>();
+      }
+    }
+    return *profile_path_;
+  }
+
+  // per-channel normalization of uint8 samples, one value or one per channel
+  const vector<double>& data_mean() const {
+    if (data_mean_ == 0) {
+      data_mean_ = make_shared<vector<double> >();
+      const YAML::Node& node = config_["data_mean"];
+      if (node && node.IsSequence()) {
+        *data_mean_ = node.as<vector<double> >();
+      } else if (node) {
+        data_mean_->push_back(node.as<double>());
+      }
+    }
+    return *data_mean_;
+  }
+
+  const vector<double>& data_scale() const {
+    if (data_scale_ == 0) {
+      data_scale_ = make_shared<vector<double> >();
+      const YAML::Node& node = config_["data_scale"];
+      if (node && node.IsSequence()) {
+        *data_scale_ = node.as<vector<double> >();
+      } else if (node) {
+        data_scale_->push_back(node.as<double>());
+      }
+    }
+    return *data_scale_;
+  }
+
+  // hdf5 file lists or flat binary files
+  const string& data_format() const {
+    if (data_format_ == 0) {
+      if (config_["data_format"]) {
+        data_format_ = make_shared<string>(config_["data_format"].as<string>());
+      } else {
+        data_format_ = make_shared<string>("hdf5");
+      }
+    }
+    return *data_format_;
+  }
+
   const string& backend_type() const {
     if (backend_type_ == 0) {
       if (config_["backend_type"]) {
@@ -156,6 +270,34 @@ class Parser {
     return *pool_size_;
   }
 
+  // eval and inference pools keep the old fixed size unless set
+  size_t eval_pool_size() const {
+    if (eval_pool_size_ == 0) {
+      if (config_["eval_pool_size"]) {
+        eval_pool_size_ = make_shared<size_t>(
+          config_["eval_pool_size"].as<size_t>());
+      } else {
+        eval_pool_size_ = make_shared<size_t>(3000);
+        LOG(WARNING) << "'eval_pool_size' parameter missing";
+      }
+    }
+    return *eval_pool_size_;
+  }
+
+  // pool windows loaded ahead by the background loader, 0 loads inline
+  size_t prefetch_depth() const {
+    if (prefetch_depth_ == 0) {
+      if (config_["prefetch_depth"]) {
+        prefetch_depth_ = make_shared<size_t>(
+          config_["prefetch_depth"].as<size_t>());
+      } else {
+        prefetch_depth_ = make_shared<size_t>(1);
+        LOG(WARNING) << "'prefetch_depth' parameter missing";
+      }
+    }
+    return *prefetch_depth_;
+  }
+
   bool eval() const {
     if (eval_ == 0) {
       if (config_["eval"]) {
@@ -180,6 +322,69 @@ class Parser {
     return *inference_;
   }
 
+  // int8 inference after the DType pass, calibrated on the first batches
+  bool quantize() const {
+    if (quantize_ == 0) {
+      if (config_["quantize"]) {
+        quantize_ = make_shared<bool>(config_["quantize"].as<bool>());
+      } else {
+        quantize_ = make_shared<bool>(false);
+      }
+    }
+    return *quantize_;
+  }
+
+  size_t calibration_batches() const {
+    if (calibration_batches_ == 0) {
+      if (config_["calibration_batches"]) {
+        calibration_batches_ = make_shared<size_t>(
+          config_["calibration_batches"].as<size_t>());
+      } else {
+        calibration_batches_ = make_shared<size_t>(8);
+      }
+    }
+    return *calibration_batches_;
+  }
+
+  // training saves checkpoint_path_<epoch>.blitz every checkpoint_step
+  // epochs, empty saves nothing
+  const string& checkpoint_path() const {
+    if (checkpoint_path_ == 0) {
+      if (config_["checkpoint_path"]) {
+        checkpoint_path_ = make_shared<string>(
+          config_["checkpoint_path"].as<string>());
+      } else {
+        checkpoint_path_ = make_shared<string>();
+      }
+    }
+    return *checkpoint_path_;
+  }
+
+  size_t checkpoint_step() const {
+    if (checkpoint_step_ == 0) {
+      if (config_["checkpoint_step"]) {
+        checkpoint_step_ = make_shared<size_t>(
+          config_["checkpoint_step"].as<size_t>());
+      } else {
+        checkpoint_step_ = make_shared<size_t>(1);
+      }
+    }
+    return *checkpoint_step_;
+  }
+
+  // checkpoint to start from instead of the fillers, training resumes
+  // after its epoch, inference maps its weights
+  const string& load_path() const {
+    if (load_path_ == 0) {
+      if (config_["load_path"]) {
+        load_path_ = make_shared<string>(config_["load_path"].as<string>());
+      } else {
+        load_path_ = make_shared<string>();
+      }
+    }
+    return *load_path_;
+  }
+
   // [batch_size, data_shape] = input_shape
   const Shape& input_shape() const {
     if (input_shape_ == 0) {
@@ -280,80 +485,89 @@ class Parser {
 
   template<template <typename> class TensorType, typename DType>
   shared_ptr<DataIterator<TensorType, DType> > data_set() const {
-    string path = data_path();
     if (model_type() == "train") {
-      path.append("_train_data.log");
-    } else if (model_type() == "inference") {
-      path.append("_test_data.log");
-    } else {
+      shared_ptr<DataIterator<TensorType, DType> > data_set =
+        SetDataIterator<TensorType, DType>("_train_data",
+        input_shape(), pool_size(), true);
+      data_set->set_shuffle(shuffle(), seed());
+      return data_set;
+    } else if (model_type() != "inference") {
       LOG(FATAL) << "Unknown model type: " << model_type();
     }
-    shared_ptr<DataIterator<TensorType, DType> > data_set =
-      make_shared<DataIterator<TensorType, DType> >(
-      path, input_shape(), batch_size(), pool_size());
-    return data_set;
+    return SetDataIterator<TensorType, DType>("_test_data",
+      input_shape(), pool_size(), true);
   }
 
   template<template <typename> class TensorType, typename DType>
   shared_ptr<DataIterator<TensorType, DType> > data_label() const {
-    string path = data_path();
     if (model_type() == "train") {
-      path.append("_train_label.log");
-    } else if (model_type() == "inference") {
-      path.append("_test_label.log");
-    } else {
+      // same seed and rows as data_set, so the same order
+      shared_ptr<DataIterator<TensorType, DType> > data_label =
+        SetDataIterator<TensorType, DType>("_train_label",
+        label_shape(), pool_size(), false);
+      data_label->set_shuffle(shuffle(), seed());
+      return data_label;
+    } else if (model_type() != "inference") {
       LOG(FATAL) << "Unknown model type: " << model_type();
     }
-
-    shared_ptr<DataIterator<TensorType, DType> > data_label =
-      make_shared<DataIterator<TensorType, DType> >(
-      path, label_shape(), batch_size(), pool_size());
-    return data_label;
+    return SetDataIterator<TensorType, DType>("_test_label",
+      label_shape(), pool_size(), false);
   }
 
   template<template <typename> class TensorType, typename DType>
   shared_ptr<DataIterator<TensorType, DType> > eval_set() const {
-    string path = data_path();
-    path.append("_eval_data.log");
-    shared_ptr<DataIterator<TensorType, DType> > eval_set =
-      make_shared<DataIterator<TensorType, DType> >(
-      path, input_shape(), batch_size());
-    return eval_set;
+    return SetDataIterator<TensorType, DType>("_eval_data",
+      input_shape(), eval_pool_size(), true);
   }
 
   template<template <typename> class TensorType, typename DType>
   shared_ptr<DataIterator<TensorType, DType> > eval_label() const {
-    string path = data_path();
-    path.append("_eval_label.log");
-
-    shared_ptr<DataIterator<TensorType, DType> > eval_label =
-      make_shared<DataIterator<TensorType, DType> >(
-      path, label_shape(), batch_size());
-    return eval_label;
+    return SetDataIterator<TensorType, DType>("_eval_label",
+      label_shape(), eval_pool_size(), false);
   }
 
   template<template <typename> class TensorType, typename DType>
   shared_ptr<DataIterator<TensorType, DType> > inference_set() const {
-    string path = data_path();
-    path.append("_inference_data.log");
-    shared_ptr<DataIterator<TensorType, DType> > inference_set =
-      make_shared<DataIterator<TensorType, DType> >(
-      path, input_shape(), batch_size());
-    return inference_set;
+    return SetDataIterator<TensorType, DType>("_inference_data",
+      input_shape(), eval_pool_size(), true);
   }
 
   template<template <typename> class TensorType, typename DType>
   shared_ptr<DataIterator<TensorType, DType> > inference_label() const {
-    string path = data_path();
-    path.append("_inference_label.log");
-    shared_ptr<DataIterator<TensorType, DType> > inference_label =
-      make_shared<DataIterator<TensorType, DType> >(
-      path, label_shape(), batch_size());
-    return inference_label;
+    return SetDataIterator<TensorType, DType>("_inference_label",
+      label_shape(), eval_pool_size(), false);
   }
 
  private:
   // subsetters
+  // data_path + name + .log lists hdf5 files, data_path + name + .bin
+  // is a single flat binary file
+  template<template <typename> class TensorType, typename DType>
+  shared_ptr<DataIterator<TensorType, DType> > SetDataIterator(
+    const string& name, const Shape& shape, size_t pool,
+    bool normalize) const {
+    string path = data_path() + name;
+    shared_ptr<DataIterator<TensorType, DType> > data_iterator;
+    if (data_format() == "hdf5") {
+      path.append(".log");
+      data_iterator = make_shared<DataIterator<TensorType, DType> >(
+        path, shape, batch_size(), pool, prefetch_depth());
+    } else if (data_format() == "binary") {
+      path.append(".bin");
+      data_iterator = static_pointer_cast<DataIterator<TensorType, DType> >(
+        make_shared<MmapDataIterator<TensorType, DType> >(
+        path, shape, batch_size()));
+    } else {
+      LOG(FATAL) << "Unknown data format: " << data_format();
+    }
+    if (normalize) {
+      data_iterator->set_normalization(
+        vector<DType>(data_mean().begin(), data_mean().end()),
+        vector<DType>(data_scale().begin(), data_scale().end()));
+    }
+    return data_iterator;
+  }
+
   shared_ptr<Callback> SetCallback(const YAML::Node& node) const;
 
   template<template <typename> class TensorType, typename DType>
@@ -383,6 +597,8 @@ class Parser {
   mutable shared_ptr<Shape> data_shape_;
   mutable shared_ptr<Shape> input_shape_;
   mutable shared_ptr<Shape> label_shape_;
+  mutable shared_ptr<vector<double> > data_mean_;
+  mutable shared_ptr<vector<double> > data_scale_;
 
   // basic types
   mutable shared_ptr<string> data_type_;
@@ -390,16 +606,30 @@ class Parser {
   mutable shared_ptr<string> model_type_;
   mutable shared_ptr<string> eval_type_;
   mutable shared_ptr<string> backend_type_;
+  mutable shared_ptr<string> data_format_;
+  mutable shared_ptr<string> checkpoint_path_;
+  mutable shared_ptr<string> load_path_;
+  mutable shared_ptr<string> profile_path_;
 
   mutable shared_ptr<size_t> epoches_;
   mutable shared_ptr<size_t> batch_size_;
   mutable shared_ptr<size_t> label_size_;
   mutable shared_ptr<size_t> pool_size_;
+  mutable shared_ptr<size_t> eval_pool_size_;
+  mutable shared_ptr<size_t> prefetch_depth_;
+  mutable shared_ptr<size_t> calibration_batches_;
+  mutable shared_ptr<size_t> checkpoint_step_;
+  mutable shared_ptr<size_t> seed_;
+  mutable shared_ptr<size_t> random_seed_;
 
   mutable shared_ptr<BLITZ_DATA_LAYOUT> data_layout_;
 
   mutable shared_ptr<bool> eval_;
+  mutable shared_ptr<bool> shuffle_;
   mutable shared_ptr<bool> inference_;
+  mutable shared_ptr<bool> quantize_;
+  mutable shared_ptr<bool> deterministic_;
+  mutable shared_ptr<bool> profile_;
 
   DISABLE_COPY_AND_ASSIGN(Parser);
 };
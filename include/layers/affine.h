@@ -19,15 +19,42 @@ class Affine : public ParamLayer<TensorType, DType> {
     shared_ptr<Activation<TensorType, DType> > activation,
     size_t nout, BLITZ_ALGORITHM algorithm = BLITZ_BLAS_GEMM) :
     ParamLayer<TensorType, DType>(name, filler_name,
-    optimizer_name, activation), nout_(nout), algorithm_(algorithm) {}
+    optimizer_name, activation), nout_(nout), alpha_(1),
+    algorithm_(algorithm) {}
   ~Affine() {}
 
   virtual void InitImpl(const Shape& input_shape);
   virtual void ForwardPropImpl(shared_ptr<TensorType<DType> > forward_input);
   virtual void BackwardPropImpl(shared_ptr<TensorType<DType> > backward_input);
 
+  virtual void Quantize();
+
+  // every GEMM of the layer is batch * nin * nout multiply-adds
+  virtual double forward_computations() const {
+    return 2.0 * (this->forward_output_)->shape()[0] *
+      (this->weight_)->size();
+  }
+
+  virtual double backward_computations() const {
+    return forward_computations();
+  }
+
+  virtual double update_computations() const {
+    return forward_computations();
+  }
+
+  // an inference only GEMM scales the product instead of its input
+  virtual bool FoldInputScale(DType scale) {
+    if (!this->inference_only_) {
+      return false;
+    }
+    alpha_ *= scale;
+    return true;
+  }
+
  private:
   size_t nout_;
+  DType alpha_;
 
   BLITZ_ALGORITHM algorithm_;
 
@@ -35,6 +35,28 @@ class Conv : public ParamLayer<TensorType, DType> {
   virtual void ForwardPropImpl(shared_ptr<TensorType<DType> > forward_input);
   virtual void BackwardPropImpl(shared_ptr<TensorType<DType> > backward_input);
 
+  virtual void Quantize();
+
+  virtual double forward_computations() const {
+    return forward_computations_;
+  }
+
+  virtual double backward_computations() const {
+    return backward_computations_;
+  }
+
+  virtual double update_computations() const {
+    return backward_update_computations_;
+  }
+
+  virtual shared_ptr<TensorType<DType> > workspace() const {
+    return this->workspace_;
+  }
+
+  virtual void set_workspace(shared_ptr<TensorType<DType> > workspace) {
+    this->workspace_ = workspace;
+  }
+
  private:
   // TODO(keren) bias
   const Shape filter_shape_;
@@ -20,6 +20,12 @@ class Dropout : public Layer<TensorType, DType> {
   virtual void ForwardPropImpl(shared_ptr<TensorType<DType> > forward_input);
   virtual void BackwardPropImpl(shared_ptr<TensorType<DType> > backward_input);
 
+  // inference scales by keep, which the next layer may absorb
+  virtual bool InferenceScale(DType* scale) const {
+    *scale = keep_;
+    return true;
+  }
+
  private:
   const DType keep_;
 
@@ -3,10 +3,13 @@
 
 #include <string>
 
+#include "backends/backend.h"
 #include "backends/shape.h"
 #include "fillers/filler_wrapper.h"
 #include "scheduler/scheduler.h"
 #include "utils/common.h"
+#include "utils/blitz_precision_function.h"
+#include "utils/blitz_profiler.h"
 
 namespace blitz {
 
@@ -14,7 +17,9 @@ template<template <typename> class TensorType, typename DType>
 class Layer {
  public:
   explicit Layer(const string& name) :
-    name_(name), train_(true), backward_prop_(true) {}  // indicate pure virtual
+    name_(name), train_(true), backward_prop_(true),
+    inference_only_(false),
+    precision_(BLITZ_PRECISION_FLOAT) {}  // indicate pure virtual
   virtual ~Layer() {}  // ensure pure virtual
 
   virtual void Init(const Shape& input_shape,
@@ -26,43 +31,18 @@ class Layer {
 
   // forward
   virtual void ForwardProp(shared_ptr<TensorType<DType> > forward_input) {
-    #ifdef BLITZ_PERFORMANCE
-    time_point<system_clock> start, end;
-    duration<double> core_time =
-      duration<double>::zero();
-    LOG(INFO) << this->name_ << ":";
-    start = system_clock::now();
-    #endif  // BLITZ_PERFORMANCE
-
+    BlitzProfileScope scope(this->name_, "forward",
+      this->forward_computations());
     this->ForwardPropImpl(forward_input);
-
-    #ifdef BLITZ_PERFORMANCE
-    end = system_clock::now();
-    core_time = end - start;
-    LOG(INFO) << "Forward core time: " <<
-      core_time.count();
-    #endif  // BLITZ_PERFORMANCE
   }
   virtual void ForwardPropImpl(shared_ptr<TensorType<DType> >
     forward_input) = 0;
 
   // backward
   virtual void BackwardProp(shared_ptr<TensorType<DType> > backward_input) {
-    #ifdef BLITZ_PERFORMANCE
-    time_point<system_clock> start, end;
-    duration<double> core_time = duration<double>::zero();
-    start = system_clock::now();
-    LOG(INFO) << this->name_ << ":";
-    #endif  // BLITZ_PERFORMANCE
-
+    BlitzProfileScope scope(this->name_, "backward",
+      this->backward_prop_ ? this->backward_computations() : 0);
     this->BackwardPropImpl(backward_input);
-
-    #ifdef BLITZ_PERFORMANCE
-    end = system_clock::now();
-    core_time = end - start;
-    LOG(INFO) << "Backward core time: " <<
-      core_time.count();
-    #endif  // BLITZ_PERFORMANCE
   }
 
   virtual void BackwardPropImpl(shared_ptr<TensorType<DType> >
@@ -92,6 +72,60 @@ class Layer {
     return this->backward_output_->shape();
   }
 
+  // floating point operations of one batch, for the profiler
+  virtual double forward_computations() const {
+    return 0;
+  }
+
+  virtual double backward_computations() const {
+    return 0;
+  }
+
+  virtual double update_computations() const {
+    return 0;
+  }
+
+  // scratch memory, only layers that need one override these
+  virtual shared_ptr<TensorType<DType> > workspace() const {
+    return shared_ptr<TensorType<DType> >();
+  }
+
+  virtual void set_workspace(shared_ptr<TensorType<DType> > workspace) {}
+
+  // leave the softmax activation to a fused softmax + cost kernel,
+  // returns false if the layer does not end in a short cut softmax
+  virtual bool FuseSoftmaxCost() {
+    return false;
+  }
+
+  // storage of forward_output between the forward of the next layer and
+  // the backward that reads it again, arithmetic stays in DType
+  BLITZ_PRECISION precision() const {
+    return this->precision_;
+  }
+
+  void set_precision(BLITZ_PRECISION precision) {
+    this->precision_ = precision;
+  }
+
+  shared_ptr<TensorType<unsigned short> > stash() const {
+    return this->stash_;
+  }
+
+  void set_stash(shared_ptr<TensorType<unsigned short> > stash) {
+    this->stash_ = stash;
+  }
+
+  void CompressOutput() {
+    Backend<TensorType, DType>::CompressFunc(this->forward_output_.get(),
+      this->stash_.get(), this->precision_);
+  }
+
+  void DecompressOutput() {
+    Backend<TensorType, DType>::DecompressFunc(this->stash_.get(),
+      this->forward_output_.get(), this->precision_);
+  }
+
   bool backward_prop() const {
     return this->backward_prop;
   }
@@ -100,8 +134,48 @@ class Layer {
     this->backward_prop_ = backward_prop;
   }
 
+  // an inference only layer allocates no backward_output, update or
+  // other training state in Init and cannot switch to the train mode
+  bool inference_only() const {
+    return this->inference_only_;
+  }
+
+  void set_inference_only(bool inference_only) {
+    this->inference_only_ = inference_only;
+  }
+
+  // read the weights of the same layer in another network built from
+  // the same config instead of owning a copy
+  virtual void ShareWeights(const Layer<TensorType, DType>& layer) {}
+
+  // weights and statistics a checkpoint keeps, by name
+  virtual void CollectParams(
+    map<string, shared_ptr<TensorType<DType> > >* params) const {}
+
+  // a layer whose inference forward only multiplies its input by a
+  // constant returns true and the constant
+  virtual bool InferenceScale(DType* scale) const {
+    return false;
+  }
+
+  // fold a constant scale of forward_input into this layer, returns
+  // false if the layer cannot absorb it
+  virtual bool FoldInputScale(DType scale) {
+    return false;
+  }
+
+  // int8 inference, only layers with a weight GEMM override these:
+  // Calibrate records the range of forward_input over a few batches,
+  // Quantize packs the weights and enables the int8 forward
+  virtual void Calibrate(shared_ptr<TensorType<DType> > forward_input) {}
+
+  virtual void Quantize() {}
+
   // two modes
   void SetTrainMode() {
+    if (this->inference_only_) {
+      LOG(FATAL) << "Layer " << this->name_ << " is built for inference only";
+    }
     this->train_ = true;
   }
 
@@ -114,9 +188,13 @@ class Layer {
   shared_ptr<TensorType<DType> > forward_output_;
   shared_ptr<TensorType<DType> > backward_output_;
 
+  shared_ptr<TensorType<unsigned short> > stash_;
+
   const string name_;
   bool train_;
   bool backward_prop_;
+  bool inference_only_;
+  BLITZ_PRECISION precision_;
 
   DISABLE_COPY_AND_ASSIGN(Layer);
 };
@@ -2,7 +2,9 @@
 #define INCLUDE_LAYERS_LAYER_WRAPPER_H_
 
 #include <list>
+#include <map>
 #include <string>
+#include <vector>
 
 #include "fillers/filler_wrapper.h"
 #include "layers/layer.h"
@@ -26,7 +28,8 @@ class LayerWrapper {
   explicit LayerWrapper(
     const list<shared_ptr<Layer<TensorType, DType> > >& layers,
     shared_ptr<Cost<TensorType, DType> > cost) :
-    layers_(layers), cost_(cost) {}
+    layers_(layers), cost_(cost), softmax_cost_fused_(false),
+    accuracy_(0.0f), train_(true), inference_only_(false) {}
 
   // STL like function
   void push_back(shared_ptr<Layer<TensorType, DType> > layer) {
@@ -74,18 +77,70 @@ class LayerWrapper {
     shared_ptr<FillerWrapper<TensorType, DType> > filler_wrapper,
     shared_ptr<Scheduler<TensorType, DType> > scheduler);
 
+  // forward only build without backward, update or optimizer state,
+  // dropout is folded into the next layer where possible and the
+  // activations only live until the next layer has read them
+  void InitInference(const Shape& data_shape,
+    shared_ptr<FillerWrapper<TensorType, DType> > filler_wrapper);
+
   void ForwardProp(shared_ptr<TensorType<DType> > input);
 
+  // forward without a cost, a softmax fused into the cost is applied
+  // to the output here instead
+  void Predict(shared_ptr<TensorType<DType> > input);
+
+  // point the weights of every layer to those of a network built from
+  // the same config, activations and workspace stay separate
+  void ShareWeights(const LayerWrapper<TensorType, DType>& layer_wrapper);
+
+  // weights and statistics of every layer by name, for checkpoints
+  void CollectParams(
+    map<string, shared_ptr<TensorType<DType> > >* params) const;
+
   void BackwardProp();
 
+  // forward in DType while every layer records the range of its input
+  void Calibrate(shared_ptr<TensorType<DType> > input);
+
+  // switch the calibrated layers to the int8 forward
+  void Quantize();
+
   void SetTrainMode();
 
   void SetInferenceMode();
 
  private:
+  // one activation buffer, live on the closed step interval [begin, end]
+  // of the forward -> cost -> backward timeline, except for the open
+  // interval (gap_begin, gap_end) while a reduced precision stash holds it
+  struct MemoryBlock {
+    shared_ptr<Layer<TensorType, DType> > layer;  // empty for error_
+    bool forward;
+    size_t begin;
+    size_t end;
+    size_t gap_begin;
+    size_t gap_end;
+    size_t size;
+    size_t offset;
+  };
+
+  // alias activations with disjoint lifetimes into arena_,
+  // and let all layers share one workspace_
+  void PlanMemory();
+
   list<shared_ptr<Layer<TensorType, DType> > > layers_;
   shared_ptr<Cost<TensorType, DType> > cost_;
   shared_ptr<TensorType<DType> > error_;
+  shared_ptr<TensorType<DType> > arena_;
+  shared_ptr<TensorType<DType> > workspace_;
+  // a short cut softmax into CrossEntropyMulti runs as one kernel in
+  // ApplyCost, which also leaves the derivative in error_ and the
+  // classification accuracy in accuracy_
+  bool softmax_cost_fused_;
+  float accuracy_;
+  // stashes are only written and read back while training
+  bool train_;
+  bool inference_only_;
 
   DISABLE_COPY_AND_ASSIGN(LayerWrapper);
 };
@@ -1,6 +1,7 @@
 #ifndef INCLUDE_LAYERS_PARAM_LAYER_H_
 #define INCLUDE_LAYERS_PARAM_LAYER_H_
 
+#include <algorithm>
 #include <string>
 
 #include "backends/backend.h"
@@ -8,6 +9,7 @@
 #include "utils/common.h"
 #include "fillers/filler.h"
 #include "transforms/activation.h"
+#include "utils/blitz_shape_function.h"
 
 namespace blitz {
 
@@ -15,17 +17,20 @@ template<template <typename> class TensorType, typename DType>
 class ParamLayer : public Layer<TensorType, DType> {
  public:
   // BatchNorm:
-  // Y = gamma * X + beta
+  // Y = gamma * X_hat + beta, statistics per channel
+  // training normalizes with the batch statistics and keeps their
+  // moving averages, inference normalizes with the moving averages
   class BatchNorm {
    public:
     // default
     explicit BatchNorm(const string& name, const string& gamma_filler_name,
       const string& gamma_optimizer_name, const string& beta_filler_name,
-      const string& beta_optimizer_name) : name_(name),
-      gamma_optimizer_name_(gamma_optimizer_name),
+      const string& beta_optimizer_name, DType momentum = 0.9) :
+      name_(name), gamma_optimizer_name_(gamma_optimizer_name),
       gamma_filler_name_(gamma_filler_name),
       beta_optimizer_name_(beta_optimizer_name),
-      beta_filler_name_(beta_filler_name), epsilon_(1e-6) {}
+      beta_filler_name_(beta_filler_name), epsilon_(1e-6),
+      momentum_(momentum) {}
 
     const string& name() const {
       return name_;
@@ -95,10 +100,46 @@ class ParamLayer : public Layer<TensorType, DType> {
       return input_hat_;
     }
 
+    void set_running_mean(shared_ptr<TensorType<DType> > running_mean) {
+      running_mean_ = running_mean;
+    }
+
+    shared_ptr<TensorType<DType> > running_mean() {
+      return running_mean_;
+    }
+
+    void set_running_var(shared_ptr<TensorType<DType> > running_var) {
+      running_var_ = running_var;
+    }
+
+    shared_ptr<TensorType<DType> > running_var() {
+      return running_var_;
+    }
+
+    void set_scale(shared_ptr<TensorType<DType> > scale) {
+      scale_ = scale;
+    }
+
+    shared_ptr<TensorType<DType> > scale() {
+      return scale_;
+    }
+
+    void set_shift(shared_ptr<TensorType<DType> > shift) {
+      shift_ = shift;
+    }
+
+    shared_ptr<TensorType<DType> > shift() {
+      return shift_;
+    }
+
     DType epsilon() {
       return epsilon_;
     }
 
+    DType momentum() {
+      return momentum_;
+    }
+
    private:
     const string name_;
     const string gamma_optimizer_name_;
@@ -106,16 +147,22 @@ class ParamLayer : public Layer<TensorType, DType> {
     const string beta_optimizer_name_;
     const string beta_filler_name_;
     const DType epsilon_;
+    const DType momentum_;
     shared_ptr<TensorType<DType> > gamma_weight_;
     shared_ptr<TensorType<DType> > beta_weight_;
     shared_ptr<TensorType<DType> > gamma_update_;
     shared_ptr<TensorType<DType> > beta_update_;
     shared_ptr<TensorType<DType> > input_var_;
     shared_ptr<TensorType<DType> > input_hat_;
+    shared_ptr<TensorType<DType> > running_mean_;
+    shared_ptr<TensorType<DType> > running_var_;
+    // running statistics folded into a per element affine for inference
+    shared_ptr<TensorType<DType> > scale_;
+    shared_ptr<TensorType<DType> > shift_;
   };
 
   // Bias:
-  // Y = X + beta
+  // Y = X + beta, one beta per channel
   class Bias {
    public:
     // default
@@ -164,7 +211,10 @@ class ParamLayer : public Layer<TensorType, DType> {
     const string& filler_name, const string& optimizer_name,
     shared_ptr<Activation<TensorType, DType> > activation) :
     Layer<TensorType, DType>(name), filler_name_(filler_name),
-    optimizer_name_(optimizer_name), activation_(activation) {}
+    optimizer_name_(optimizer_name), activation_(activation),
+    softmax_cost_fused_(false), input_minimum_(0), input_maximum_(0),
+    input_scale_(1), zero_point_(0), calibrated_(false),
+    quantized_(false) {}
   virtual ~ParamLayer() {}
 
   virtual void Init(const Shape& input_shape,
@@ -175,45 +225,55 @@ class ParamLayer : public Layer<TensorType, DType> {
     // set filler
     filler_wrapper->AddLayer(this->filler_name_, this->name_,
       this->weight_);
-    // set update state
-    scheduler->AddLayer(this->optimizer_name_, this->name_,
-      this->weight_, this->update_);
+    // set update state, an inference build has no scheduler
+    const bool train = !this->inference_only_;
+    if (train) {
+      scheduler->AddLayer(this->optimizer_name_, this->name_,
+        this->weight_, this->update_);
+    }
 
+    // bias, gamma, beta and statistics are per channel
     const Shape& output_shape = (this->forward_output_)->shape();
-    Shape shape(1);
-    shape[0] = output_shape.size() / output_shape[0];
+    size_t N, C, S;
+    BlitzChannelView(&output_shape, &N, &C, &S);
+    Shape channel_shape(1);
+    channel_shape[0] = C;
 
     if (bias_ != 0) {
       // make bias tensor
       (this->bias_)->set_weight(
-        make_shared<TensorType<DType> >(shape));
-      (this->bias_)->set_update(
-        make_shared<TensorType<DType> >(shape));
+        make_shared<TensorType<DType> >(channel_shape));
       // set filler
       filler_wrapper->AddLayer((this->bias_)->filler_name(),
         (this->bias_)->name(), (this->bias_)->weight());
-      // set update state
-      scheduler->AddLayer((this->bias_)->optimizer_name(),
-        (this->bias_)->name(), (this->bias_)->weight(),
-        (this->bias_)->update());
+      if (train) {
+        (this->bias_)->set_update(
+          make_shared<TensorType<DType> >(channel_shape));
+        // set update state
+        scheduler->AddLayer((this->bias_)->optimizer_name(),
+          (this->bias_)->name(), (this->bias_)->weight(),
+          (this->bias_)->update());
+      }
     }
 
     if (batch_norm_ != 0) {
-      // make beta tensor
+      Shape sample_shape(output_shape);
+      sample_shape[0] = 1;
+      // make beta and gamma tensor
       (this->batch_norm_)->set_beta_weight(
-        make_shared<TensorType<DType> >(shape));
-      (this->batch_norm_)->set_beta_update(
-        make_shared<TensorType<DType> >(shape));
-      // make gamma tensor
+        make_shared<TensorType<DType> >(channel_shape));
       (this->batch_norm_)->set_gamma_weight(
-        make_shared<TensorType<DType> >(shape));
-      (this->batch_norm_)->set_gamma_update(
-        make_shared<TensorType<DType> >(shape));
-      // input mean and variance
-      (this->batch_norm_)->set_input_hat(
-        make_shared<TensorType<DType> >(output_shape));
-      (this->batch_norm_)->set_input_var(
-        make_shared<TensorType<DType> >(shape));
+        make_shared<TensorType<DType> >(channel_shape));
+      // moving averages start from the identity transform
+      (this->batch_norm_)->set_running_mean(
+        make_shared<TensorType<DType> >(channel_shape));
+      (this->batch_norm_)->set_running_var(
+        make_shared<TensorType<DType> >(channel_shape));
+      (this->batch_norm_)->running_var()->Fill(1);
+      (this->batch_norm_)->set_scale(
+        make_shared<TensorType<DType> >(sample_shape));
+      (this->batch_norm_)->set_shift(
+        make_shared<TensorType<DType> >(sample_shape));
       // set filler
       filler_wrapper->AddLayer((this->batch_norm_)->beta_filler_name(),
         (this->batch_norm_)->name() + "_beta",
@@ -221,15 +281,27 @@ class ParamLayer : public Layer<TensorType, DType> {
       filler_wrapper->AddLayer((this->batch_norm_)->gamma_filler_name(),
         (this->batch_norm_)->name() + "_gamma",
         (this->batch_norm_)->gamma_weight());
-      // set update state
-      scheduler->AddLayer((this->batch_norm_)->beta_optimizer_name(),
-        (this->batch_norm_)->name() + "_beta",
-        (this->batch_norm_)->beta_weight(),
-        (this->batch_norm_)->beta_update());
-      scheduler->AddLayer((this->batch_norm_)->gamma_optimizer_name(),
-        (this->batch_norm_)->name() + "_gamma",
-        (this->batch_norm_)->gamma_weight(),
-        (this->batch_norm_)->gamma_update());
+      // gradients and batch statistics are only needed while training
+      if (train) {
+        (this->batch_norm_)->set_beta_update(
+          make_shared<TensorType<DType> >(channel_shape));
+        (this->batch_norm_)->set_gamma_update(
+          make_shared<TensorType<DType> >(channel_shape));
+        // input mean and variance
+        (this->batch_norm_)->set_input_hat(
+          make_shared<TensorType<DType> >(output_shape));
+        (this->batch_norm_)->set_input_var(
+          make_shared<TensorType<DType> >(channel_shape));
+        // set update state
+        scheduler->AddLayer((this->batch_norm_)->beta_optimizer_name(),
+          (this->batch_norm_)->name() + "_beta",
+          (this->batch_norm_)->beta_weight(),
+          (this->batch_norm_)->beta_update());
+        scheduler->AddLayer((this->batch_norm_)->gamma_optimizer_name(),
+          (this->batch_norm_)->name() + "_gamma",
+          (this->batch_norm_)->gamma_weight(),
+          (this->batch_norm_)->gamma_update());
+      }
     }
   }
 
@@ -237,36 +309,35 @@ class ParamLayer : public Layer<TensorType, DType> {
 
   // forward
   virtual void ForwardProp(shared_ptr<TensorType<DType> > forward_input) {
-    Layer<TensorType, DType>::ForwardProp(forward_input);
-    #ifdef BLITZ_PERFORMANCE
-    time_point<system_clock> start, end;
-    duration<double> bias_time =
-      duration<double>::zero();
-    duration<double> batch_norm_time =
-      duration<double>::zero();
-    duration<double> activation_time =
-      duration<double>::zero();
-    start = system_clock::now();
-    #endif  // BLITZ_PERFORMANCE
+    BlitzProfileScope scope(this->name_, "forward",
+      this->forward_computations());
+    this->ForwardPropImpl(forward_input);
+    if (this->FusedEpilogue()) {
+      BlitzProfileStageTimer stage("epilogue");
+      if (batch_norm_ != 0) {
+        this->BatchNormScaleShift();
+      }
+      // bias, inference batch norm and activation in a single pass
+      Backend<TensorType, DType>::EpilogueForwardFunc(
+        (this->forward_output_).get(),
+        bias_ != 0 ? ((this->bias_)->weight()).get() : NULL,
+        batch_norm_ != 0 ? (this->batch_norm_)->scale().get() : NULL,
+        batch_norm_ != 0 ? (this->batch_norm_)->shift().get() : NULL,
+        (this->forward_output_).get(),
+        this->activation_type(),
+        this->activation_slope());
+      this->forward_input_ = forward_input;
+      return;
+    }
     if (bias_ != 0) {
+      BlitzProfileStageTimer stage("bias");
       Backend<TensorType, DType>::BiasForwardFunc(
         (this->forward_output_).get(),
         ((this->bias_)->weight()).get(),
         (this->forward_output_).get());
     }
-    #ifdef BLITZ_PERFORMANCE
-    end = system_clock::now();
-    bias_time = end - start;
-    LOG(INFO) << "Forward bias time: " <<
-      bias_time.count();
-    #endif  // BLITZ_PERFORMANCE
-
-    #ifdef BLITZ_PERFORMANCE
-    start = system_clock::now();
-    #endif  // BLITZ_PERFORMANCE
-    if (batch_norm_ != 0) {
-      (this->batch_norm_)->input_var()->Fill(0);
-      (this->batch_norm_)->input_hat()->Fill(0);
+    if (batch_norm_ != 0 && this->train_) {
+      BlitzProfileStageTimer stage("batch_norm");
       Backend<TensorType, DType>::BatchNormForwardFunc(
         this->forward_output_.get(),
         (this->batch_norm_)->gamma_weight().get(),
@@ -274,95 +345,76 @@ class ParamLayer : public Layer<TensorType, DType> {
         (this->batch_norm_)->input_var().get(),
         (this->batch_norm_)->input_hat().get(),
         this->forward_output_.get(),
+        (this->batch_norm_)->running_mean().get(),
+        (this->batch_norm_)->running_var().get(),
+        (this->batch_norm_)->momentum(),
         (this->batch_norm_)->epsilon());
+    } else if (batch_norm_ != 0) {
+      BlitzProfileStageTimer stage("batch_norm");
+      this->BatchNormScaleShift();
+      Backend<TensorType, DType>::EpilogueForwardFunc(
+        this->forward_output_.get(), NULL,
+        (this->batch_norm_)->scale().get(),
+        (this->batch_norm_)->shift().get(),
+        this->forward_output_.get(),
+        BLITZ_ACTIVATION_NONE, static_cast<DType>(0));
     }
-    #ifdef BLITZ_PERFORMANCE
-    end = system_clock::now();
-    batch_norm_time = end - start;
-    LOG(INFO) << "Forward batch_norm time: " <<
-      batch_norm_time.count();
-    #endif  // BLITZ_PERFORMANCE
-
-    #ifdef BLITZ_PERFORMANCE
-    start = system_clock::now();
-    #endif  // BLITZ_PERFORMANCE
     // activation
-    if (this->activation_ != 0)
+    if (this->activation_ != 0 && !softmax_cost_fused_) {
+      BlitzProfileStageTimer stage("activation");
       this->activation_->Apply(this->forward_output_, this->forward_output_);
-    #ifdef BLITZ_PERFORMANCE
-    end = system_clock::now();
-    activation_time = end - start;
-    LOG(INFO) << "Forward activation time: " <<
-      activation_time.count();
-    #endif  // BLITZ_PERFORMANCE
+    }
     // update forward_input
     this->forward_input_ = forward_input;
   }
   virtual void ForwardPropImpl(shared_ptr<TensorType<DType> >
     forward_input) = 0;
 
-  // backward
+  // backward, the weight gradient of BackwardPropImpl is an update scope
   virtual void BackwardProp(shared_ptr<TensorType<DType> > backward_input) {
-    #ifdef BLITZ_PERFORMANCE
-    time_point<system_clock> start, end;
-    duration<double> bias_time =
-      duration<double>::zero();
-    duration<double> batch_norm_time =
-      duration<double>::zero();
-    duration<double> activation_time =
-      duration<double>::zero();
-    start = system_clock::now();
-    #endif  // BLITZ_PERFORMANCE
-    if (this->activation_ != 0)
-      this->activation_->Derivative(this->forward_output_, backward_input);
-    #ifdef BLITZ_PERFORMANCE
-    end = system_clock::now();
-    activation_time = end - start;
-    LOG(INFO) << "Backward activation time: " <<
-      activation_time.count();
-    #endif  // BLITZ_PERFORMANCE
-
-    #ifdef BLITZ_PERFORMANCE
-    start = system_clock::now();
-    #endif  // BLITZ_PERFORMANCE
-    if (bias_ != 0) {
-      (this->bias_)->update()->Fill(0);
-      Backend<TensorType, DType>::BiasBackwardUpdateFunc(
-        backward_input.get(),
-        (this->bias_)->update().get());
-    }
-    #ifdef BLITZ_PERFORMANCE
-    end = system_clock::now();
-    bias_time = end - start;
-    LOG(INFO) << "Backward bias time: " <<
-      bias_time.count();
-    #endif  // BLITZ_PERFORMANCE
-
-    #ifdef BLITZ_PERFORMANCE
-    start = system_clock::now();
-    #endif  // BLITZ_PERFORMANCE
-    if (batch_norm_ != 0) {
-      (this->batch_norm_)->beta_update()->Fill(0);
-      (this->batch_norm_)->gamma_update()->Fill(0);
-      Backend<TensorType, DType>::BatchNormBackwardFunc(
-        backward_input.get(),
-        (this->batch_norm_)->input_hat().get(),
-        (this->batch_norm_)->input_var().get(),
-        (this->batch_norm_)->gamma_weight().get(),
-        (this->batch_norm_)->gamma_update().get(),
-        (this->batch_norm_)->beta_update().get(),
+    BlitzProfileScope scope(this->name_, "backward",
+      this->backward_prop_ ? this->backward_computations() : 0);
+    if (this->FusedEpilogue()) {
+      BlitzProfileStageTimer stage("epilogue");
+      // activation derivative and bias gradient in a single pass
+      if (bias_ != 0) {
+        (this->bias_)->update()->Fill(0);
+      }
+      Backend<TensorType, DType>::EpilogueBackwardFunc(
+        (this->forward_output_).get(),
         backward_input.get(),
-        (this->batch_norm_)->epsilon());
+        bias_ != 0 ? ((this->bias_)->update()).get() : NULL,
+        this->activation_derivative_type(),
+        this->activation_slope());
+    } else {
+      if (this->activation_ != 0) {
+        BlitzProfileStageTimer stage("activation");
+        this->activation_->Derivative(this->forward_output_, backward_input);
+      }
+      if (bias_ != 0) {
+        BlitzProfileStageTimer stage("bias");
+        (this->bias_)->update()->Fill(0);
+        Backend<TensorType, DType>::BiasBackwardUpdateFunc(
+          backward_input.get(),
+          (this->bias_)->update().get());
+      }
+      if (batch_norm_ != 0) {
+        BlitzProfileStageTimer stage("batch_norm");
+        (this->batch_norm_)->beta_update()->Fill(0);
+        (this->batch_norm_)->gamma_update()->Fill(0);
+        Backend<TensorType, DType>::BatchNormBackwardFunc(
+          backward_input.get(),
+          (this->batch_norm_)->input_hat().get(),
+          (this->batch_norm_)->input_var().get(),
+          (this->batch_norm_)->gamma_weight().get(),
+          (this->batch_norm_)->gamma_update().get(),
+          (this->batch_norm_)->beta_update().get(),
+          backward_input.get(),
+          (this->batch_norm_)->epsilon());
+      }
     }
-    #ifdef BLITZ_PERFORMANCE
-    end = system_clock::now();
-    batch_norm_time = end - start;
-    LOG(INFO) << "Backward batch_norm time: " <<
-      batch_norm_time.count();
-    #endif  // BLITZ_PERFORMANCE
-
     (this->update_)->Fill(0);
-    Layer<TensorType, DType>::BackwardProp(backward_input);
+    this->BackwardPropImpl(backward_input);
   }
 
   virtual void BackwardPropImpl(shared_ptr<TensorType<DType> >
@@ -376,7 +428,129 @@ class ParamLayer : public Layer<TensorType, DType> {
     this->batch_norm_ = batch_norm;
   }
 
+  virtual bool FuseSoftmaxCost() {
+    softmax_cost_fused_ = this->activation_ != 0 &&
+      (this->activation_)->softmax_short_cut();
+    return softmax_cost_fused_;
+  }
+
+  virtual void ShareWeights(const Layer<TensorType, DType>& layer) {
+    const ParamLayer<TensorType, DType>& param_layer =
+      static_cast<const ParamLayer<TensorType, DType>&>(layer);
+    this->weight_ = param_layer.weight_;
+    if (bias_ != 0) {
+      (this->bias_)->set_weight((param_layer.bias_)->weight());
+    }
+    if (batch_norm_ != 0) {
+      // scale and shift are derived per network in the forward
+      (this->batch_norm_)->set_gamma_weight(
+        (param_layer.batch_norm_)->gamma_weight());
+      (this->batch_norm_)->set_beta_weight(
+        (param_layer.batch_norm_)->beta_weight());
+      (this->batch_norm_)->set_running_mean(
+        (param_layer.batch_norm_)->running_mean());
+      (this->batch_norm_)->set_running_var(
+        (param_layer.batch_norm_)->running_var());
+    }
+  }
+
+  virtual void CollectParams(
+    map<string, shared_ptr<TensorType<DType> > >* params) const {
+    (*params)[this->name_] = this->weight_;
+    if (bias_ != 0) {
+      (*params)[(this->bias_)->name()] = (this->bias_)->weight();
+    }
+    if (batch_norm_ != 0) {
+      const string& name = (this->batch_norm_)->name();
+      (*params)[name + "_gamma"] = (this->batch_norm_)->gamma_weight();
+      (*params)[name + "_beta"] = (this->batch_norm_)->beta_weight();
+      (*params)[name + "_running_mean"] =
+        (this->batch_norm_)->running_mean();
+      (*params)[name + "_running_var"] =
+        (this->batch_norm_)->running_var();
+    }
+  }
+
+  virtual void Calibrate(shared_ptr<TensorType<DType> > forward_input) {
+    DType minimum, maximum;
+    Backend<TensorType, DType>::RangeFunc(forward_input.get(),
+      &minimum, &maximum);
+    if (calibrated_) {
+      input_minimum_ = std::min(input_minimum_, minimum);
+      input_maximum_ = std::max(input_maximum_, maximum);
+    } else {
+      input_minimum_ = minimum;
+      input_maximum_ = maximum;
+      calibrated_ = true;
+    }
+  }
+
  protected:
+  // batch norm statistics need a separate pass over the batch,
+  // at inference it is a per element affine from the running statistics
+  bool FusedEpilogue() const {
+    return (batch_norm_ == 0 || !this->train_) && (this->activation_ == 0 ||
+      softmax_cost_fused_ ||
+      (this->activation_)->type() != BLITZ_ACTIVATION_UNDEFINED);
+  }
+
+  // a softmax fused into the cost leaves the logits untouched
+  BLITZ_ACTIVATION activation_type() const {
+    return this->activation_ != 0 && !softmax_cost_fused_ ?
+      (this->activation_)->type() : BLITZ_ACTIVATION_NONE;
+  }
+
+  BLITZ_ACTIVATION activation_derivative_type() const {
+    return this->activation_ != 0 && !softmax_cost_fused_ ?
+      (this->activation_)->derivative_type() : BLITZ_ACTIVATION_NONE;
+  }
+
+  void BatchNormScaleShift() {
+    Backend<TensorType, DType>::BatchNormScaleShiftFunc(
+      (this->batch_norm_)->gamma_weight().get(),
+      (this->batch_norm_)->beta_weight().get(),
+      (this->batch_norm_)->running_mean().get(),
+      (this->batch_norm_)->running_var().get(),
+      (this->batch_norm_)->scale().get(),
+      (this->batch_norm_)->shift().get(),
+      (this->batch_norm_)->epsilon());
+  }
+
+  DType activation_slope() const {
+    return this->activation_ != 0 ? (this->activation_)->slope() :
+      static_cast<DType>(0);
+  }
+
+  // per output channel int8 weights and the per tensor input range,
+  // transpose if the output channels are the first weight dimension
+  void QuantizeWeight(bool transpose, size_t workspace_size) {
+    CHECK(calibrated_) << "Layer " << this->name_ << " is not calibrated";
+    const Shape& shape = (this->weight_)->shape();
+    const size_t N = transpose ? shape[0] : shape[shape.dimension() - 1];
+    const size_t K = (this->weight_)->size() / N;
+    Shape quantized_shape(1);
+    quantized_shape[0] = BlitzQuantizedWeightSize(K, N);
+    Shape channel_shape(1);
+    channel_shape[0] = N;
+    Shape workspace_shape(1);
+    workspace_shape[0] = workspace_size;
+    quantized_weight_ = make_shared<TensorType<signed char> >(
+      quantized_shape);
+    weight_scale_ = make_shared<TensorType<DType> >(channel_shape);
+    weight_sum_ = make_shared<TensorType<int> >(channel_shape);
+    quantized_workspace_ = make_shared<TensorType<unsigned char> >(
+      workspace_shape);
+    Backend<TensorType, DType>::QuantizeWeightFunc((this->weight_).get(),
+      quantized_weight_.get(), weight_scale_.get(), weight_sum_.get(),
+      transpose);
+    BlitzQuantizeRange(input_minimum_, input_maximum_,
+      &input_scale_, &zero_point_);
+    quantized_ = true;
+    LOG(INFO) << "Quantize Layer: " << this->name_ << " input range: [" <<
+      input_minimum_ << ", " << input_maximum_ << "] scale: " <<
+      input_scale_ << " zero point: " << static_cast<int>(zero_point_);
+  }
+
   const string filler_name_;
   const string optimizer_name_;
 
@@ -386,6 +560,19 @@ class ParamLayer : public Layer<TensorType, DType> {
   shared_ptr<Bias> bias_;
   shared_ptr<BatchNorm> batch_norm_;
   shared_ptr<Activation<TensorType, DType> > activation_;
+  bool softmax_cost_fused_;
+
+  // int8 inference state, the forward falls back to DType while training
+  shared_ptr<TensorType<signed char> > quantized_weight_;
+  shared_ptr<TensorType<DType> > weight_scale_;
+  shared_ptr<TensorType<int> > weight_sum_;
+  shared_ptr<TensorType<unsigned char> > quantized_workspace_;
+  DType input_minimum_;
+  DType input_maximum_;
+  DType input_scale_;
+  unsigned char zero_point_;
+  bool calibrated_;
+  bool quantized_;
 
   DISABLE_COPY_AND_ASSIGN(ParamLayer);
 };
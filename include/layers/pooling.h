@@ -14,23 +14,40 @@ class Pooling : public Layer<TensorType, DType> {
  public:
   explicit Pooling(
     const string& name, const size_t filter, const size_t stride,
-    const string& op = "max") :
+    const string& op = "max", const bool global = false) :
     Layer<TensorType, DType>(name), filter_(filter),
-    stride_(stride), op_(op) {}
+    stride_(stride), op_(op), global_(global),
+    filter_height_(filter), filter_width_(filter) {}
   ~Pooling() {}
 
   virtual void InitImpl(const Shape& input_shape);
   virtual void ForwardPropImpl(shared_ptr<TensorType<DType> > forward_input);
   virtual void BackwardPropImpl(shared_ptr<TensorType<DType> > backward_input);
 
+  virtual shared_ptr<TensorType<DType> > workspace() const {
+    return this->workspace_;
+  }
+
+  virtual void set_workspace(shared_ptr<TensorType<DType> > workspace) {
+    this->workspace_ = workspace;
+  }
+
  private:
   const size_t filter_;
   const size_t stride_;
 
   const string op_;
 
-  // according to different op
-  shared_ptr<TensorType<size_t> > max_index_;
+  // global windows take the input height and width
+  const bool global_;
+  size_t filter_height_;
+  size_t filter_width_;
+
+  // according to different op, the argmax inside each window
+  shared_ptr<TensorType<unsigned char> > max_index_;
+
+  // partial sums of global average pooling
+  shared_ptr<TensorType<DType> > workspace_;
 
   DISABLE_COPY_AND_ASSIGN(Pooling);
 };
@@ -0,0 +1,36 @@
+#ifndef INCLUDE_MODEL_C_PREDICTOR_H_
+#define INCLUDE_MODEL_C_PREDICTOR_H_
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// C interface of the float CPU Predictor in libblitz.so
+typedef struct BlitzPredictor BlitzPredictor;
+
+// NULL if the config cannot be loaded
+BlitzPredictor* BlitzPredictorCreate(const char* config_path);
+
+// shares the weights of predictor, one clone per calling thread
+BlitzPredictor* BlitzPredictorClone(const BlitzPredictor* predictor);
+
+// n samples of input_size floats to n samples of output_size floats,
+// 0 on success
+int BlitzPredictorPredict(BlitzPredictor* predictor,
+  const float* input, size_t n, float* output);
+
+size_t BlitzPredictorBatchSize(const BlitzPredictor* predictor);
+
+size_t BlitzPredictorInputSize(const BlitzPredictor* predictor);
+
+size_t BlitzPredictorOutputSize(const BlitzPredictor* predictor);
+
+void BlitzPredictorDestroy(BlitzPredictor* predictor);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // INCLUDE_MODEL_C_PREDICTOR_H_
@@ -6,6 +6,7 @@
 #include "callbacks/callback_wrapper.h"
 #include "data/data_iterator.h"
 #include "layers/layer_wrapper.h"
+#include "model/seralize.h"
 #include "scheduler/scheduler.h"
 #include "utils/common.h"
 
@@ -17,11 +18,21 @@ class Model {
   explicit Model(const size_t epoches) :
     epoches_(epoches) {}
 
+  // fitting restores the network from the checkpoint at path first and
+  // goes on after its epoch
+  void set_resume(shared_ptr<Serializer<TensorType, DType> > serializer,
+    const string& path) {
+    resume_serializer_ = serializer;
+    resume_path_ = path;
+  }
+
   void Inference(
     shared_ptr<DataIterator<TensorType, DType> > inference_set,
     shared_ptr<DataIterator<TensorType, DType> > inference_label,
     shared_ptr<LayerWrapper<TensorType, DType> > layer_wrapper,
-    const string& eval_type);
+    const string& eval_type,
+    bool quantize = false,
+    size_t calibration_batches = 8);
 
   // fit and evaluate
   void Fit(
@@ -59,13 +70,27 @@ class Model {
     shared_ptr<LayerWrapper<TensorType, DType> > layer_wrapper,
     const string& eval_type);
 
+  // one pass over the inference set, outputs are written to output_file
+  DType InferenceEpoch(
+    shared_ptr<DataIterator<TensorType, DType> > inference_set,
+    shared_ptr<DataIterator<TensorType, DType> > inference_label,
+    shared_ptr<LayerWrapper<TensorType, DType> > layer_wrapper,
+    const string& eval_type,
+    const string& output_file,
+    double* elapsed_seconds);
+
   DType ForwardProp(shared_ptr<LayerWrapper<TensorType, DType> > layer_wrapper,
     shared_ptr<TensorType<DType> > input,
     const shared_ptr<TensorType<DType> > target);
   void BackwardProp(shared_ptr<LayerWrapper<TensorType, DType> > layer_wrapper,
     const shared_ptr<TensorType<DType> > target);
 
+  // first epoch to fit, after the fillers have run
+  size_t Resume();
+
   const size_t epoches_;
+  shared_ptr<Serializer<TensorType, DType> > resume_serializer_;
+  string resume_path_;
 
   DISABLE_COPY_AND_ASSIGN(Model);
 };
@@ -0,0 +1,65 @@
+#ifndef INCLUDE_MODEL_PREDICTOR_H_
+#define INCLUDE_MODEL_PREDICTOR_H_
+
+#include <string>
+
+#include "layers/layer_wrapper.h"
+#include "model/seralize.h"
+#include "utils/common.h"
+
+namespace blitz {
+
+class Parser;
+
+// Forward only network for embedding, inputs and outputs are host
+// buffers owned by the caller. All buffers are allocated on
+// construction, Predict allocates nothing.
+// A Predictor is used by one thread at a time, other threads Clone it:
+// clones keep their own activations and workspace but read the weights
+// of the original. Construction and Clone are not thread safe.
+// The profiler keeps process wide state that is not thread safe, so
+// `profile: true` must not be combined with clones predicting
+// concurrently.
+template<template <typename> class TensorType, typename DType>
+class Predictor {
+ public:
+  // network, batch_size and data_shape from a blitz yaml config,
+  // weights from the checkpoint at load_path if given
+  explicit Predictor(const string& config_path);
+
+  shared_ptr<Predictor<TensorType, DType> > Clone() const;
+
+  // n samples of input_size() from input, output_size() of each to
+  // output, in batches of batch_size()
+  void Predict(const DType* input, size_t n, DType* output);
+
+  size_t batch_size() const {
+    return batch_size_;
+  }
+
+  size_t input_size() const {
+    return input_->size() / batch_size_;
+  }
+
+  size_t output_size() const {
+    return (layer_wrapper_->forward_output())->size() / batch_size_;
+  }
+
+ private:
+  explicit Predictor(shared_ptr<Parser> parser);
+
+  void Init();
+
+  shared_ptr<Parser> parser_;
+  shared_ptr<LayerWrapper<TensorType, DType> > layer_wrapper_;
+  // owns the mapped weights, shared with clones
+  shared_ptr<Serializer<TensorType, DType> > serializer_;
+  shared_ptr<TensorType<DType> > input_;
+  size_t batch_size_;
+
+  DISABLE_COPY_AND_ASSIGN(Predictor);
+};
+
+}  // namespace blitz
+
+#endif  // INCLUDE_MODEL_PREDICTOR_H_
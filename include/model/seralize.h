@@ -0,0 +1,107 @@
+#ifndef INCLUDE_MODEL_SERALIZE_H_
+#define INCLUDE_MODEL_SERALIZE_H_
+
+#include <boost/thread/thread.hpp>
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "layers/layer_wrapper.h"
+#include "scheduler/scheduler.h"
+#include "utils/common.h"
+
+namespace blitz {
+
+#define BLITZ_CHECKPOINT_MAGIC "BLITZCKP"
+#define BLITZ_CHECKPOINT_VERSION 1
+#define BLITZ_CHECKPOINT_ALIGNMENT 64
+#define BLITZ_CHECKPOINT_NAME_SIZE 96
+
+// binary checkpoint: this 64-byte header, num_sections section entries,
+// then the data of every section at a 64-byte aligned offset
+struct BlitzCheckpointHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t element_size;
+  uint64_t num_sections;
+  // epochs completed and optimizer steps taken
+  uint64_t epoch;
+  uint64_t iteration;
+  char reserved[24];
+};
+
+// one named tensor, size in elements, offset in bytes from the file start
+struct BlitzCheckpointSection {
+  char name[BLITZ_CHECKPOINT_NAME_SIZE];
+  uint64_t size;
+  uint64_t offset;
+  char reserved[16];
+};
+
+// saves and restores the weights, biases, batch norm statistics and
+// optimizer states of a network, the network has to be initialized
+// before the first call
+template<template <typename> class TensorType, typename DType>
+class Serializer {
+ public:
+  // an inference only network has no scheduler
+  explicit Serializer(
+    shared_ptr<LayerWrapper<TensorType, DType> > layer_wrapper,
+    shared_ptr<Scheduler<TensorType, DType> > scheduler =
+    shared_ptr<Scheduler<TensorType, DType> >()) :
+    layer_wrapper_(layer_wrapper), scheduler_(scheduler),
+    mapping_(NULL), mapping_size_(0) {}
+
+  ~Serializer();
+
+  // copy every tensor into a host staging buffer and write it to path
+  // on a background thread, the previous write is finished first
+  void Save(const string& path, size_t epoch);
+
+  // block until the background write is done
+  void Wait();
+
+  // copy every tensor out of the checkpoint, returns the epochs completed
+  size_t Load(const string& path);
+
+  // host tensors view the mapped checkpoint without a copy, devices
+  // copy it in, the mapping is kept until destruction
+  // tensors must not be relocated afterwards, so inference only
+  void Map(const string& path);
+
+ private:
+  void Collect();
+
+  // map path and check its header and sections
+  void MapFile(const string& path);
+
+  void UnmapFile();
+
+  // section of each tensor, fatal if one is missing or does not match
+  void Sections(
+    map<string, const BlitzCheckpointSection*>* sections) const;
+
+  // writer thread body
+  void Write(const string& path);
+
+  shared_ptr<LayerWrapper<TensorType, DType> > layer_wrapper_;
+  shared_ptr<Scheduler<TensorType, DType> > scheduler_;
+
+  // ordered by name, which is also the order of the sections
+  map<string, shared_ptr<TensorType<DType> > > tensors_;
+
+  // the file as written, reused across saves
+  vector<char> staging_;
+  shared_ptr<boost::thread> writer_;
+
+  char* mapping_;
+  size_t mapping_size_;
+
+  DISABLE_COPY_AND_ASSIGN(Serializer);
+};
+
+}  // namespace blitz
+
+#endif  // INCLUDE_MODEL_SERALIZE_H_
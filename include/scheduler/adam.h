@@ -0,0 +1,53 @@
+#ifndef INCLUDE_SCHEDULER_ADAM_H_
+#define INCLUDE_SCHEDULER_ADAM_H_
+
+#include <string>
+
+#include "scheduler/optimizer.h"
+#include "utils/common.h"
+
+namespace blitz {
+
+// first and second moments with bias correction, the moments are the
+// two states of each weight
+template<template <typename> class TensorType, typename DType>
+class Adam : public Optimizer<TensorType, DType> {
+ public:
+  explicit Adam(const string& name, const DType learning_rate,
+    const DType change, const size_t step,
+    DType beta1 = 0.9, DType beta2 = 0.999, DType epsilon = 1e-8,
+    DType decay = 0.0) :
+    Optimizer<TensorType, DType>(name, learning_rate, change, step),
+    beta1_(beta1), beta2_(beta2), epsilon_(epsilon), decay_(decay),
+    iteration_(0) {}
+  virtual ~Adam() {}
+
+  virtual void OptimizeImpl(const size_t epoch, const size_t batch_size,
+    const DType learning_rate);
+
+  virtual size_t num_states() const {
+    return 2;
+  }
+
+  virtual size_t iteration() const {
+    return iteration_;
+  }
+
+  virtual void set_iteration(size_t iteration) {
+    iteration_ = iteration;
+  }
+
+ private:
+  DType beta1_;
+  DType beta2_;
+  DType epsilon_;
+  DType decay_;
+  // steps taken, for the bias correction
+  size_t iteration_;
+
+  DISABLE_COPY_AND_ASSIGN(Adam);
+};
+
+}  // namespace blitz
+
+#endif  // INCLUDE_SCHEDULER_ADAM_H_
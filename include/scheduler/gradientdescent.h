@@ -10,12 +10,6 @@ namespace blitz {
 
 template<template <typename> class TensorType, typename DType>
 class Gradientdescent : public Optimizer<TensorType, DType> {
- public:
-  typedef typename Optimizer<TensorType, DType>::LayerParam
-    LayerParam;
-  typedef typename Optimizer<TensorType, DType>::LayerParamIterator
-    LayerParamIterator;
-
  public:
   explicit Gradientdescent(const string& name, const DType learning_rate,
     const DType change, const size_t step,
@@ -25,7 +19,7 @@ class Gradientdescent : public Optimizer<TensorType, DType> {
   virtual ~Gradientdescent() {}
 
   virtual void OptimizeImpl(const size_t epoch, const size_t batch_size,
-    const DType learning_rate, LayerParamIterator layer_param_it);
+    const DType learning_rate);
 
  private:
   DType momentum_coef_;
@@ -0,0 +1,34 @@
+#ifndef INCLUDE_SCHEDULER_NESTEROV_H_
+#define INCLUDE_SCHEDULER_NESTEROV_H_
+
+#include <string>
+
+#include "scheduler/optimizer.h"
+#include "utils/common.h"
+
+namespace blitz {
+
+// momentum evaluated at the look-ahead weight
+template<template <typename> class TensorType, typename DType>
+class Nesterov : public Optimizer<TensorType, DType> {
+ public:
+  explicit Nesterov(const string& name, const DType learning_rate,
+    const DType change, const size_t step,
+    DType momentum_coef = 0.9, DType decay = 0.0) :
+    Optimizer<TensorType, DType>(name, learning_rate, change, step),
+    momentum_coef_(momentum_coef), decay_(decay) {}
+  virtual ~Nesterov() {}
+
+  virtual void OptimizeImpl(const size_t epoch, const size_t batch_size,
+    const DType learning_rate);
+
+ private:
+  DType momentum_coef_;
+  DType decay_;
+
+  DISABLE_COPY_AND_ASSIGN(Nesterov);
+};
+
+}  // namespace blitz
+
+#endif  // INCLUDE_SCHEDULER_NESTEROV_H_
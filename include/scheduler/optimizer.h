@@ -5,6 +5,7 @@
 #include <string>
 
 #include "backends/tensor.h"
+#include "utils/blitz_profiler.h"
 #include "utils/common.h"
 
 namespace blitz {
@@ -16,9 +17,7 @@ class Optimizer {
    public:
     LayerParam(shared_ptr<TensorType<DType> > weight,
       shared_ptr<TensorType<DType> > update) : weight_(weight),
-      update_(update) {
-      state_ = make_shared<TensorType<DType> >(weight->shape());
-    }
+      update_(update), offset_(0) {}
 
     shared_ptr<TensorType<DType> > weight() {
       return weight_;
@@ -32,10 +31,34 @@ class Optimizer {
       return state_;
     }
 
+    shared_ptr<TensorType<DType> > second_state() {
+      return second_state_;
+    }
+
+    size_t offset() const {
+      return offset_;
+    }
+
+    void set_state(shared_ptr<TensorType<DType> > state) {
+      state_ = state;
+    }
+
+    void set_second_state(shared_ptr<TensorType<DType> > second_state) {
+      second_state_ = second_state;
+    }
+
+    void set_offset(size_t offset) {
+      offset_ = offset;
+    }
+
    private:
     shared_ptr<TensorType<DType> > weight_;
     shared_ptr<TensorType<DType> > update_;
     shared_ptr<TensorType<DType> > state_;
+    // only for optimizers with two states, e.g. Adam moments
+    shared_ptr<TensorType<DType> > second_state_;
+    // first element inside each region of the arena
+    size_t offset_;
   };
 
   typedef typename map<string, shared_ptr<LayerParam> >::iterator
@@ -48,37 +71,104 @@ class Optimizer {
     change_(change), step_(step) {}
   virtual ~Optimizer() {}
 
-  void Optimize(const size_t epoch, const size_t batch_size) {
-    const DType learning_rate = this->ChangeLearningRate(epoch);
+  // weights, updates and states of all layers are moved into one
+  // arena with a region for each, so a step is a single sweep
+  void Init() {
+    const size_t num_states = this->num_states();
+    CHECK_LE(num_states, 2);
+    if (this->arena_ != 0 || this->layer_params_.empty()) {
+      return;
+    }
+#ifdef BLITZ_ALIGNMENT_SIZE
+    const size_t alignment = BLITZ_ALIGNMENT_SIZE / sizeof(DType);
+#else
+    const size_t alignment = 1;
+#endif
+    LayerParamIterator layer_param_it = this->layer_params_.begin();
+    size_t size = 0;
+    for (; layer_param_it != this->layer_params_.end(); ++layer_param_it) {
+      shared_ptr<LayerParam> layer_param = layer_param_it->second;
+      CHECK_EQ(layer_param->weight()->size(), layer_param->update()->size());
+      layer_param->set_offset(size);
+      size += (layer_param->weight()->size() + alignment - 1) /
+        alignment * alignment;
+    }
+    Shape arena_shape(1);
+    arena_shape[0] = size * (2 + num_states);
+    this->arena_ = make_shared<TensorType<DType> >(arena_shape);
+    DType* weight = this->arena_->data();
+    DType* update = weight + size;
+    DType* state = update + size;
+    DType* second_state = state + size;
+    for (layer_param_it = this->layer_params_.begin();
+      layer_param_it != this->layer_params_.end(); ++layer_param_it) {
+      shared_ptr<LayerParam> layer_param = layer_param_it->second;
+      const size_t offset = layer_param->offset();
+      layer_param->weight()->Relocate(weight + offset);
+      layer_param->update()->Relocate(update + offset);
+      layer_param->set_state(make_shared<TensorType<DType> >(
+        state + offset, layer_param->weight()->shape()));
+      if (num_states == 2) {
+        layer_param->set_second_state(make_shared<TensorType<DType> >(
+          second_state + offset, layer_param->weight()->shape()));
+      }
+    }
+    Shape region_shape(1);
+    region_shape[0] = size;
+    this->weight_ = make_shared<TensorType<DType> >(weight, region_shape);
+    this->update_ = make_shared<TensorType<DType> >(update, region_shape);
+    this->state_ = make_shared<TensorType<DType> >(state, region_shape);
+    if (num_states == 2) {
+      this->second_state_ = make_shared<TensorType<DType> >(second_state,
+        region_shape);
+    }
+  }
 
-    LayerParamIterator layer_param_it =
-      this->layer_params_.begin();
-
-    for (; layer_param_it != this->layer_params_.end();
-      ++layer_param_it) {
-      #ifdef BLITZ_PERFORMANCE
-      time_point<system_clock> start, end;
-      duration<double> core_time = duration<double>::zero();
-      LOG(INFO) << layer_param_it->first << ":";
-      start = system_clock::now();
-      #endif  // BLITZ_PERFORMANCE
-      this->OptimizeImpl(epoch, batch_size, learning_rate,
-        layer_param_it);
-      #ifdef BLITZ_PERFORMANCE
-      end = system_clock::now();
-      core_time = end - start;
-      LOG(INFO) << "Optimize core time: " <<
-        core_time.count();
-      #endif  // BLITZ_PERFORMANCE
+  void Optimize(const size_t epoch, const size_t batch_size) {
+    if (this->arena_ == 0) {
+      this->Init();
     }
+    const DType learning_rate = this->ChangeLearningRate(epoch);
+    BlitzProfileScope scope(name_, "optimize");
+    this->OptimizeImpl(epoch, batch_size, learning_rate);
   }
 
   virtual void OptimizeImpl(const size_t epoch, const size_t batch_size,
-    const DType learning_rate, LayerParamIterator layer_param_it) = 0;
+    const DType learning_rate) = 0;
+
+  // state tensors kept per weight
+  virtual size_t num_states() const {
+    return 1;
+  }
+
+  // steps taken, only optimizers that correct for it keep a count
+  virtual size_t iteration() const {
+    return 0;
+  }
+
+  virtual void set_iteration(size_t iteration) {}
+
+  // states of every weight by name, for checkpoints, after Init
+  void CollectStates(map<string, shared_ptr<TensorType<DType> > >* states) {
+    LayerParamIterator layer_param_it = this->layer_params_.begin();
+    for (; layer_param_it != this->layer_params_.end(); ++layer_param_it) {
+      shared_ptr<LayerParam> layer_param = layer_param_it->second;
+      if (layer_param->state() != 0) {
+        (*states)[layer_param_it->first + "_state"] = layer_param->state();
+      }
+      if (layer_param->second_state() != 0) {
+        (*states)[layer_param_it->first + "_second_state"] =
+          layer_param->second_state();
+      }
+    }
+  }
 
   void AddLayer(const string& name,
     shared_ptr<TensorType<DType> > weight,
     shared_ptr<TensorType<DType> > update) {
+    if (this->arena_ != 0) {
+      LOG(FATAL) << "layer: " << name << " added after optimizer init";
+    }
     if (this->layer_params_.find(name) == this->layer_params_.end()) {
       // move constructor
       this->layer_params_[name] = make_shared<LayerParam>(weight, update);
@@ -97,6 +187,14 @@ class Optimizer {
 
   map<string, shared_ptr<LayerParam> > layer_params_;
 
+  // weights | updates | states | second states, each region padded per
+  // layer to the alignment, the members below view the whole regions
+  shared_ptr<TensorType<DType> > arena_;
+  shared_ptr<TensorType<DType> > weight_;
+  shared_ptr<TensorType<DType> > update_;
+  shared_ptr<TensorType<DType> > state_;
+  shared_ptr<TensorType<DType> > second_state_;
+
   const string name_;
   const DType learning_rate_;
   const DType change_;
@@ -0,0 +1,35 @@
+#ifndef INCLUDE_SCHEDULER_RMSPROP_H_
+#define INCLUDE_SCHEDULER_RMSPROP_H_
+
+#include <string>
+
+#include "scheduler/optimizer.h"
+#include "utils/common.h"
+
+namespace blitz {
+
+// steps scaled by a moving average of the squared gradient
+template<template <typename> class TensorType, typename DType>
+class RMSProp : public Optimizer<TensorType, DType> {
+ public:
+  explicit RMSProp(const string& name, const DType learning_rate,
+    const DType change, const size_t step,
+    DType rho = 0.9, DType epsilon = 1e-8, DType decay = 0.0) :
+    Optimizer<TensorType, DType>(name, learning_rate, change, step),
+    rho_(rho), epsilon_(epsilon), decay_(decay) {}
+  virtual ~RMSProp() {}
+
+  virtual void OptimizeImpl(const size_t epoch, const size_t batch_size,
+    const DType learning_rate);
+
+ private:
+  DType rho_;
+  DType epsilon_;
+  DType decay_;
+
+  DISABLE_COPY_AND_ASSIGN(RMSProp);
+};
+
+}  // namespace blitz
+
+#endif  // INCLUDE_SCHEDULER_RMSPROP_H_
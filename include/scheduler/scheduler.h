@@ -17,6 +17,9 @@ class Scheduler {
     map<string, shared_ptr<Optimizer<TensorType, DType> > > optimizers) :
     optimizers_(optimizers) {}
 
+  // after all layers are added, packs each optimizer's parameters
+  void Init();
+
   void Run(const size_t epoch, const size_t batch_size);
 
   void AddLayer(const string& optimizer_name,
@@ -24,6 +27,14 @@ class Scheduler {
     shared_ptr<TensorType<DType> > weight,
     shared_ptr<TensorType<DType> > update);
 
+  // optimizer states of every weight by name, for checkpoints
+  void CollectStates(map<string, shared_ptr<TensorType<DType> > >* states);
+
+  // every optimizer steps once per batch, so they share one count
+  size_t iteration() const;
+
+  void set_iteration(size_t iteration);
+
  private:
   map<string, shared_ptr<Optimizer<TensorType, DType> > > optimizers_;
 
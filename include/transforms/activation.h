@@ -2,6 +2,7 @@
 #define INCLUDE_TRANSFORMS_ACTIVATION_H_
 
 #include "backends/tensor.h"
+#include "utils/blitz_activation_function.h"
 #include "utils/common.h"
 
 namespace blitz {
@@ -17,6 +18,25 @@ class Activation {
   virtual void Derivative(const shared_ptr<TensorType<DType> > input,
     shared_ptr<TensorType<DType> > output) = 0;
 
+  // fused epilogue kernels, undefined activations are applied separately
+  virtual BLITZ_ACTIVATION type() const {
+    return BLITZ_ACTIVATION_UNDEFINED;
+  }
+
+  virtual BLITZ_ACTIVATION derivative_type() const {
+    return this->type();
+  }
+
+  virtual DType slope() const {
+    return 0;
+  }
+
+  // a softmax whose derivative the cost folds in, it can be fused
+  // into the cost kernel
+  virtual bool softmax_short_cut() const {
+    return false;
+  }
+
   DISABLE_COPY_AND_ASSIGN(Activation);
 };
 
@@ -20,6 +20,12 @@ class Cost {
     const shared_ptr<TensorType<DType> > target,
     shared_ptr<TensorType<DType> > result) = 0;
 
+  // the cost can take the logits of a short cut softmax and run
+  // softmax, cost and derivative in one kernel
+  virtual bool softmax_fusible() const {
+    return false;
+  }
+
   DISABLE_COPY_AND_ASSIGN(Cost);
 };
 
@@ -19,6 +19,10 @@ class CrossEntropyMulti : public Cost<TensorType, DType> {
     const shared_ptr<TensorType<DType> > target,
     shared_ptr<TensorType<DType> > result);
 
+  virtual bool softmax_fusible() const {
+    return true;
+  }
+
  private:
   const DType scale_;
 
@@ -18,6 +18,15 @@ class Logistic : public Activation<TensorType, DType> {
   virtual void Derivative(const shared_ptr<TensorType<DType> > input,
     shared_ptr<TensorType<DType> > output);
 
+  virtual BLITZ_ACTIVATION type() const {
+    return BLITZ_ACTIVATION_LOGISTIC;
+  }
+
+  // the cost already folds the derivative in when short cut
+  virtual BLITZ_ACTIVATION derivative_type() const {
+    return short_cut_ ? BLITZ_ACTIVATION_NONE : BLITZ_ACTIVATION_LOGISTIC;
+  }
+
  private:
   const bool short_cut_;
 
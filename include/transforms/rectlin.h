@@ -18,6 +18,14 @@ class Rectlin : public Activation<TensorType, DType> {
   virtual void Derivative(const shared_ptr<TensorType<DType> > input,
     shared_ptr<TensorType<DType> > output);
 
+  virtual BLITZ_ACTIVATION type() const {
+    return BLITZ_ACTIVATION_RECTLIN;
+  }
+
+  virtual DType slope() const {
+    return slope_;
+  }
+
  private:
   const DType slope_;
 
@@ -18,6 +18,10 @@ class Softmax : public Activation<TensorType, DType> {
   virtual void Derivative(const shared_ptr<TensorType<DType> > input,
     shared_ptr<TensorType<DType> > output);
 
+  virtual bool softmax_short_cut() const {
+    return short_cut_;
+  }
+
  private:
   const bool short_cut_;
 
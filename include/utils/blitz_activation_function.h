@@ -0,0 +1,16 @@
+#ifndef INCLUDE_UTIL_BLITZ_ACTIVATION_FUNCTION_H_
+#define INCLUDE_UTIL_BLITZ_ACTIVATION_FUNCTION_H_
+
+namespace blitz {
+
+// activations the backends can fuse into a layer epilogue
+enum BLITZ_ACTIVATION {
+  BLITZ_ACTIVATION_NONE = 0,
+  BLITZ_ACTIVATION_RECTLIN = 1,
+  BLITZ_ACTIVATION_LOGISTIC = 2,
+  BLITZ_ACTIVATION_UNDEFINED = 3
+};
+
+}  // namespace blitz
+
+#endif  // INCLUDE_UTIL_BLITZ_ACTIVATION_FUNCTION_H_
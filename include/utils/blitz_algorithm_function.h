@@ -12,7 +12,9 @@ enum BLITZ_ALGORITHM {
   BLITZ_CONVOLUTION_XSMM_DIRECT = 5,
   BLITZ_BLAS_GEMM = 6,
   BLITZ_SASS_GEMM = 7,
-  BLITZ_ALGORITHM_UNDEFINED = 8
+  BLITZ_CONVOLUTION_DIRECT = 8,
+  BLITZ_CONVOLUTION_WINOGRAD = 9,
+  BLITZ_ALGORITHM_UNDEFINED = 10
 };
 
 inline BLITZ_ALGORITHM BlitzParseAlgorithm(const string& algorithm) {
@@ -28,6 +30,10 @@ inline BLITZ_ALGORITHM BlitzParseAlgorithm(const string& algorithm) {
     return BLITZ_CONVOLUTION_BLAS_GEMM_BATCH;
   } else if (algorithm == "convolution_xsmm_direct") {
     return BLITZ_CONVOLUTION_XSMM_DIRECT;
+  } else if (algorithm == "convolution_direct") {
+    return BLITZ_CONVOLUTION_DIRECT;
+  } else if (algorithm == "convolution_winograd") {
+    return BLITZ_CONVOLUTION_WINOGRAD;
   } else if (algorithm == "blas_gemm") {
     return BLITZ_BLAS_GEMM;
   } else if (algorithm == "sass_gemm") {
@@ -37,6 +43,15 @@ inline BLITZ_ALGORITHM BlitzParseAlgorithm(const string& algorithm) {
   }
 }
 
+// number of winograd tiles every thread transforms and multiplies at once
+#define BLITZ_WINOGRAD_TILE_BLOCK 64
+
+// F(4x4, 3x3) for large feature maps, F(2x2, 3x3) otherwise
+inline size_t BlitzWinogradOutputTile(size_t output_height,
+  size_t output_width) {
+  return (output_height >= 8 && output_width >= 8) ? 4 : 2;
+}
+
 }  // namespace blitz
 
 #endif  // INCLUDE_UTIL_BLITZ_ALGORITHM_FUNCTION_H_
@@ -3,20 +3,73 @@
 
 #include <immintrin.h>
 
+#include <cstddef>
+
 namespace blitz {
 
+// BLITZ_AVX_WIDTH selects the register: 32 bytes for AVX/AVX2,
+// 64 bytes for AVX-512. Without AVX2 the integer steps of exp/log
+// are done on two SSE halves.
+#if BLITZ_AVX_WIDTH == 64
+#define BLITZ_AVX_PS(op) _mm512_##op##_ps
+#define BLITZ_AVX_PD(op) _mm512_##op##_pd
+typedef __m512 BlitzAVXFloat;
+typedef __m512d BlitzAVXDouble;
+typedef __m512i BlitzAVXInteger;
+#else
+#define BLITZ_AVX_PS(op) _mm256_##op##_ps
+#define BLITZ_AVX_PD(op) _mm256_##op##_pd
+typedef __m256 BlitzAVXFloat;
+typedef __m256d BlitzAVXDouble;
+typedef __m256i BlitzAVXInteger;
+#endif
+
 template <typename DType>
 union BlitzAVXReg;
 
+template <>
+union BlitzAVXReg<float> {
+  BlitzAVXFloat v;
+  float d[BLITZ_AVX_WIDTH / sizeof(float)];
+};
+
+template <>
+union BlitzAVXReg<double> {
+  BlitzAVXDouble v;
+  double d[BLITZ_AVX_WIDTH / sizeof(double)];
+};
+
 template<typename DType>
 inline void BlitzAVXBroadcast(const DType* addr, BlitzAVXReg<DType>* reg);
 
 template<typename DType>
 inline void BlitzAVXLoad(const DType* addr, BlitzAVXReg<DType>* reg);
 
+template<typename DType>
+inline void BlitzAVXLoadu(const DType* addr, BlitzAVXReg<DType>* reg);
+
 template<typename DType>
 inline void BlitzAVXStore(const DType* addr, BlitzAVXReg<DType>* reg);
 
+template<typename DType>
+inline void BlitzAVXStoreu(const DType* addr, BlitzAVXReg<DType>* reg);
+
+template<typename DType>
+inline void BlitzAVXAdd(const BlitzAVXReg<DType>* left,
+  const BlitzAVXReg<DType>* right, BlitzAVXReg<DType>* output);
+
+template<typename DType>
+inline void BlitzAVXSub(const BlitzAVXReg<DType>* left,
+  const BlitzAVXReg<DType>* right, BlitzAVXReg<DType>* output);
+
+template<typename DType>
+inline void BlitzAVXMul(const BlitzAVXReg<DType>* left,
+  const BlitzAVXReg<DType>* right, BlitzAVXReg<DType>* output);
+
+template<typename DType>
+inline void BlitzAVXDiv(const BlitzAVXReg<DType>* left,
+  const BlitzAVXReg<DType>* right, BlitzAVXReg<DType>* output);
+
 template<typename DType>
 inline void BlitzAVXMax(const BlitzAVXReg<DType>* left,
   const BlitzAVXReg<DType>* right, BlitzAVXReg<DType>* output);
@@ -25,6 +78,1020 @@ template<typename DType>
 inline void BlitzAVXMin(const BlitzAVXReg<DType>* left,
   const BlitzAVXReg<DType>* right, BlitzAVXReg<DType>* output);
 
+// output = left * right + addend
+template<typename DType>
+inline void BlitzAVXFma(const BlitzAVXReg<DType>* left,
+  const BlitzAVXReg<DType>* right, const BlitzAVXReg<DType>* addend,
+  BlitzAVXReg<DType>* output);
+
+// 1 / input, approximation refined by one Newton step
+template<typename DType>
+inline void BlitzAVXRcp(const BlitzAVXReg<DType>* input,
+  BlitzAVXReg<DType>* output);
+
+template<typename DType>
+inline void BlitzAVXSqrt(const BlitzAVXReg<DType>* input,
+  BlitzAVXReg<DType>* output);
+
+// round to the nearest integral value
+template<typename DType>
+inline void BlitzAVXRound(const BlitzAVXReg<DType>* input,
+  BlitzAVXReg<DType>* output);
+
+// 2^input for integral input inside the normal exponent range
+template<typename DType>
+inline void BlitzAVXPow2(const BlitzAVXReg<DType>* input,
+  BlitzAVXReg<DType>* output);
+
+// input = 2^exponent * mantissa, mantissa in [sqrt(1/2), sqrt(2)),
+// for positive normal input
+template<typename DType>
+inline void BlitzAVXSplit(const BlitzAVXReg<DType>* input,
+  BlitzAVXReg<DType>* exponent, BlitzAVXReg<DType>* mantissa);
+
+#define BLITZ_AVX_SPECIALIZE_LOAD(name, DType, op) \
+  template<> \
+  inline void name<DType>(const DType* addr, BlitzAVXReg<DType>* reg) { \
+    reg->v = op(addr); \
+  }
+
+#define BLITZ_AVX_SPECIALIZE_STORE(name, DType, op) \
+  template<> \
+  inline void name<DType>(const DType* addr, BlitzAVXReg<DType>* reg) { \
+    op(const_cast<DType*>(addr), reg->v); \
+  }
+
+#define BLITZ_AVX_SPECIALIZE_BINARY(name, DType, op) \
+  template<> \
+  inline void name<DType>(const BlitzAVXReg<DType>* left, \
+    const BlitzAVXReg<DType>* right, BlitzAVXReg<DType>* output) { \
+    output->v = op(left->v, right->v); \
+  }
+
+#define BLITZ_AVX_SPECIALIZE(DType, OP) \
+  BLITZ_AVX_SPECIALIZE_LOAD(BlitzAVXLoad, DType, OP(load)) \
+  BLITZ_AVX_SPECIALIZE_LOAD(BlitzAVXLoadu, DType, OP(loadu)) \
+  BLITZ_AVX_SPECIALIZE_STORE(BlitzAVXStore, DType, OP(store)) \
+  BLITZ_AVX_SPECIALIZE_STORE(BlitzAVXStoreu, DType, OP(storeu)) \
+  BLITZ_AVX_SPECIALIZE_BINARY(BlitzAVXAdd, DType, OP(add)) \
+  BLITZ_AVX_SPECIALIZE_BINARY(BlitzAVXSub, DType, OP(sub)) \
+  BLITZ_AVX_SPECIALIZE_BINARY(BlitzAVXMul, DType, OP(mul)) \
+  BLITZ_AVX_SPECIALIZE_BINARY(BlitzAVXDiv, DType, OP(div)) \
+  BLITZ_AVX_SPECIALIZE_BINARY(BlitzAVXMax, DType, OP(max)) \
+  BLITZ_AVX_SPECIALIZE_BINARY(BlitzAVXMin, DType, OP(min))
+
+BLITZ_AVX_SPECIALIZE(float, BLITZ_AVX_PS)
+BLITZ_AVX_SPECIALIZE(double, BLITZ_AVX_PD)
+
+#undef BLITZ_AVX_SPECIALIZE
+#undef BLITZ_AVX_SPECIALIZE_BINARY
+#undef BLITZ_AVX_SPECIALIZE_STORE
+#undef BLITZ_AVX_SPECIALIZE_LOAD
+
+template<>
+inline void BlitzAVXBroadcast<float>(const float* addr,
+  BlitzAVXReg<float>* reg) {
+  reg->v = BLITZ_AVX_PS(set1)(*addr);
+}
+
+template<>
+inline void BlitzAVXBroadcast<double>(const double* addr,
+  BlitzAVXReg<double>* reg) {
+  reg->v = BLITZ_AVX_PD(set1)(*addr);
+}
+
+template<>
+inline void BlitzAVXFma<float>(const BlitzAVXReg<float>* left,
+  const BlitzAVXReg<float>* right, const BlitzAVXReg<float>* addend,
+  BlitzAVXReg<float>* output) {
+#if BLITZ_AVX_WIDTH == 64 || defined(__FMA__)
+  output->v = BLITZ_AVX_PS(fmadd)(left->v, right->v, addend->v);
+#else
+  output->v = _mm256_add_ps(_mm256_mul_ps(left->v, right->v), addend->v);
+#endif
+}
+
+template<>
+inline void BlitzAVXFma<double>(const BlitzAVXReg<double>* left,
+  const BlitzAVXReg<double>* right, const BlitzAVXReg<double>* addend,
+  BlitzAVXReg<double>* output) {
+#if BLITZ_AVX_WIDTH == 64 || defined(__FMA__)
+  output->v = BLITZ_AVX_PD(fmadd)(left->v, right->v, addend->v);
+#else
+  output->v = _mm256_add_pd(_mm256_mul_pd(left->v, right->v), addend->v);
+#endif
+}
+
+template<>
+inline void BlitzAVXRcp<float>(const BlitzAVXReg<float>* input,
+  BlitzAVXReg<float>* output) {
+#if BLITZ_AVX_WIDTH == 64
+  BlitzAVXFloat rcp = _mm512_rcp14_ps(input->v);
+#else
+  BlitzAVXFloat rcp = _mm256_rcp_ps(input->v);
+#endif
+  // r * (2 - x * r)
+  output->v = BLITZ_AVX_PS(mul)(rcp, BLITZ_AVX_PS(sub)(
+    BLITZ_AVX_PS(set1)(2.0f), BLITZ_AVX_PS(mul)(input->v, rcp)));
+}
+
+template<>
+inline void BlitzAVXRcp<double>(const BlitzAVXReg<double>* input,
+  BlitzAVXReg<double>* output) {
+  // no double approximation below AVX-512, a division is as fast
+  output->v = BLITZ_AVX_PD(div)(BLITZ_AVX_PD(set1)(1.0), input->v);
+}
+
+template<>
+inline void BlitzAVXSqrt<float>(const BlitzAVXReg<float>* input,
+  BlitzAVXReg<float>* output) {
+  output->v = BLITZ_AVX_PS(sqrt)(input->v);
+}
+
+template<>
+inline void BlitzAVXSqrt<double>(const BlitzAVXReg<double>* input,
+  BlitzAVXReg<double>* output) {
+  output->v = BLITZ_AVX_PD(sqrt)(input->v);
+}
+
+template<>
+inline void BlitzAVXRound<float>(const BlitzAVXReg<float>* input,
+  BlitzAVXReg<float>* output) {
+#if BLITZ_AVX_WIDTH == 64
+  output->v = _mm512_roundscale_ps(input->v,
+    _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+#else
+  output->v = _mm256_round_ps(input->v,
+    _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+#endif
+}
+
+template<>
+inline void BlitzAVXRound<double>(const BlitzAVXReg<double>* input,
+  BlitzAVXReg<double>* output) {
+#if BLITZ_AVX_WIDTH == 64
+  output->v = _mm512_roundscale_pd(input->v,
+    _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+#else
+  output->v = _mm256_round_pd(input->v,
+    _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+#endif
+}
+
+// integer lanes over the float/double bits
+#if BLITZ_AVX_WIDTH == 64
+#define BLITZ_AVX_INTEGER_SHIFT(name, op) \
+  inline BlitzAVXInteger name(BlitzAVXInteger a, int imm) { \
+    return _mm512_##op(a, imm); \
+  }
+#define BLITZ_AVX_INTEGER_BINARY(name, op) \
+  inline BlitzAVXInteger name(BlitzAVXInteger a, BlitzAVXInteger b) { \
+    return _mm512_##op(a, b); \
+  }
+#elif defined(__AVX2__)
+#define BLITZ_AVX_INTEGER_SHIFT(name, op) \
+  inline BlitzAVXInteger name(BlitzAVXInteger a, int imm) { \
+    return _mm256_##op(a, imm); \
+  }
+#define BLITZ_AVX_INTEGER_BINARY(name, op) \
+  inline BlitzAVXInteger name(BlitzAVXInteger a, BlitzAVXInteger b) { \
+    return _mm256_##op(a, b); \
+  }
+#else
+#define BLITZ_AVX_INTEGER_SHIFT(name, op) \
+  inline BlitzAVXInteger name(BlitzAVXInteger a, int imm) { \
+    __m128i low = _mm_##op(_mm256_castsi256_si128(a), imm); \
+    __m128i high = _mm_##op(_mm256_extractf128_si256(a, 1), imm); \
+    return _mm256_insertf128_si256(_mm256_castsi128_si256(low), high, 1); \
+  }
+#define BLITZ_AVX_INTEGER_BINARY(name, op) \
+  inline BlitzAVXInteger name(BlitzAVXInteger a, BlitzAVXInteger b) { \
+    __m128i low = _mm_##op(_mm256_castsi256_si128(a), \
+      _mm256_castsi256_si128(b)); \
+    __m128i high = _mm_##op(_mm256_extractf128_si256(a, 1), \
+      _mm256_extractf128_si256(b, 1)); \
+    return _mm256_insertf128_si256(_mm256_castsi128_si256(low), high, 1); \
+  }
+#endif
+
+BLITZ_AVX_INTEGER_SHIFT(BlitzAVXShiftLeft32, slli_epi32)
+BLITZ_AVX_INTEGER_SHIFT(BlitzAVXShiftLeft64, slli_epi64)
+BLITZ_AVX_INTEGER_SHIFT(BlitzAVXShiftRight32, srli_epi32)
+BLITZ_AVX_INTEGER_SHIFT(BlitzAVXShiftRight64, srli_epi64)
+BLITZ_AVX_INTEGER_BINARY(BlitzAVXAdd32, add_epi32)
+BLITZ_AVX_INTEGER_BINARY(BlitzAVXAdd64, add_epi64)
+
+#if BLITZ_AVX_WIDTH == 64
+BLITZ_AVX_INTEGER_BINARY(BlitzAVXAnd, and_si512)
+BLITZ_AVX_INTEGER_BINARY(BlitzAVXOr, or_si512)
+#elif defined(__AVX2__)
+BLITZ_AVX_INTEGER_BINARY(BlitzAVXAnd, and_si256)
+BLITZ_AVX_INTEGER_BINARY(BlitzAVXOr, or_si256)
+#else
+inline BlitzAVXInteger BlitzAVXAnd(BlitzAVXInteger a, BlitzAVXInteger b) {
+  return _mm256_castps_si256(_mm256_and_ps(_mm256_castsi256_ps(a),
+    _mm256_castsi256_ps(b)));
+}
+inline BlitzAVXInteger BlitzAVXOr(BlitzAVXInteger a, BlitzAVXInteger b) {
+  return _mm256_castps_si256(_mm256_or_ps(_mm256_castsi256_ps(a),
+    _mm256_castsi256_ps(b)));
+}
+#endif
+
+#undef BLITZ_AVX_INTEGER_SHIFT
+#undef BLITZ_AVX_INTEGER_BINARY
+
+#if BLITZ_AVX_WIDTH == 64
+#define BLITZ_AVX_PS_BITS(a) _mm512_castps_si512(a)
+#define BLITZ_AVX_PD_BITS(a) _mm512_castpd_si512(a)
+#define BLITZ_AVX_BITS_PS(a) _mm512_castsi512_ps(a)
+#define BLITZ_AVX_BITS_PD(a) _mm512_castsi512_pd(a)
+#define BLITZ_AVX_SET1_EPI32(a) _mm512_set1_epi32(a)
+#define BLITZ_AVX_SET1_EPI64(a) _mm512_set1_epi64(a)
+#else
+#define BLITZ_AVX_PS_BITS(a) _mm256_castps_si256(a)
+#define BLITZ_AVX_PD_BITS(a) _mm256_castpd_si256(a)
+#define BLITZ_AVX_BITS_PS(a) _mm256_castsi256_ps(a)
+#define BLITZ_AVX_BITS_PD(a) _mm256_castsi256_pd(a)
+#define BLITZ_AVX_SET1_EPI32(a) _mm256_set1_epi32(a)
+#define BLITZ_AVX_SET1_EPI64(a) _mm256_set1_epi64x(a)
+#endif
+
+// (n + bias) + 2^mantissa_bits leaves the biased exponent in the low
+// bits, shifting it into the exponent field gives 2^n
+template<>
+inline void BlitzAVXPow2<float>(const BlitzAVXReg<float>* input,
+  BlitzAVXReg<float>* output) {
+  BlitzAVXFloat biased = BLITZ_AVX_PS(add)(input->v,
+    BLITZ_AVX_PS(set1)(127.0f + 8388608.0f));
+  output->v = BLITZ_AVX_BITS_PS(BlitzAVXShiftLeft32(
+    BLITZ_AVX_PS_BITS(biased), 23));
+}
+
+template<>
+inline void BlitzAVXPow2<double>(const BlitzAVXReg<double>* input,
+  BlitzAVXReg<double>* output) {
+  BlitzAVXDouble biased = BLITZ_AVX_PD(add)(input->v,
+    BLITZ_AVX_PD(set1)(1023.0 + 4503599627370496.0));
+  output->v = BLITZ_AVX_BITS_PD(BlitzAVXShiftLeft64(
+    BLITZ_AVX_PD_BITS(biased), 52));
+}
+
+// offsetting the bits by 1 - sqrt(1/2) moves the exponent boundary to
+// sqrt(1/2); the exponent becomes a float by or-ing it under 2^23 (2^52)
+template<>
+inline void BlitzAVXSplit<float>(const BlitzAVXReg<float>* input,
+  BlitzAVXReg<float>* exponent, BlitzAVXReg<float>* mantissa) {
+  BlitzAVXInteger bits = BlitzAVXAdd32(BLITZ_AVX_PS_BITS(input->v),
+    BLITZ_AVX_SET1_EPI32(0x3f800000 - 0x3f3504f3));
+  BlitzAVXInteger biased = BlitzAVXOr(BlitzAVXShiftRight32(bits, 23),
+    BLITZ_AVX_SET1_EPI32(0x4b000000));
+  exponent->v = BLITZ_AVX_PS(sub)(BLITZ_AVX_BITS_PS(biased),
+    BLITZ_AVX_PS(set1)(8388608.0f + 127.0f));
+  mantissa->v = BLITZ_AVX_BITS_PS(BlitzAVXAdd32(
+    BlitzAVXAnd(bits, BLITZ_AVX_SET1_EPI32(0x007fffff)),
+    BLITZ_AVX_SET1_EPI32(0x3f3504f3)));
+}
+
+template<>
+inline void BlitzAVXSplit<double>(const BlitzAVXReg<double>* input,
+  BlitzAVXReg<double>* exponent, BlitzAVXReg<double>* mantissa) {
+  BlitzAVXInteger bits = BlitzAVXAdd64(BLITZ_AVX_PD_BITS(input->v),
+    BLITZ_AVX_SET1_EPI64(0x3ff0000000000000LL - 0x3fe6a09e667f3bcdLL));
+  BlitzAVXInteger biased = BlitzAVXOr(BlitzAVXShiftRight64(bits, 52),
+    BLITZ_AVX_SET1_EPI64(0x4330000000000000LL));
+  exponent->v = BLITZ_AVX_PD(sub)(BLITZ_AVX_BITS_PD(biased),
+    BLITZ_AVX_PD(set1)(4503599627370496.0 + 1023.0));
+  mantissa->v = BLITZ_AVX_BITS_PD(BlitzAVXAdd64(
+    BlitzAVXAnd(bits, BLITZ_AVX_SET1_EPI64(0x000fffffffffffffLL)),
+    BLITZ_AVX_SET1_EPI64(0x3fe6a09e667f3bcdLL)));
+}
+
+#undef BLITZ_AVX_PS_BITS
+#undef BLITZ_AVX_PD_BITS
+#undef BLITZ_AVX_BITS_PS
+#undef BLITZ_AVX_BITS_PD
+#undef BLITZ_AVX_SET1_EPI32
+#undef BLITZ_AVX_SET1_EPI64
+
+template<typename DType>
+inline void BlitzAVXSet(DType value, BlitzAVXReg<DType>* reg) {
+  BlitzAVXBroadcast(&value, reg);
+}
+
+// first size lanes from addr, the rest filled with value
+template<typename DType>
+inline void BlitzAVXLoadPartial(const DType* addr, size_t size,
+  DType value, BlitzAVXReg<DType>* reg);
+
+// first size lanes to addr
+template<typename DType>
+inline void BlitzAVXStorePartial(DType* addr, size_t size,
+  BlitzAVXReg<DType>* reg);
+
+// lanes from size on set to value
+template<typename DType>
+inline void BlitzAVXFillPartial(size_t size, DType value,
+  BlitzAVXReg<DType>* reg);
+
+#if BLITZ_AVX_WIDTH == 64
+template<>
+inline void BlitzAVXLoadPartial<float>(const float* addr, size_t size,
+  float value, BlitzAVXReg<float>* reg) {
+  if (size >= 16) {
+    reg->v = _mm512_loadu_ps(addr);
+  } else {
+    reg->v = _mm512_mask_loadu_ps(_mm512_set1_ps(value),
+      static_cast<__mmask16>((1U << size) - 1), addr);
+  }
+}
+
+template<>
+inline void BlitzAVXLoadPartial<double>(const double* addr, size_t size,
+  double value, BlitzAVXReg<double>* reg) {
+  if (size >= 8) {
+    reg->v = _mm512_loadu_pd(addr);
+  } else {
+    reg->v = _mm512_mask_loadu_pd(_mm512_set1_pd(value),
+      static_cast<__mmask8>((1U << size) - 1), addr);
+  }
+}
+
+template<>
+inline void BlitzAVXStorePartial<float>(float* addr, size_t size,
+  BlitzAVXReg<float>* reg) {
+  if (size >= 16) {
+    _mm512_storeu_ps(addr, reg->v);
+  } else {
+    _mm512_mask_storeu_ps(addr,
+      static_cast<__mmask16>((1U << size) - 1), reg->v);
+  }
+}
+
+template<>
+inline void BlitzAVXStorePartial<double>(double* addr, size_t size,
+  BlitzAVXReg<double>* reg) {
+  if (size >= 8) {
+    _mm512_storeu_pd(addr, reg->v);
+  } else {
+    _mm512_mask_storeu_pd(addr,
+      static_cast<__mmask8>((1U << size) - 1), reg->v);
+  }
+}
+
+template<>
+inline void BlitzAVXFillPartial<float>(size_t size, float value,
+  BlitzAVXReg<float>* reg) {
+  if (size < 16) {
+    reg->v = _mm512_mask_blend_ps(static_cast<__mmask16>((1U << size) - 1),
+      _mm512_set1_ps(value), reg->v);
+  }
+}
+
+template<>
+inline void BlitzAVXFillPartial<double>(size_t size, double value,
+  BlitzAVXReg<double>* reg) {
+  if (size < 8) {
+    reg->v = _mm512_mask_blend_pd(static_cast<__mmask8>((1U << size) - 1),
+      _mm512_set1_pd(value), reg->v);
+  }
+}
+#else
+// lane masks are read from a sliding window over all-ones and zeros
+inline __m256i BlitzAVXMask32(size_t size) {
+  static const int mask[16] = {
+    -1, -1, -1, -1, -1, -1, -1, -1,
+    0, 0, 0, 0, 0, 0, 0, 0
+  };
+  return _mm256_loadu_si256(
+    reinterpret_cast<const __m256i*>(mask + 8 - size));
+}
+
+inline __m256i BlitzAVXMask64(size_t size) {
+  static const long long mask[8] = {  // NOLINT
+    -1, -1, -1, -1, 0, 0, 0, 0
+  };
+  return _mm256_loadu_si256(
+    reinterpret_cast<const __m256i*>(mask + 4 - size));
+}
+
+template<>
+inline void BlitzAVXLoadPartial<float>(const float* addr, size_t size,
+  float value, BlitzAVXReg<float>* reg) {
+  if (size >= 8) {
+    reg->v = _mm256_loadu_ps(addr);
+  } else {
+    __m256i mask = BlitzAVXMask32(size);
+    reg->v = _mm256_blendv_ps(_mm256_set1_ps(value),
+      _mm256_maskload_ps(addr, mask), _mm256_castsi256_ps(mask));
+  }
+}
+
+template<>
+inline void BlitzAVXLoadPartial<double>(const double* addr, size_t size,
+  double value, BlitzAVXReg<double>* reg) {
+  if (size >= 4) {
+    reg->v = _mm256_loadu_pd(addr);
+  } else {
+    __m256i mask = BlitzAVXMask64(size);
+    reg->v = _mm256_blendv_pd(_mm256_set1_pd(value),
+      _mm256_maskload_pd(addr, mask), _mm256_castsi256_pd(mask));
+  }
+}
+
+template<>
+inline void BlitzAVXStorePartial<float>(float* addr, size_t size,
+  BlitzAVXReg<float>* reg) {
+  if (size >= 8) {
+    _mm256_storeu_ps(addr, reg->v);
+  } else {
+    _mm256_maskstore_ps(addr, BlitzAVXMask32(size), reg->v);
+  }
+}
+
+template<>
+inline void BlitzAVXStorePartial<double>(double* addr, size_t size,
+  BlitzAVXReg<double>* reg) {
+  if (size >= 4) {
+    _mm256_storeu_pd(addr, reg->v);
+  } else {
+    _mm256_maskstore_pd(addr, BlitzAVXMask64(size), reg->v);
+  }
+}
+
+template<>
+inline void BlitzAVXFillPartial<float>(size_t size, float value,
+  BlitzAVXReg<float>* reg) {
+  if (size < 8) {
+    reg->v = _mm256_blendv_ps(_mm256_set1_ps(value), reg->v,
+      _mm256_castsi256_ps(BlitzAVXMask32(size)));
+  }
+}
+
+template<>
+inline void BlitzAVXFillPartial<double>(size_t size, double value,
+  BlitzAVXReg<double>* reg) {
+  if (size < 4) {
+    reg->v = _mm256_blendv_pd(_mm256_set1_pd(value), reg->v,
+      _mm256_castsi256_pd(BlitzAVXMask64(size)));
+  }
+}
+#endif
+
+// first size lanes from addr with a lane stride, the rest filled with
+// value; stride one is a plain vector load, stride two deinterleaves two
+// loads that end at the last lane, other full registers are gathered
+template<typename DType>
+inline void BlitzAVXLoadStride(const DType* addr, size_t stride,
+  size_t size, DType value, BlitzAVXReg<DType>* reg);
+
+#define BLITZ_AVX_LOAD_STRIDE_PARTIAL(DType) \
+  if (stride == 1) { \
+    BlitzAVXLoadPartial(addr, size, value, reg); \
+    return; \
+  } \
+  if (size < BLITZ_AVX_WIDTH / sizeof(DType)) { \
+    for (size_t i = 0; i < BLITZ_AVX_WIDTH / sizeof(DType); ++i) { \
+      reg->d[i] = i < size ? addr[i * stride] : value; \
+    } \
+    return; \
+  }
+
+#if BLITZ_AVX_WIDTH == 64
+template<>
+inline void BlitzAVXLoadStride<float>(const float* addr, size_t stride,
+  size_t size, float value, BlitzAVXReg<float>* reg) {
+  BLITZ_AVX_LOAD_STRIDE_PARTIAL(float)
+  if (stride == 2) {
+    reg->v = _mm512_permutex2var_ps(_mm512_loadu_ps(addr),
+      _mm512_set_epi32(31, 29, 27, 25, 23, 21, 19, 17,
+        14, 12, 10, 8, 6, 4, 2, 0), _mm512_loadu_ps(addr + 15));
+    return;
+  }
+  const int s = static_cast<int>(stride);
+  reg->v = _mm512_i32gather_ps(_mm512_mullo_epi32(_mm512_set1_epi32(s),
+    _mm512_set_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)),
+    addr, 4);
+}
+
+template<>
+inline void BlitzAVXLoadStride<double>(const double* addr, size_t stride,
+  size_t size, double value, BlitzAVXReg<double>* reg) {
+  BLITZ_AVX_LOAD_STRIDE_PARTIAL(double)
+  if (stride == 2) {
+    reg->v = _mm512_permutex2var_pd(_mm512_loadu_pd(addr),
+      _mm512_set_epi64(15, 13, 11, 9, 6, 4, 2, 0), _mm512_loadu_pd(addr + 7));
+    return;
+  }
+  const int s = static_cast<int>(stride);
+  reg->v = _mm512_i32gather_pd(_mm256_mullo_epi32(_mm256_set1_epi32(s),
+    _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0)), addr, 8);
+}
+#else
+template<>
+inline void BlitzAVXLoadStride<float>(const float* addr, size_t stride,
+  size_t size, float value, BlitzAVXReg<float>* reg) {
+  BLITZ_AVX_LOAD_STRIDE_PARTIAL(float)
+#ifdef __AVX2__
+  if (stride == 2) {
+    // [0 2 8 10 | 4 6 12 14], then swap the middle 64-bit pairs
+    __m256 even = _mm256_shuffle_ps(_mm256_loadu_ps(addr),
+      _mm256_loadu_ps(addr + 7), 0xD8);
+    reg->v = _mm256_castpd_ps(_mm256_permute4x64_pd(
+      _mm256_castps_pd(even), 0xD8));
+    return;
+  }
+#endif
+  reg->v = _mm256_set_ps(addr[7 * stride], addr[6 * stride],
+    addr[5 * stride], addr[4 * stride], addr[3 * stride],
+    addr[2 * stride], addr[stride], addr[0]);
+}
+
+template<>
+inline void BlitzAVXLoadStride<double>(const double* addr, size_t stride,
+  size_t size, double value, BlitzAVXReg<double>* reg) {
+  BLITZ_AVX_LOAD_STRIDE_PARTIAL(double)
+#ifdef __AVX2__
+  if (stride == 2) {
+    // [0 4 2 6], then swap the middle lanes
+    __m256d even = _mm256_shuffle_pd(_mm256_loadu_pd(addr),
+      _mm256_loadu_pd(addr + 3), 0xA);
+    reg->v = _mm256_permute4x64_pd(even, 0xD8);
+    return;
+  }
+#endif
+  reg->v = _mm256_set_pd(addr[3 * stride], addr[2 * stride],
+    addr[stride], addr[0]);
+}
+#endif
+
+#undef BLITZ_AVX_LOAD_STRIDE_PARTIAL
+
+// where input > max: max = input and index = candidate, the first
+// maximum is kept on ties
+template<typename DType>
+inline void BlitzAVXArgmax(const BlitzAVXReg<DType>* input,
+  const BlitzAVXReg<DType>* candidate,
+  BlitzAVXReg<DType>* max, BlitzAVXReg<DType>* index);
+
+#if BLITZ_AVX_WIDTH == 64
+template<>
+inline void BlitzAVXArgmax<float>(const BlitzAVXReg<float>* input,
+  const BlitzAVXReg<float>* candidate,
+  BlitzAVXReg<float>* max, BlitzAVXReg<float>* index) {
+  __mmask16 mask = _mm512_cmp_ps_mask(input->v, max->v, _CMP_GT_OQ);
+  max->v = _mm512_mask_blend_ps(mask, max->v, input->v);
+  index->v = _mm512_mask_blend_ps(mask, index->v, candidate->v);
+}
+
+template<>
+inline void BlitzAVXArgmax<double>(const BlitzAVXReg<double>* input,
+  const BlitzAVXReg<double>* candidate,
+  BlitzAVXReg<double>* max, BlitzAVXReg<double>* index) {
+  __mmask8 mask = _mm512_cmp_pd_mask(input->v, max->v, _CMP_GT_OQ);
+  max->v = _mm512_mask_blend_pd(mask, max->v, input->v);
+  index->v = _mm512_mask_blend_pd(mask, index->v, candidate->v);
+}
+#else
+template<>
+inline void BlitzAVXArgmax<float>(const BlitzAVXReg<float>* input,
+  const BlitzAVXReg<float>* candidate,
+  BlitzAVXReg<float>* max, BlitzAVXReg<float>* index) {
+  __m256 mask = _mm256_cmp_ps(input->v, max->v, _CMP_GT_OQ);
+  max->v = _mm256_blendv_ps(max->v, input->v, mask);
+  index->v = _mm256_blendv_ps(index->v, candidate->v, mask);
+}
+
+template<>
+inline void BlitzAVXArgmax<double>(const BlitzAVXReg<double>* input,
+  const BlitzAVXReg<double>* candidate,
+  BlitzAVXReg<double>* max, BlitzAVXReg<double>* index) {
+  __m256d mask = _mm256_cmp_pd(input->v, max->v, _CMP_GT_OQ);
+  max->v = _mm256_blendv_pd(max->v, input->v, mask);
+  index->v = _mm256_blendv_pd(index->v, candidate->v, mask);
+}
+#endif
+
+// horizontal reductions
+template<typename DType>
+inline DType BlitzAVXSum(const BlitzAVXReg<DType>* reg);
+
+template<typename DType>
+inline DType BlitzAVXMaximum(const BlitzAVXReg<DType>* reg);
+
+#if BLITZ_AVX_WIDTH == 64
+template<>
+inline float BlitzAVXSum<float>(const BlitzAVXReg<float>* reg) {
+  return _mm512_reduce_add_ps(reg->v);
+}
+
+template<>
+inline double BlitzAVXSum<double>(const BlitzAVXReg<double>* reg) {
+  return _mm512_reduce_add_pd(reg->v);
+}
+
+template<>
+inline float BlitzAVXMaximum<float>(const BlitzAVXReg<float>* reg) {
+  return _mm512_reduce_max_ps(reg->v);
+}
+
+template<>
+inline double BlitzAVXMaximum<double>(const BlitzAVXReg<double>* reg) {
+  return _mm512_reduce_max_pd(reg->v);
+}
+#else
+template<>
+inline float BlitzAVXSum<float>(const BlitzAVXReg<float>* reg) {
+  __m128 sum = _mm_add_ps(_mm256_castps256_ps128(reg->v),
+    _mm256_extractf128_ps(reg->v, 1));
+  sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+  return _mm_cvtss_f32(sum);
+}
+
+template<>
+inline double BlitzAVXSum<double>(const BlitzAVXReg<double>* reg) {
+  __m128d sum = _mm_add_pd(_mm256_castpd256_pd128(reg->v),
+    _mm256_extractf128_pd(reg->v, 1));
+  sum = _mm_add_sd(sum, _mm_unpackhi_pd(sum, sum));
+  return _mm_cvtsd_f64(sum);
+}
+
+template<>
+inline float BlitzAVXMaximum<float>(const BlitzAVXReg<float>* reg) {
+  __m128 max = _mm_max_ps(_mm256_castps256_ps128(reg->v),
+    _mm256_extractf128_ps(reg->v, 1));
+  max = _mm_max_ps(max, _mm_movehl_ps(max, max));
+  max = _mm_max_ss(max, _mm_shuffle_ps(max, max, 1));
+  return _mm_cvtss_f32(max);
+}
+
+template<>
+inline double BlitzAVXMaximum<double>(const BlitzAVXReg<double>* reg) {
+  __m128d max = _mm_max_pd(_mm256_castpd256_pd128(reg->v),
+    _mm256_extractf128_pd(reg->v, 1));
+  max = _mm_max_sd(max, _mm_unpackhi_pd(max, max));
+  return _mm_cvtsd_f64(max);
+}
+#endif
+
+// exp/log constants, the float range stays inside normal numbers
+template<typename DType>
+struct BlitzAVXMathConstant;
+
+template<>
+struct BlitzAVXMathConstant<float> {
+  static float exp_max() { return 88.0f; }
+  static float exp_min() { return -87.3f; }
+  static size_t exp_terms() { return 7; }
+  static size_t log_terms() { return 4; }
+};
+
+template<>
+struct BlitzAVXMathConstant<double> {
+  static double exp_max() { return 709.0; }
+  static double exp_min() { return -708.0; }
+  static size_t exp_terms() { return 13; }
+  static size_t log_terms() { return 11; }
+};
+
+// exp(x) = 2^n * exp(r), n = round(x / ln2), |r| <= ln2 / 2,
+// exp(r) by its Taylor series in Horner form;
+// input is clamped so that 2^n stays a normal number
+template<typename DType>
+inline void BlitzAVXExp(const BlitzAVXReg<DType>* input,
+  BlitzAVXReg<DType>* output) {
+  typedef BlitzAVXMathConstant<DType> Constant;
+  BlitzAVXReg<DType> x, n, r, t, p;
+  BlitzAVXSet(Constant::exp_max(), &t);
+  BlitzAVXMin(input, &t, &x);
+  BlitzAVXSet(Constant::exp_min(), &t);
+  BlitzAVXMax(&x, &t, &x);
+  BlitzAVXSet(static_cast<DType>(1.44269504088896340736), &t);
+  BlitzAVXMul(&x, &t, &n);
+  BlitzAVXRound(&n, &n);
+  // r = x - n * ln2 with ln2 split in a high and a low part
+  BlitzAVXSet(static_cast<DType>(-0.693145751953125), &t);
+  BlitzAVXFma(&n, &t, &x, &r);
+  BlitzAVXSet(static_cast<DType>(-1.42860682030941723212e-6), &t);
+  BlitzAVXFma(&n, &t, &r, &r);
+  const size_t terms = Constant::exp_terms();
+  DType coefficient = 1;
+  for (size_t i = 2; i <= terms; ++i) {
+    coefficient /= i;
+  }
+  BlitzAVXSet(coefficient, &p);
+  for (size_t i = terms; i > 0; --i) {
+    coefficient *= i;
+    BlitzAVXSet(coefficient, &t);
+    BlitzAVXFma(&p, &r, &t, &p);
+  }
+  BlitzAVXPow2(&n, &n);
+  BlitzAVXMul(&p, &n, output);
+}
+
+// log(x) = e * ln2 + 2 * atanh(s), s = (m - 1) / (m + 1),
+// x = 2^e * m and m in [sqrt(1/2), sqrt(2)); input has to be positive
+template<typename DType>
+inline void BlitzAVXLog(const BlitzAVXReg<DType>* input,
+  BlitzAVXReg<DType>* output) {
+  typedef BlitzAVXMathConstant<DType> Constant;
+  BlitzAVXReg<DType> e, m, s, z, p, t, one;
+  BlitzAVXSplit(input, &e, &m);
+  BlitzAVXSet(static_cast<DType>(1), &one);
+  BlitzAVXSub(&m, &one, &s);
+  BlitzAVXAdd(&m, &one, &t);
+  BlitzAVXDiv(&s, &t, &s);
+  BlitzAVXMul(&s, &s, &z);
+  // 1 + z / 3 + z^2 / 5 + ...
+  const size_t terms = Constant::log_terms();
+  BlitzAVXSet(static_cast<DType>(1) / (2 * terms + 1), &p);
+  for (size_t i = terms; i > 0; --i) {
+    BlitzAVXSet(static_cast<DType>(1) / (2 * i - 1), &t);
+    BlitzAVXFma(&p, &z, &t, &p);
+  }
+  BlitzAVXAdd(&s, &s, &s);
+  BlitzAVXMul(&p, &s, &p);
+  BlitzAVXSet(static_cast<DType>(1.42860682030941723212e-6), &t);
+  BlitzAVXFma(&e, &t, &p, &p);
+  BlitzAVXSet(static_cast<DType>(0.693145751953125), &t);
+  BlitzAVXFma(&e, &t, &p, output);
+}
+
+// transposes a square tile of one register per row, rows of the input
+// are input_ld apart and rows of the output output_ld apart
+template<typename DType>
+inline void BlitzAVXTranspose(const DType* input, size_t input_ld,
+  DType* output, size_t output_ld);
+
+#if BLITZ_AVX_WIDTH == 64
+template<>
+inline void BlitzAVXTranspose<float>(const float* input, size_t input_ld,
+  float* output, size_t output_ld) {
+  __m512 r[16], t[16];
+  for (size_t i = 0; i < 16; ++i) {
+    r[i] = _mm512_loadu_ps(input + i * input_ld);
+  }
+  // t[2i + k] holds rows 2i and 2i + 1 at columns 4L + 2k and 4L + 2k + 1
+  for (size_t i = 0; i < 16; i += 2) {
+    t[i] = _mm512_unpacklo_ps(r[i], r[i + 1]);
+    t[i + 1] = _mm512_unpackhi_ps(r[i], r[i + 1]);
+  }
+  // r[4i + k] holds rows 4i to 4i + 3 at column 4L + k of 128-bit lane L
+  for (size_t i = 0; i < 16; i += 4) {
+    r[i] = _mm512_shuffle_ps(t[i], t[i + 2], 0x44);
+    r[i + 1] = _mm512_shuffle_ps(t[i], t[i + 2], 0xEE);
+    r[i + 2] = _mm512_shuffle_ps(t[i + 1], t[i + 3], 0x44);
+    r[i + 3] = _mm512_shuffle_ps(t[i + 1], t[i + 3], 0xEE);
+  }
+  // gather lane L of r[k], r[4 + k], r[8 + k], r[12 + k]
+  for (size_t k = 0; k < 4; ++k) {
+    __m512 x0 = _mm512_shuffle_f32x4(r[k], r[4 + k], 0x88);
+    __m512 x1 = _mm512_shuffle_f32x4(r[8 + k], r[12 + k], 0x88);
+    __m512 y0 = _mm512_shuffle_f32x4(r[k], r[4 + k], 0xDD);
+    __m512 y1 = _mm512_shuffle_f32x4(r[8 + k], r[12 + k], 0xDD);
+    _mm512_storeu_ps(output + k * output_ld,
+      _mm512_shuffle_f32x4(x0, x1, 0x88));
+    _mm512_storeu_ps(output + (4 + k) * output_ld,
+      _mm512_shuffle_f32x4(y0, y1, 0x88));
+    _mm512_storeu_ps(output + (8 + k) * output_ld,
+      _mm512_shuffle_f32x4(x0, x1, 0xDD));
+    _mm512_storeu_ps(output + (12 + k) * output_ld,
+      _mm512_shuffle_f32x4(y0, y1, 0xDD));
+  }
+}
+
+template<>
+inline void BlitzAVXTranspose<double>(const double* input, size_t input_ld,
+  double* output, size_t output_ld) {
+  __m512d r[8], t[8];
+  for (size_t i = 0; i < 8; ++i) {
+    r[i] = _mm512_loadu_pd(input + i * input_ld);
+  }
+  // t[2i + k] holds rows 2i and 2i + 1 at column 2L + k of 128-bit lane L
+  for (size_t i = 0; i < 8; i += 2) {
+    t[i] = _mm512_unpacklo_pd(r[i], r[i + 1]);
+    t[i + 1] = _mm512_unpackhi_pd(r[i], r[i + 1]);
+  }
+  for (size_t k = 0; k < 2; ++k) {
+    __m512d x0 = _mm512_shuffle_f64x2(t[k], t[2 + k], 0x88);
+    __m512d x1 = _mm512_shuffle_f64x2(t[4 + k], t[6 + k], 0x88);
+    __m512d y0 = _mm512_shuffle_f64x2(t[k], t[2 + k], 0xDD);
+    __m512d y1 = _mm512_shuffle_f64x2(t[4 + k], t[6 + k], 0xDD);
+    _mm512_storeu_pd(output + k * output_ld,
+      _mm512_shuffle_f64x2(x0, x1, 0x88));
+    _mm512_storeu_pd(output + (2 + k) * output_ld,
+      _mm512_shuffle_f64x2(y0, y1, 0x88));
+    _mm512_storeu_pd(output + (4 + k) * output_ld,
+      _mm512_shuffle_f64x2(x0, x1, 0xDD));
+    _mm512_storeu_pd(output + (6 + k) * output_ld,
+      _mm512_shuffle_f64x2(y0, y1, 0xDD));
+  }
+}
+#else
+template<>
+inline void BlitzAVXTranspose<float>(const float* input, size_t input_ld,
+  float* output, size_t output_ld) {
+  __m256 r[8], t[8];
+  for (size_t i = 0; i < 8; ++i) {
+    r[i] = _mm256_loadu_ps(input + i * input_ld);
+  }
+  for (size_t i = 0; i < 8; i += 2) {
+    t[i] = _mm256_unpacklo_ps(r[i], r[i + 1]);
+    t[i + 1] = _mm256_unpackhi_ps(r[i], r[i + 1]);
+  }
+  // r[4i + k] holds rows 4i to 4i + 3 at column 4L + k of 128-bit lane L
+  for (size_t i = 0; i < 8; i += 4) {
+    r[i] = _mm256_shuffle_ps(t[i], t[i + 2], 0x44);
+    r[i + 1] = _mm256_shuffle_ps(t[i], t[i + 2], 0xEE);
+    r[i + 2] = _mm256_shuffle_ps(t[i + 1], t[i + 3], 0x44);
+    r[i + 3] = _mm256_shuffle_ps(t[i + 1], t[i + 3], 0xEE);
+  }
+  for (size_t k = 0; k < 4; ++k) {
+    _mm256_storeu_ps(output + k * output_ld,
+      _mm256_permute2f128_ps(r[k], r[4 + k], 0x20));
+    _mm256_storeu_ps(output + (4 + k) * output_ld,
+      _mm256_permute2f128_ps(r[k], r[4 + k], 0x31));
+  }
+}
+
+template<>
+inline void BlitzAVXTranspose<double>(const double* input, size_t input_ld,
+  double* output, size_t output_ld) {
+  __m256d r[4], t[4];
+  for (size_t i = 0; i < 4; ++i) {
+    r[i] = _mm256_loadu_pd(input + i * input_ld);
+  }
+  // t[2i + k] holds rows 2i and 2i + 1 at column 2L + k of 128-bit lane L
+  for (size_t i = 0; i < 4; i += 2) {
+    t[i] = _mm256_unpacklo_pd(r[i], r[i + 1]);
+    t[i + 1] = _mm256_unpackhi_pd(r[i], r[i + 1]);
+  }
+  for (size_t k = 0; k < 2; ++k) {
+    _mm256_storeu_pd(output + k * output_ld,
+      _mm256_permute2f128_pd(t[k], t[2 + k], 0x20));
+    _mm256_storeu_pd(output + (2 + k) * output_ld,
+      _mm256_permute2f128_pd(t[k], t[2 + k], 0x31));
+  }
+}
+#endif
+
+// one float register from or to 16-bit storage, half through F16C and
+// bfloat16 as the upper half of the float bits rounded to nearest even
+#if BLITZ_AVX_WIDTH == 64 || defined(__F16C__)
+#define BLITZ_AVX_HALF
+#endif
+#if BLITZ_AVX_WIDTH == 64 || defined(__AVX2__)
+#define BLITZ_AVX_BFLOAT
+#endif
+
+#ifdef BLITZ_AVX_HALF
+inline void BlitzAVXLoadHalf(const unsigned short* addr,
+  BlitzAVXReg<float>* reg) {
+#if BLITZ_AVX_WIDTH == 64
+  reg->v = _mm512_cvtph_ps(_mm256_loadu_si256(
+    reinterpret_cast<const __m256i*>(addr)));
+#else
+  reg->v = _mm256_cvtph_ps(_mm_loadu_si128(
+    reinterpret_cast<const __m128i*>(addr)));
+#endif
+}
+
+inline void BlitzAVXStoreHalf(unsigned short* addr,
+  const BlitzAVXReg<float>* reg) {
+#if BLITZ_AVX_WIDTH == 64
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(addr),
+    _mm512_cvtps_ph(reg->v, _MM_FROUND_TO_NEAREST_INT));
+#else
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(addr),
+    _mm256_cvtps_ph(reg->v, _MM_FROUND_TO_NEAREST_INT));
+#endif
+}
+#endif
+
+#ifdef BLITZ_AVX_BFLOAT
+inline void BlitzAVXLoadBFloat(const unsigned short* addr,
+  BlitzAVXReg<float>* reg) {
+#if BLITZ_AVX_WIDTH == 64
+  reg->v = _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(
+    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(addr))), 16));
+#else
+  reg->v = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(
+    _mm_loadu_si128(reinterpret_cast<const __m128i*>(addr))), 16));
+#endif
+}
+
+// nan keeps its upper half, quieted, instead of being rounded
+inline void BlitzAVXStoreBFloat(unsigned short* addr,
+  const BlitzAVXReg<float>* reg) {
+#if BLITZ_AVX_WIDTH == 64
+  __m512i bits = _mm512_castps_si512(reg->v);
+  __m512i lsb = _mm512_and_si512(_mm512_srli_epi32(bits, 16),
+    _mm512_set1_epi32(1));
+  __m512i rounded = _mm512_add_epi32(bits,
+    _mm512_add_epi32(lsb, _mm512_set1_epi32(0x7FFF)));
+  __mmask16 nan = _mm512_cmp_ps_mask(reg->v, reg->v, _CMP_UNORD_Q);
+  rounded = _mm512_mask_blend_epi32(nan, rounded,
+    _mm512_or_si512(bits, _mm512_set1_epi32(0x400000)));
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(addr),
+    _mm512_cvtepi32_epi16(_mm512_srli_epi32(rounded, 16)));
+#else
+  __m256i bits = _mm256_castps_si256(reg->v);
+  __m256i lsb = _mm256_and_si256(_mm256_srli_epi32(bits, 16),
+    _mm256_set1_epi32(1));
+  __m256i rounded = _mm256_add_epi32(bits,
+    _mm256_add_epi32(lsb, _mm256_set1_epi32(0x7FFF)));
+  __m256i nan = _mm256_castps_si256(
+    _mm256_cmp_ps(reg->v, reg->v, _CMP_UNORD_Q));
+  rounded = _mm256_blendv_epi8(rounded,
+    _mm256_or_si256(bits, _mm256_set1_epi32(0x400000)), nan);
+  // packus works per 128-bit lane, gather the two low quadwords
+  __m256i packed = _mm256_packus_epi32(_mm256_srli_epi32(rounded, 16),
+    _mm256_setzero_si256());
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(addr),
+    _mm256_castsi256_si128(_mm256_permute4x64_epi64(packed, 0x08)));
+#endif
+}
+#endif
+
+// uint8 * int8 dot products of four bytes into every 32-bit lane.
+// Without VNNI maddubs adds two products in saturating int16, so the
+// weights are limited to [-63, 63] and 2 * 255 * 63 stays below 32767
+#if (BLITZ_AVX_WIDTH == 64 && defined(__AVX512BW__)) || \
+  (BLITZ_AVX_WIDTH == 32 && defined(__AVX2__))
+#define BLITZ_AVX_INT8
+#endif
+#if defined(BLITZ_AVX_INT8) && \
+  ((BLITZ_AVX_WIDTH == 64 && defined(__AVX512VNNI__)) || \
+  (BLITZ_AVX_WIDTH == 32 && (defined(__AVXVNNI__) || \
+  (defined(__AVX512VNNI__) && defined(__AVX512VL__)))))
+#define BLITZ_AVX_VNNI
+#endif
+#if defined(BLITZ_AVX_INT8) && !defined(BLITZ_AVX_VNNI)
+#define BLITZ_AVX_INT8_WEIGHT_MAX 63
+#else
+#define BLITZ_AVX_INT8_WEIGHT_MAX 127
+#endif
+
+#ifdef BLITZ_AVX_INT8
+inline BlitzAVXInteger BlitzAVXSetInteger(int value) {
+#if BLITZ_AVX_WIDTH == 64
+  return _mm512_set1_epi32(value);
+#else
+  return _mm256_set1_epi32(value);
+#endif
+}
+
+inline BlitzAVXInteger BlitzAVXLoadInteger(const void* addr) {
+#if BLITZ_AVX_WIDTH == 64
+  return _mm512_loadu_si512(addr);
+#else
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(addr));
+#endif
+}
+
+inline void BlitzAVXStoreInteger(void* addr, BlitzAVXInteger reg) {
+#if BLITZ_AVX_WIDTH == 64
+  _mm512_storeu_si512(addr, reg);
+#else
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(addr), reg);
+#endif
+}
+
+inline void BlitzAVXDotInt8(BlitzAVXInteger left, BlitzAVXInteger right,
+  BlitzAVXInteger* output) {
+#if BLITZ_AVX_WIDTH == 64 && defined(BLITZ_AVX_VNNI)
+  *output = _mm512_dpbusd_epi32(*output, left, right);
+#elif BLITZ_AVX_WIDTH == 64
+  *output = _mm512_add_epi32(*output, _mm512_madd_epi16(
+    _mm512_maddubs_epi16(left, right), _mm512_set1_epi16(1)));
+#elif defined(BLITZ_AVX_VNNI) && defined(__AVX512VNNI__)
+  *output = _mm256_dpbusd_epi32(*output, left, right);
+#elif defined(BLITZ_AVX_VNNI)
+  *output = _mm256_dpbusd_avx_epi32(*output, left, right);
+#else
+  *output = _mm256_add_epi32(*output, _mm256_madd_epi16(
+    _mm256_maddubs_epi16(left, right), _mm256_set1_epi16(1)));
+#endif
+}
+
+// levels already rounded and clamped to [0, 255]
+inline void BlitzAVXStoreLevels(unsigned char* addr,
+  const BlitzAVXReg<float>* reg) {
+#if BLITZ_AVX_WIDTH == 64
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(addr),
+    _mm512_cvtepi32_epi8(_mm512_cvtps_epi32(reg->v)));
+#else
+  // packs work per 128-bit lane, the bytes end up in dwords 0 and 4
+  __m256i levels = _mm256_cvtps_epi32(reg->v);
+  levels = _mm256_packus_epi16(_mm256_packus_epi32(levels, levels), levels);
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(addr),
+    _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(levels,
+    _mm256_setr_epi32(0, 4, 0, 0, 0, 0, 0, 0))));
+#endif
+}
+#endif
+
 }  // namespace blitz
 
 #endif  // INCLUDE_UTIL_BLITZ_CPU_AVX_H_
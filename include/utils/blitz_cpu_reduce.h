@@ -0,0 +1,224 @@
+#ifndef INCLUDE_UTIL_BLITZ_CPU_REDUCE_H_
+#define INCLUDE_UTIL_BLITZ_CPU_REDUCE_H_
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "utils/blitz_cpu_avx.h"
+
+namespace blitz {
+
+// Sums over a buffer viewed as outer x middle x inner, keeping middle:
+//   whole buffer   1 x 1 x size
+//   row sums       1 x rows x cols
+//   column sums    rows x cols x 1
+//   NCHW channels  N x C x (H * W)
+//   NHWC channels  (N * H * W) x C x 1
+// With a large middle every thread owns a middle range and reads it in
+// order. Otherwise the buffer is cut into contiguous units, each unit
+// sums into its own partial and the partials are added pairwise. There
+// is one unit per thread by default; the deterministic mode cuts fixed
+// size units instead, so the result does not depend on the number of
+// threads.
+#define BLITZ_REDUCE_UNIT_SIZE 16384
+#define BLITZ_REDUCE_OWNER_SIZE 256
+
+// process wide mode, set once from the config
+inline bool& BlitzReduceDeterministic() {
+  static bool deterministic = false;
+  return deterministic;
+}
+
+inline void BlitzReduceSetDeterministic(bool deterministic) {
+  BlitzReduceDeterministic() = deterministic;
+}
+
+// Op(offset, m, size, lanes, first, second) sets first and second to
+// the two summands of elements [offset, offset + size), size is at most
+// one register. m is the middle index of element offset; with lanes the
+// elements are consecutive middle indices, otherwise they all belong
+// to m. Lanes past size are ignored.
+template<typename DType>
+struct BlitzReduceSumOp {
+  explicit BlitzReduceSumOp(const DType* data) : data_(data) {}
+
+  void operator()(size_t offset, size_t m, size_t size, bool lanes,
+    BlitzAVXReg<DType>* first, BlitzAVXReg<DType>* second) const {
+    BlitzAVXLoadPartial(data_ + offset, size, static_cast<DType>(0), first);
+    *second = *first;
+  }
+
+  const DType* data_;
+};
+
+template<typename DType, typename Op>
+inline void BlitzReduceRun(const Op& op, size_t begin, size_t end,
+  size_t middle, size_t inner, DType* first, DType* second) {
+  const size_t width = BLITZ_AVX_WIDTH / sizeof(DType);
+  BlitzAVXReg<DType> x, y, sum, square;
+  for (size_t p = begin; p < end; ) {
+    const size_t m = (p / inner) % middle;
+    const size_t run_end = std::min(end, (p / inner + 1) * inner);
+    BlitzAVXSet(static_cast<DType>(0), &sum);
+    BlitzAVXSet(static_cast<DType>(0), &square);
+    for (size_t q = p; q < run_end; q += width) {
+      const size_t size = std::min(width, run_end - q);
+      op(q, m, size, false, &x, &y);
+      BlitzAVXFillPartial(size, static_cast<DType>(0), &x);
+      BlitzAVXFillPartial(size, static_cast<DType>(0), &y);
+      BlitzAVXAdd(&sum, &x, &sum);
+      BlitzAVXAdd(&square, &y, &square);
+    }
+    first[m] += BlitzAVXSum(&sum);
+    if (second != NULL) {
+      second[m] += BlitzAVXSum(&square);
+    }
+    p = run_end;
+  }
+}
+
+// rows [row_begin, row_end) of middle [begin, end), inner is 1
+template<typename DType, typename Op>
+inline void BlitzReduceLanes(const Op& op, size_t row_begin, size_t row_end,
+  size_t middle, size_t begin, size_t end, DType* first, DType* second) {
+  const size_t width = BLITZ_AVX_WIDTH / sizeof(DType);
+  BlitzAVXReg<DType> x, y, sum;
+  for (size_t i = row_begin; i < row_end; ++i) {
+    for (size_t j = begin; j < end; j += width) {
+      const size_t size = std::min(width, end - j);
+      op(i * middle + j, j, size, true, &x, &y);
+      BlitzAVXLoadPartial(first + j, size, static_cast<DType>(0), &sum);
+      BlitzAVXAdd(&sum, &x, &sum);
+      BlitzAVXStorePartial(first + j, size, &sum);
+      if (second != NULL) {
+        BlitzAVXLoadPartial(second + j, size, static_cast<DType>(0), &sum);
+        BlitzAVXAdd(&sum, &y, &sum);
+        BlitzAVXStorePartial(second + j, size, &sum);
+      }
+    }
+  }
+}
+
+// elements of scratch a BlitzReduce call needs for its partials,
+// second summands included if with_second
+inline size_t BlitzReduceScratchSize(size_t outer, size_t middle,
+  size_t inner, bool with_second) {
+  const size_t size = outer * middle * inner;
+  if (size == 0 || middle >= BLITZ_REDUCE_OWNER_SIZE) {
+    return 0;
+  }
+  // units are never smaller than BLITZ_REDUCE_UNIT_SIZE
+  const size_t units = (size + BLITZ_REDUCE_UNIT_SIZE - 1) /
+    BLITZ_REDUCE_UNIT_SIZE;
+  return units * middle * (with_second ? 2 : 1);
+}
+
+// first[m] += sum of the first summands of middle index m, the same for
+// second, which may be NULL; scratch of BlitzReduceScratchSize elements
+// holds the partials, without one they are allocated per call
+template<typename DType, typename Op>
+void BlitzReduce(const Op& op, size_t outer, size_t middle, size_t inner,
+  DType* first, DType* second, DType* scratch = NULL) {
+  const size_t width = BLITZ_AVX_WIDTH / sizeof(DType);
+  const size_t size = outer * middle * inner;
+  const bool lanes = inner == 1;
+  if (size == 0) {
+    return;
+  }
+
+  if (middle >= BLITZ_REDUCE_OWNER_SIZE) {
+    if (lanes) {
+      #pragma omp parallel
+      {
+        const size_t tid = omp_get_thread_num();
+        const size_t num_threads = omp_get_num_threads();
+        const size_t align = BLITZ_ALIGNMENT_SIZE / sizeof(DType);
+        const size_t slice = (middle + num_threads * align - 1) /
+          (num_threads * align) * align;
+        const size_t begin = std::min(tid * slice, middle);
+        const size_t end = std::min(begin + slice, middle);
+        BlitzReduceLanes(op, 0, outer, middle, begin, end, first, second);
+      }
+    } else {
+      #pragma omp parallel for
+      for (size_t m = 0; m < middle; ++m) {
+        for (size_t i = 0; i < outer; ++i) {
+          const size_t begin = (i * middle + m) * inner;
+          BlitzReduceRun(op, begin, begin + inner, middle, inner,
+            first, second);
+        }
+      }
+    }
+    return;
+  }
+
+  // units are whole rows with lanes and whole registers otherwise
+  const size_t grain = lanes ? middle : width;
+  size_t unit = BLITZ_REDUCE_UNIT_SIZE;
+  if (!BlitzReduceDeterministic()) {
+    unit = std::max(unit, (size + omp_get_max_threads() - 1) /
+      omp_get_max_threads());
+  }
+  unit = (unit + grain - 1) / grain * grain;
+  const size_t units = (size + unit - 1) / unit;
+
+  const size_t partial_size = units * middle * (second != NULL ? 2 : 1);
+  std::vector<DType> partial;
+  if (scratch == NULL) {
+    partial.resize(partial_size, 0);
+    scratch = &partial[0];
+  } else {
+    std::fill(scratch, scratch + partial_size, static_cast<DType>(0));
+  }
+  DType* first_partial = scratch;
+  DType* second_partial = second != NULL ? scratch + units * middle : NULL;
+  #pragma omp parallel for if (units > 1)
+  for (size_t u = 0; u < units; ++u) {
+    const size_t begin = u * unit;
+    const size_t end = std::min(begin + unit, size);
+    DType* first_unit = &first_partial[u * middle];
+    DType* second_unit = second != NULL ? &second_partial[u * middle] : NULL;
+    if (lanes) {
+      BlitzReduceLanes(op, begin / middle, end / middle, middle,
+        static_cast<size_t>(0), middle, first_unit, second_unit);
+    } else {
+      BlitzReduceRun(op, begin, end, middle, inner, first_unit, second_unit);
+    }
+  }
+
+  // pairwise, unit u absorbs unit u + step
+  for (size_t step = 1; step < units; step *= 2) {
+    for (size_t u = 0; u + step < units; u += 2 * step) {
+      for (size_t m = 0; m < middle; ++m) {
+        first_partial[u * middle + m] +=
+          first_partial[(u + step) * middle + m];
+        if (second != NULL) {
+          second_partial[u * middle + m] +=
+            second_partial[(u + step) * middle + m];
+        }
+      }
+    }
+  }
+  for (size_t m = 0; m < middle; ++m) {
+    first[m] += first_partial[m];
+    if (second != NULL) {
+      second[m] += second_partial[m];
+    }
+  }
+}
+
+// sum of a contiguous buffer
+template<typename DType>
+inline DType BlitzReduceSum(const DType* data, size_t size) {
+  DType output = 0;
+  BlitzReduce(BlitzReduceSumOp<DType>(data), 1, 1, size, &output,
+    static_cast<DType*>(NULL));
+  return output;
+}
+
+}  // namespace blitz
+
+#endif  // INCLUDE_UTIL_BLITZ_CPU_REDUCE_H_
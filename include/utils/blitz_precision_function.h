@@ -0,0 +1,158 @@
+#ifndef INCLUDE_UTIL_BLITZ_PRECISION_FUNCTION_H_
+#define INCLUDE_UTIL_BLITZ_PRECISION_FUNCTION_H_
+
+#include <algorithm>
+#include <cmath>
+
+namespace blitz {
+
+// storage of activations kept between forward and backward,
+// arithmetic stays in DType; a stash lowers the planned activation
+// memory, not bandwidth, since it adds a compress and a decompress pass
+enum BLITZ_PRECISION {
+  BLITZ_PRECISION_FLOAT = 0,
+  BLITZ_PRECISION_HALF = 1,
+  BLITZ_PRECISION_BFLOAT = 2,
+  BLITZ_PRECISION_UNDEFINED = 3
+};
+
+inline BLITZ_PRECISION BlitzParsePrecision(const string& precision) {
+  if (precision == "float") {
+    return BLITZ_PRECISION_FLOAT;
+  } else if (precision == "half") {
+    return BLITZ_PRECISION_HALF;
+  } else if (precision == "bfloat16") {
+    return BLITZ_PRECISION_BFLOAT;
+  } else {
+    return BLITZ_PRECISION_UNDEFINED;
+  }
+}
+
+union BlitzFloatBits {
+  float f;
+  unsigned int u;
+};
+
+// IEEE binary16, round to nearest even, overflow to infinity
+inline unsigned short BlitzFloatToHalf(float value) {
+  BlitzFloatBits bits;
+  bits.f = value;
+  const unsigned int sign = (bits.u >> 16) & 0x8000;
+  const unsigned int exponent = (bits.u >> 23) & 0xFF;
+  unsigned int mantissa = bits.u & 0x7FFFFF;
+  if (exponent == 0xFF) {
+    // infinity or quiet nan
+    return sign | 0x7C00 | (mantissa ? 0x200 : 0);
+  }
+  const int half_exponent = static_cast<int>(exponent) - 127 + 15;
+  if (half_exponent >= 0x1F) {
+    return sign | 0x7C00;
+  }
+  if (half_exponent <= 0) {
+    // subnormal or zero, shift the implicit one in
+    if (half_exponent < -10) {
+      return sign;
+    }
+    mantissa |= 0x800000;
+    const unsigned int shift = 14 - half_exponent;
+    const unsigned int half_mantissa = mantissa >> shift;
+    const unsigned int rest = mantissa & ((1u << shift) - 1);
+    const unsigned int halfway = 1u << (shift - 1);
+    return sign | (half_mantissa +
+      (rest > halfway || (rest == halfway && (half_mantissa & 1))));
+  }
+  const unsigned int half = (half_exponent << 10) | (mantissa >> 13);
+  const unsigned int rest = mantissa & 0x1FFF;
+  // a carry out of the mantissa rounds up the exponent, up to infinity
+  return sign | (half +
+    (rest > 0x1000 || (rest == 0x1000 && (half & 1))));
+}
+
+inline float BlitzHalfToFloat(unsigned short value) {
+  const unsigned int sign = (value & 0x8000u) << 16;
+  unsigned int exponent = (value >> 10) & 0x1F;
+  unsigned int mantissa = value & 0x3FF;
+  BlitzFloatBits bits;
+  if (exponent == 0x1F) {
+    bits.u = sign | 0x7F800000 | (mantissa << 13);
+  } else if (exponent != 0) {
+    bits.u = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+  } else if (mantissa == 0) {
+    bits.u = sign;
+  } else {
+    // subnormal, normalize
+    exponent = 127 - 15 + 1;
+    while ((mantissa & 0x400) == 0) {
+      mantissa <<= 1;
+      --exponent;
+    }
+    bits.u = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+  }
+  return bits.f;
+}
+
+// upper half of binary32, round to nearest even
+inline unsigned short BlitzFloatToBFloat(float value) {
+  BlitzFloatBits bits;
+  bits.f = value;
+  if ((bits.u & 0x7FFFFFFF) > 0x7F800000) {
+    return (bits.u >> 16) | 0x40;
+  }
+  return (bits.u + 0x7FFF + ((bits.u >> 16) & 1)) >> 16;
+}
+
+inline float BlitzBFloatToFloat(unsigned short value) {
+  BlitzFloatBits bits;
+  bits.u = static_cast<unsigned int>(value) << 16;
+  return bits.f;
+}
+
+// int8 inference multiplies uint8 activations with a zero point by int8
+// weights scaled per output column. Weights are packed four rows at a
+// time, [ceil(K / 4)][ceil(N / 16) * 16][4], so one 32-bit lane holds
+// the four products of one column
+#define BLITZ_QUANTIZE_GROUP 4
+#define BLITZ_QUANTIZE_BLOCK 16
+
+inline size_t BlitzQuantizeRows(size_t K) {
+  return (K + BLITZ_QUANTIZE_GROUP - 1) / BLITZ_QUANTIZE_GROUP *
+    BLITZ_QUANTIZE_GROUP;
+}
+
+inline size_t BlitzQuantizeColumns(size_t N) {
+  return (N + BLITZ_QUANTIZE_BLOCK - 1) / BLITZ_QUANTIZE_BLOCK *
+    BLITZ_QUANTIZE_BLOCK;
+}
+
+inline size_t BlitzQuantizedWeightSize(size_t K, size_t N) {
+  return BlitzQuantizeRows(K) * BlitzQuantizeColumns(N);
+}
+
+// non-negative inputs, e.g. after rectlin, use all 256 levels from
+// zero point 0, others are centered on 128
+template<typename DType>
+inline void BlitzQuantizeRange(DType minimum, DType maximum,
+  DType* scale, unsigned char* zero_point) {
+  if (minimum >= 0) {
+    *zero_point = 0;
+    *scale = maximum / 255;
+  } else {
+    *zero_point = 128;
+    *scale = std::max(-minimum, maximum) / 127;
+  }
+  if (*scale == 0) {
+    *scale = 1;
+  }
+}
+
+template<typename DType>
+inline unsigned char BlitzQuantize(DType value, DType inverse_scale,
+  unsigned char zero_point) {
+  const DType level = nearbyint(value * inverse_scale) + zero_point;
+  return static_cast<unsigned char>(level < 0 ? 0 :
+    (level > 255 ? 255 : level));
+}
+
+}  // namespace blitz
+
+#endif  // INCLUDE_UTIL_BLITZ_PRECISION_FUNCTION_H_
@@ -0,0 +1,93 @@
+#ifndef INCLUDE_UTILS_BLITZ_PROFILER_H_
+#define INCLUDE_UTILS_BLITZ_PROFILER_H_
+
+#include <string>
+
+#include "utils/common.h"
+
+namespace blitz {
+
+// Runtime profiler, off by default and a flag test per call site when off.
+// A scope times one phase (forward, backward, update, optimize) of a named
+// layer or optimizer; scopes nest and each records its self time, so an
+// update scope inside a backward scope is not counted twice. Stages
+// (unpack, gemm, pack, epilogue, ...) break the innermost scope down.
+// Times are summed per batch and reported as percentiles over batches.
+// Scopes and stages are recorded by the thread that drives the network,
+// kernels hand in per thread times of their parallel regions.
+
+// process wide switches, set once from the config, trace keeps every
+// scope and stage as a Chrome trace event
+inline bool& BlitzProfilerEnabled() {
+  static bool enabled = false;
+  return enabled;
+}
+
+void BlitzProfilerSetEnabled(bool enabled, bool trace = false);
+
+// lap timer for kernel loops, no clock is read while the profiler is off
+inline time_point<system_clock> BlitzProfilerNow() {
+  return BlitzProfilerEnabled() ? system_clock::now() :
+    time_point<system_clock>();
+}
+
+// seconds since start, which moves to now
+inline double BlitzProfilerLap(time_point<system_clock>* start) {
+  if (!BlitzProfilerEnabled()) {
+    return 0;
+  }
+  const time_point<system_clock> now = system_clock::now();
+  duration<double> elapsed = now - *start;
+  *start = now;
+  return elapsed.count();
+}
+
+// closes the batch the scopes and stages since the last call belong to
+void BlitzProfilerBatchEnd();
+
+// a stage of the innermost scope that has just taken seconds
+void BlitzProfilerStage(const char* stage, double seconds);
+
+// a stage run by num_threads threads, the slowest thread is the stage
+// time and slowest / mean its imbalance
+void BlitzProfilerThreadStage(const char* stage, const double* seconds,
+  size_t num_threads);
+
+// log time percentiles, GFLOP/s and imbalance of every scope and stage
+void BlitzProfilerReport();
+
+// write the trace as Chrome trace event JSON, for chrome://tracing
+void BlitzProfilerExportTrace(const string& path);
+
+class BlitzProfileScope {
+ public:
+  // computations are the floating point operations of one call
+  BlitzProfileScope(const string& name, const char* phase,
+    double computations = 0);
+
+  ~BlitzProfileScope();
+
+ private:
+  bool active_;
+
+  DISABLE_COPY_AND_ASSIGN(BlitzProfileScope);
+};
+
+// times a stage of the innermost scope until it goes out of scope
+class BlitzProfileStageTimer {
+ public:
+  explicit BlitzProfileStageTimer(const char* stage);
+
+  ~BlitzProfileStageTimer();
+
+ private:
+  const char* stage_;
+  bool active_;
+  time_point<system_clock> start_;
+
+  DISABLE_COPY_AND_ASSIGN(BlitzProfileStageTimer);
+};
+
+}  // namespace blitz
+
+#endif  // INCLUDE_UTILS_BLITZ_PROFILER_H_
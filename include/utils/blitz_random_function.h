@@ -0,0 +1,116 @@
+#ifndef INCLUDE_UTIL_BLITZ_RANDOM_FUNCTION_H_
+#define INCLUDE_UTIL_BLITZ_RANDOM_FUNCTION_H_
+
+#include <stdint.h>
+
+#include <cmath>
+#include <cstddef>
+#include <ctime>
+
+namespace blitz {
+
+// Philox4x32-10 counter-based generator (Salmon et al., SC'11).
+// Block i of a fill is a pure function of (seed, stream, i), so any
+// thread can produce any slice of a tensor and the values do not
+// depend on the number of threads.
+inline void BlitzPhilox4x32(uint64_t seed, uint64_t stream, uint64_t block,
+  uint32_t output[4]) {
+  uint32_t c0 = static_cast<uint32_t>(block);
+  uint32_t c1 = static_cast<uint32_t>(block >> 32);
+  uint32_t c2 = static_cast<uint32_t>(stream);
+  uint32_t c3 = static_cast<uint32_t>(stream >> 32);
+  uint32_t k0 = static_cast<uint32_t>(seed);
+  uint32_t k1 = static_cast<uint32_t>(seed >> 32);
+  for (size_t i = 0; i < 10; ++i) {
+    const uint64_t p0 = static_cast<uint64_t>(0xD2511F53u) * c0;
+    const uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57u) * c2;
+    const uint32_t hi0 = static_cast<uint32_t>(p0 >> 32);
+    const uint32_t hi1 = static_cast<uint32_t>(p1 >> 32);
+    c0 = hi1 ^ c1 ^ k0;
+    c1 = static_cast<uint32_t>(p1);
+    c2 = hi0 ^ c3 ^ k1;
+    c3 = static_cast<uint32_t>(p0);
+    k0 += 0x9E3779B9u;
+    k1 += 0xBB67AE85u;
+  }
+  output[0] = c0;
+  output[1] = c1;
+  output[2] = c2;
+  output[3] = c3;
+}
+
+// process wide seed, set once from the config before any filler runs
+inline uint64_t& BlitzRandomSeed() {
+  static uint64_t seed = static_cast<uint64_t>(time(NULL));
+  return seed;
+}
+
+inline void BlitzRandomSetSeed(uint64_t seed) {
+  BlitzRandomSeed() = seed;
+}
+
+// every fill draws from its own stream, called from the master thread
+inline uint64_t BlitzRandomNextStream() {
+  static uint64_t stream = 0;
+  return stream++;
+}
+
+// uniform values in [0, 1) produced by one Philox block
+template<typename DType>
+struct BlitzRandomBlock;
+
+template<>
+struct BlitzRandomBlock<float> {
+  static size_t size() { return 4; }
+
+  static void Uniform(const uint32_t bits[4], float output[4]) {
+    for (size_t i = 0; i < 4; ++i) {
+      output[i] = (bits[i] >> 8) * (1.0f / 16777216.0f);
+    }
+  }
+};
+
+template<>
+struct BlitzRandomBlock<double> {
+  static size_t size() { return 2; }
+
+  static void Uniform(const uint32_t bits[4], double output[2]) {
+    for (size_t i = 0; i < 2; ++i) {
+      const uint64_t value = (static_cast<uint64_t>(bits[2 * i]) << 21) ^
+        (bits[2 * i + 1] >> 11);
+      output[i] = value * (1.0 / 9007199254740992.0);
+    }
+  }
+};
+
+// block of uniform values in [low, high)
+template<typename DType>
+inline void BlitzRandomUniform(uint64_t seed, uint64_t stream,
+  uint64_t block, DType low, DType high, DType* output) {
+  uint32_t bits[4];
+  BlitzPhilox4x32(seed, stream, block, bits);
+  BlitzRandomBlock<DType>::Uniform(bits, output);
+  for (size_t i = 0; i < BlitzRandomBlock<DType>::size(); ++i) {
+    output[i] = low + (high - low) * output[i];
+  }
+}
+
+// block of normal values, Box-Muller over pairs of uniforms
+template<typename DType>
+inline void BlitzRandomNormal(uint64_t seed, uint64_t stream,
+  uint64_t block, DType loc, DType scale, DType* output) {
+  uint32_t bits[4];
+  BlitzPhilox4x32(seed, stream, block, bits);
+  BlitzRandomBlock<DType>::Uniform(bits, output);
+  for (size_t i = 0; i < BlitzRandomBlock<DType>::size(); i += 2) {
+    // 1 - u is in (0, 1], log stays finite
+    const DType radius = sqrt(-2 * log(1 - output[i]));
+    const DType angle = static_cast<DType>(2 * M_PI) * output[i + 1];
+    output[i] = loc + scale * radius * cos(angle);
+    output[i + 1] = loc + scale * radius * sin(angle);
+  }
+}
+
+}  // namespace blitz
+
+#endif  // INCLUDE_UTIL_BLITZ_RANDOM_FUNCTION_H_
@@ -41,6 +41,28 @@ inline void Blitz2DBuffer(BLITZ_DATA_LAYOUT data_layout,
   }
 }
 
+// channels of an activation for per-channel statistics: NCHW is
+// N x C x (H * W), NHWC and flat N x C outputs are N x (H * W) x C;
+// returns whether channels are the innermost dimension
+inline bool BlitzChannelView(const Shape* shape,
+  size_t* N, size_t* C, size_t* S) {
+  *N = (*shape)[0];
+  if (shape->dimension() == 4 &&
+    shape->data_layout() == BLITZ_BUFFER_NCHW) {
+    *C = (*shape)[1];
+    *S = (*shape)[2] * (*shape)[3];
+    return false;
+  } else if (shape->dimension() == 4 &&
+    shape->data_layout() == BLITZ_BUFFER_NHWC) {
+    *C = (*shape)[3];
+    *S = (*shape)[1] * (*shape)[2];
+    return true;
+  }
+  *C = shape->size() / *N;
+  *S = 1;
+  return true;
+}
+
 inline void Blitz2DFilter(BLITZ_DATA_LAYOUT data_layout,
   const Shape* shape, size_t* K, size_t* C, size_t* R, size_t* S) {
   CHECK_EQ(shape->dimension(), 4);
@@ -63,6 +85,67 @@ inline void Blitz2DFilter(BLITZ_DATA_LAYOUT data_layout,
   }
 }
 
+// every supported 4D permutation is a batch of 2D transposes: batch b
+// reads rows x cols at input + b * input_stride with leading dimension
+// input_ld, and writes cols x rows at output + b * output_stride with
+// leading dimension output_ld; returns false if the layouts are equal
+inline bool BlitzTransposeView(const Shape* input, const Shape* output,
+  size_t* batch, size_t* rows, size_t* cols,
+  size_t* input_ld, size_t* output_ld,
+  size_t* input_stride, size_t* output_stride) {
+  CHECK_EQ(input->size(), output->size());
+  const BLITZ_DATA_LAYOUT input_layout = input->data_layout();
+  const BLITZ_DATA_LAYOUT output_layout = output->data_layout();
+  if (input_layout == output_layout) {
+    return false;
+  }
+  size_t N, C, H, W;
+  if (input_layout == BLITZ_BUFFER_NCHW &&
+    output_layout == BLITZ_BUFFER_NHWC) {
+    Blitz2DBuffer(input_layout, input, &N, &C, &H, &W);
+    *batch = N;
+    *rows = C;
+    *cols = H * W;
+  } else if (input_layout == BLITZ_BUFFER_NHWC &&
+    output_layout == BLITZ_BUFFER_NCHW) {
+    Blitz2DBuffer(input_layout, input, &N, &C, &H, &W);
+    *batch = N;
+    *rows = H * W;
+    *cols = C;
+  } else if (input_layout == BLITZ_FILTER_KCRS &&
+    output_layout == BLITZ_FILTER_RSCK) {
+    // K x (C x RS) to (RS x C) x K, one K x RS transpose per channel
+    Blitz2DFilter(input_layout, input, &N, &C, &H, &W);
+    *batch = C;
+    *rows = N;
+    *cols = H * W;
+    *input_ld = C * H * W;
+    *output_ld = C * N;
+    *input_stride = H * W;
+    *output_stride = N;
+    return true;
+  } else if (input_layout == BLITZ_FILTER_RSCK &&
+    output_layout == BLITZ_FILTER_KCRS) {
+    Blitz2DFilter(input_layout, input, &N, &C, &H, &W);
+    *batch = C;
+    *rows = H * W;
+    *cols = N;
+    *input_ld = C * N;
+    *output_ld = C * H * W;
+    *input_stride = N;
+    *output_stride = H * W;
+    return true;
+  } else {
+    LOG(FATAL) << "Blitz unsupport layout transform: " <<
+      input_layout << " to " << output_layout;
+  }
+  *input_ld = *cols;
+  *output_ld = *rows;
+  *input_stride = *rows * *cols;
+  *output_stride = *rows * *cols;
+  return true;
+}
+
 }  // namespace blitz
 
 #endif  // INCLUDE_UTIL_BLITZ_SHAPE_FUNCTION_H_
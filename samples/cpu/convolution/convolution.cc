@@ -229,6 +229,11 @@ int main(int argc, char** argv) {
   set_filter_shape_kcrs(K, C, R, S);
   // set workspace shape
   workspace_shape_cpu[0] = C * R * S * P * Q;
+  if (BlitzParseAlgorithm(kernel) == BLITZ_CONVOLUTION_WINOGRAD) {
+    // transformed filter and per-thread tiles
+    workspace_shape_cpu[0] = std::max(workspace_shape_cpu[0],
+      6 * 6 * (C * K + BLITZ_NUM_THREADS * (C + K) * BLITZ_WINOGRAD_TILE_BLOCK));
+  }
   // run convolution
   if (phase == "forward") {
     convolution_forward(BlitzParseAlgorithm(kernel), pad_h, pad_w, str_h, str_w, iter);
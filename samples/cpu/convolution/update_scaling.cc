@@ -0,0 +1,113 @@
+#include <omp.h>
+#include <sys/time.h>
+#include <iostream>
+#include "backends/backends.h"
+#include "utils/blitz_algorithm_function.h"
+#include "utils/blitz_cpu_function.h"
+
+using namespace blitz;
+
+// N C H W
+Shape input_shape(4);
+// K C R S
+Shape filter_shape(4);
+// N K P Q
+Shape output_shape(4);
+// cpu workspace
+Shape workspace_shape_cpu(1);
+
+void update_scaling(
+  size_t pad_h, size_t pad_w,
+  size_t str_h, size_t str_w,
+  size_t iterations) {
+  // set up cpu
+  CPUTensor<float> input_cpu(input_shape);
+  CPUTensor<float> filter_cpu(filter_shape);
+  CPUTensor<float> output_cpu(output_shape);
+  CPUTensor<float> workspace_cpu(workspace_shape_cpu);
+  // init values
+  Backend<CPUTensor, float>::UniformDistributionFunc(&output_cpu, 0.0, 1.0);
+  Backend<CPUTensor, float>::UniformDistributionFunc(&input_cpu, 0.0, 1.0);
+  const double computations = 2.0 * output_shape.size() *
+    filter_shape[1] * filter_shape[2] * filter_shape[3];
+  timeval t1, t2;
+  double elapsed_time = 0.0;
+  double base_time = 0.0;
+  for (size_t threads = 1; threads <= BLITZ_NUM_THREADS; ++threads) {
+    omp_set_num_threads(threads);
+    // warm up
+    Backend<CPUTensor, float>::Convolution2DUpdateFunc(
+      &input_cpu,
+      &output_cpu,
+      &filter_cpu,
+      &workspace_cpu,
+      pad_h, pad_w,
+      str_h, str_w,
+      BLITZ_CONVOLUTION_BLAS_GEMM_BATCH);
+    BLITZ_CPU_TIMER_START(elapsed_time, t1);
+    for (size_t i = 0; i < iterations; ++i) {
+      Backend<CPUTensor, float>::Convolution2DUpdateFunc(
+        &input_cpu,
+        &output_cpu,
+        &filter_cpu,
+        &workspace_cpu,
+        pad_h, pad_w,
+        str_h, str_w,
+        BLITZ_CONVOLUTION_BLAS_GEMM_BATCH);
+    }
+    BLITZ_CPU_TIMER_END(elapsed_time, t1, t2);
+    elapsed_time /= iterations;
+    if (threads == 1) {
+      base_time = elapsed_time;
+    }
+    std::cout << "threads: " << threads <<
+      " update time: " << elapsed_time <<
+      " speedup: " << base_time / elapsed_time <<
+      " gflops: " << computations / (elapsed_time * 1e9) << std::endl;
+  }
+}
+
+int main(int argc, char** argv) {
+  const size_t NUM_ARGS = 14;
+  // N C H W R S K P Q pad_h pad_w str_h str_w iter
+  if (argc != NUM_ARGS + 1) {
+    std::cerr << "Not enough args!" << std::endl;
+    exit(1);
+  }
+  // get args
+  const size_t N = atoi(argv[1]);
+  const size_t C = atoi(argv[2]);
+  const size_t H = atoi(argv[3]);
+  const size_t W = atoi(argv[4]);
+  const size_t R = atoi(argv[5]);
+  const size_t S = atoi(argv[6]);
+  const size_t K = atoi(argv[7]);
+  const size_t P = atoi(argv[8]);
+  const size_t Q = atoi(argv[9]);
+  const size_t pad_h = atoi(argv[10]);
+  const size_t pad_w = atoi(argv[11]);
+  const size_t str_h = atoi(argv[12]);
+  const size_t str_w = atoi(argv[13]);
+  const size_t iter = atoi(argv[14]);
+  // set shapes
+  input_shape[0] = N;
+  input_shape[1] = C;
+  input_shape[2] = H;
+  input_shape[3] = W;
+  input_shape.set_data_layout(BLITZ_BUFFER_NCHW);
+  filter_shape[0] = K;
+  filter_shape[1] = C;
+  filter_shape[2] = R;
+  filter_shape[3] = S;
+  filter_shape.set_data_layout(BLITZ_FILTER_KCRS);
+  output_shape[0] = N;
+  output_shape[1] = K;
+  output_shape[2] = P;
+  output_shape[3] = Q;
+  output_shape.set_data_layout(BLITZ_BUFFER_NCHW);
+  // per-thread unpack buffer and private update
+  workspace_shape_cpu[0] = BLITZ_NUM_THREADS * (C * R * S * P * Q + K * C * R * S);
+  // run convolution update
+  update_scaling(pad_h, pad_w, str_h, str_w, iter);
+  return 0;
+}
@@ -0,0 +1,147 @@
+#include <omp.h>
+#include <sys/time.h>
+#include <cmath>
+#include <iostream>
+#include "backends/backends.h"
+#include "utils/blitz_cpu_function.h"
+
+using namespace blitz;
+
+// N D
+Shape shape(2);
+
+// libm reference of the kernels, also the scalar baseline
+void logistic_reference(const CPUTensor<float>* input,
+  CPUTensor<float>* output) {
+  #pragma omp parallel for
+  for (size_t i = 0; i < input->size(); ++i) {
+    (*output)[i] = 1 / (exp(-(*input)[i]) + 1);
+  }
+}
+
+void softmax_reference(const CPUTensor<float>* input,
+  CPUTensor<float>* output) {
+  const size_t num_sample = input->shape()[0];
+  const size_t dim = input->size() / num_sample;
+  #pragma omp parallel for
+  for (size_t i = 0; i < num_sample; ++i) {
+    float sum = 0;
+    for (size_t j = 0; j < dim; ++j) {
+      (*output)[i * dim + j] = exp((*input)[i * dim + j]);
+      sum += (*output)[i * dim + j];
+    }
+    for (size_t j = 0; j < dim; ++j) {
+      (*output)[i * dim + j] /= sum;
+    }
+  }
+}
+
+float cross_entropy_reference(const CPUTensor<float>* input,
+  const CPUTensor<float>* target) {
+  double output = 0;
+  #pragma omp parallel for reduction(+:output)
+  for (size_t i = 0; i < input->size(); ++i) {
+    output += -BlitzCPUSafeLog((*input)[i]) * (*target)[i];
+  }
+  return output / input->shape()[0];
+}
+
+float max_relative_error(const CPUTensor<float>* output,
+  const CPUTensor<float>* reference) {
+  float error = 0;
+  for (size_t i = 0; i < output->size(); ++i) {
+    float diff = fabs((*output)[i] - (*reference)[i]) /
+      std::max(fabs((*reference)[i]), 1e-30f);
+    error = std::max(error, diff);
+  }
+  return error;
+}
+
+void report(const char* name, double elapsed_time,
+  double reference_time, double bytes, double error) {
+  std::cout << name <<
+    " time: " << elapsed_time <<
+    " GB/s: " << bytes / (elapsed_time * 1e9) <<
+    " reference GB/s: " << bytes / (reference_time * 1e9) <<
+    " speedup: " << reference_time / elapsed_time <<
+    " max relative error: " << error << std::endl;
+}
+
+void activation(size_t iterations) {
+  CPUTensor<float> input(shape);
+  CPUTensor<float> target(shape);
+  CPUTensor<float> output(shape);
+  CPUTensor<float> reference(shape);
+  Backend<CPUTensor, float>::UniformDistributionFunc(&input, -10.0, 10.0);
+  Backend<CPUTensor, float>::UniformDistributionFunc(&target, 0.0, 1.0);
+  const double bytes = 2.0 * sizeof(float) * input.size();
+  timeval t1, t2;
+  double elapsed_time = 0.0;
+  double reference_time = 0.0;
+  // logistic
+  logistic_reference(&input, &reference);
+  BLITZ_CPU_TIMER_START(reference_time, t1);
+  for (size_t i = 0; i < iterations; ++i) {
+    logistic_reference(&input, &reference);
+  }
+  BLITZ_CPU_TIMER_END(reference_time, t1, t2);
+  Backend<CPUTensor, float>::LogisticApplyFunc(&input, &output);
+  BLITZ_CPU_TIMER_START(elapsed_time, t1);
+  for (size_t i = 0; i < iterations; ++i) {
+    Backend<CPUTensor, float>::LogisticApplyFunc(&input, &output);
+  }
+  BLITZ_CPU_TIMER_END(elapsed_time, t1, t2);
+  report("logistic", elapsed_time / iterations,
+    reference_time / iterations, bytes,
+    max_relative_error(&output, &reference));
+  // softmax
+  softmax_reference(&input, &reference);
+  BLITZ_CPU_TIMER_START(reference_time, t1);
+  for (size_t i = 0; i < iterations; ++i) {
+    softmax_reference(&input, &reference);
+  }
+  BLITZ_CPU_TIMER_END(reference_time, t1, t2);
+  Backend<CPUTensor, float>::SoftmaxApplyFunc(&input, &output);
+  BLITZ_CPU_TIMER_START(elapsed_time, t1);
+  for (size_t i = 0; i < iterations; ++i) {
+    Backend<CPUTensor, float>::SoftmaxApplyFunc(&input, &output);
+  }
+  BLITZ_CPU_TIMER_END(elapsed_time, t1, t2);
+  report("softmax", elapsed_time / iterations,
+    reference_time / iterations, bytes,
+    max_relative_error(&output, &reference));
+  // cross entropy over the softmax output
+  Backend<CPUTensor, float>::SoftmaxApplyFunc(&input, &output);
+  float cost_reference = cross_entropy_reference(&output, &target);
+  BLITZ_CPU_TIMER_START(reference_time, t1);
+  for (size_t i = 0; i < iterations; ++i) {
+    cost_reference = cross_entropy_reference(&output, &target);
+  }
+  BLITZ_CPU_TIMER_END(reference_time, t1, t2);
+  float cost = 0;
+  BLITZ_CPU_TIMER_START(elapsed_time, t1);
+  for (size_t i = 0; i < iterations; ++i) {
+    cost = Backend<CPUTensor, float>::CrossEntropyMultiApplyFunc(
+      &output, &target);
+  }
+  BLITZ_CPU_TIMER_END(elapsed_time, t1, t2);
+  report("cross entropy", elapsed_time / iterations,
+    reference_time / iterations, bytes,
+    fabs(cost - cost_reference) / fabs(cost_reference));
+}
+
+int main(int argc, char** argv) {
+  const size_t NUM_ARGS = 3;
+  // N D iter
+  if (argc != NUM_ARGS + 1) {
+    std::cerr << "Not enough args!" << std::endl;
+    exit(1);
+  }
+  // get args
+  shape[0] = atoi(argv[1]);
+  shape[1] = atoi(argv[2]);
+  const size_t iter = atoi(argv[3]);
+  // run kernels
+  activation(iter);
+  return 0;
+}
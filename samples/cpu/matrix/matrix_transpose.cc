@@ -1,48 +1,154 @@
+#include <omp.h>
+#include <sys/time.h>
+#include <cmath>
 #include <iostream>
 #include "backends/backends.h"
+#include "utils/blitz_cpu_function.h"
+#include "utils/blitz_shape_function.h"
 
 using namespace blitz;
+
 // M N
 Shape input_shape(2);
 // N M
 Shape output_shape(2);
+// N C H W
+Shape nchw_shape(4, BLITZ_BUFFER_NCHW);
+// N H W C
+Shape nhwc_shape(4, BLITZ_BUFFER_NHWC);
+// K C R S
+Shape kcrs_shape(4, BLITZ_FILTER_KCRS);
+// R S C K
+Shape rsck_shape(4, BLITZ_FILTER_RSCK);
 
-void output_matrix(size_t dim_left, size_t dim_right, float* matrix) {
-  for (size_t i = 0; i < dim_left; ++i) {
-    for (size_t j = 0; j < dim_right; ++j) {
-      std::cout << matrix[i * dim_right + j] << " ";
+// element loop of the permutation, also the scalar baseline
+void transpose_reference(const CPUTensor<float>* input,
+  CPUTensor<float>* output, size_t batch, size_t rows, size_t cols,
+  size_t input_ld, size_t output_ld,
+  size_t input_stride, size_t output_stride) {
+  #pragma omp parallel for collapse(3)
+  for (size_t b = 0; b < batch; ++b) {
+    for (size_t i = 0; i < rows; ++i) {
+      for (size_t j = 0; j < cols; ++j) {
+        (*output)[b * output_stride + j * output_ld + i] =
+          (*input)[b * input_stride + i * input_ld + j];
+      }
     }
-    std::cout << std::endl;
   }
 }
 
-void transpose(size_t m, size_t n) {
-  // set up cpu
-  CPUTensor<float> input_cpu(input_shape);
-  CPUTensor<float> output_cpu(output_shape);
-  // init values
-  Backend<CPUTensor, float>::UniformDistributionFunc(&input_cpu, 0.0, 1.0);
-  output_matrix(m, n, input_cpu.data());
-  // transpose
-  Backend<CPUTensor, float>::Transpose2DFunc(&input_cpu, &output_cpu);
-  output_matrix(n, m, output_cpu.data());
+float max_error(const CPUTensor<float>* output,
+  const CPUTensor<float>* reference) {
+  float error = 0;
+  for (size_t i = 0; i < output->size(); ++i) {
+    error = std::max(error, fabs((*output)[i] - (*reference)[i]));
+  }
+  return error;
+}
+
+void report(const char* name, double elapsed_time,
+  double reference_time, double bytes, double error) {
+  std::cout << name <<
+    " time: " << elapsed_time <<
+    " GB/s: " << bytes / (elapsed_time * 1e9) <<
+    " reference GB/s: " << bytes / (reference_time * 1e9) <<
+    " speedup: " << reference_time / elapsed_time <<
+    " max error: " << error << std::endl;
+}
+
+void permute(const char* name, const Shape& from, const Shape& to,
+  size_t iterations) {
+  CPUTensor<float> input(from);
+  CPUTensor<float> output(to);
+  CPUTensor<float> reference(to);
+  Backend<CPUTensor, float>::UniformDistributionFunc(&input, 0.0, 1.0);
+  size_t batch, rows, cols;
+  size_t input_ld, output_ld, input_stride, output_stride;
+  if (from.dimension() == 2) {
+    batch = 1;
+    rows = from[0];
+    cols = from[1];
+    input_ld = cols;
+    output_ld = rows;
+    input_stride = output_stride = 0;
+  } else {
+    BlitzTransposeView(&from, &to, &batch, &rows, &cols,
+      &input_ld, &output_ld, &input_stride, &output_stride);
+  }
+  const double bytes = 2.0 * sizeof(float) * input.size();
+  timeval t1, t2;
+  double elapsed_time = 0.0;
+  double reference_time = 0.0;
+  transpose_reference(&input, &reference, batch, rows, cols,
+    input_ld, output_ld, input_stride, output_stride);
+  BLITZ_CPU_TIMER_START(reference_time, t1);
+  for (size_t i = 0; i < iterations; ++i) {
+    transpose_reference(&input, &reference, batch, rows, cols,
+      input_ld, output_ld, input_stride, output_stride);
+  }
+  BLITZ_CPU_TIMER_END(reference_time, t1, t2);
+  if (from.dimension() == 2) {
+    Backend<CPUTensor, float>::Transpose2DFunc(&input, &output);
+  } else {
+    Backend<CPUTensor, float>::TransformLayoutFunc(&input, &output);
+  }
+  BLITZ_CPU_TIMER_START(elapsed_time, t1);
+  for (size_t i = 0; i < iterations; ++i) {
+    if (from.dimension() == 2) {
+      Backend<CPUTensor, float>::Transpose2DFunc(&input, &output);
+    } else {
+      Backend<CPUTensor, float>::TransformLayoutFunc(&input, &output);
+    }
+  }
+  BLITZ_CPU_TIMER_END(elapsed_time, t1, t2);
+  report(name, elapsed_time / iterations, reference_time / iterations,
+    bytes, max_error(&output, &reference));
 }
 
 int main(int argc, char** argv) {
-  const size_t NUM_ARGS = 2;
-  // M N
+  const size_t NUM_ARGS = 10;
+  // M N NB C H W K R S iter
   if (argc != NUM_ARGS + 1) {
     std::cerr << "Not enough args!" << std::endl;
     exit(1);
   }
+  // get args
   const size_t M = atoi(argv[1]);
   const size_t N = atoi(argv[2]);
+  const size_t NB = atoi(argv[3]);
+  const size_t C = atoi(argv[4]);
+  const size_t H = atoi(argv[5]);
+  const size_t W = atoi(argv[6]);
+  const size_t K = atoi(argv[7]);
+  const size_t R = atoi(argv[8]);
+  const size_t S = atoi(argv[9]);
+  const size_t iter = atoi(argv[10]);
   // set shapes
   input_shape[0] = M;
   input_shape[1] = N;
   output_shape[0] = N;
   output_shape[1] = M;
+  nchw_shape[0] = NB;
+  nchw_shape[1] = C;
+  nchw_shape[2] = H;
+  nchw_shape[3] = W;
+  nhwc_shape[0] = NB;
+  nhwc_shape[1] = H;
+  nhwc_shape[2] = W;
+  nhwc_shape[3] = C;
+  kcrs_shape[0] = K;
+  kcrs_shape[1] = C;
+  kcrs_shape[2] = R;
+  kcrs_shape[3] = S;
+  rsck_shape[0] = R;
+  rsck_shape[1] = S;
+  rsck_shape[2] = C;
+  rsck_shape[3] = K;
   // run
-  transpose(M, N);
+  permute("transpose", input_shape, output_shape, iter);
+  permute("nchw to nhwc", nchw_shape, nhwc_shape, iter);
+  permute("nhwc to nchw", nhwc_shape, nchw_shape, iter);
+  permute("kcrs to rsck", kcrs_shape, rsck_shape, iter);
+  permute("rsck to kcrs", rsck_shape, kcrs_shape, iter);
   return 0;
 }
@@ -4,6 +4,7 @@
 #include <cuda_runtime_api.h>
 
 #include "backends/backends.h"
+#include "utils/blitz_profiler.h"
 #include "utils/blitz_gpu_function.h"
 #include "utils/blitz_cpu_function.h"
 #include "utils/blitz_algorithm_function.h"
@@ -245,6 +246,8 @@ int main(int argc, char** argv) {
   workspace_shape_gpu[0] =
     input_shape.size() + output_shape.size() + filter_shape.size();
   workspace_shape_cpu[0] = C * R * S * P * Q;
+  // kernels time their stages only when the profiler is on
+  BlitzProfilerSetEnabled(true);
   // run convolution
   if (phase == "forward") {
     convolution_forward(BlitzParseAlgorithm(kernel), pad_h, pad_w, str_h, str_w, iterations);
@@ -253,5 +256,6 @@ int main(int argc, char** argv) {
   } else if (phase == "update") {
     convolution_update(BlitzParseAlgorithm(kernel), pad_h, pad_w, str_h, str_w, iterations);
   }
+  BlitzProfilerReport();
   return 0;
 }
@@ -4,6 +4,7 @@
 #include <cuda_runtime_api.h>
 
 #include "backends/backends.h"
+#include "utils/blitz_profiler.h"
 
 using namespace blitz;
 // M K
@@ -67,7 +68,10 @@ int main(int argc, char** argv) {
   right_shape[1] = N;
   output_shape[0] = M;
   output_shape[1] = N;
+  // kernels time their stages only when the profiler is on
+  BlitzProfilerSetEnabled(true);
   // run
   multiply(M, N, K, BlitzParseAlgorithm(kernel));
+  BlitzProfilerReport();
   return 0;
 }
@@ -21,7 +21,7 @@ void compare(float* algo1, float* algo2, size_t size) {
   }
 }
 
-void init_max_index(size_t* max_index, size_t window_size, size_t size) {
+void init_max_index(unsigned char* max_index, size_t window_size, size_t size) {
   for (size_t i = 0; i < size; ++i) {
     max_index[i] = i % window_size;
   }
@@ -102,11 +102,11 @@ void nhwc2nchw(const float* nhwc, float* nchw, size_t batch, size_t channel, siz
 void pooling_forward_nchw(size_t filter_h, size_t filter_w, size_t str_h, size_t str_w) {
   // set up cpu
   CPUTensor<float> input_cpu(input_shape_nchw);
-  CPUTensor<size_t> max_index_cpu(output_shape_nkpq);
+  CPUTensor<unsigned char> max_index_cpu(output_shape_nkpq);
   CPUTensor<float> output_cpu(output_shape_nkpq);
   // set up mic
   MICTensor<float> input_mic(input_shape_nchw);
-  MICTensor<size_t> max_index_mic(output_shape_nkpq);
+  MICTensor<unsigned char> max_index_mic(output_shape_nkpq);
   MICTensor<float> output_mic(output_shape_nkpq);
   // init values
   Backend<CPUTensor, float>::UniformDistributionFunc(&input_cpu, 0.0, 1.0);
@@ -131,11 +131,11 @@ void pooling_forward_nchw(size_t filter_h, size_t filter_w, size_t str_h, size_t
 void pooling_forward_nhwc(size_t filter_h, size_t filter_w, size_t str_h, size_t str_w) {
   // set up cpu
   CPUTensor<float> input_cpu(input_shape_nchw);
-  CPUTensor<size_t> max_index_cpu(output_shape_nkpq);
+  CPUTensor<unsigned char> max_index_cpu(output_shape_nkpq);
   CPUTensor<float> output_cpu(output_shape_nkpq);
   // set up mic
   MICTensor<float> input_mic(input_shape_nhwc);
-  MICTensor<size_t> max_index_mic(output_shape_npqk);
+  MICTensor<unsigned char> max_index_mic(output_shape_npqk);
   MICTensor<float> output_mic(output_shape_npqk);
   MICTensor<float> output_mic_transform(output_shape_nkpq);
   // init values
@@ -165,17 +165,17 @@ void pooling_forward_nhwc(size_t filter_h, size_t filter_w, size_t str_h, size_t
 void pooling_backward_nchw(size_t filter_h, size_t filter_w, size_t str_h, size_t str_w) {
   // set up cpu
   CPUTensor<float> input_cpu(input_shape_nchw);
-  CPUTensor<size_t> max_index_cpu(output_shape_nkpq);
+  CPUTensor<unsigned char> max_index_cpu(output_shape_nkpq);
   CPUTensor<float> output_cpu(output_shape_nkpq);
   // set up mic
   MICTensor<float> input_mic(input_shape_nchw);
-  MICTensor<size_t> max_index_mic(output_shape_nkpq);
+  MICTensor<unsigned char> max_index_mic(output_shape_nkpq);
   MICTensor<float> output_mic(output_shape_nkpq);
   // init values
   Backend<CPUTensor, float>::UniformDistributionFunc(&output_cpu, 0.0, 1.0);
   memcpy(output_mic.data(), output_cpu.data(), sizeof(float) * output_cpu.size());
-  init_max_index(max_index_cpu.data(), input_shape_nchw[2] * input_shape_nchw[3], max_index_cpu.size());
-  memcpy(max_index_mic.data(), max_index_cpu.data(), sizeof(size_t) * max_index_cpu.size());
+  init_max_index(max_index_cpu.data(), filter_h * filter_w, max_index_cpu.size());
+  memcpy(max_index_mic.data(), max_index_cpu.data(), sizeof(unsigned char) * max_index_cpu.size());
   // cpu pooling 
   Backend<CPUTensor, float>::MaxPooling2DBackwardFunc(
     &output_cpu,
@@ -196,18 +196,18 @@ void pooling_backward_nchw(size_t filter_h, size_t filter_w, size_t str_h, size_
 void pooling_backward_nhwc(size_t filter_h, size_t filter_w, size_t str_h, size_t str_w) {
   // set up cpu
   CPUTensor<float> input_cpu(input_shape_nchw);
-  CPUTensor<size_t> max_index_cpu(output_shape_nkpq);
+  CPUTensor<unsigned char> max_index_cpu(output_shape_nkpq);
   CPUTensor<float> output_cpu(output_shape_nkpq);
   // set up mic
   MICTensor<float> input_mic(input_shape_nhwc);
   MICTensor<float> input_mic_transform(input_shape_nchw);
-  MICTensor<size_t> max_index_mic(output_shape_npqk);
+  MICTensor<unsigned char> max_index_mic(output_shape_npqk);
   MICTensor<float> output_mic(output_shape_npqk);
   // init values
   Backend<CPUTensor, float>::UniformDistributionFunc(&output_cpu, 0.0, 1.0);
   nchw2nhwc(output_cpu.data(), output_mic.data(),
     output_shape_nkpq[0], output_shape_nkpq[1], output_shape_nkpq[2], output_shape_nkpq[3]);
-  init_max_index(max_index_cpu.data(), input_shape_nchw[2] * input_shape_nchw[3], max_index_cpu.size());
+  init_max_index(max_index_cpu.data(), filter_h * filter_w, max_index_cpu.size());
   nchw2nhwc(max_index_cpu.data(), max_index_mic.data(),
     output_shape_nkpq[0], output_shape_nkpq[1], output_shape_nkpq[2], output_shape_nkpq[3]);
   // cpu pooling 
@@ -0,0 +1,74 @@
+"""Convert blitz HDF5 datasets into the flat binary format.
+
+Every <prefix>_<split>_<kind>.log file lists HDF5 files holding 'data' and
+'sample_num' datasets, as written by MNIST.py and CIFAR10.py. All of them
+are concatenated into <prefix>_<split>_<kind>.bin, which is read through
+mmap when the model yaml sets 'data_format: binary'.
+
+usage: python HDF5ToBinary.py <prefix> [float|uint8] [scale]
+
+uint8 stores round(value * scale) clipped to [0, 255], labels stay float.
+"""
+import os
+import struct
+import sys
+import h5py
+import numpy as np
+
+MAGIC = b'BLITZBIN'
+VERSION = 1
+HEADER_SIZE = 64
+DATA_TYPES = {'float': (0, np.float32), 'uint8': (1, np.uint8)}
+
+SPLITS = ['train', 'eval', 'test', 'inference']
+KINDS = ['data', 'label']
+
+
+def write_header(output, data_type, num_samples, sample_size):
+  header = struct.pack('<8sIIQQ', MAGIC, VERSION, data_type,
+      num_samples, sample_size)
+  output.write(header + b'\0' * (HEADER_SIZE - len(header)))
+
+
+def convert(log_path, bin_path, data_type, scale):
+  with open(log_path) as log:
+    files = log.read().split()
+  code, dtype = DATA_TYPES[data_type]
+  num_samples = 0
+  sample_size = None
+  for name in files:
+    with h5py.File(name, 'r') as f:
+      num_samples += int(np.array(f['sample_num']))
+      size = int(np.prod(f['data'].shape[1:]))
+      if sample_size is not None and sample_size != size:
+        raise ValueError('sample size mismatch in {0}'.format(name))
+      sample_size = size
+  with open(bin_path, 'wb') as output:
+    write_header(output, code, num_samples, sample_size)
+    for name in files:
+      with h5py.File(name, 'r') as f:
+        rows = int(np.array(f['sample_num']))
+        data = np.asarray(f['data'][:rows]).reshape(rows, sample_size)
+        if dtype == np.uint8:
+          data = np.clip(np.rint(data * scale), 0, 255)
+        output.write(data.astype(dtype).tobytes())
+  print('{0}: {1} samples of {2} {3}'.format(bin_path, num_samples,
+    sample_size, data_type))
+
+
+if __name__ == '__main__':
+  if len(sys.argv) < 2:
+    print(__doc__)
+    sys.exit(1)
+  prefix = sys.argv[1]
+  data_type = sys.argv[2] if len(sys.argv) > 2 else 'float'
+  scale = float(sys.argv[3]) if len(sys.argv) > 3 else 1.0
+  if data_type not in DATA_TYPES:
+    raise ValueError('unknown data type: {0}'.format(data_type))
+  for split in SPLITS:
+    for kind in KINDS:
+      log_path = '{0}_{1}_{2}.log'.format(prefix, split, kind)
+      if os.path.exists(log_path):
+        # labels are one-hot targets and always stay float
+        convert(log_path, '{0}_{1}_{2}.bin'.format(prefix, split, kind),
+            data_type if kind == 'data' else 'float', scale)
@@ -18,6 +18,10 @@
 #./samples/cpu/convolution/convolution forward convolution_blas_gemm_batch nhwc nhwc 128 192 13 13 3 3 384 13 13 1 1 1 1 2 
 #./samples/cpu/convolution/convolution forward convolution_blas_gemm_batch nhwc nhwc 128 384 13 13 3 3 256 13 13 1 1 1 1 2
 #./samples/cpu/convolution/convolution forward convolution_blas_gemm_batch nhwc nhwc 128 256 13 13 3 3 256 13 13 1 1 1 1 2
+#./samples/cpu/convolution/convolution forward convolution_direct nchw nchw 128 64 27 27 5 5 192 27 27 2 2 1 1 2
+#./samples/cpu/convolution/convolution forward convolution_direct nchw nchw 128 192 13 13 3 3 384 13 13 1 1 1 1 2
+#./samples/cpu/convolution/convolution forward convolution_winograd nchw nchw 128 192 13 13 3 3 384 13 13 1 1 1 1 2
+#./samples/cpu/convolution/convolution forward convolution_winograd nchw nchw 128 384 13 13 3 3 256 13 13 1 1 1 1 2
 ##backward:
 #./samples/cpu/convolution/convolution backward convolution_blas_gemm_batch 128 3 224 224 11 11 64 55 55 3 3 4 4 1
 #./samples/cpu/convolution/convolution backward convolution_blas_gemm_batch 128 64 27 27 5 5 192 27 27 2 2 1 1 1
@@ -49,3 +53,8 @@
 #./samples/cpu/convolution/convolution forward convolution_blas_gemm_batch 128 256 12 12 3 3 512 12 12 1 1 1 1 2 
 #./samples/cpu/convolution/convolution forward convolution_blas_gemm_batch 128 512 12 12 3 3 1024 12 12 1 1 1 1 2
 #./samples/cpu/convolution/convolution forward convolution_blas_gemm_batch 128 1024 12 12 3 3 1024 12 12 1 1 1 1 2
+
+#update scaling from 1 to BLITZ_NUM_THREADS threads
+#N C H W R S K P Q pad_h pad_w str_h str_w iterations
+#./samples/cpu/convolution/update_scaling 128 64 27 27 5 5 192 27 27 2 2 1 1 2
+#./samples/cpu/convolution/update_scaling 128 384 13 13 3 3 256 13 13 1 1 1 1 2
@@ -2,15 +2,25 @@
 
 #include <omp.h>
 
+#include <algorithm>
+#include <limits>
+
 #include "utils/blitz_cpu_function.h"
 #include "utils/blitz_cpu_avx.h"
+#include "utils/blitz_cpu_reduce.h"
+#include "utils/blitz_profiler.h"
+#include "utils/blitz_random_function.h"
 #include "utils/blitz_shape_function.h"
 
 namespace blitz {
 
 #include "cpu_backend_common-inl.h"
+#include "cpu_backend_direct-inl.h"
+#include "cpu_backend_winograd-inl.h"
 #include "cpu_backend_conv-inl.h"
 #include "cpu_backend_pack-inl.h"
+#include "cpu_backend_layout-inl.h"
+#include "cpu_backend_quantize-inl.h"
 #include "cpu_backend_pool-inl.h"
 #include "cpu_backend_dispatch-inl.h"
 
@@ -30,14 +30,35 @@ void Backend<CPUTensor, DType>::RectlinDerivativeFunc(
   }
 }
 
+// at most one register of elements, the tail is padded
+template<typename DType>
+inline void LogisticApplyAVX(const DType* input, DType* output, size_t size) {
+  BlitzAVXReg<DType> x, zero, one;
+  BlitzAVXSet(static_cast<DType>(0), &zero);
+  BlitzAVXSet(static_cast<DType>(1), &one);
+  BlitzAVXLoadPartial(input, size, static_cast<DType>(0), &x);
+  BlitzAVXSub(&zero, &x, &x);
+  BlitzAVXExp(&x, &x);
+  BlitzAVXAdd(&x, &one, &x);
+  BlitzAVXRcp(&x, &x);
+  BlitzAVXStorePartial(output, size, &x);
+}
+
 template<typename DType>
 void Backend<CPUTensor, DType>::LogisticApplyFunc(
   const CPUTensor<DType>* input, CPUTensor<DType>* output) {
   CHECK_EQ(input->size(), output->size());
+  const size_t size = input->size();
+  const size_t width = BLITZ_AVX_WIDTH / sizeof(DType);
+  const size_t blocks = (size + width - 1) / width;
+  const DType* input_data = input->data();
+  DType* output_data = output->data();
 
   #pragma omp parallel for
-  for (size_t i = 0; i < input->size(); ++i) {
-    (*output)[i] = 1 / (exp(-(*input)[i]) + 1);
+  for (size_t i = 0; i < blocks; ++i) {
+    const size_t begin = i * width;
+    LogisticApplyAVX(input_data + begin, output_data + begin,
+      std::min(width, size - begin));
   }
 }
 
@@ -45,7 +66,10 @@ template<typename DType>
 void Backend<CPUTensor, DType>::LogisticDerivativeFunc(
   const CPUTensor<DType>* input, CPUTensor<DType>* output) {
   CHECK_EQ(input->size(), output->size());
-  // TODO(keren) not short cut version
+  #pragma omp parallel for
+  for (size_t i = 0; i < input->size(); ++i) {
+    (*output)[i] *= (*input)[i] * (1 - (*input)[i]);
+  }
 }
 
 template<typename DType>
@@ -54,18 +78,50 @@ void Backend<CPUTensor, DType>::SoftmaxApplyFunc(
   CHECK_EQ(input->size(), output->size());
   size_t num_sample = input->shape()[0];
   size_t dim = input->size() / num_sample;
+  const size_t width = BLITZ_AVX_WIDTH / sizeof(DType);
 
   #pragma omp parallel for
   for (size_t i = 0; i < num_sample; ++i) {
-    DType sum = 0;
-    for (size_t j = 0; j < dim; ++j) {
-      size_t index = i * dim + j;
-      (*output)[index] = exp((*input)[index]);
-      sum += (*output)[index];
+    const DType* input_slice = input->Slice(i * dim);
+    DType* output_slice = output->Slice(i * dim);
+    BlitzAVXReg<DType> x, max, sum;
+    // padded lanes never win the maximum and are zeroed after exp
+    const DType padding = -std::numeric_limits<DType>::max();
+    if (dim <= width) {
+      // the row fits in one register
+      BlitzAVXLoadPartial(input_slice, dim, padding, &x);
+      BlitzAVXSet(BlitzAVXMaximum(&x), &max);
+      BlitzAVXSub(&x, &max, &x);
+      BlitzAVXExp(&x, &x);
+      BlitzAVXFillPartial(dim, static_cast<DType>(0), &x);
+      BlitzAVXSet(1 / BlitzAVXSum(&x), &sum);
+      BlitzAVXMul(&x, &sum, &x);
+      BlitzAVXStorePartial(output_slice, dim, &x);
+      continue;
     }
-
-    for (size_t j = 0; j < dim; ++j) {
-      (*output)[i * dim + j] /= sum;
+    // the row maximum is subtracted before exp to avoid overflow
+    BlitzAVXSet(padding, &max);
+    for (size_t j = 0; j < dim; j += width) {
+      BlitzAVXLoadPartial(input_slice + j, dim - j, padding, &x);
+      BlitzAVXMax(&x, &max, &max);
+    }
+    BlitzAVXSet(BlitzAVXMaximum(&max), &max);
+    BlitzAVXSet(static_cast<DType>(0), &sum);
+    for (size_t j = 0; j < dim; j += width) {
+      const size_t rest = std::min(width, dim - j);
+      BlitzAVXLoadPartial(input_slice + j, rest, padding, &x);
+      BlitzAVXSub(&x, &max, &x);
+      BlitzAVXExp(&x, &x);
+      BlitzAVXFillPartial(rest, static_cast<DType>(0), &x);
+      BlitzAVXStorePartial(output_slice + j, rest, &x);
+      BlitzAVXAdd(&sum, &x, &sum);
+    }
+    BlitzAVXSet(1 / BlitzAVXSum(&sum), &sum);
+    for (size_t j = 0; j < dim; j += width) {
+      const size_t rest = std::min(width, dim - j);
+      BlitzAVXLoadPartial(output_slice + j, rest, static_cast<DType>(0), &x);
+      BlitzAVXMul(&x, &sum, &x);
+      BlitzAVXStorePartial(output_slice + j, rest, &x);
     }
   }
 }
@@ -77,51 +133,75 @@ void Backend<CPUTensor, DType>::SoftmaxDerivativeFunc(
   // TODO(keren) not short cut version
 }
 
+// t * log(x) + (1 - t) * log(1 - x)
+template<typename DType>
+struct CrossEntropyBinaryOp {
+  CrossEntropyBinaryOp(const DType* input, const DType* target) :
+    input_(input), target_(target) {}
+
+  void operator()(size_t offset, size_t m, size_t size, bool lanes,
+    BlitzAVXReg<DType>* first, BlitzAVXReg<DType>* second) const {
+    BlitzAVXReg<DType> x, y, t, one, epsilon;
+    BlitzAVXSet(static_cast<DType>(1), &one);
+    BlitzAVXSet(static_cast<DType>(exp(-50.0)), &epsilon);
+    // padded lanes are x = t = 1, which stay finite
+    BlitzAVXLoadPartial(input_ + offset, size, static_cast<DType>(1), &x);
+    BlitzAVXLoadPartial(target_ + offset, size, static_cast<DType>(1), &t);
+    BlitzAVXSub(&one, &x, &y);
+    BlitzAVXMax(&x, &epsilon, &x);
+    BlitzAVXMax(&y, &epsilon, &y);
+    BlitzAVXLog(&x, &x);
+    BlitzAVXLog(&y, &y);
+    BlitzAVXMul(&t, &x, &x);
+    BlitzAVXSub(&one, &t, &t);
+    BlitzAVXFma(&t, &y, &x, first);
+    *second = *first;
+  }
+
+  const DType* input_;
+  const DType* target_;
+};
+
 template<typename DType>
 DType Backend<CPUTensor, DType>::CrossEntropyBinaryApplyFunc(
   const CPUTensor<DType>* input, const CPUTensor<DType>* target) {
   CHECK_EQ(input->size(), target->size());
-  DType private_output = 0;
   DType output = 0;
-  #pragma omp parallel firstprivate(private_output)
-  {
-    #pragma omp for
-    for (size_t i = 0; i < input->size(); ++i) {
-      private_output += -BlitzCPUSafeLog((*input)[i]) * (*target)[i] -
-      BlitzCPUSafeLog(1 - (*input)[i]) * (1 - (*target)[i]);
-    }
+  BlitzReduce(CrossEntropyBinaryOp<DType>(input->data(), target->data()),
+    1, 1, input->size(), &output, static_cast<DType*>(NULL));
+  return -output / (input->shape())[0];
+}
 
-    #pragma omp atomic
-    output += private_output;
+// (x - t) ^ 2 and |x - t|
+template<typename DType>
+struct DistanceOp {
+  DistanceOp(const DType* input, const DType* target) :
+    input_(input), target_(target) {}
+
+  void operator()(size_t offset, size_t m, size_t size, bool lanes,
+    BlitzAVXReg<DType>* first, BlitzAVXReg<DType>* second) const {
+    BlitzAVXReg<DType> t;
+    BlitzAVXLoadPartial(input_ + offset, size, static_cast<DType>(0), first);
+    BlitzAVXLoadPartial(target_ + offset, size, static_cast<DType>(0), &t);
+    BlitzAVXSub(first, &t, first);
+    BlitzAVXSet(static_cast<DType>(0), &t);
+    BlitzAVXSub(&t, first, &t);
+    BlitzAVXMax(first, &t, second);
+    BlitzAVXMul(first, first, first);
   }
 
-  output /= (input->shape())[0];
-  return output;
-}
+  const DType* input_;
+  const DType* target_;
+};
 
 template<typename DType>
 DType Backend<CPUTensor, DType>::SquareMeanApplyFunc(
   const CPUTensor<DType>* input, const CPUTensor<DType>* target) {
   CHECK_EQ(input->size(), target->size());
   DType sum_square = 0;
-  DType sum = 0;
-
-  size_t batch_size = input->shape()[0];
-  size_t dim = input->size() / batch_size;
-  #pragma omp parallel firstprivate(sum_square)
-  {
-    #pragma omp for
-    for (size_t i = 0; i < batch_size; ++i) {
-      for (size_t j = 0; j < dim; ++j) {
-        sum_square += pow((*input)[i * dim + j] -
-          (*target)[i * dim + j], 2);
-      }
-    }
-
-    #pragma omp atomic
-    sum += sum_square;
-  }
-  return sum / (2 * batch_size);
+  BlitzReduce(DistanceOp<DType>(input->data(), target->data()),
+    1, 1, input->size(), &sum_square, static_cast<DType*>(NULL));
+  return sum_square / (2 * input->shape()[0]);
 }
 
 template<typename DType>
@@ -137,25 +217,10 @@ template<typename DType>
 DType Backend<CPUTensor, DType>::AbsMeanApplyFunc(
   const CPUTensor<DType>* input, const CPUTensor<DType>* target) {
   CHECK_EQ(input->size(), target->size());
-  DType sum_abs = 0;
-  DType sum = 0;
-
-  size_t batch_size = input->shape()[0];
-  size_t dim = input->size() / batch_size;
-  #pragma omp parallel firstprivate(sum_abs)
-  {
-    #pragma omp for
-    for (size_t i = 0; i < batch_size; ++i) {
-      for (size_t j = 0; j < dim; ++j) {
-        sum_abs += fabs((*input)[i * dim + j] -
-          (*target)[i * dim + j]);
-      }
-    }
-
-    #pragma omp atomic
-    sum += sum_abs;
-  }
-  return sum / batch_size;
+  DType sum_square = 0, sum_abs = 0;
+  BlitzReduce(DistanceOp<DType>(input->data(), target->data()),
+    1, 1, input->size(), &sum_square, &sum_abs);
+  return sum_abs / input->shape()[0];
 }
 
 template<typename DType>
@@ -187,26 +252,36 @@ void Backend<CPUTensor, DType>::CrossEntropyBinaryDerivativeFunc(
   MinusFunc(input, target, output);
 }
 
+// t * log(x)
+template<typename DType>
+struct CrossEntropyMultiOp {
+  CrossEntropyMultiOp(const DType* input, const DType* target) :
+    input_(input), target_(target) {}
+
+  void operator()(size_t offset, size_t m, size_t size, bool lanes,
+    BlitzAVXReg<DType>* first, BlitzAVXReg<DType>* second) const {
+    BlitzAVXReg<DType> x, t, epsilon;
+    BlitzAVXSet(static_cast<DType>(exp(-50.0)), &epsilon);
+    BlitzAVXLoadPartial(input_ + offset, size, static_cast<DType>(1), &x);
+    BlitzAVXLoadPartial(target_ + offset, size, static_cast<DType>(0), &t);
+    BlitzAVXMax(&x, &epsilon, &x);
+    BlitzAVXLog(&x, &x);
+    BlitzAVXMul(&x, &t, first);
+    *second = *first;
+  }
+
+  const DType* input_;
+  const DType* target_;
+};
+
 template<typename DType>
 DType Backend<CPUTensor, DType>::CrossEntropyMultiApplyFunc(
   const CPUTensor<DType>* input, const CPUTensor<DType>* target) {
   CHECK_EQ(input->size(), target->size());
-  DType private_output = 0;
   DType output = 0;
-
-  #pragma omp parallel firstprivate(private_output)
-  {
-    #pragma omp for
-    for (size_t i = 0; i < input->size(); ++i) {
-      private_output += BlitzCPUSafeLog((*input)[i]) * (*target)[i];
-    }
-
-    #pragma omp atomic
-    output += -private_output;
-  }
-
-  output /= (input->shape())[0];
-  return output;
+  BlitzReduce(CrossEntropyMultiOp<DType>(input->data(), target->data()),
+    1, 1, input->size(), &output, static_cast<DType*>(NULL));
+  return -output / (input->shape())[0];
 }
 
 template<typename DType>
@@ -216,31 +291,349 @@ void Backend<CPUTensor, DType>::CrossEntropyMultiDerivativeFunc(
   MinusFunc(input, target, output);
 }
 
+// per row: max, exp and sum, then normalize; the later sweeps hit the
+// row in cache. the loss is sum(t) * log(sum) - sum(t * (x - max)),
+// so tiny probabilities never go through log
 template<typename DType>
-void Backend<CPUTensor, DType>::BiasForwardFunc(
-  const CPUTensor<DType>* input, const CPUTensor<DType>* bias,
-  CPUTensor<DType>* output) {
+DType Backend<CPUTensor, DType>::SoftmaxCrossEntropyMultiFunc(
+  const CPUTensor<DType>* input, const CPUTensor<DType>* target,
+  CPUTensor<DType>* output, CPUTensor<DType>* gradient, float* accuracy) {
+  CHECK_EQ(input->size(), target->size());
   CHECK_EQ(input->size(), output->size());
   size_t num_sample = input->shape()[0];
   size_t dim = input->size() / num_sample;
+  const size_t width = BLITZ_AVX_WIDTH / sizeof(DType);
+  const DType padding = -std::numeric_limits<DType>::max();
+  // row losses are summed pairwise afterwards, hits are exact in float
+  vector<DType> loss(num_sample);
+  float correct = 0.0f;
 
   #pragma omp parallel for
   for (size_t i = 0; i < num_sample; ++i) {
-    for (size_t j = 0; j < dim; ++j) {
-      (*output)[i * dim + j] = (*input)[i * dim + j] + (*bias)[j];
+    const DType* input_slice = input->Slice(i * dim);
+    const DType* target_slice = target->Slice(i * dim);
+    DType* output_slice = output->Slice(i * dim);
+    DType* gradient_slice = gradient != NULL ? gradient->Slice(i * dim) : NULL;
+    BlitzAVXReg<DType> x, t, max, sum, dot, mass;
+    BlitzAVXSet(padding, &max);
+    for (size_t j = 0; j < dim; j += width) {
+      BlitzAVXLoadPartial(input_slice + j, dim - j, padding, &x);
+      BlitzAVXMax(&x, &max, &max);
+    }
+    const DType max_value = BlitzAVXMaximum(&max);
+    // output may alias input, so the argmax is taken before any store
+    const size_t max_index = std::find(input_slice, input_slice + dim,
+      max_value) - input_slice;
+    const bool hit = max_index < dim &&
+      target_slice[max_index] == static_cast<DType>(1);
+
+    BlitzAVXSet(max_value, &max);
+    BlitzAVXSet(static_cast<DType>(0), &sum);
+    BlitzAVXSet(static_cast<DType>(0), &dot);
+    BlitzAVXSet(static_cast<DType>(0), &mass);
+    for (size_t j = 0; j < dim; j += width) {
+      const size_t rest = std::min(width, dim - j);
+      // padded lanes are x = max and t = 0
+      BlitzAVXLoadPartial(input_slice + j, rest, max_value, &x);
+      BlitzAVXLoadPartial(target_slice + j, rest, static_cast<DType>(0), &t);
+      BlitzAVXSub(&x, &max, &x);
+      BlitzAVXFma(&t, &x, &dot, &dot);
+      BlitzAVXAdd(&t, &mass, &mass);
+      BlitzAVXExp(&x, &x);
+      BlitzAVXFillPartial(rest, static_cast<DType>(0), &x);
+      BlitzAVXStorePartial(output_slice + j, rest, &x);
+      BlitzAVXAdd(&sum, &x, &sum);
     }
+    const DType row_sum = BlitzAVXSum(&sum);
+    const DType row_loss = BlitzAVXSum(&mass) * log(row_sum) -
+      BlitzAVXSum(&dot);
+
+    BlitzAVXSet(1 / row_sum, &sum);
+    for (size_t j = 0; j < dim; j += width) {
+      const size_t rest = std::min(width, dim - j);
+      BlitzAVXLoadPartial(output_slice + j, rest, static_cast<DType>(0), &x);
+      BlitzAVXMul(&x, &sum, &x);
+      BlitzAVXStorePartial(output_slice + j, rest, &x);
+      if (gradient_slice != NULL) {
+        BlitzAVXLoadPartial(target_slice + j, rest,
+          static_cast<DType>(0), &t);
+        BlitzAVXSub(&x, &t, &x);
+        BlitzAVXStorePartial(gradient_slice + j, rest, &x);
+      }
+    }
+
+    loss[i] = row_loss;
+    if (hit) {
+      #pragma omp atomic
+      correct += 1.0f;
+    }
+  }
+
+  if (accuracy != NULL) {
+    *accuracy = correct / num_sample;
   }
+  return BlitzReduceSum(&loss[0], num_sample) / num_sample;
+}
+
+// per channel sums, NCHW is N x C x (H * W) and buffers with channels
+// innermost are (N * H * W) x C
+template<typename DType, typename Op>
+inline void ChannelReduce(const Op& op, const Shape& shape,
+  DType* first, DType* second) {
+  size_t N, C, S;
+  if (BlitzChannelView(&shape, &N, &C, &S)) {
+    BlitzReduce(op, N * S, C, static_cast<size_t>(1), first, second);
+  } else {
+    BlitzReduce(op, N, C, S, first, second);
+  }
+}
+
+template<typename DType>
+void Backend<CPUTensor, DType>::BiasForwardFunc(
+  const CPUTensor<DType>* input, const CPUTensor<DType>* bias,
+  CPUTensor<DType>* output) {
+  EpilogueForwardFunc(input, bias, NULL, NULL, output,
+    BLITZ_ACTIVATION_NONE, static_cast<DType>(0));
 }
 
 template<typename DType>
 void Backend<CPUTensor, DType>::BiasBackwardUpdateFunc(
   const CPUTensor<DType>* input, CPUTensor<DType>* update) {
-  size_t num_sample = input->shape()[0];
+  ChannelReduce(BlitzReduceSumOp<DType>(input->data()), input->shape(),
+    update->data(), static_cast<DType*>(NULL));
+}
+
+template<typename DType>
+inline DType EpilogueActivationApply(DType value,
+  BLITZ_ACTIVATION activation, DType slope) {
+  switch (activation) {
+    case BLITZ_ACTIVATION_RECTLIN:
+      return std::max(value, static_cast<DType>(0)) +
+        slope * std::min(value, static_cast<DType>(0));
+    case BLITZ_ACTIVATION_LOGISTIC:
+      return 1 / (exp(-value) + 1);
+    default:
+      return value;
+  }
+}
+
+template<typename DType>
+inline DType EpilogueActivationDerivative(DType output,
+  BLITZ_ACTIVATION activation, DType slope) {
+  switch (activation) {
+    case BLITZ_ACTIVATION_RECTLIN:
+      return output > 0 ? 1 : slope;
+    case BLITZ_ACTIVATION_LOGISTIC:
+      return output * (1 - output);
+    default:
+      return 1;
+  }
+}
+
+template<typename DType>
+void Backend<CPUTensor, DType>::EpilogueForwardFunc(
+  const CPUTensor<DType>* input,
+  const CPUTensor<DType>* bias,
+  const CPUTensor<DType>* scale,
+  const CPUTensor<DType>* shift,
+  CPUTensor<DType>* output,
+  BLITZ_ACTIVATION activation,
+  DType slope) {
+  CHECK_EQ(input->size(), output->size());
+  size_t num_sample, C, S;
+  const bool channel_last = BlitzChannelView(&(input->shape()),
+    &num_sample, &C, &S);
   size_t dim = input->size() / num_sample;
+  // a sample is C runs of one channel in NCHW, S rows of all channels
+  // otherwise; the bias is per channel, scale & shift per element
+  const size_t runs = channel_last ? S : C;
+  const size_t run = channel_last ? C : S;
+  const size_t bias_step = channel_last ? 1 : 0;
+  const DType* bias_data = bias != NULL ? bias->data() : NULL;
+  const DType* scale_data = scale != NULL ? scale->data() : NULL;
+  const DType* shift_data = shift != NULL ? shift->data() : NULL;
+  // logistic goes through the vector exp after the affine part
+  const BLITZ_ACTIVATION scalar_activation =
+    activation == BLITZ_ACTIVATION_LOGISTIC ?
+    BLITZ_ACTIVATION_NONE : activation;
+  const size_t width = BLITZ_AVX_WIDTH / sizeof(DType);
+  // one pass per sample: bias, then scale & shift, then activation
+  #pragma omp parallel for
+  for (size_t i = 0; i < num_sample; ++i) {
+    const DType* input_slice = input->Slice(i * dim);
+    DType* output_slice = output->Slice(i * dim);
+    for (size_t r = 0; r < runs; ++r) {
+      const size_t offset = r * run;
+      const DType* bias_run = bias_data != NULL ?
+        bias_data + (channel_last ? 0 : r) : NULL;
+      #pragma simd
+      for (size_t k = 0; k < run; ++k) {
+        const size_t j = offset + k;
+        DType value = input_slice[j];
+        if (bias_run != NULL) {
+          value += bias_run[k * bias_step];
+        }
+        if (scale_data != NULL) {
+          value = scale_data[j] * value + shift_data[j];
+        }
+        output_slice[j] = EpilogueActivationApply(value,
+          scalar_activation, slope);
+      }
+    }
+    if (activation == BLITZ_ACTIVATION_LOGISTIC) {
+      for (size_t j = 0; j < dim; j += width) {
+        LogisticApplyAVX(output_slice + j, output_slice + j,
+          std::min(width, dim - j));
+      }
+    }
+  }
+}
+
+// writes dy * f'(y) back and hands it to the bias reduction
+template<typename DType>
+struct EpilogueBackwardOp {
+  EpilogueBackwardOp(const DType* forward_output, DType* backward_input,
+    BLITZ_ACTIVATION activation, DType slope) :
+    forward_output_(forward_output), backward_input_(backward_input),
+    activation_(activation), slope_(slope) {}
+
+  void operator()(size_t offset, size_t m, size_t size, bool lanes,
+    BlitzAVXReg<DType>* first, BlitzAVXReg<DType>* second) const {
+    for (size_t k = 0; k < size; ++k) {
+      const DType value = backward_input_[offset + k] *
+        EpilogueActivationDerivative(forward_output_[offset + k],
+        activation_, slope_);
+      backward_input_[offset + k] = value;
+      first->d[k] = value;
+    }
+    *second = *first;
+  }
+
+  const DType* forward_output_;
+  DType* backward_input_;
+  const BLITZ_ACTIVATION activation_;
+  const DType slope_;
+};
+
+template<typename DType>
+void Backend<CPUTensor, DType>::EpilogueBackwardFunc(
+  const CPUTensor<DType>* forward_output,
+  CPUTensor<DType>* backward_input,
+  CPUTensor<DType>* bias_update,
+  BLITZ_ACTIVATION activation,
+  DType slope) {
+  CHECK_EQ(forward_output->size(), backward_input->size());
+  const DType* output_data = forward_output->data();
+  DType* input_data = backward_input->data();
+  if (bias_update != NULL) {
+    // the reduction visits every element once, so the bias gradient
+    // is summed in the same pass
+    ChannelReduce(EpilogueBackwardOp<DType>(output_data, input_data,
+      activation, slope), backward_input->shape(), bias_update->data(),
+      static_cast<DType*>(NULL));
+    return;
+  }
   #pragma omp parallel for
-  for (size_t i = 0; i < dim; ++i) {
-    for (size_t j = 0; j < num_sample; ++j) {
-      (*update)[i] += (*input)[j * dim + i];
+  for (size_t i = 0; i < backward_input->size(); ++i) {
+    input_data[i] *= EpilogueActivationDerivative(output_data[i],
+      activation, slope);
+  }
+}
+
+// a - center and (a - center) * b, b defaults to a - center and the
+// center to zero
+template<typename DType>
+struct BatchNormSumOp {
+  BatchNormSumOp(const DType* a, const DType* b, const DType* center) :
+    a_(a), b_(b), center_(center) {}
+
+  void operator()(size_t offset, size_t m, size_t size, bool lanes,
+    BlitzAVXReg<DType>* first, BlitzAVXReg<DType>* second) const {
+    BlitzAVXLoadPartial(a_ + offset, size, static_cast<DType>(0), first);
+    if (center_ != NULL) {
+      BlitzAVXReg<DType> c;
+      if (lanes) {
+        BlitzAVXLoadPartial(center_ + m, size, static_cast<DType>(0), &c);
+      } else {
+        BlitzAVXSet(center_[m], &c);
+      }
+      BlitzAVXSub(first, &c, first);
+    }
+    if (b_ != NULL) {
+      BlitzAVXLoadPartial(b_ + offset, size, static_cast<DType>(0), second);
+      BlitzAVXMul(first, second, second);
+    } else {
+      BlitzAVXMul(first, first, second);
+    }
+  }
+
+  const DType* a_;
+  const DType* b_;
+  const DType* center_;
+};
+
+// per channel coefficient, a single channel per run in NCHW
+// or one channel per lane when channels are innermost
+template<typename DType>
+inline void BatchNormLoadAVX(const DType* coefficient, size_t size,
+  bool broadcast, BlitzAVXReg<DType>* reg) {
+  if (broadcast) {
+    BlitzAVXSet(*coefficient, reg);
+  } else {
+    BlitzAVXLoadPartial(coefficient, size, static_cast<DType>(0), reg);
+  }
+}
+
+// y = p * (a - r) + q * b, then z = s * y + t when z is given
+template<typename DType>
+inline void BatchNormApplyAVX(const DType* a, const DType* b,
+  DType* y, DType* z, size_t size, const DType* p, const DType* q,
+  const DType* r, const DType* s, const DType* t, bool broadcast) {
+  const size_t width = BLITZ_AVX_WIDTH / sizeof(DType);
+  const size_t step = broadcast ? 0 : width;
+  BlitzAVXReg<DType> x, w, c;
+  for (size_t j = 0, k = 0; j < size; j += width, k += step) {
+    const size_t rest = std::min(width, size - j);
+    BlitzAVXLoadPartial(a + j, rest, static_cast<DType>(0), &x);
+    BatchNormLoadAVX(r + k, rest, broadcast, &w);
+    BlitzAVXSub(&x, &w, &x);
+    BatchNormLoadAVX(p + k, rest, broadcast, &c);
+    BlitzAVXMul(&x, &c, &x);
+    if (b != NULL) {
+      BlitzAVXLoadPartial(b + j, rest, static_cast<DType>(0), &w);
+      BatchNormLoadAVX(q + k, rest, broadcast, &c);
+      BlitzAVXFma(&w, &c, &x, &x);
+    }
+    BlitzAVXStorePartial(y + j, rest, &x);
+    if (z != NULL) {
+      BatchNormLoadAVX(s + k, rest, broadcast, &c);
+      BatchNormLoadAVX(t + k, rest, broadcast, &w);
+      BlitzAVXFma(&x, &c, &w, &x);
+      BlitzAVXStorePartial(z + j, rest, &x);
+    }
+  }
+}
+
+// y = p * (a - r) + q * b, then z = s * y + t, coefficients per channel
+template<typename DType>
+inline void BatchNormChannelApply(const DType* a, const DType* b,
+  DType* y, DType* z, const DType* p, const DType* q, const DType* r,
+  const DType* s, const DType* t, size_t N, size_t C, size_t S,
+  bool channel_last) {
+  if (channel_last) {
+    #pragma omp parallel for
+    for (size_t i = 0; i < N * S; ++i) {
+      BatchNormApplyAVX(a + i * C, b != NULL ? b + i * C : NULL,
+        y + i * C, z != NULL ? z + i * C : NULL, C,
+        p, q, r, s, t, false);
+    }
+  } else {
+    #pragma omp parallel for
+    for (size_t i = 0; i < N * C; ++i) {
+      const size_t c = i % C;
+      BatchNormApplyAVX(a + i * S, b != NULL ? b + i * S : NULL,
+        y + i * S, z != NULL ? z + i * S : NULL, S,
+        p + c, q + c, r + c, s + c, t + c, true);
     }
   }
 }
@@ -253,38 +646,45 @@ void Backend<CPUTensor, DType>::BatchNormForwardFunc(
   CPUTensor<DType>* input_var,
   CPUTensor<DType>* input_hat,
   CPUTensor<DType>* output,
+  CPUTensor<DType>* running_mean,
+  CPUTensor<DType>* running_var,
+  DType momentum,
   DType epsilon) {
-  size_t num_sample = input->shape()[0];
-  size_t dim = input->size() / num_sample;
-  input_var->Fill(0);
-  input_hat->Fill(0);
-
-  #pragma omp parallel for
-  for (size_t i = 0; i < dim; ++i) {
-    DType mean = 0.0;
-    for (size_t j = 0; j < num_sample; ++j) {
-      mean += (*input)[j * dim + i];
-    }
-    mean /= num_sample;
-
-    DType var;
-    for (size_t j = 0; j < num_sample; ++j) {
-      var = (*input)[j * dim + i] - mean;
-      (*input_var)[i] += var * var;
-    }
-    (*input_var)[i] /= num_sample;
-
-    DType divider = sqrt((*input_var)[i] + epsilon);
-
-    size_t index = 0;
-    for (size_t j = 0; j < num_sample; ++j) {
-      index = j * dim + i;
-      (*input_hat)[index] = ((*input)[index] -
-        mean) / divider;
-      (*output)[index] = (*gamma)[i] * (*input_hat)[index] +
-        (*beta)[i];
-    }
+  CHECK_EQ(input->size(), output->size());
+  size_t N, C, S;
+  const bool channel_last = BlitzChannelView(&(input->shape()),
+    &N, &C, &S);
+  CHECK_EQ(input_var->size(), C);
+  const size_t count = N * S;
+  // mean, then the second pass around it to keep the variance stable
+  vector<DType> mean(C, 0), square(C, 0);
+  vector<DType> residual(C, 0), scale(C, 0);
+  ChannelReduce(BatchNormSumOp<DType>(input->data(), NULL, NULL),
+    input->shape(), &mean[0], &square[0]);
+  for (size_t c = 0; c < C; ++c) {
+    mean[c] /= count;
+    square[c] = 0;
+  }
+  ChannelReduce(BatchNormSumOp<DType>(input->data(), NULL, &mean[0]),
+    input->shape(), &residual[0], &square[0]);
+  for (size_t c = 0; c < C; ++c) {
+    // the first sum is the rounding error of the mean
+    residual[c] /= count;
+    const DType var = std::max(square[c] / count - residual[c] * residual[c],
+      static_cast<DType>(0));
+    mean[c] += residual[c];
+    (*input_var)[c] = var;
+    (*running_mean)[c] = momentum * (*running_mean)[c] +
+      (1 - momentum) * mean[c];
+    (*running_var)[c] = momentum * (*running_var)[c] +
+      (1 - momentum) * (count > 1 ? var * count / (count - 1) : var);
+    scale[c] = 1 / sqrt(var + epsilon);
   }
+  // input_hat = (x - mean) / sqrt(var + epsilon), output = gamma * hat + beta
+  BatchNormChannelApply(input->data(), static_cast<const DType*>(NULL),
+    input_hat->data(), output->data(), &scale[0],
+    static_cast<const DType*>(NULL), &mean[0], gamma->data(),
+    beta->data(), N, C, S, channel_last);
 }
 
 template<typename DType>
@@ -297,29 +697,81 @@ void Backend<CPUTensor, DType>::BatchNormBackwardFunc(
   CPUTensor<DType>* beta_update,
   CPUTensor<DType>* output,
   DType epsilon) {
-  size_t num_sample = backward_input->shape()[0];
-  size_t dim = backward_input->size() / num_sample;
+  CHECK_EQ(backward_input->size(), output->size());
+  size_t N, C, S;
+  const bool channel_last = BlitzChannelView(&(backward_input->shape()),
+    &N, &C, &S);
+  CHECK_EQ(forward_input_var->size(), C);
+  const size_t count = N * S;
+  vector<DType> beta_sum(C, 0), gamma_sum(C, 0);
+  ChannelReduce(BatchNormSumOp<DType>(backward_input->data(),
+    forward_input_hat->data(), NULL), backward_input->shape(),
+    &beta_sum[0], &gamma_sum[0]);
+  // output = gamma / sqrt(var + epsilon) *
+  // (dy - beta_update / count - hat * gamma_update / count)
+  vector<DType> scale(C), hat_scale(C), shift(C);
+  for (size_t c = 0; c < C; ++c) {
+    (*gamma_update)[c] += gamma_sum[c];
+    (*beta_update)[c] += beta_sum[c];
+    scale[c] = (*gamma)[c] / sqrt((*forward_input_var)[c] + epsilon);
+    hat_scale[c] = -scale[c] * (*gamma_update)[c] / count;
+    shift[c] = (*beta_update)[c] / count;
+  }
+  BatchNormChannelApply(backward_input->data(), forward_input_hat->data(),
+    output->data(), static_cast<DType*>(NULL), &scale[0], &hat_scale[0],
+    &shift[0], static_cast<const DType*>(NULL),
+    static_cast<const DType*>(NULL), N, C, S, channel_last);
+}
 
+template<typename DType>
+void Backend<CPUTensor, DType>::BatchNormScaleShiftFunc(
+  const CPUTensor<DType>* gamma,
+  const CPUTensor<DType>* beta,
+  const CPUTensor<DType>* running_mean,
+  const CPUTensor<DType>* running_var,
+  CPUTensor<DType>* scale,
+  CPUTensor<DType>* shift,
+  DType epsilon) {
+  CHECK_EQ(scale->size(), shift->size());
+  size_t N, C, S;
+  const bool channel_last = BlitzChannelView(&(scale->shape()),
+    &N, &C, &S);
+  CHECK_EQ(gamma->size(), C);
   #pragma omp parallel for
-  for (size_t i = 0; i < dim; ++i) {
-    for (size_t j = 0; j < num_sample; ++j) {
-      const size_t index = j * dim + i;
-      (*gamma_update)[i] += (*forward_input_hat)[index] *
-        (*backward_input)[index];
-      (*beta_update)[i] += (*backward_input)[index];
-    }
-
-    DType xhat;
-    for (size_t j = 0; j < num_sample; ++j) {
-      const size_t index = j * dim + i;
-      xhat = ((*forward_input_hat)[index] * (*gamma_update)[i] +
-        (*beta_update)[i]) / num_sample;
-      (*output)[index] = (*gamma)[i] * ((*backward_input)[index] -
-        xhat) / sqrt((*forward_input_var)[i] + epsilon);
-    }
+  for (size_t i = 0; i < scale->size(); ++i) {
+    const size_t c = channel_last ? i % C : (i / S) % C;
+    (*scale)[i] = (*gamma)[c] / sqrt((*running_var)[c] + epsilon);
+    (*shift)[i] = (*beta)[c] - (*running_mean)[c] * (*scale)[i];
   }
 }
 
+// at most one register of elements, the tail is padded
+template<typename DType>
+inline void GradientdescentAVX(DType* weight, DType* gradient,
+  DType* velocity, size_t size, DType momentum_coef, DType learning_rate,
+  DType decay, DType batch_size) {
+  BlitzAVXReg<DType> w, g, v, t, momentum_coef_reg, learning_rate_reg,
+    decay_reg, batch_size_reg;
+  BlitzAVXSet(momentum_coef, &momentum_coef_reg);
+  BlitzAVXSet(-learning_rate, &learning_rate_reg);
+  BlitzAVXSet(decay, &decay_reg);
+  BlitzAVXSet(batch_size, &batch_size_reg);
+  BlitzAVXLoadPartial(weight, size, static_cast<DType>(0), &w);
+  BlitzAVXLoadPartial(gradient, size, static_cast<DType>(0), &g);
+  BlitzAVXLoadPartial(velocity, size, static_cast<DType>(0), &v);
+  // g /= batch_size
+  BlitzAVXDiv(&g, &batch_size_reg, &g);
+  // v = v * momentum_coef - learning_rate * (g + decay * w)
+  BlitzAVXFma(&decay_reg, &w, &g, &t);
+  BlitzAVXMul(&learning_rate_reg, &t, &t);
+  BlitzAVXFma(&v, &momentum_coef_reg, &t, &v);
+  // w += v
+  BlitzAVXAdd(&w, &v, &w);
+  BlitzAVXStorePartial(gradient, size, &g);
+  BlitzAVXStorePartial(velocity, size, &v);
+  BlitzAVXStorePartial(weight, size, &w);
+}
+
 template<typename DType>
 void Backend<CPUTensor, DType>::GradientdescentFunc(
   CPUTensor<DType>* weight,
@@ -339,12 +791,199 @@ void Backend<CPUTensor, DType>::GradientdescentFunc(
   LOG(INFO) << "batch_size: " << batch_size;
 #endif
 
+  const size_t size = velocity->size();
+  const size_t width = BLITZ_AVX_WIDTH / sizeof(DType);
+  const size_t blocks = (size + width - 1) / width;
+  DType* weight_data = weight->data();
+  DType* gradient_data = gradient->data();
+  DType* velocity_data = velocity->data();
+
   #pragma omp parallel for
-  for (size_t i = 0; i < velocity->size(); ++i) {
-    (*gradient)[i] /= batch_size;
-    (*velocity)[i] = (*velocity)[i] * momentum_coef - learning_rate *
-      ((*gradient)[i] + decay * (*weight)[i]);
-    (*weight)[i] = (*weight)[i] + (*velocity)[i];
+  for (size_t i = 0; i < blocks; ++i) {
+    const size_t begin = i * width;
+    GradientdescentAVX(weight_data + begin, gradient_data + begin,
+      velocity_data + begin, std::min(width, size - begin),
+      momentum_coef, learning_rate, decay, static_cast<DType>(batch_size));
+  }
+}
+
+// g = gradient / batch_size + decay * weight
+template<typename DType>
+inline void OptimizerGradientAVX(const DType* weight, const DType* gradient,
+  size_t size, DType decay, DType batch_size, BlitzAVXReg<DType>* w,
+  BlitzAVXReg<DType>* g) {
+  BlitzAVXReg<DType> decay_reg, batch_size_reg;
+  BlitzAVXSet(decay, &decay_reg);
+  BlitzAVXSet(batch_size, &batch_size_reg);
+  BlitzAVXLoadPartial(weight, size, static_cast<DType>(0), w);
+  BlitzAVXLoadPartial(gradient, size, static_cast<DType>(0), g);
+  BlitzAVXDiv(g, &batch_size_reg, g);
+  BlitzAVXFma(&decay_reg, w, g, g);
+}
+
+template<typename DType>
+inline void NesterovAVX(DType* weight, const DType* gradient,
+  DType* velocity, size_t size, DType momentum_coef, DType learning_rate,
+  DType decay, DType batch_size) {
+  BlitzAVXReg<DType> w, g, v, v_next, momentum_coef_reg, learning_rate_reg;
+  BlitzAVXSet(momentum_coef, &momentum_coef_reg);
+  BlitzAVXSet(-learning_rate, &learning_rate_reg);
+  OptimizerGradientAVX(weight, gradient, size, decay, batch_size, &w, &g);
+  BlitzAVXLoadPartial(velocity, size, static_cast<DType>(0), &v);
+  // v' = v * momentum_coef - learning_rate * g
+  BlitzAVXMul(&learning_rate_reg, &g, &g);
+  BlitzAVXFma(&v, &momentum_coef_reg, &g, &v_next);
+  // w += v' + momentum_coef * (v' - v)
+  BlitzAVXSub(&v_next, &v, &v);
+  BlitzAVXFma(&momentum_coef_reg, &v, &v_next, &v);
+  BlitzAVXAdd(&w, &v, &w);
+  BlitzAVXStorePartial(velocity, size, &v_next);
+  BlitzAVXStorePartial(weight, size, &w);
+}
+
+template<typename DType>
+void Backend<CPUTensor, DType>::NesterovFunc(
+  CPUTensor<DType>* weight,
+  CPUTensor<DType>* gradient,
+  CPUTensor<DType>* velocity,
+  DType momentum_coef,
+  DType learning_rate,
+  DType decay,
+  size_t batch_size) {
+  CHECK_EQ(weight->size(), gradient->size());
+  CHECK_EQ(gradient->size(), velocity->size());
+  const size_t size = velocity->size();
+  const size_t width = BLITZ_AVX_WIDTH / sizeof(DType);
+  const size_t blocks = (size + width - 1) / width;
+  DType* weight_data = weight->data();
+  const DType* gradient_data = gradient->data();
+  DType* velocity_data = velocity->data();
+
+  #pragma omp parallel for
+  for (size_t i = 0; i < blocks; ++i) {
+    const size_t begin = i * width;
+    NesterovAVX(weight_data + begin, gradient_data + begin,
+      velocity_data + begin, std::min(width, size - begin),
+      momentum_coef, learning_rate, decay, static_cast<DType>(batch_size));
+  }
+}
+
+template<typename DType>
+inline void RMSPropAVX(DType* weight, const DType* gradient,
+  DType* mean_square, size_t size, DType rho, DType epsilon,
+  DType learning_rate, DType decay, DType batch_size) {
+  BlitzAVXReg<DType> w, g, s, t, rho_reg, one_minus_rho_reg, epsilon_reg,
+    learning_rate_reg;
+  BlitzAVXSet(rho, &rho_reg);
+  BlitzAVXSet(1 - rho, &one_minus_rho_reg);
+  BlitzAVXSet(epsilon, &epsilon_reg);
+  BlitzAVXSet(-learning_rate, &learning_rate_reg);
+  OptimizerGradientAVX(weight, gradient, size, decay, batch_size, &w, &g);
+  BlitzAVXLoadPartial(mean_square, size, static_cast<DType>(0), &s);
+  // s = rho * s + (1 - rho) * g^2
+  BlitzAVXMul(&g, &g, &t);
+  BlitzAVXMul(&one_minus_rho_reg, &t, &t);
+  BlitzAVXFma(&rho_reg, &s, &t, &s);
+  // w -= learning_rate * g / (sqrt(s) + epsilon)
+  BlitzAVXSqrt(&s, &t);
+  BlitzAVXAdd(&t, &epsilon_reg, &t);
+  BlitzAVXDiv(&g, &t, &t);
+  BlitzAVXFma(&learning_rate_reg, &t, &w, &w);
+  BlitzAVXStorePartial(mean_square, size, &s);
+  BlitzAVXStorePartial(weight, size, &w);
+}
+
+template<typename DType>
+void Backend<CPUTensor, DType>::RMSPropFunc(
+  CPUTensor<DType>* weight,
+  CPUTensor<DType>* gradient,
+  CPUTensor<DType>* mean_square,
+  DType rho,
+  DType epsilon,
+  DType learning_rate,
+  DType decay,
+  size_t batch_size) {
+  CHECK_EQ(weight->size(), gradient->size());
+  CHECK_EQ(gradient->size(), mean_square->size());
+  const size_t size = mean_square->size();
+  const size_t width = BLITZ_AVX_WIDTH / sizeof(DType);
+  const size_t blocks = (size + width - 1) / width;
+  DType* weight_data = weight->data();
+  const DType* gradient_data = gradient->data();
+  DType* mean_square_data = mean_square->data();
+
+  #pragma omp parallel for
+  for (size_t i = 0; i < blocks; ++i) {
+    const size_t begin = i * width;
+    RMSPropAVX(weight_data + begin, gradient_data + begin,
+      mean_square_data + begin, std::min(width, size - begin),
+      rho, epsilon, learning_rate, decay, static_cast<DType>(batch_size));
+  }
+}
+
+template<typename DType>
+inline void AdamAVX(DType* weight, const DType* gradient,
+  DType* first_moment, DType* second_moment, size_t size,
+  DType beta1, DType beta2, DType epsilon, DType learning_rate,
+  DType decay, DType batch_size) {
+  BlitzAVXReg<DType> w, g, m, v, t, beta1_reg, one_minus_beta1_reg,
+    beta2_reg, one_minus_beta2_reg, epsilon_reg, learning_rate_reg;
+  BlitzAVXSet(beta1, &beta1_reg);
+  BlitzAVXSet(1 - beta1, &one_minus_beta1_reg);
+  BlitzAVXSet(beta2, &beta2_reg);
+  BlitzAVXSet(1 - beta2, &one_minus_beta2_reg);
+  BlitzAVXSet(epsilon, &epsilon_reg);
+  BlitzAVXSet(-learning_rate, &learning_rate_reg);
+  OptimizerGradientAVX(weight, gradient, size, decay, batch_size, &w, &g);
+  BlitzAVXLoadPartial(first_moment, size, static_cast<DType>(0), &m);
+  BlitzAVXLoadPartial(second_moment, size, static_cast<DType>(0), &v);
+  // m = beta1 * m + (1 - beta1) * g
+  BlitzAVXMul(&one_minus_beta1_reg, &g, &t);
+  BlitzAVXFma(&beta1_reg, &m, &t, &m);
+  // v = beta2 * v + (1 - beta2) * g^2
+  BlitzAVXMul(&g, &g, &t);
+  BlitzAVXMul(&one_minus_beta2_reg, &t, &t);
+  BlitzAVXFma(&beta2_reg, &v, &t, &v);
+  // w -= learning_rate * m / (sqrt(v) + epsilon)
+  BlitzAVXSqrt(&v, &t);
+  BlitzAVXAdd(&t, &epsilon_reg, &t);
+  BlitzAVXDiv(&m, &t, &t);
+  BlitzAVXFma(&learning_rate_reg, &t, &w, &w);
+  BlitzAVXStorePartial(first_moment, size, &m);
+  BlitzAVXStorePartial(second_moment, size, &v);
+  BlitzAVXStorePartial(weight, size, &w);
+}
+
+template<typename DType>
+void Backend<CPUTensor, DType>::AdamFunc(
+  CPUTensor<DType>* weight,
+  CPUTensor<DType>* gradient,
+  CPUTensor<DType>* first_moment,
+  CPUTensor<DType>* second_moment,
+  DType beta1,
+  DType beta2,
+  DType epsilon,
+  DType learning_rate,
+  DType decay,
+  size_t batch_size) {
+  CHECK_EQ(weight->size(), gradient->size());
+  CHECK_EQ(gradient->size(), first_moment->size());
+  CHECK_EQ(first_moment->size(), second_moment->size());
+  const size_t size = first_moment->size();
+  const size_t width = BLITZ_AVX_WIDTH / sizeof(DType);
+  const size_t blocks = (size + width - 1) / width;
+  DType* weight_data = weight->data();
+  const DType* gradient_data = gradient->data();
+  DType* first_moment_data = first_moment->data();
+  DType* second_moment_data = second_moment->data();
+
+  #pragma omp parallel for
+  for (size_t i = 0; i < blocks; ++i) {
+    const size_t begin = i * width;
+    AdamAVX(weight_data + begin, gradient_data + begin,
+      first_moment_data + begin, second_moment_data + begin,
+      std::min(width, size - begin), beta1, beta2, epsilon,
+      learning_rate, decay, static_cast<DType>(batch_size));
   }
 }
 
@@ -376,21 +1015,6 @@ void Backend<CPUTensor, DType>::MatrixMultiplyFunc(
     dim_left, dim_right, dim_common_left);
 }
 
-template<typename DType>
-void Backend<CPUTensor, DType>::Transpose2DFunc(
-  const CPUTensor<DType>* input, CPUTensor<DType>* output) {
-  size_t dim_left = input->shape()[0];
-  size_t dim_right = input->shape()[1];
-  CHECK_EQ(dim_left, output->shape()[1]);
-  CHECK_EQ(dim_right, output->shape()[0]);
-  #pragma omp parallel for collapse(2)
-  for (size_t i = 0; i < dim_left; ++i) {
-    for (size_t j = 0; j < dim_right; ++j) {
-      (*output)[j * dim_left + i] = (*input)[i * dim_right + j];
-    }
-  }
-}
-
 template<typename DType>
 void Backend<CPUTensor, DType>::MaximumFunc(
   const CPUTensor<DType>* left, const CPUTensor<DType>* right,
@@ -419,11 +1043,7 @@ void Backend<CPUTensor, DType>::MinusFunc(
 template<typename DType>
 DType Backend<CPUTensor, DType>::SumFunc(
   const CPUTensor<DType>* input) {
-  DType output = 0;
-  for (size_t i = 0; i < input->size(); ++i) {
-    output += (*input)[i];
-  }
-  return output;
+  return BlitzReduceSum(input->data(), input->size());
 }
 
 template<typename DType>
@@ -467,15 +1087,23 @@ void Backend<CPUTensor, DType>::MakeBinaryMaskFunc(
   CPUTensor<DType>* output,
   DType low,
   DType high,
-  DType keep) { 
-  UniformDistributionFunc(output, low, high);
-
+  DType keep) {
+  const uint64_t seed = BlitzRandomSeed();
+  const uint64_t stream = BlitzRandomNextStream();
+  const size_t size = output->size();
+  const size_t block_size = BlitzRandomBlock<DType>::size();
+  const size_t blocks = (size + block_size - 1) / block_size;
+  DType* data = output->data();
+
+  // draw and threshold in the same pass
   #pragma omp parallel for
-  for (size_t i = 0; i < output->size(); ++i) {
-    if ((*output)[i] < keep) {
-      (*output)[i] = DType(1);
-    } else {
-      (*output)[i] = DType(0);
+  for (size_t i = 0; i < blocks; ++i) {
+    DType value[4];
+    BlitzRandomUniform(seed, stream, i, low, high, value);
+    const size_t begin = i * block_size;
+    const size_t end = std::min(begin + block_size, size);
+    for (size_t j = begin; j < end; ++j) {
+      data[j] = value[j - begin] < keep ? DType(1) : DType(0);
     }
   }
 }
@@ -489,34 +1117,44 @@ void Backend<CPUTensor, DType>::ConstantDistributionFunc(
 template<typename DType>
 void Backend<CPUTensor, DType>::NormalDistributionFunc(
   CPUTensor<DType>* output, DType loc, DType scale) {
-  // TODO(keren) synchronized seed
-  static unsigned int seed = 0;
-  boost::mt19937 rng((++seed) + time(NULL));
-  boost::normal_distribution<DType> nd(loc, scale);  // convert to DType
-  boost::variate_generator<boost::mt19937&,
-    boost::normal_distribution<DType> > var_nor(rng, nd);
-  var_nor.distribution().reset();
+  const uint64_t seed = BlitzRandomSeed();
+  const uint64_t stream = BlitzRandomNextStream();
+  const size_t size = output->size();
+  const size_t block_size = BlitzRandomBlock<DType>::size();
+  const size_t blocks = (size + block_size - 1) / block_size;
+  DType* data = output->data();
 
-  size_t size = output->size();
-  for (size_t i = 0; i < size; ++i) {
-    (*output)[i] = var_nor();
+  #pragma omp parallel for
+  for (size_t i = 0; i < blocks; ++i) {
+    DType value[4];
+    BlitzRandomNormal(seed, stream, i, loc, scale, value);
+    const size_t begin = i * block_size;
+    const size_t end = std::min(begin + block_size, size);
+    for (size_t j = begin; j < end; ++j) {
+      data[j] = value[j - begin];
+    }
   }
 }
 
 template<typename DType>
 void Backend<CPUTensor, DType>::UniformDistributionFunc(
   CPUTensor<DType>* output, DType low, DType high) {
-  // TODO(keren) synchronized seed
-  static unsigned int seed = 0;
-  boost::mt19937 rng((++seed) + time(NULL));
-  boost::uniform_real<DType> ur(low, high);  // convert to DType
-  boost::variate_generator<boost::mt19937&,
-    boost::uniform_real<DType> > var_uni(rng, ur);
-  var_uni.distribution().reset();
+  const uint64_t seed = BlitzRandomSeed();
+  const uint64_t stream = BlitzRandomNextStream();
+  const size_t size = output->size();
+  const size_t block_size = BlitzRandomBlock<DType>::size();
+  const size_t blocks = (size + block_size - 1) / block_size;
+  DType* data = output->data();
 
-  size_t size = output->size();
-  for (size_t i = 0; i < size; ++i) {
-    (*output)[i] = var_uni();
+  #pragma omp parallel for
+  for (size_t i = 0; i < blocks; ++i) {
+    DType value[4];
+    BlitzRandomUniform(seed, stream, i, low, high, value);
+    const size_t begin = i * block_size;
+    const size_t end = std::min(begin + block_size, size);
+    for (size_t j = begin; j < end; ++j) {
+      data[j] = value[j - begin];
+    }
   }
 }
 
@@ -526,6 +1164,12 @@ void Backend<CPUTensor, DType>::HostCopyToFunc(
   BlitzCPUCopy(source, target, size);
 }
 
+template<typename DType>
+void Backend<CPUTensor, DType>::HostCopyFromFunc(
+  const DType* source, DType* target, size_t size) {
+  BlitzCPUCopy(source, target, size);
+}
+
 template<typename DType>
 float Backend<CPUTensor, DType>::EvaluateClassifyFunc(
   const CPUTensor<DType>* output, const CPUTensor<DType>* target) {
@@ -30,18 +30,9 @@ void Backend<CPUTensor, DType>::Convolution2DForwardFunc(
   const size_t PQ = P * Q;
   const size_t KPQ = K * PQ;
   const size_t CRS = C * R * S;
-  // time counter
-  #ifdef BLITZ_PERFORMANCE
-  time_point<system_clock> start, end;
-  duration<float> unpack_time[BLITZ_NUM_THREADS];
-  duration<float> gemm_time[BLITZ_NUM_THREADS];
-  for (size_t i = 0; i < BLITZ_NUM_THREADS; ++i) {
-    unpack_time[i] = duration<float>::zero();
-    gemm_time[i] = duration<float>::zero();
-  }
-  float total_unpack_time = 0.0;
-  float total_gemm_time = 0.0;
-  #endif  // BLITZ_PERFORMANCE
+  // per thread stage times, only taken when the profiler is on
+  double unpack_time[BLITZ_NUM_THREADS] = {0};
+  double gemm_time[BLITZ_NUM_THREADS] = {0};
   switch (algorithm) { // NCHW & NHWC
     case BLITZ_CONVOLUTION_BLAS_GEMM_BATCH: {
       #pragma omp parallel private(nCHW, nKPQ)
@@ -49,17 +40,11 @@ void Backend<CPUTensor, DType>::Convolution2DForwardFunc(
         const size_t tid = omp_get_thread_num();
         const size_t workspace_unpack_offset = tid * CRS * PQ;
         DType* workspace_unpack_slice = workspace->Slice(workspace_unpack_offset);
-        #ifdef BLITZ_PERFORMANCE
-          #pragma omp for private(start, end)
-        #else
-          #pragma omp for
-        #endif
+        #pragma omp for
         for (size_t n = 0; n < NIN; ++n) {
           nCHW = n * CHW;
           nKPQ = n * KPQ;
-          #ifdef BLITZ_PERFORMANCE
-          start = system_clock::now();
-          #endif  // BLITZ_PERFORMANCE
+          time_point<system_clock> start = BlitzProfilerNow();
           BLITZ_DATA_LAYOUT unpack_data_layout = Unpack2DFunc(
             input->Slice(nCHW),
             workspace_unpack_slice,
@@ -69,11 +54,7 @@ void Backend<CPUTensor, DType>::Convolution2DForwardFunc(
             padding_height, padding_width,
             stride_height, stride_width,
             input->data_layout());
-          #ifdef BLITZ_PERFORMANCE
-          end = system_clock::now();
-          unpack_time[tid] += end -start;
-          start = system_clock::now();
-          #endif  // BLITZ_PERFORMANCE
+          unpack_time[tid] += BlitzProfilerLap(&start);
           Convolution2DForwardGEMMDispatch(workspace_unpack_slice,
             output->Slice(nKPQ),
             const_cast<CPUTensor<DType>*>(filter)->data(),
@@ -81,29 +62,18 @@ void Backend<CPUTensor, DType>::Convolution2DForwardFunc(
             unpack_data_layout,
             output->data_layout(),
             filter->data_layout());
-          #ifdef BLITZ_PERFORMANCE
-          end = system_clock::now();
-          gemm_time[tid] += end - start;
-          #endif  // BLITZ_PERFORMANCE
+          gemm_time[tid] += BlitzProfilerLap(&start);
         }
       }
-      #ifdef BLITZ_PERFORMANCE
-      for (size_t i = 0; i < BLITZ_NUM_THREADS; ++i) {
-        total_unpack_time += unpack_time[i].count();
-        total_gemm_time += gemm_time[i].count();
-      }
-      total_unpack_time /= BLITZ_NUM_THREADS;
-      total_gemm_time /= BLITZ_NUM_THREADS;
-      #endif
+      BlitzProfilerThreadStage("unpack", unpack_time, BLITZ_NUM_THREADS);
+      BlitzProfilerThreadStage("gemm", gemm_time, BLITZ_NUM_THREADS);
       break;
     }
     case BLITZ_CONVOLUTION_BLAS_GEMM: {
       for (size_t n = 0; n < NIN; ++n) {
         nCHW = n * CHW;
         nKPQ = n * KPQ;
-        #ifdef BLITZ_PERFORMANCE
-        start = system_clock::now();
-        #endif
+        time_point<system_clock> start = BlitzProfilerNow();
         BLITZ_DATA_LAYOUT unpack_data_layout = Unpack2DFunc(
 	  input->Slice(nCHW),
           workspace->data(),
@@ -113,11 +83,7 @@ void Backend<CPUTensor, DType>::Convolution2DForwardFunc(
           padding_height, padding_width,
           stride_height, stride_width,
           input->data_layout());
-        #ifdef BLITZ_PERFORMANCE
-        end = system_clock::now();
-        unpack_time[0] += end - start;
-        start = system_clock::now();
-        #endif
+        unpack_time[0] += BlitzProfilerLap(&start);
         Convolution2DForwardGEMMDispatch(workspace->data(),
           output->Slice(nKPQ),
           const_cast<CPUTensor<DType>*>(filter)->data(),
@@ -125,12 +91,78 @@ void Backend<CPUTensor, DType>::Convolution2DForwardFunc(
           unpack_data_layout,
           output->data_layout(),
           filter->data_layout());
-        #ifdef BLITZ_PERFORMANCE
-        end = system_clock::now();
-        gemm_time[0] += end - start;
-        total_unpack_time = unpack_time[0].count();
-        total_gemm_time = gemm_time[0].count();
-        #endif
+        gemm_time[0] += BlitzProfilerLap(&start);
+      }
+      BlitzProfilerStage("unpack", unpack_time[0]);
+      BlitzProfilerStage("gemm", gemm_time[0]);
+      break;
+    }
+    case BLITZ_CONVOLUTION_DIRECT: {
+      BlitzProfileStageTimer stage("gemm");
+      if (input->data_layout() == BLITZ_BUFFER_NCHW &&
+        filter->data_layout() == BLITZ_FILTER_KCRS &&
+        output->data_layout() == BLITZ_BUFFER_NCHW) {
+        #pragma omp parallel for collapse(2)
+        for (size_t n = 0; n < NIN; ++n) {
+          for (size_t k = 0; k < K; ++k) {
+            ConvolutionDirectForwardImpl(
+              input->Slice(n * CHW),
+              filter->Slice(k * CRS),
+              output->Slice(n * KPQ + k * PQ),
+              C, H, W,
+              R, S,
+              P, Q,
+              padding_height, padding_width,
+              stride_height, stride_width);
+          }
+        }
+      } else if (input->data_layout() == BLITZ_BUFFER_NHWC &&
+        filter->data_layout() == BLITZ_FILTER_RSCK &&
+        output->data_layout() == BLITZ_BUFFER_NHWC) {
+        #pragma omp parallel for collapse(2)
+        for (size_t n = 0; n < NIN; ++n) {
+          for (size_t p = 0; p < P; ++p) {
+            ConvolutionDirectForwardHWCImpl(
+              input->Slice(n * CHW),
+              filter->data(),
+              output->Slice(n * KPQ + p * Q * K),
+              C, K,
+              H, W,
+              R, S,
+              P, Q,
+              padding_height, padding_width,
+              stride_height, stride_width,
+              p);
+          }
+        }
+      } else {
+        LOG(FATAL) << "Unsupported layout for direct convolution: " <<
+          input->data_layout() << " " << filter->data_layout() << " " <<
+          output->data_layout();
+      }
+      break;
+    }
+    case BLITZ_CONVOLUTION_WINOGRAD: {
+      if (R == 3 && S == 3 && stride_height == 1 && stride_width == 1 &&
+        input->data_layout() == BLITZ_BUFFER_NCHW &&
+        filter->data_layout() == BLITZ_FILTER_KCRS &&
+        output->data_layout() == BLITZ_BUFFER_NCHW) {
+        BlitzProfileStageTimer stage("gemm");
+        ConvolutionWinogradImpl(
+          const_cast<CPUTensor<DType>*>(input)->data(),
+          const_cast<CPUTensor<DType>*>(filter)->data(),
+          output->data(),
+          workspace->data(),
+          NIN, C, H, W,
+          K, P, Q,
+          padding_height, padding_width,
+          false);
+      } else {
+        // the transform only handles 3x3 stride 1 filters
+        Convolution2DForwardFunc(input, filter, output, workspace,
+          padding_height, padding_width,
+          stride_height, stride_width,
+          BLITZ_CONVOLUTION_BLAS_GEMM);
       }
       break;
     }
@@ -138,10 +170,6 @@ void Backend<CPUTensor, DType>::Convolution2DForwardFunc(
       LOG(FATAL) << "Unsupported algorithm type: " << algorithm;
       break;
   }
-  #ifdef BLITZ_PERFORMANCE
-  LOG(INFO) << "Forward convolution compute: " << total_gemm_time;
-  LOG(INFO) << "Forward convolution transform: " << total_unpack_time;
-  #endif  // BLITZ_PERFORMANCE
 }
 
 template<typename DType>
@@ -174,35 +202,20 @@ void Backend<CPUTensor, DType>::Convolution2DBackwardFunc(
   size_t nCHW = 0;
   size_t nKPQ = 0;
   input->Fill(0);
-  // time counter
-  #ifdef BLITZ_PERFORMANCE
-  time_point<system_clock> start, end;
-  duration<float> pack_time[BLITZ_NUM_THREADS];
-  duration<float> gemm_time[BLITZ_NUM_THREADS];
-  for (size_t i = 0; i < BLITZ_NUM_THREADS; ++i) {
-    pack_time[i] = duration<float>::zero();
-    gemm_time[i] = duration<float>::zero();
-  }
-  float total_pack_time = 0.0;
-  float total_gemm_time = 0.0;
-  #endif  // BLITZ_PERFORMANCE
+  // per thread stage times, only taken when the profiler is on
+  double pack_time[BLITZ_NUM_THREADS] = {0};
+  double gemm_time[BLITZ_NUM_THREADS] = {0};
   switch (algorithm) {
     case BLITZ_CONVOLUTION_BLAS_GEMM_BATCH: {
       #pragma omp parallel private(nCHW, nKPQ) 
       {
         const size_t tid = omp_get_thread_num();
         const size_t workspace_unpack_offset = tid * CRS * PQ;
-        #ifdef BLITZ_PERFORMANCE
-          #pragma omp for private(start, end)
-        #else
-          #pragma omp for
-        #endif
+        #pragma omp for
         for (size_t n = 0; n < NIN; ++n) {
           nCHW = n * CHW;
           nKPQ = n * KPQ;
-          #ifdef BLITZ_PERFORMANCE
-          start = system_clock::now();
-          #endif  // BLITZ_PERFORMANCE
+          time_point<system_clock> start = BlitzProfilerNow();
           // gemm generate
           // (input_channel * filter_height * filter_width)
           // (output_width * output_height) *
@@ -212,11 +225,7 @@ void Backend<CPUTensor, DType>::Convolution2DBackwardFunc(
             true, false,
             static_cast<DType>(1), static_cast<DType>(0),
             CRS, PQ, K);
-          #ifdef BLITZ_PERFORMANCE
-          end = system_clock::now();
-          gemm_time[tid] += end - start;
-          start = system_clock::now();
-          #endif  // BLITZ_PERFORMANCE
+          gemm_time[tid] += BlitzProfilerLap(&start);
           // pack
           // (input_channel * filter_height * filter_width) *
           // (output_width * output_height)
@@ -230,29 +239,18 @@ void Backend<CPUTensor, DType>::Convolution2DBackwardFunc(
             P, Q,
             padding_height, padding_width,
             stride_height, stride_width);
-          #ifdef BLITZ_PERFORMANCE
-          end = system_clock::now();
-          pack_time[tid] += end - start;
-          #endif  // BLITZ_PERFORMANCE
+          pack_time[tid] += BlitzProfilerLap(&start);
         }
-        #ifdef BLITZ_PERFORMANCE
-        for (size_t i = 0; i < BLITZ_NUM_THREADS; ++i) {
-          total_pack_time += pack_time[i].count();
-          total_gemm_time += gemm_time[i].count();
-        }
-        total_pack_time /= BLITZ_NUM_THREADS;
-        total_gemm_time /= BLITZ_NUM_THREADS;
-        #endif
       }
+      BlitzProfilerThreadStage("gemm", gemm_time, BLITZ_NUM_THREADS);
+      BlitzProfilerThreadStage("pack", pack_time, BLITZ_NUM_THREADS);
       break;
     }
     case BLITZ_CONVOLUTION_BLAS_GEMM: {
       for (size_t n = 0; n < NIN; ++n) {
         nCHW = n * CHW;
         nKPQ = n * KPQ;
-        #ifdef BLITZ_PERFORMANCE
-        start = system_clock::now();
-        #endif
+        time_point<system_clock> start = BlitzProfilerNow();
         // gemm generate
         // (input_channel * filter_height * filter_width)
         // (output_width * output_height) *
@@ -262,11 +260,7 @@ void Backend<CPUTensor, DType>::Convolution2DBackwardFunc(
           true, false,
           static_cast<DType>(1), static_cast<DType>(0),
           CRS, PQ, K);
-        #ifdef BLITZ_PERFORMANCE
-        end = system_clock::now();
-        gemm_time[0] += end - start;
-        start = system_clock::now();
-        #endif
+        gemm_time[0] += BlitzProfilerLap(&start);
         // pack
         // (input_channel * filter_height * filter_width)
         // (output_width * output_height)
@@ -280,12 +274,77 @@ void Backend<CPUTensor, DType>::Convolution2DBackwardFunc(
           P, Q,
           padding_height, padding_width,
           stride_height, stride_width);
-        #ifdef BLITZ_PERFORMANCE
-        end = system_clock::now();
-        pack_time[0] += end - start;
-        total_pack_time = pack_time[0].count();
-        total_gemm_time = gemm_time[0].count();
-        #endif
+        pack_time[0] += BlitzProfilerLap(&start);
+      }
+      BlitzProfilerStage("gemm", gemm_time[0]);
+      BlitzProfilerStage("pack", pack_time[0]);
+      break;
+    }
+    case BLITZ_CONVOLUTION_DIRECT: {
+      BlitzProfileStageTimer stage("gemm");
+      if (input->data_layout() == BLITZ_BUFFER_NCHW &&
+        filter->data_layout() == BLITZ_FILTER_KCRS &&
+        output->data_layout() == BLITZ_BUFFER_NCHW) {
+        #pragma omp parallel for collapse(2)
+        for (size_t n = 0; n < NIN; ++n) {
+          for (size_t c = 0; c < C; ++c) {
+            ConvolutionDirectBackwardImpl(
+              output->Slice(n * KPQ),
+              filter->Slice(c * R * S),
+              input->Slice(n * CHW + c * H * W),
+              C, K,
+              H, W,
+              R, S,
+              P, Q,
+              padding_height, padding_width,
+              stride_height, stride_width);
+          }
+        }
+      } else if (input->data_layout() == BLITZ_BUFFER_NHWC &&
+        filter->data_layout() == BLITZ_FILTER_RSCK &&
+        output->data_layout() == BLITZ_BUFFER_NHWC) {
+        #pragma omp parallel for
+        for (size_t n = 0; n < NIN; ++n) {
+          ConvolutionDirectBackwardHWCImpl(
+            output->Slice(n * KPQ),
+            filter->data(),
+            input->Slice(n * CHW),
+            C, K,
+            H, W,
+            R, S,
+            P, Q,
+            padding_height, padding_width,
+            stride_height, stride_width);
+        }
+      } else {
+        LOG(FATAL) << "Unsupported layout for direct convolution: " <<
+          input->data_layout() << " " << filter->data_layout() << " " <<
+          output->data_layout();
+      }
+      break;
+    }
+    case BLITZ_CONVOLUTION_WINOGRAD: {
+      if (R == 3 && S == 3 && stride_height == 1 && stride_width == 1 &&
+        padding_height <= 2 && padding_width <= 2 &&
+        input->data_layout() == BLITZ_BUFFER_NCHW &&
+        filter->data_layout() == BLITZ_FILTER_KCRS &&
+        output->data_layout() == BLITZ_BUFFER_NCHW) {
+        BlitzProfileStageTimer stage("gemm");
+        // full convolution of output with the rotated filter
+        ConvolutionWinogradImpl(
+          const_cast<CPUTensor<DType>*>(output)->data(),
+          const_cast<CPUTensor<DType>*>(filter)->data(),
+          input->data(),
+          workspace->data(),
+          NIN, K, P, Q,
+          C, H, W,
+          2 - padding_height, 2 - padding_width,
+          true);
+      } else {
+        Convolution2DBackwardFunc(output, filter, input, workspace,
+          padding_height, padding_width,
+          stride_height, stride_width,
+          BLITZ_CONVOLUTION_BLAS_GEMM);
       }
       break;
     }
@@ -293,10 +352,6 @@ void Backend<CPUTensor, DType>::Convolution2DBackwardFunc(
       LOG(FATAL) << "Unsupported algorithm type: " << algorithm;
       break;
   }
-  #ifdef BLITZ_PERFORMANCE
-  LOG(INFO) << "Backward convolution compute: " << total_gemm_time;
-  LOG(INFO) << "Backward convolution transform: " << total_pack_time;
-  #endif  // BLITZ_PERFORMANCE
 }
 
 template<typename DType>
@@ -329,17 +384,9 @@ void Backend<CPUTensor, DType>::Convolution2DUpdateFunc(
   size_t nCHW = 0;
   size_t nKPQ = 0;
   workspace->Fill(0);
-  #ifdef BLITZ_PERFORMANCE
-  time_point<system_clock> start, end;
-  duration<float> unpack_time[BLITZ_NUM_THREADS];
-  duration<float> gemm_time[BLITZ_NUM_THREADS];
-  for (size_t i = 0; i < BLITZ_NUM_THREADS; ++i) {
-    unpack_time[i] = duration<float>::zero();
-    gemm_time[i] = duration<float>::zero();
-  }
-  float total_unpack_time = 0.0;
-  float total_gemm_time = 0.0;
-  #endif  // BLITZ_PERFORMANCE
+  // per thread stage times, only taken when the profiler is on
+  double unpack_time[BLITZ_NUM_THREADS] = {0};
+  double gemm_time[BLITZ_NUM_THREADS] = {0};
   switch (algorithm) {
     case BLITZ_CONVOLUTION_BLAS_GEMM_BATCH: {
       #pragma omp parallel private(nCHW, nKPQ)
@@ -349,17 +396,11 @@ void Backend<CPUTensor, DType>::Convolution2DUpdateFunc(
         const size_t workspace_update_size = K * CRS;
         const size_t workspace_unpack_offset = tid * (workspace_unpack_size + workspace_update_size);
         const size_t workspace_update_offset = workspace_unpack_offset + workspace_unpack_size;
-        #ifdef BLITZ_PERFORMANCE
-          #pragma omp for private(start, end)
-        #else
-          #pragma omp for
-        #endif
+        #pragma omp for
         for (size_t n = 0; n < NIN; ++n) {
           nCHW = n * CHW;
           nKPQ = n * KPQ;
-          #ifdef BLITZ_PERFORMANCE
-          start = system_clock::now();
-          #endif  // BLITZ_PERFORMANCE
+          time_point<system_clock> start = BlitzProfilerNow();
           // unpack
           // (input_channel) *
           // (input_width * input_height)
@@ -374,11 +415,7 @@ void Backend<CPUTensor, DType>::Convolution2DUpdateFunc(
             padding_height, padding_width,
             stride_height, stride_width,
             input->data_layout());
-          #ifdef BLITZ_PERFORMANCE
-          end = system_clock::now();
-          unpack_time[tid] += end - start;
-          start = system_clock::now();
-          #endif  // BLITZ_PERFORMANCE
+          unpack_time[tid] += BlitzProfilerLap(&start);
           Convolution2DUpdateGEMMDispatch(
             workspace->Slice(workspace_unpack_offset),
             const_cast<CPUTensor<DType>*>(output)->Slice(nKPQ),
@@ -387,33 +424,37 @@ void Backend<CPUTensor, DType>::Convolution2DUpdateFunc(
             unpack_data_layout,
             output->data_layout(),
             update->data_layout());
-          #ifdef BLITZ_PERFORMANCE
-          end = system_clock::now();
-          gemm_time[tid] += end - start;
-          #endif  // BLITZ_PERFORMANCE
+          gemm_time[tid] += BlitzProfilerLap(&start);
         }
-        for (size_t i = 0; i < update->size(); ++i) {
-          #pragma omp atomic
-          (*update)[i] += *(workspace->Slice(workspace_update_offset + i));
+        // partitioned reduction: after the implicit barrier every thread
+        // sums its own cache-aligned slice of update over all private copies
+        const size_t num_threads = omp_get_num_threads();
+        const size_t update_size = update->size();
+        const size_t update_align = BLITZ_ALIGNMENT_SIZE / sizeof(DType);
+        const size_t update_slice = (update_size + num_threads * update_align - 1) /
+          (num_threads * update_align) * update_align;
+        const size_t update_begin = std::min(tid * update_slice, update_size);
+        const size_t update_end = std::min(update_begin + update_slice, update_size);
+        DType* update_data = update->data();
+        for (size_t t = 0; t < num_threads; ++t) {
+          const DType* workspace_update_slice = workspace->Slice(
+            t * (workspace_unpack_size + workspace_update_size) +
+            workspace_unpack_size);
+          #pragma simd
+          for (size_t i = update_begin; i < update_end; ++i) {
+            update_data[i] += workspace_update_slice[i];
+          }
         }
-        #ifdef BLITZ_PERFORMANCE
-        for (size_t i = 0; i < BLITZ_NUM_THREADS; ++i) {
-          total_unpack_time += unpack_time[i].count();
-          total_gemm_time += gemm_time[i].count();
-        }
-        total_unpack_time /= BLITZ_NUM_THREADS;
-        total_gemm_time /= BLITZ_NUM_THREADS;
-        #endif
       }
+      BlitzProfilerThreadStage("unpack", unpack_time, BLITZ_NUM_THREADS);
+      BlitzProfilerThreadStage("gemm", gemm_time, BLITZ_NUM_THREADS);
       break;
     }
     case BLITZ_CONVOLUTION_BLAS_GEMM: {
       for (size_t n = 0; n < NIN; ++n) {
         nCHW = n * CHW;
         nKPQ = n * KPQ;
-        #ifdef BLITZ_PERFORMANCE
-        start = system_clock::now();
-        #endif
+        time_point<system_clock> start = BlitzProfilerNow();
         // unpack
         // (input_channel) *
         // (input_width * input_height)
@@ -428,11 +469,7 @@ void Backend<CPUTensor, DType>::Convolution2DUpdateFunc(
           padding_height, padding_width,
           stride_height, stride_width,
           input->data_layout());
-        #ifdef BLITZ_PERFORMANCE
-        end = system_clock::now();
-        unpack_time[0] += end - start;
-        start = system_clock::now();
-        #endif
+        unpack_time[0] += BlitzProfilerLap(&start);
         Convolution2DUpdateGEMMDispatch(
           workspace->data(),
           const_cast<CPUTensor<DType>*>(output)->Slice(nKPQ),
@@ -441,23 +478,70 @@ void Backend<CPUTensor, DType>::Convolution2DUpdateFunc(
           unpack_data_layout,
           output->data_layout(),
           update->data_layout());
-        #ifdef BLITZ_PERFORMANCE
-        end = system_clock::now();
-        gemm_time[0] += end - start;
-        total_gemm_time = gemm_time[0].count();
-        total_unpack_time = unpack_time[0].count();
-        #endif
+        gemm_time[0] += BlitzProfilerLap(&start);
       }
+      BlitzProfilerStage("unpack", unpack_time[0]);
+      BlitzProfilerStage("gemm", gemm_time[0]);
+      break;
+    }
+    case BLITZ_CONVOLUTION_DIRECT: {
+      BlitzProfileStageTimer stage("gemm");
+      // every thread owns a disjoint part of update, no reduction needed
+      if (input->data_layout() == BLITZ_BUFFER_NCHW &&
+        update->data_layout() == BLITZ_FILTER_KCRS &&
+        output->data_layout() == BLITZ_BUFFER_NCHW) {
+        #pragma omp parallel for collapse(2)
+        for (size_t k = 0; k < K; ++k) {
+          for (size_t c = 0; c < C; ++c) {
+            ConvolutionDirectUpdateImpl(
+              input->Slice(c * H * W),
+              output->Slice(k * PQ),
+              update->Slice(k * CRS + c * R * S),
+              NIN, C, K,
+              H, W,
+              R, S,
+              P, Q,
+              padding_height, padding_width,
+              stride_height, stride_width);
+          }
+        }
+      } else if (input->data_layout() == BLITZ_BUFFER_NHWC &&
+        update->data_layout() == BLITZ_FILTER_RSCK &&
+        output->data_layout() == BLITZ_BUFFER_NHWC) {
+        #pragma omp parallel for collapse(2)
+        for (size_t r = 0; r < R; ++r) {
+          for (size_t s = 0; s < S; ++s) {
+            ConvolutionDirectUpdateHWCImpl(
+              input->data(),
+              output->data(),
+              update->Slice((r * S + s) * C * K),
+              NIN, C, K,
+              H, W,
+              P, Q,
+              padding_height, padding_width,
+              stride_height, stride_width,
+              r, s);
+          }
+        }
+      } else {
+        LOG(FATAL) << "Unsupported layout for direct convolution: " <<
+          input->data_layout() << " " << update->data_layout() << " " <<
+          output->data_layout();
+      }
+      break;
+    }
+    case BLITZ_CONVOLUTION_WINOGRAD: {
+      // weight update stays on the unpack path
+      Convolution2DUpdateFunc(input, output, update, workspace,
+        padding_height, padding_width,
+        stride_height, stride_width,
+        BLITZ_CONVOLUTION_BLAS_GEMM);
       break;
     }
     default:
       LOG(FATAL) << "Unsupported algorithm type: " << algorithm;
       break;
   }
-  #ifdef BLITZ_PERFORMANCE
-  LOG(INFO) << "Backward convolution update compute: " << total_gemm_time;
-  LOG(INFO) << "Backward convolution update transform: " << total_unpack_time;
-  #endif  // BLITZ_PERFORMANCE
 }
 
 #endif  // SRC_BACKENDS_CPU_BACKEND_CONV_INL_H_
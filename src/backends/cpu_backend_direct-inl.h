@@ -0,0 +1,320 @@
+#ifndef SRC_BACKENDS_CPU_BACKEND_DIRECT_INL_H_
+#define SRC_BACKENDS_CPU_BACKEND_DIRECT_INL_H_
+
+// output indices [begin, end) whose input coordinate
+// index * stride + filter_index - padding lies inside [0, input_extent)
+inline void ConvolutionDirectValidRange(
+  size_t filter_index,
+  size_t padding,
+  size_t stride,
+  size_t input_extent,
+  size_t output_extent,
+  size_t* begin,
+  size_t* end) {
+  if (filter_index >= padding) {
+    *begin = 0;
+  } else {
+    *begin = (padding - filter_index + stride - 1) / stride;
+  }
+  if (input_extent + padding <= filter_index) {
+    *end = 0;
+  } else {
+    *end = std::min(output_extent,
+      (input_extent + padding - filter_index - 1) / stride + 1);
+  }
+  if (*begin > *end) {
+    *begin = *end;
+  }
+}
+
+// NCHW input, KCRS filter, NCHW output, one image and one output channel
+template<typename DType>
+void ConvolutionDirectForwardImpl(
+  const DType* input,
+  const DType* filter,
+  DType* output,
+  size_t channel,
+  size_t input_height,
+  size_t input_width,
+  size_t filter_height,
+  size_t filter_width,
+  size_t output_height,
+  size_t output_width,
+  size_t padding_height,
+  size_t padding_width,
+  size_t stride_height,
+  size_t stride_width) {
+  const size_t HW = input_height * input_width;
+  const size_t RS = filter_height * filter_width;
+  for (size_t i = 0; i < output_height * output_width; ++i) {
+    output[i] = 0;
+  }
+  for (size_t c = 0; c < channel; ++c) {
+    const DType* input_slice = input + c * HW;
+    const DType* filter_slice = filter + c * RS;
+    for (size_t r = 0; r < filter_height; ++r) {
+      size_t p_begin, p_end;
+      ConvolutionDirectValidRange(r, padding_height, stride_height,
+        input_height, output_height, &p_begin, &p_end);
+      for (size_t s = 0; s < filter_width; ++s) {
+        size_t q_begin, q_end;
+        ConvolutionDirectValidRange(s, padding_width, stride_width,
+          input_width, output_width, &q_begin, &q_end);
+        const DType value = filter_slice[r * filter_width + s];
+        for (size_t p = p_begin; p < p_end; ++p) {
+          const DType* input_row = input_slice +
+            (p * stride_height + r - padding_height) * input_width;
+          DType* output_row = output + p * output_width;
+          #pragma simd
+          for (size_t q = q_begin; q < q_end; ++q) {
+            output_row[q] += value * input_row[q * stride_width + s - padding_width];
+          }
+        }
+      }
+    }
+  }
+}
+
+// NCHW output, KCRS filter, NCHW input, one image and one input channel
+template<typename DType>
+void ConvolutionDirectBackwardImpl(
+  const DType* output,
+  const DType* filter,
+  DType* input,
+  size_t channel,
+  size_t output_channel,
+  size_t input_height,
+  size_t input_width,
+  size_t filter_height,
+  size_t filter_width,
+  size_t output_height,
+  size_t output_width,
+  size_t padding_height,
+  size_t padding_width,
+  size_t stride_height,
+  size_t stride_width) {
+  const size_t PQ = output_height * output_width;
+  const size_t RS = filter_height * filter_width;
+  const size_t CRS = channel * RS;
+  for (size_t k = 0; k < output_channel; ++k) {
+    const DType* output_slice = output + k * PQ;
+    const DType* filter_slice = filter + k * CRS;
+    for (size_t r = 0; r < filter_height; ++r) {
+      size_t p_begin, p_end;
+      ConvolutionDirectValidRange(r, padding_height, stride_height,
+        input_height, output_height, &p_begin, &p_end);
+      for (size_t s = 0; s < filter_width; ++s) {
+        size_t q_begin, q_end;
+        ConvolutionDirectValidRange(s, padding_width, stride_width,
+          input_width, output_width, &q_begin, &q_end);
+        const DType value = filter_slice[r * filter_width + s];
+        for (size_t p = p_begin; p < p_end; ++p) {
+          DType* input_row = input +
+            (p * stride_height + r - padding_height) * input_width;
+          const DType* output_row = output_slice + p * output_width;
+          for (size_t q = q_begin; q < q_end; ++q) {
+            input_row[q * stride_width + s - padding_width] += value * output_row[q];
+          }
+        }
+      }
+    }
+  }
+}
+
+// NCHW input, NCHW output, KCRS update, one (output channel, input channel) pair
+template<typename DType>
+void ConvolutionDirectUpdateImpl(
+  const DType* input,
+  const DType* output,
+  DType* update,
+  size_t batch_size,
+  size_t channel,
+  size_t output_channel,
+  size_t input_height,
+  size_t input_width,
+  size_t filter_height,
+  size_t filter_width,
+  size_t output_height,
+  size_t output_width,
+  size_t padding_height,
+  size_t padding_width,
+  size_t stride_height,
+  size_t stride_width) {
+  const size_t CHW = channel * input_height * input_width;
+  const size_t KPQ = output_channel * output_height * output_width;
+  for (size_t r = 0; r < filter_height; ++r) {
+    size_t p_begin, p_end;
+    ConvolutionDirectValidRange(r, padding_height, stride_height,
+      input_height, output_height, &p_begin, &p_end);
+    for (size_t s = 0; s < filter_width; ++s) {
+      size_t q_begin, q_end;
+      ConvolutionDirectValidRange(s, padding_width, stride_width,
+        input_width, output_width, &q_begin, &q_end);
+      DType sum = 0;
+      for (size_t n = 0; n < batch_size; ++n) {
+        for (size_t p = p_begin; p < p_end; ++p) {
+          const DType* input_row = input + n * CHW +
+            (p * stride_height + r - padding_height) * input_width;
+          const DType* output_row = output + n * KPQ + p * output_width;
+          #pragma simd reduction(+:sum)
+          for (size_t q = q_begin; q < q_end; ++q) {
+            sum += output_row[q] * input_row[q * stride_width + s - padding_width];
+          }
+        }
+      }
+      update[r * filter_width + s] += sum;
+    }
+  }
+}
+
+// NHWC input, RSCK filter, NHWC output, one image and one output row
+template<typename DType>
+void ConvolutionDirectForwardHWCImpl(
+  const DType* input,
+  const DType* filter,
+  DType* output,
+  size_t channel,
+  size_t output_channel,
+  size_t input_height,
+  size_t input_width,
+  size_t filter_height,
+  size_t filter_width,
+  size_t output_height,
+  size_t output_width,
+  size_t padding_height,
+  size_t padding_width,
+  size_t stride_height,
+  size_t stride_width,
+  size_t output_height_index) {
+  const size_t CK = channel * output_channel;
+  for (size_t q = 0; q < output_width; ++q) {
+    DType* output_slice = output + q * output_channel;
+    for (size_t k = 0; k < output_channel; ++k) {
+      output_slice[k] = 0;
+    }
+    for (size_t r = 0; r < filter_height; ++r) {
+      const size_t h = output_height_index * stride_height + r;
+      if (h < padding_height || h >= padding_height + input_height) {
+        continue;
+      }
+      for (size_t s = 0; s < filter_width; ++s) {
+        const size_t w = q * stride_width + s;
+        if (w < padding_width || w >= padding_width + input_width) {
+          continue;
+        }
+        const DType* input_slice = input +
+          ((h - padding_height) * input_width + w - padding_width) * channel;
+        const DType* filter_slice = filter + (r * filter_width + s) * CK;
+        for (size_t c = 0; c < channel; ++c) {
+          const DType value = input_slice[c];
+          const DType* filter_row = filter_slice + c * output_channel;
+          #pragma simd
+          for (size_t k = 0; k < output_channel; ++k) {
+            output_slice[k] += value * filter_row[k];
+          }
+        }
+      }
+    }
+  }
+}
+
+// NHWC output, RSCK filter, NHWC input, one image
+template<typename DType>
+void ConvolutionDirectBackwardHWCImpl(
+  const DType* output,
+  const DType* filter,
+  DType* input,
+  size_t channel,
+  size_t output_channel,
+  size_t input_height,
+  size_t input_width,
+  size_t filter_height,
+  size_t filter_width,
+  size_t output_height,
+  size_t output_width,
+  size_t padding_height,
+  size_t padding_width,
+  size_t stride_height,
+  size_t stride_width) {
+  const size_t CK = channel * output_channel;
+  for (size_t p = 0; p < output_height; ++p) {
+    for (size_t q = 0; q < output_width; ++q) {
+      const DType* output_slice = output +
+        (p * output_width + q) * output_channel;
+      for (size_t r = 0; r < filter_height; ++r) {
+        const size_t h = p * stride_height + r;
+        if (h < padding_height || h >= padding_height + input_height) {
+          continue;
+        }
+        for (size_t s = 0; s < filter_width; ++s) {
+          const size_t w = q * stride_width + s;
+          if (w < padding_width || w >= padding_width + input_width) {
+            continue;
+          }
+          DType* input_slice = input +
+            ((h - padding_height) * input_width + w - padding_width) * channel;
+          const DType* filter_slice = filter + (r * filter_width + s) * CK;
+          for (size_t c = 0; c < channel; ++c) {
+            const DType* filter_row = filter_slice + c * output_channel;
+            DType sum = 0;
+            #pragma simd reduction(+:sum)
+            for (size_t k = 0; k < output_channel; ++k) {
+              sum += output_slice[k] * filter_row[k];
+            }
+            input_slice[c] += sum;
+          }
+        }
+      }
+    }
+  }
+}
+
+// NHWC input, NHWC output, RSCK update, one filter position
+template<typename DType>
+void ConvolutionDirectUpdateHWCImpl(
+  const DType* input,
+  const DType* output,
+  DType* update,
+  size_t batch_size,
+  size_t channel,
+  size_t output_channel,
+  size_t input_height,
+  size_t input_width,
+  size_t output_height,
+  size_t output_width,
+  size_t padding_height,
+  size_t padding_width,
+  size_t stride_height,
+  size_t stride_width,
+  size_t filter_height_index,
+  size_t filter_width_index) {
+  const size_t HWC = input_height * input_width * channel;
+  const size_t PQK = output_height * output_width * output_channel;
+  size_t p_begin, p_end, q_begin, q_end;
+  ConvolutionDirectValidRange(filter_height_index, padding_height,
+    stride_height, input_height, output_height, &p_begin, &p_end);
+  ConvolutionDirectValidRange(filter_width_index, padding_width,
+    stride_width, input_width, output_width, &q_begin, &q_end);
+  for (size_t n = 0; n < batch_size; ++n) {
+    for (size_t p = p_begin; p < p_end; ++p) {
+      const size_t h = p * stride_height + filter_height_index - padding_height;
+      for (size_t q = q_begin; q < q_end; ++q) {
+        const size_t w = q * stride_width + filter_width_index - padding_width;
+        const DType* input_slice = input + n * HWC +
+          (h * input_width + w) * channel;
+        const DType* output_slice = output + n * PQK +
+          (p * output_width + q) * output_channel;
+        for (size_t c = 0; c < channel; ++c) {
+          const DType value = input_slice[c];
+          DType* update_row = update + c * output_channel;
+          #pragma simd
+          for (size_t k = 0; k < output_channel; ++k) {
+            update_row[k] += value * output_slice[k];
+          }
+        }
+      }
+    }
+  }
+}
+
+#endif  // SRC_BACKENDS_CPU_BACKEND_DIRECT_INL_H_
@@ -0,0 +1,214 @@
+#ifndef SRC_BACKENDS_CPU_BACKEND_LAYOUT_INL_H_
+#define SRC_BACKENDS_CPU_BACKEND_LAYOUT_INL_H_
+
+// square blocks whose input and output both stay in L1
+#define BLITZ_LAYOUT_BLOCK_SIZE 64
+
+// rows x cols block: register tiles, then the right and bottom borders
+template<typename DType>
+inline void TransposeBlockImpl(
+  const DType* input, DType* output,
+  size_t rows, size_t cols,
+  size_t input_ld, size_t output_ld) {
+  const size_t width = BLITZ_AVX_WIDTH / sizeof(DType);
+  const size_t tile_rows = rows / width * width;
+  const size_t tile_cols = cols / width * width;
+  for (size_t i = 0; i < tile_rows; i += width) {
+    for (size_t j = 0; j < tile_cols; j += width) {
+      BlitzAVXTranspose(input + i * input_ld + j, input_ld,
+        output + j * output_ld + i, output_ld);
+    }
+  }
+  for (size_t j = tile_cols; j < cols; ++j) {
+    for (size_t i = 0; i < rows; ++i) {
+      output[j * output_ld + i] = input[i * input_ld + j];
+    }
+  }
+  for (size_t j = 0; j < tile_cols; ++j) {
+    for (size_t i = tile_rows; i < rows; ++i) {
+      output[j * output_ld + i] = input[i * input_ld + j];
+    }
+  }
+}
+
+// batch of rows x cols transposes, see BlitzTransposeView
+template<typename DType>
+void TransposeBatchImpl(
+  const DType* input, DType* output,
+  size_t batch, size_t rows, size_t cols,
+  size_t input_ld, size_t output_ld,
+  size_t input_stride, size_t output_stride) {
+  const size_t block = BLITZ_LAYOUT_BLOCK_SIZE;
+  const size_t row_blocks = (rows + block - 1) / block;
+  const size_t col_blocks = (cols + block - 1) / block;
+  #pragma omp parallel for collapse(3)
+  for (size_t b = 0; b < batch; ++b) {
+    for (size_t i = 0; i < row_blocks; ++i) {
+      for (size_t j = 0; j < col_blocks; ++j) {
+        const size_t row = i * block;
+        const size_t col = j * block;
+        TransposeBlockImpl(
+          input + b * input_stride + row * input_ld + col,
+          output + b * output_stride + col * output_ld + row,
+          std::min(block, rows - row), std::min(block, cols - col),
+          input_ld, output_ld);
+      }
+    }
+  }
+}
+
+template<typename DType>
+void Backend<CPUTensor, DType>::Transpose2DFunc(
+  const CPUTensor<DType>* input, CPUTensor<DType>* output) {
+  size_t dim_left = input->shape()[0];
+  size_t dim_right = input->shape()[1];
+  CHECK_EQ(dim_left, output->shape()[1]);
+  CHECK_EQ(dim_right, output->shape()[0]);
+  TransposeBatchImpl(input->data(), output->data(),
+    1, dim_left, dim_right, dim_right, dim_left, 0, 0);
+}
+
+template<typename DType>
+void Backend<CPUTensor, DType>::TransformLayoutFunc(
+  const CPUTensor<DType>* input, CPUTensor<DType>* output) {
+  size_t batch, rows, cols;
+  size_t input_ld, output_ld, input_stride, output_stride;
+  if (BlitzTransposeView(input->shape_ptr(), output->shape_ptr(),
+    &batch, &rows, &cols, &input_ld, &output_ld,
+    &input_stride, &output_stride)) {
+    TransposeBatchImpl(input->data(), output->data(),
+      batch, rows, cols, input_ld, output_ld,
+      input_stride, output_stride);
+  } else {
+    BlitzCPUCopy(input->data(), output->data(), input->size());
+  }
+}
+
+// elements converted by one thread at a time, a multiple of any register
+#define BLITZ_PRECISION_BLOCK_SIZE 4096
+
+template<typename DType>
+inline void CompressImpl(const DType* input, unsigned short* output,
+  size_t size, BLITZ_PRECISION precision) {
+  for (size_t i = 0; i < size; ++i) {
+    output[i] = precision == BLITZ_PRECISION_HALF ?
+      BlitzFloatToHalf(static_cast<float>(input[i])) :
+      BlitzFloatToBFloat(static_cast<float>(input[i]));
+  }
+}
+
+template<typename DType>
+inline void DecompressImpl(const unsigned short* input, DType* output,
+  size_t size, BLITZ_PRECISION precision) {
+  for (size_t i = 0; i < size; ++i) {
+    output[i] = precision == BLITZ_PRECISION_HALF ?
+      BlitzHalfToFloat(input[i]) : BlitzBFloatToFloat(input[i]);
+  }
+}
+
+// full registers in SIMD, the tail by the scalar conversion
+template<>
+inline void CompressImpl<float>(const float* input, unsigned short* output,
+  size_t size, BLITZ_PRECISION precision) {
+  size_t i = 0;
+#if defined(BLITZ_AVX_HALF) || defined(BLITZ_AVX_BFLOAT)
+  const size_t width = BLITZ_AVX_WIDTH / sizeof(float);
+  const size_t vector_size = size / width * width;
+  BlitzAVXReg<float> reg;
+#endif
+#ifdef BLITZ_AVX_HALF
+  if (precision == BLITZ_PRECISION_HALF) {
+    for (; i < vector_size; i += width) {
+      BlitzAVXLoadu(input + i, &reg);
+      BlitzAVXStoreHalf(output + i, &reg);
+    }
+  }
+#endif
+#ifdef BLITZ_AVX_BFLOAT
+  if (precision == BLITZ_PRECISION_BFLOAT) {
+    for (; i < vector_size; i += width) {
+      BlitzAVXLoadu(input + i, &reg);
+      BlitzAVXStoreBFloat(output + i, &reg);
+    }
+  }
+#endif
+  for (; i < size; ++i) {
+    output[i] = precision == BLITZ_PRECISION_HALF ?
+      BlitzFloatToHalf(input[i]) : BlitzFloatToBFloat(input[i]);
+  }
+}
+
+template<>
+inline void DecompressImpl<float>(const unsigned short* input, float* output,
+  size_t size, BLITZ_PRECISION precision) {
+  size_t i = 0;
+#if defined(BLITZ_AVX_HALF) || defined(BLITZ_AVX_BFLOAT)
+  const size_t width = BLITZ_AVX_WIDTH / sizeof(float);
+  const size_t vector_size = size / width * width;
+  BlitzAVXReg<float> reg;
+#endif
+#ifdef BLITZ_AVX_HALF
+  if (precision == BLITZ_PRECISION_HALF) {
+    for (; i < vector_size; i += width) {
+      BlitzAVXLoadHalf(input + i, &reg);
+      BlitzAVXStoreu(output + i, &reg);
+    }
+  }
+#endif
+#ifdef BLITZ_AVX_BFLOAT
+  if (precision == BLITZ_PRECISION_BFLOAT) {
+    for (; i < vector_size; i += width) {
+      BlitzAVXLoadBFloat(input + i, &reg);
+      BlitzAVXStoreu(output + i, &reg);
+    }
+  }
+#endif
+  for (; i < size; ++i) {
+    output[i] = precision == BLITZ_PRECISION_HALF ?
+      BlitzHalfToFloat(input[i]) : BlitzBFloatToFloat(input[i]);
+  }
+}
+
+template<typename DType>
+void Backend<CPUTensor, DType>::CompressFunc(
+  const CPUTensor<DType>* input,
+  CPUTensor<unsigned short>* output,
+  BLITZ_PRECISION precision) {
+  CHECK_EQ(input->size(), output->size());
+  if (precision != BLITZ_PRECISION_HALF &&
+    precision != BLITZ_PRECISION_BFLOAT) {
+    LOG(FATAL) << "Unsupported storage precision: " << precision;
+  }
+  const size_t size = input->size();
+  const size_t block = BLITZ_PRECISION_BLOCK_SIZE;
+  const size_t blocks = (size + block - 1) / block;
+  #pragma omp parallel for
+  for (size_t i = 0; i < blocks; ++i) {
+    const size_t begin = i * block;
+    CompressImpl(input->data() + begin, output->data() + begin,
+      std::min(block, size - begin), precision);
+  }
+}
+
+template<typename DType>
+void Backend<CPUTensor, DType>::DecompressFunc(
+  const CPUTensor<unsigned short>* input,
+  CPUTensor<DType>* output,
+  BLITZ_PRECISION precision) {
+  CHECK_EQ(input->size(), output->size());
+  if (precision != BLITZ_PRECISION_HALF &&
+    precision != BLITZ_PRECISION_BFLOAT) {
+    LOG(FATAL) << "Unsupported storage precision: " << precision;
+  }
+  const size_t size = input->size();
+  const size_t block = BLITZ_PRECISION_BLOCK_SIZE;
+  const size_t blocks = (size + block - 1) / block;
+  #pragma omp parallel for
+  for (size_t i = 0; i < blocks; ++i) {
+    const size_t begin = i * block;
+    DecompressImpl(input->data() + begin, output->data() + begin,
+      std::min(block, size - begin), precision);
+  }
+}
+
+#endif  // SRC_BACKENDS_CPU_BACKEND_LAYOUT_INL_H_
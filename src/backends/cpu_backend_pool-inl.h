@@ -1,73 +1,441 @@
 #ifndef SRC_BACKENDS_CPU_BACKEND_POOL_INL_H_
 #define SRC_BACKENDS_CPU_BACKEND_POOL_INL_H_
 
+// max_index keeps the window-local argmax r * filter_width + s in one
+// byte, so a window has at most BLITZ_POOLING_MAX_WINDOW elements.
+// NCHW kernels vectorize across the output width, NHWC kernels across
+// the channels. Backward accumulates, overlapping windows add up.
+// Inference may pass a NULL max_index and keep only the maximum.
+#define BLITZ_POOLING_MAX_WINDOW 256
+
+template<typename DType>
+inline void PoolingStoreIndexImpl(const BlitzAVXReg<DType>* index,
+  size_t size, unsigned char* addr) {
+  for (size_t i = 0; i < size; ++i) {
+    addr[i] = static_cast<unsigned char>(index->d[i]);
+  }
+}
+
+// addr[i * stride] += lane i of the first size lanes
+template<typename DType>
+inline void PoolingAccumulateImpl(DType* addr, size_t stride,
+  size_t size, const BlitzAVXReg<DType>* reg) {
+  if (stride == 1) {
+    BlitzAVXReg<DType> x;
+    BlitzAVXLoadPartial(addr, size, static_cast<DType>(0), &x);
+    BlitzAVXAdd(&x, reg, &x);
+    BlitzAVXStorePartial(addr, size, &x);
+  } else {
+    for (size_t i = 0; i < size; ++i) {
+      addr[i * stride] += reg->d[i];
+    }
+  }
+}
+
+// strided lanes past size are read as long as they stay inside the
+// input, so only the tail of the input takes the partial load
+template<typename DType>
+inline size_t PoolingLoadSizeImpl(const DType* window, const DType* end,
+  size_t stride, size_t extent, size_t size) {
+  const size_t width = BLITZ_AVX_WIDTH / sizeof(DType);
+  return window + extent + (width - 1) * stride < end ? width : size;
+}
+
+template<typename DType>
+void MaxPoolingForwardNCHWImpl(
+  const DType* I,
+  DType* O,
+  unsigned char* max_index,
+  size_t N,
+  size_t C, size_t H, size_t W,
+  size_t P, size_t Q,
+  size_t R, size_t S,
+  size_t str_h, size_t str_w) {
+  const size_t width = BLITZ_AVX_WIDTH / sizeof(DType);
+  const DType* end = I + N * C * H * W;
+  #pragma omp parallel for collapse(2)
+  for (size_t n = 0; n < N; ++n) {
+    for (size_t c = 0; c < C; ++c) {
+      const DType* input_slice = I + (n * C + c) * H * W;
+      DType* output_slice = O + (n * C + c) * P * Q;
+      BlitzAVXReg<DType> x, max, index, candidate;
+      for (size_t p = 0; p < P; ++p) {
+        for (size_t q = 0; q < Q; q += width) {
+          const size_t size = std::min(width, Q - q);
+          const DType* window = input_slice + p * str_h * W + q * str_w;
+          const size_t load = PoolingLoadSizeImpl(window, end, str_w,
+            (R - 1) * W + S - 1, size);
+          BlitzAVXLoadStride(window, str_w, load, static_cast<DType>(0), &max);
+          BlitzAVXSet(static_cast<DType>(0), &index);
+          for (size_t r = 0; r < R; ++r) {
+            for (size_t s = 0; s < S; ++s) {
+              BlitzAVXLoadStride(window + r * W + s, str_w, load,
+                static_cast<DType>(0), &x);
+              BlitzAVXSet(static_cast<DType>(r * S + s), &candidate);
+              BlitzAVXArgmax(&x, &candidate, &max, &index);
+            }
+          }
+          BlitzAVXStorePartial(output_slice + p * Q + q, size, &max);
+          if (max_index != NULL) {
+            PoolingStoreIndexImpl(&index, size,
+              max_index + (n * C + c) * P * Q + p * Q + q);
+          }
+        }
+      }
+    }
+  }
+}
+
+template<typename DType>
+void MaxPoolingForwardNHWCImpl(
+  const DType* I,
+  DType* O,
+  unsigned char* max_index,
+  size_t N,
+  size_t C, size_t H, size_t W,
+  size_t P, size_t Q,
+  size_t R, size_t S,
+  size_t str_h, size_t str_w) {
+  const size_t width = BLITZ_AVX_WIDTH / sizeof(DType);
+  #pragma omp parallel for collapse(2)
+  for (size_t n = 0; n < N; ++n) {
+    for (size_t p = 0; p < P; ++p) {
+      BlitzAVXReg<DType> x, max, index, candidate;
+      for (size_t q = 0; q < Q; ++q) {
+        const DType* window = I + ((n * H + p * str_h) * W + q * str_w) * C;
+        DType* output_slice = O + ((n * P + p) * Q + q) * C;
+        for (size_t c = 0; c < C; c += width) {
+          const size_t size = std::min(width, C - c);
+          BlitzAVXLoadPartial(window + c, size, static_cast<DType>(0), &max);
+          BlitzAVXSet(static_cast<DType>(0), &index);
+          for (size_t r = 0; r < R; ++r) {
+            for (size_t s = 0; s < S; ++s) {
+              BlitzAVXLoadPartial(window + (r * W + s) * C + c, size,
+                static_cast<DType>(0), &x);
+              BlitzAVXSet(static_cast<DType>(r * S + s), &candidate);
+              BlitzAVXArgmax(&x, &candidate, &max, &index);
+            }
+          }
+          BlitzAVXStorePartial(output_slice + c, size, &max);
+          if (max_index != NULL) {
+            PoolingStoreIndexImpl(&index, size,
+              max_index + ((n * P + p) * Q + q) * C + c);
+          }
+        }
+      }
+    }
+  }
+}
+
 template<typename DType>
 void Backend<CPUTensor, DType>::MaxPooling2DForwardFunc(
   const CPUTensor<DType>* input,
   CPUTensor<DType>* output,
-  CPUTensor<size_t>* max_index, 
+  CPUTensor<unsigned char>* max_index,
+  size_t filter_height,
+  size_t filter_width,
+  size_t stride_height,
+  size_t stride_width) {
+  // shape init
+  size_t IN, C, H, W;
+  size_t ON, K, P, Q;
+  // shape decode
+  CHECK_EQ(input->data_layout(), output->data_layout());
+  Blitz2DBuffer(input->data_layout(), input->shape_ptr(), &IN, &C, &H, &W);
+  Blitz2DBuffer(output->data_layout(), output->shape_ptr(), &ON, &K, &P, &Q);
+  CHECK_EQ(IN, ON);
+  CHECK_EQ(C, K);
+  if (max_index != NULL) {
+    CHECK_EQ(max_index->size(), output->size());
+  }
+  CHECK_LE(filter_height * filter_width, BLITZ_POOLING_MAX_WINDOW);
+  // no padding
+  switch (input->data_layout()) {
+    case BLITZ_BUFFER_NCHW:
+      MaxPoolingForwardNCHWImpl(
+        input->data(),
+        output->data(),
+        max_index != NULL ? max_index->data() : NULL,
+        IN,
+        C, H, W,
+        P, Q,
+        filter_height, filter_width,
+        stride_height, stride_width);
+      break;
+    case BLITZ_BUFFER_NHWC:
+      MaxPoolingForwardNHWCImpl(
+        input->data(),
+        output->data(),
+        max_index != NULL ? max_index->data() : NULL,
+        IN,
+        C, H, W,
+        P, Q,
+        filter_height, filter_width,
+        stride_height, stride_width);
+      break;
+    default:
+      LOG(FATAL) << "Blitz not support pooling format: " << input->data_layout();
+      break;
+  }
+}
+
+template<typename DType>
+void Backend<CPUTensor, DType>::MaxPooling2DBackwardFunc(
+  const CPUTensor<DType>* output,
+  CPUTensor<DType>* input,
+  const CPUTensor<unsigned char>* max_index,
+  size_t filter_height,
+  size_t filter_width,
+  size_t stride_height,
+  size_t stride_width) {
+  // shape init
+  size_t IN, C, H, W;
+  size_t ON, K, P, Q;
+  // shape decode
+  CHECK_EQ(input->data_layout(), output->data_layout());
+  Blitz2DBuffer(input->data_layout(), input->shape_ptr(), &IN, &C, &H, &W);
+  Blitz2DBuffer(output->data_layout(), output->shape_ptr(), &ON, &K, &P, &Q);
+  CHECK_EQ(IN, ON);
+  CHECK_EQ(C, K);
+  // input offset of every window-local index
+  vector<size_t> offset(filter_height * filter_width);
+  for (size_t i = 0; i < offset.size(); ++i) {
+    offset[i] = (i / filter_width) * W + i % filter_width;
+  }
+  const unsigned char* max_index_data = max_index->data();
+  const DType* O = output->data();
+  DType* I = input->data();
+  // set zero
+  input->Fill(0);
+  // a window may overlap its neighbours, each thread owns whole images
+  // or channels
+  switch (input->data_layout()) {
+    case BLITZ_BUFFER_NCHW:
+      #pragma omp parallel for collapse(2)
+      for (size_t n = 0; n < IN; ++n) {
+        for (size_t c = 0; c < C; ++c) {
+          DType* input_slice = I + (n * C + c) * H * W;
+          const DType* output_slice = O + (n * C + c) * P * Q;
+          const unsigned char* max_index_slice = max_index_data +
+            (n * C + c) * P * Q;
+          for (size_t p = 0; p < P; ++p) {
+            for (size_t q = 0; q < Q; ++q) {
+              input_slice[p * stride_height * W + q * stride_width +
+                offset[max_index_slice[p * Q + q]]] +=
+                output_slice[p * Q + q];
+            }
+          }
+        }
+      }
+      break;
+    case BLITZ_BUFFER_NHWC:
+      #pragma omp parallel for
+      for (size_t n = 0; n < IN; ++n) {
+        for (size_t p = 0; p < P; ++p) {
+          for (size_t q = 0; q < Q; ++q) {
+            DType* window = I +
+              ((n * H + p * stride_height) * W + q * stride_width) * C;
+            const DType* output_slice = O + ((n * P + p) * Q + q) * C;
+            const unsigned char* max_index_slice = max_index_data +
+              ((n * P + p) * Q + q) * C;
+            for (size_t c = 0; c < C; ++c) {
+              window[offset[max_index_slice[c]] * C + c] += output_slice[c];
+            }
+          }
+        }
+      }
+      break;
+    default:
+      LOG(FATAL) << "Blitz not support pooling format: " << input->data_layout();
+      break;
+  }
+}
+
+template<typename DType>
+void AvgPoolingForwardNCHWImpl(
+  const DType* I,
+  DType* O,
+  size_t N,
+  size_t C, size_t H, size_t W,
+  size_t P, size_t Q,
+  size_t R, size_t S,
+  size_t str_h, size_t str_w) {
+  const size_t width = BLITZ_AVX_WIDTH / sizeof(DType);
+  const DType* end = I + N * C * H * W;
+  BlitzAVXReg<DType> scale;
+  BlitzAVXSet(static_cast<DType>(1) / (R * S), &scale);
+  #pragma omp parallel for collapse(2)
+  for (size_t n = 0; n < N; ++n) {
+    for (size_t c = 0; c < C; ++c) {
+      const DType* input_slice = I + (n * C + c) * H * W;
+      DType* output_slice = O + (n * C + c) * P * Q;
+      BlitzAVXReg<DType> x, sum;
+      for (size_t p = 0; p < P; ++p) {
+        for (size_t q = 0; q < Q; q += width) {
+          const size_t size = std::min(width, Q - q);
+          const DType* window = input_slice + p * str_h * W + q * str_w;
+          const size_t load = PoolingLoadSizeImpl(window, end, str_w,
+            (R - 1) * W + S - 1, size);
+          BlitzAVXSet(static_cast<DType>(0), &sum);
+          for (size_t r = 0; r < R; ++r) {
+            for (size_t s = 0; s < S; ++s) {
+              BlitzAVXLoadStride(window + r * W + s, str_w, load,
+                static_cast<DType>(0), &x);
+              BlitzAVXAdd(&sum, &x, &sum);
+            }
+          }
+          BlitzAVXMul(&sum, &scale, &sum);
+          BlitzAVXStorePartial(output_slice + p * Q + q, size, &sum);
+        }
+      }
+    }
+  }
+}
+
+template<typename DType>
+void AvgPoolingForwardNHWCImpl(
+  const DType* I,
+  DType* O,
+  size_t N,
+  size_t C, size_t H, size_t W,
+  size_t P, size_t Q,
+  size_t R, size_t S,
+  size_t str_h, size_t str_w) {
+  const size_t width = BLITZ_AVX_WIDTH / sizeof(DType);
+  BlitzAVXReg<DType> scale;
+  BlitzAVXSet(static_cast<DType>(1) / (R * S), &scale);
+  #pragma omp parallel for collapse(2)
+  for (size_t n = 0; n < N; ++n) {
+    for (size_t p = 0; p < P; ++p) {
+      BlitzAVXReg<DType> x, sum;
+      for (size_t q = 0; q < Q; ++q) {
+        const DType* window = I + ((n * H + p * str_h) * W + q * str_w) * C;
+        DType* output_slice = O + ((n * P + p) * Q + q) * C;
+        for (size_t c = 0; c < C; c += width) {
+          const size_t size = std::min(width, C - c);
+          BlitzAVXSet(static_cast<DType>(0), &sum);
+          for (size_t r = 0; r < R; ++r) {
+            for (size_t s = 0; s < S; ++s) {
+              BlitzAVXLoadPartial(window + (r * W + s) * C + c, size,
+                static_cast<DType>(0), &x);
+              BlitzAVXAdd(&sum, &x, &sum);
+            }
+          }
+          BlitzAVXMul(&sum, &scale, &sum);
+          BlitzAVXStorePartial(output_slice + c, size, &sum);
+        }
+      }
+    }
+  }
+}
+
+template<typename DType>
+void Backend<CPUTensor, DType>::AvgPooling2DForwardFunc(
+  const CPUTensor<DType>* input,
+  CPUTensor<DType>* output,
+  CPUTensor<DType>* workspace,
   size_t filter_height,
   size_t filter_width,
-  size_t stride_width,
-  size_t stride_height) {
+  size_t stride_height,
+  size_t stride_width) {
+  // shape init
+  size_t IN, C, H, W;
+  size_t ON, K, P, Q;
   // shape decode
-  // input
-  const Shape& input_shape = input->shape();
-  const size_t batch_size = input_shape[0];
-  const size_t input_channel = input_shape[1];
-  const size_t input_height = input_shape[2];
-  const size_t input_width = input_shape[3];
-  // output
-  const Shape& output_shape = output->shape();
-  const size_t output_channel = output_shape[1];
-  const size_t output_height = output_shape[2];
-  const size_t output_width = output_shape[3];
-  // offset
-  const size_t input_single_size = input_channel * input_height * input_width;
-  const size_t input_channel_size = input_height * input_width;
-  const size_t output_single_size = output_channel * output_height * output_width;
-  const size_t output_channel_size = output_height * output_width;
-  size_t input_channel_offset;
-  size_t output_channel_offset;
-  size_t input_batch_offset;
-  size_t output_batch_offset;
-  CHECK_EQ(input_channel, output_channel);
+  CHECK_EQ(input->data_layout(), output->data_layout());
+  Blitz2DBuffer(input->data_layout(), input->shape_ptr(), &IN, &C, &H, &W);
+  Blitz2DBuffer(output->data_layout(), output->shape_ptr(), &ON, &K, &P, &Q);
+  CHECK_EQ(IN, ON);
+  CHECK_EQ(C, K);
+  // global pooling is a channel reduction
+  if (filter_height == H && filter_width == W) {
+    const DType* I = input->data();
+    DType* O = output->data();
+    // the partials live in the workspace, so inference allocates nothing
+    DType* scratch = workspace != NULL ? workspace->data() : NULL;
+    output->Fill(0);
+    if (input->data_layout() == BLITZ_BUFFER_NCHW) {
+      if (scratch != NULL) {
+        CHECK_GE(workspace->size(),
+          BlitzReduceScratchSize(1, IN * C, H * W, false));
+      }
+      BlitzReduce(BlitzReduceSumOp<DType>(I), 1, IN * C, H * W,
+        O, static_cast<DType*>(NULL), scratch);
+    } else {
+      if (scratch != NULL) {
+        CHECK_GE(workspace->size(), BlitzReduceScratchSize(H * W, C, 1, false));
+      }
+      for (size_t n = 0; n < IN; ++n) {
+        BlitzReduce(BlitzReduceSumOp<DType>(I + n * H * W * C), H * W, C, 1,
+          O + n * C, static_cast<DType*>(NULL), scratch);
+      }
+    }
+    const DType scale = static_cast<DType>(1) / (H * W);
+    #pragma omp parallel for
+    for (size_t i = 0; i < output->size(); ++i) {
+      O[i] *= scale;
+    }
+    return;
+  }
   // no padding
-  #pragma omp parallel for private(input_batch_offset, output_batch_offset, \
-    input_channel_offset, output_channel_offset)
-  for (size_t batch_index = 0; batch_index < batch_size; ++batch_index) {
-    input_batch_offset = batch_index * input_single_size;
-    output_batch_offset = batch_index * output_single_size;
-    for (size_t channel_index = 0; channel_index < input_channel; ++channel_index) {
-      input_channel_offset = channel_index * input_channel_size;
-      output_channel_offset = channel_index * output_channel_size;
-      const DType* input_slice = input->Slice(input_batch_offset +
-        input_channel_offset);
-      DType* output_slice = output->Slice(output_batch_offset +
-        output_channel_offset);
-      size_t* max_index_slice = max_index->Slice(output_batch_offset +
-        output_channel_offset);
-      for (size_t output_height_index = 0; output_height_index < output_height;
-        ++output_height_index) {
-        for (size_t output_width_index = 0; output_width_index < output_width;
-          ++output_width_index) {
-          size_t height_start = output_height_index * stride_height;
-          size_t width_start = output_width_index * stride_width;
-          size_t height_end = height_start + filter_height;
-          size_t width_end = width_start + filter_width;
-          size_t pool_index = output_height_index * output_width +
-            output_width_index;
-          size_t max_index_tmp = height_start * input_width + width_start;
-          for (size_t h = height_start; h < height_end; ++h) {
-            for (size_t w = width_start; w < width_end; ++w) {
-              size_t index = h * input_width + w;
-              if (input_slice[index] > input_slice[max_index_tmp]) {
-                max_index_tmp = index;
-              }
+  switch (input->data_layout()) {
+    case BLITZ_BUFFER_NCHW:
+      AvgPoolingForwardNCHWImpl(
+        input->data(),
+        output->data(),
+        IN,
+        C, H, W,
+        P, Q,
+        filter_height, filter_width,
+        stride_height, stride_width);
+      break;
+    case BLITZ_BUFFER_NHWC:
+      AvgPoolingForwardNHWCImpl(
+        input->data(),
+        output->data(),
+        IN,
+        C, H, W,
+        P, Q,
+        filter_height, filter_width,
+        stride_height, stride_width);
+      break;
+    default:
+      LOG(FATAL) << "Blitz not support pooling format: " << input->data_layout();
+      break;
+  }
+}
+
+template<typename DType>
+void AvgPoolingBackwardNCHWImpl(
+  const DType* O,
+  DType* I,
+  size_t N,
+  size_t C, size_t H, size_t W,
+  size_t P, size_t Q,
+  size_t R, size_t S,
+  size_t str_h, size_t str_w) {
+  const size_t width = BLITZ_AVX_WIDTH / sizeof(DType);
+  BlitzAVXReg<DType> scale;
+  BlitzAVXSet(static_cast<DType>(1) / (R * S), &scale);
+  #pragma omp parallel for collapse(2)
+  for (size_t n = 0; n < N; ++n) {
+    for (size_t c = 0; c < C; ++c) {
+      DType* input_slice = I + (n * C + c) * H * W;
+      const DType* output_slice = O + (n * C + c) * P * Q;
+      BlitzAVXReg<DType> gradient;
+      for (size_t p = 0; p < P; ++p) {
+        for (size_t q = 0; q < Q; q += width) {
+          const size_t size = std::min(width, Q - q);
+          DType* window = input_slice + p * str_h * W + q * str_w;
+          BlitzAVXLoadPartial(output_slice + p * Q + q, size,
+            static_cast<DType>(0), &gradient);
+          BlitzAVXMul(&gradient, &scale, &gradient);
+          for (size_t r = 0; r < R; ++r) {
+            for (size_t s = 0; s < S; ++s) {
+              PoolingAccumulateImpl(window + r * W + s, str_w, size,
+                &gradient);
             }
           }
-          output_slice[pool_index] = input_slice[max_index_tmp];
-          max_index_slice[pool_index] = max_index_tmp;
         }
       }
     }
@@ -75,61 +443,85 @@ void Backend<CPUTensor, DType>::MaxPooling2DForwardFunc(
 }
 
 template<typename DType>
-void Backend<CPUTensor, DType>::MaxPooling2DBackwardFunc(
+void AvgPoolingBackwardNHWCImpl(
+  const DType* O,
+  DType* I,
+  size_t N,
+  size_t C, size_t H, size_t W,
+  size_t P, size_t Q,
+  size_t R, size_t S,
+  size_t str_h, size_t str_w) {
+  const size_t width = BLITZ_AVX_WIDTH / sizeof(DType);
+  BlitzAVXReg<DType> scale;
+  BlitzAVXSet(static_cast<DType>(1) / (R * S), &scale);
+  #pragma omp parallel for
+  for (size_t n = 0; n < N; ++n) {
+    BlitzAVXReg<DType> gradient;
+    for (size_t p = 0; p < P; ++p) {
+      for (size_t q = 0; q < Q; ++q) {
+        DType* window = I + ((n * H + p * str_h) * W + q * str_w) * C;
+        const DType* output_slice = O + ((n * P + p) * Q + q) * C;
+        for (size_t c = 0; c < C; c += width) {
+          const size_t size = std::min(width, C - c);
+          BlitzAVXLoadPartial(output_slice + c, size,
+            static_cast<DType>(0), &gradient);
+          BlitzAVXMul(&gradient, &scale, &gradient);
+          for (size_t r = 0; r < R; ++r) {
+            for (size_t s = 0; s < S; ++s) {
+              PoolingAccumulateImpl(window + (r * W + s) * C + c, 1, size,
+                &gradient);
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+template<typename DType>
+void Backend<CPUTensor, DType>::AvgPooling2DBackwardFunc(
   const CPUTensor<DType>* output,
   CPUTensor<DType>* input,
-  const CPUTensor<size_t>* max_index,
   size_t filter_height,
   size_t filter_width,
   size_t stride_height,
   size_t stride_width) {
+  // shape init
+  size_t IN, C, H, W;
+  size_t ON, K, P, Q;
   // shape decode
-  // input
-  const Shape& input_shape = input->shape();
-  const size_t batch_size = input_shape[0];
-  const size_t channel = input_shape[1];
-  const size_t input_height = input_shape[2];
-  const size_t input_width = input_shape[3];
-  // output
-  const Shape& output_shape = output->shape();
-  const size_t output_height = output_shape[2];
-  const size_t output_width = output_shape[3];
-  // offset
-  const size_t input_single_size = channel * input_height * input_width;
-  const size_t input_channel_size = input_height * input_width;
-  const size_t output_single_size = channel * output_height * output_width;
-  const size_t output_channel_size = output_height * output_width;
-  size_t input_batch_offset;
-  size_t output_batch_offset;
-  size_t input_channel_offset;
-  size_t output_channel_offset;
+  CHECK_EQ(input->data_layout(), output->data_layout());
+  Blitz2DBuffer(input->data_layout(), input->shape_ptr(), &IN, &C, &H, &W);
+  Blitz2DBuffer(output->data_layout(), output->shape_ptr(), &ON, &K, &P, &Q);
+  CHECK_EQ(IN, ON);
+  CHECK_EQ(C, K);
   // set zero
   input->Fill(0);
   // no padding
-  #pragma omp parallel for private(input_batch_offset, output_batch_offset, \
-    input_channel_offset, output_channel_offset)
-  for (size_t batch_index = 0; batch_index < batch_size; ++batch_index) {
-    input_batch_offset = batch_index * input_single_size;
-    output_batch_offset = batch_index * output_single_size;
-    for (size_t channel_index = 0; channel_index < channel; ++channel_index) {
-      input_channel_offset = channel_index * input_channel_size;
-      output_channel_offset = channel_index * output_channel_size;
-      DType* input_slice = input->Slice(input_batch_offset +
-        input_channel_offset);
-      const DType* output_slice = output->Slice(output_batch_offset +
-        output_channel_offset);
-      const size_t* max_index_slice = max_index->Slice(output_batch_offset +
-        output_channel_offset);
-      for (size_t output_height_index = 0; output_height_index < output_height;
-        ++output_height_index) {
-        for (size_t output_width_index = 0; output_width_index < output_width;
-          ++output_width_index) {
-          size_t index = output_height_index * output_width +
-            output_width_index;
-          input_slice[max_index_slice[index]] = output_slice[index];
-        }
-      }
-    }
+  switch (input->data_layout()) {
+    case BLITZ_BUFFER_NCHW:
+      AvgPoolingBackwardNCHWImpl(
+        output->data(),
+        input->data(),
+        IN,
+        C, H, W,
+        P, Q,
+        filter_height, filter_width,
+        stride_height, stride_width);
+      break;
+    case BLITZ_BUFFER_NHWC:
+      AvgPoolingBackwardNHWCImpl(
+        output->data(),
+        input->data(),
+        IN,
+        C, H, W,
+        P, Q,
+        filter_height, filter_width,
+        stride_height, stride_width);
+      break;
+    default:
+      LOG(FATAL) << "Blitz not support pooling format: " << input->data_layout();
+      break;
   }
 }
 
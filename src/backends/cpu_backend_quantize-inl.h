@@ -0,0 +1,338 @@
+#ifndef SRC_BACKENDS_CPU_BACKEND_QUANTIZE_INL_H_
+#define SRC_BACKENDS_CPU_BACKEND_QUANTIZE_INL_H_
+
+// The int8 GEMM keeps BLITZ_QUANTIZE_ROWS rows of uint8 levels against
+// one BLITZ_QUANTIZE_BLOCK column block of packed weights in int32
+// registers, and dequantizes while storing:
+// output = (sum - zero_point * weight_sum) * input_scale * weight_scale
+#define BLITZ_QUANTIZE_ROWS 4
+
+template<typename DType>
+inline void QuantizeImpl(const DType* input, unsigned char* output,
+  size_t size, DType inverse_scale, unsigned char zero_point) {
+  for (size_t i = 0; i < size; ++i) {
+    output[i] = BlitzQuantize(input[i], inverse_scale, zero_point);
+  }
+}
+
+#ifdef BLITZ_AVX_INT8
+template<>
+inline void QuantizeImpl<float>(const float* input, unsigned char* output,
+  size_t size, float inverse_scale, unsigned char zero_point) {
+  const size_t width = BLITZ_AVX_WIDTH / sizeof(float);
+  const size_t vector_size = size / width * width;
+  BlitzAVXReg<float> scale, zero, lower, upper, x;
+  BlitzAVXSet(inverse_scale, &scale);
+  BlitzAVXSet(static_cast<float>(zero_point), &zero);
+  BlitzAVXSet(0.0f, &lower);
+  BlitzAVXSet(255.0f, &upper);
+  for (size_t i = 0; i < vector_size; i += width) {
+    BlitzAVXLoadu(input + i, &x);
+    BlitzAVXMul(&x, &scale, &x);
+    BlitzAVXRound(&x, &x);
+    BlitzAVXAdd(&x, &zero, &x);
+    BlitzAVXMax(&x, &lower, &x);
+    BlitzAVXMin(&x, &upper, &x);
+    BlitzAVXStoreLevels(output + i, &x);
+  }
+  for (size_t i = vector_size; i < size; ++i) {
+    output[i] = BlitzQuantize(input[i], inverse_scale, zero_point);
+  }
+}
+#endif
+
+// sum[i][j] = levels row i * weight column j of one column block,
+// K is a multiple of BLITZ_QUANTIZE_GROUP and ldw the padded columns
+inline void QuantizedDotImpl(const unsigned char* levels,
+  const signed char* weight, size_t rows, size_t K, size_t ldw,
+  int sum[BLITZ_QUANTIZE_ROWS][BLITZ_QUANTIZE_BLOCK]) {
+#ifdef BLITZ_AVX_INT8
+  const size_t registers = BLITZ_QUANTIZE_BLOCK * sizeof(int) /
+    BLITZ_AVX_WIDTH;
+  BlitzAVXInteger accumulator[BLITZ_QUANTIZE_ROWS][
+    BLITZ_QUANTIZE_BLOCK * sizeof(int) / BLITZ_AVX_WIDTH];
+  BlitzAVXInteger right[BLITZ_QUANTIZE_BLOCK * sizeof(int) /
+    BLITZ_AVX_WIDTH];
+  // rows past the end repeat the last row and are not stored
+  const unsigned char* row[BLITZ_QUANTIZE_ROWS];
+  for (size_t i = 0; i < BLITZ_QUANTIZE_ROWS; ++i) {
+    row[i] = levels + std::min(i, rows - 1) * K;
+    for (size_t j = 0; j < registers; ++j) {
+      accumulator[i][j] = BlitzAVXSetInteger(0);
+    }
+  }
+  for (size_t k = 0; k < K; k += BLITZ_QUANTIZE_GROUP) {
+    const signed char* weight_slice = weight + k * ldw;
+    for (size_t j = 0; j < registers; ++j) {
+      right[j] = BlitzAVXLoadInteger(weight_slice + j * BLITZ_AVX_WIDTH);
+    }
+    for (size_t i = 0; i < BLITZ_QUANTIZE_ROWS; ++i) {
+      int group;
+      memcpy(&group, row[i] + k, sizeof(int));
+      const BlitzAVXInteger left = BlitzAVXSetInteger(group);
+      for (size_t j = 0; j < registers; ++j) {
+        BlitzAVXDotInt8(left, right[j], &accumulator[i][j]);
+      }
+    }
+  }
+  for (size_t i = 0; i < rows; ++i) {
+    for (size_t j = 0; j < registers; ++j) {
+      BlitzAVXStoreInteger(sum[i] + j * BLITZ_AVX_WIDTH / sizeof(int),
+        accumulator[i][j]);
+    }
+  }
+#else
+  for (size_t i = 0; i < rows; ++i) {
+    for (size_t j = 0; j < BLITZ_QUANTIZE_BLOCK; ++j) {
+      sum[i][j] = 0;
+    }
+    for (size_t k = 0; k < K; k += BLITZ_QUANTIZE_GROUP) {
+      const unsigned char* left = levels + i * K + k;
+      const signed char* right = weight + k * ldw;
+      for (size_t j = 0; j < BLITZ_QUANTIZE_BLOCK; ++j) {
+        for (size_t g = 0; g < BLITZ_QUANTIZE_GROUP; ++g) {
+          sum[i][j] += left[g] * right[j * BLITZ_QUANTIZE_GROUP + g];
+        }
+      }
+    }
+  }
+#endif
+}
+
+// output[m * ldm + n * ldn] of the M * K levels times the packed K * N
+// weight, K a multiple of BLITZ_QUANTIZE_GROUP
+template<typename DType>
+void QuantizedGemmImpl(
+  const unsigned char* levels,
+  const signed char* weight,
+  const int* offset,
+  const DType* scale,
+  DType* output,
+  size_t M, size_t N, size_t K,
+  size_t ldm, size_t ldn) {
+  const size_t block = BLITZ_QUANTIZE_BLOCK;
+  const size_t ldw = BlitzQuantizeColumns(N);
+  const size_t row_blocks = (M + BLITZ_QUANTIZE_ROWS - 1) /
+    BLITZ_QUANTIZE_ROWS;
+  #pragma omp parallel for
+  for (size_t b = 0; b < row_blocks; ++b) {
+    const size_t m = b * BLITZ_QUANTIZE_ROWS;
+    const size_t rows = std::min(static_cast<size_t>(BLITZ_QUANTIZE_ROWS),
+      M - m);
+    int sum[BLITZ_QUANTIZE_ROWS][BLITZ_QUANTIZE_BLOCK];
+    for (size_t n = 0; n < N; n += block) {
+      QuantizedDotImpl(levels + m * K, weight + n * BLITZ_QUANTIZE_GROUP,
+        rows, K, ldw, sum);
+      const size_t columns = std::min(block, N - n);
+      for (size_t i = 0; i < rows; ++i) {
+        DType* output_slice = output + (m + i) * ldm + n * ldn;
+        for (size_t j = 0; j < columns; ++j) {
+          output_slice[j * ldn] = (sum[i][j] - offset[n + j]) * scale[n + j];
+        }
+      }
+    }
+  }
+}
+
+// one row of ld levels per output position, CRS for NCHW and RSC for
+// NHWC input, out of bounds and row padding read as the zero point
+inline void QuantizedUnpackImpl(
+  const unsigned char* input,
+  unsigned char* unpack,
+  size_t C, size_t H, size_t W,
+  size_t R, size_t S,
+  size_t P, size_t Q,
+  size_t pad_h, size_t pad_w,
+  size_t str_h, size_t str_w,
+  size_t ld,
+  unsigned char zero_point,
+  BLITZ_DATA_LAYOUT input_data_layout) {
+  const size_t CRS = C * R * S;
+  #pragma omp parallel for
+  for (size_t p = 0; p < P; ++p) {
+    for (size_t q = 0; q < Q; ++q) {
+      unsigned char* row = unpack + (p * Q + q) * ld;
+      for (size_t r = 0; r < R; ++r) {
+        // unsigned wrap around puts the padding above H and W
+        const size_t h = p * str_h + r - pad_h;
+        for (size_t s = 0; s < S; ++s) {
+          const size_t w = q * str_w + s - pad_w;
+          const bool inside = h < H && w < W;
+          if (input_data_layout == BLITZ_BUFFER_NCHW) {
+            for (size_t c = 0; c < C; ++c) {
+              row[(c * R + r) * S + s] = inside ?
+                input[(c * H + h) * W + w] : zero_point;
+            }
+          } else if (inside) {
+            memcpy(row + (r * S + s) * C, input + (h * W + w) * C, C);
+          } else {
+            memset(row + (r * S + s) * C, zero_point, C);
+          }
+        }
+      }
+      memset(row + CRS, zero_point, ld - CRS);
+    }
+  }
+}
+
+template<typename DType>
+void Backend<CPUTensor, DType>::RangeFunc(
+  const CPUTensor<DType>* input,
+  DType* minimum,
+  DType* maximum) {
+  const DType* data = input->data();
+  DType low = data[0];
+  DType high = data[0];
+  #pragma omp parallel for reduction(min:low) reduction(max:high)
+  for (size_t i = 0; i < input->size(); ++i) {
+    low = std::min(low, data[i]);
+    high = std::max(high, data[i]);
+  }
+  *minimum = low;
+  *maximum = high;
+}
+
+template<typename DType>
+void Backend<CPUTensor, DType>::QuantizeWeightFunc(
+  const CPUTensor<DType>* weight,
+  CPUTensor<signed char>* quantized_weight,
+  CPUTensor<DType>* weight_scale,
+  CPUTensor<int>* weight_sum,
+  bool transpose) {
+  const Shape& shape = weight->shape();
+  const size_t N = transpose ? shape[0] : shape[shape.dimension() - 1];
+  const size_t K = weight->size() / N;
+  CHECK_EQ(quantized_weight->size(), BlitzQuantizedWeightSize(K, N));
+  CHECK_EQ(weight_scale->size(), N);
+  CHECK_EQ(weight_sum->size(), N);
+  const size_t ldw = BlitzQuantizeColumns(N);
+  const size_t ldk = transpose ? 1 : N;
+  const DType level_max = BLITZ_AVX_INT8_WEIGHT_MAX;
+  signed char* packed = quantized_weight->data();
+  quantized_weight->Fill(0);
+  #pragma omp parallel for
+  for (size_t n = 0; n < N; ++n) {
+    const DType* column = weight->data() + (transpose ? n * K : n);
+    DType maximum = 0;
+    for (size_t k = 0; k < K; ++k) {
+      maximum = std::max(maximum, static_cast<DType>(fabs(column[k * ldk])));
+    }
+    const DType scale = maximum > 0 ? maximum / level_max : 1;
+    int sum = 0;
+    for (size_t k = 0; k < K; ++k) {
+      const DType level = std::min(level_max,
+        std::max(-level_max, static_cast<DType>(
+        nearbyint(column[k * ldk] / scale))));
+      packed[((k / BLITZ_QUANTIZE_GROUP) * ldw + n) * BLITZ_QUANTIZE_GROUP +
+        k % BLITZ_QUANTIZE_GROUP] = static_cast<signed char>(level);
+      sum += static_cast<int>(level);
+    }
+    (*weight_scale)[n] = scale;
+    (*weight_sum)[n] = sum;
+  }
+}
+
+template<typename DType>
+void Backend<CPUTensor, DType>::QuantizedMatrixMultiplyFunc(
+  const CPUTensor<DType>* input,
+  const CPUTensor<signed char>* quantized_weight,
+  const CPUTensor<DType>* weight_scale,
+  const CPUTensor<int>* weight_sum,
+  CPUTensor<DType>* output,
+  CPUTensor<unsigned char>* workspace,
+  DType input_scale,
+  unsigned char zero_point) {
+  const size_t M = (input->shape())[0];
+  const size_t K = input->size() / M;
+  const size_t N = output->size() / M;
+  const size_t KB = BlitzQuantizeRows(K);
+  CHECK_EQ(quantized_weight->size(), BlitzQuantizedWeightSize(K, N));
+  CHECK_GE(workspace->size(), M * KB);
+  // rows padded to a multiple of the group meet zero weight rows
+  unsigned char* levels = workspace->data();
+  const DType inverse_scale = 1 / input_scale;
+  #pragma omp parallel for
+  for (size_t m = 0; m < M; ++m) {
+    QuantizeImpl(input->Slice(m * K), levels + m * KB, K, inverse_scale,
+      zero_point);
+    memset(levels + m * KB + K, zero_point, KB - K);
+  }
+  vector<int> offset(N);
+  vector<DType> scale(N);
+  for (size_t n = 0; n < N; ++n) {
+    offset[n] = zero_point * (*weight_sum)[n];
+    scale[n] = input_scale * (*weight_scale)[n];
+  }
+  QuantizedGemmImpl(levels, quantized_weight->data(), &offset[0], &scale[0],
+    output->data(), M, N, KB, N, 1);
+}
+
+template<typename DType>
+void Backend<CPUTensor, DType>::QuantizedConvolution2DForwardFunc(
+  const CPUTensor<DType>* input,
+  const CPUTensor<signed char>* quantized_weight,
+  const CPUTensor<DType>* weight_scale,
+  const CPUTensor<int>* weight_sum,
+  CPUTensor<DType>* output,
+  CPUTensor<unsigned char>* workspace,
+  DType input_scale,
+  unsigned char zero_point,
+  size_t filter_height,
+  size_t filter_width,
+  size_t padding_height,
+  size_t padding_width,
+  size_t stride_height,
+  size_t stride_width) {
+  // shape decode
+  size_t NIN, C, H, W;
+  size_t NOUT, K, P, Q;
+  CHECK_EQ(input->data_layout(), output->data_layout());
+  Blitz2DBuffer(input->data_layout(), input->shape_ptr(), &NIN, &C, &H, &W);
+  Blitz2DBuffer(output->data_layout(), output->shape_ptr(), &NOUT, &K, &P, &Q);
+  CHECK_EQ(NIN, NOUT);
+  if (input->data_layout() != BLITZ_BUFFER_NCHW &&
+    input->data_layout() != BLITZ_BUFFER_NHWC) {
+    LOG(FATAL) << "Blitz not support int8 convolution format: " <<
+      input->data_layout();
+  }
+  const size_t CHW = C * H * W;
+  const size_t PQ = P * Q;
+  const size_t CRS = C * filter_height * filter_width;
+  const size_t KB = BlitzQuantizeRows(CRS);
+  CHECK_EQ(quantized_weight->size(), BlitzQuantizedWeightSize(CRS, K));
+  CHECK_GE(workspace->size(), input->size() + PQ * KB);
+  // the whole batch is rounded once, windows are unpacked per image
+  unsigned char* levels = workspace->data();
+  unsigned char* unpack = levels + input->size();
+  const DType inverse_scale = 1 / input_scale;
+  const size_t block = BLITZ_PRECISION_BLOCK_SIZE;
+  const size_t blocks = (input->size() + block - 1) / block;
+  #pragma omp parallel for
+  for (size_t i = 0; i < blocks; ++i) {
+    const size_t begin = i * block;
+    QuantizeImpl(input->Slice(begin), levels + begin,
+      std::min(block, input->size() - begin), inverse_scale, zero_point);
+  }
+  vector<int> offset(K);
+  vector<DType> scale(K);
+  for (size_t k = 0; k < K; ++k) {
+    offset[k] = zero_point * (*weight_sum)[k];
+    scale[k] = input_scale * (*weight_scale)[k];
+  }
+  // positions are the rows, so NCHW output is stored transposed
+  const bool nchw = input->data_layout() == BLITZ_BUFFER_NCHW;
+  for (size_t n = 0; n < NIN; ++n) {
+    QuantizedUnpackImpl(levels + n * CHW, unpack,
+      C, H, W,
+      filter_height, filter_width,
+      P, Q,
+      padding_height, padding_width,
+      stride_height, stride_width,
+      KB, zero_point, input->data_layout());
+    QuantizedGemmImpl(unpack, quantized_weight->data(),
+      &offset[0], &scale[0], output->Slice(n * K * PQ),
+      PQ, K, KB, nchw ? 1 : K, nchw ? PQ : 1);
+  }
+}
+
+#endif  // SRC_BACKENDS_CPU_BACKEND_QUANTIZE_INL_H_
@@ -0,0 +1,221 @@
+#ifndef SRC_BACKENDS_CPU_BACKEND_WINOGRAD_INL_H_
+#define SRC_BACKENDS_CPU_BACKEND_WINOGRAD_INL_H_
+
+// F(2x2, 3x3)
+static const float kWinogradBT2[4 * 4] = {
+  1.0f,  0.0f, -1.0f,  0.0f,
+  0.0f,  1.0f,  1.0f,  0.0f,
+  0.0f, -1.0f,  1.0f,  0.0f,
+  0.0f,  1.0f,  0.0f, -1.0f
+};
+
+static const float kWinogradG2[4 * 3] = {
+  1.0f,  0.0f, 0.0f,
+  0.5f,  0.5f, 0.5f,
+  0.5f, -0.5f, 0.5f,
+  0.0f,  0.0f, 1.0f
+};
+
+static const float kWinogradAT2[2 * 4] = {
+  1.0f, 1.0f,  1.0f,  0.0f,
+  0.0f, 1.0f, -1.0f, -1.0f
+};
+
+// F(4x4, 3x3)
+static const float kWinogradBT4[6 * 6] = {
+  4.0f,  0.0f, -5.0f,  0.0f, 1.0f, 0.0f,
+  0.0f, -4.0f, -4.0f,  1.0f, 1.0f, 0.0f,
+  0.0f,  4.0f, -4.0f, -1.0f, 1.0f, 0.0f,
+  0.0f, -2.0f, -1.0f,  2.0f, 1.0f, 0.0f,
+  0.0f,  2.0f, -1.0f, -2.0f, 1.0f, 0.0f,
+  0.0f,  4.0f,  0.0f, -5.0f, 0.0f, 1.0f
+};
+
+static const float kWinogradG4[6 * 3] = {
+  1.0f / 4.0f,   0.0f,          0.0f,
+  -1.0f / 6.0f,  -1.0f / 6.0f,  -1.0f / 6.0f,
+  -1.0f / 6.0f,  1.0f / 6.0f,   -1.0f / 6.0f,
+  1.0f / 24.0f,  1.0f / 12.0f,  1.0f / 6.0f,
+  1.0f / 24.0f,  -1.0f / 12.0f, 1.0f / 6.0f,
+  0.0f,          0.0f,          1.0f
+};
+
+static const float kWinogradAT4[4 * 6] = {
+  1.0f, 1.0f,  1.0f, 1.0f,  1.0f, 0.0f,
+  0.0f, 1.0f, -1.0f, 2.0f, -2.0f, 0.0f,
+  0.0f, 1.0f,  1.0f, 4.0f,  4.0f, 0.0f,
+  0.0f, 1.0f, -1.0f, 8.0f, -8.0f, 1.0f
+};
+
+// out (rows * rows) = left (rows * cols) * in (cols * cols) * left^T
+template<typename DType>
+inline void WinogradTransformImpl(
+  const float* left,
+  const DType* in,
+  DType* out,
+  size_t rows,
+  size_t cols) {
+  DType temp[6 * 6];
+  for (size_t i = 0; i < rows; ++i) {
+    for (size_t j = 0; j < cols; ++j) {
+      DType sum = 0;
+      for (size_t l = 0; l < cols; ++l) {
+        sum += left[i * cols + l] * in[l * cols + j];
+      }
+      temp[i * cols + j] = sum;
+    }
+  }
+  for (size_t i = 0; i < rows; ++i) {
+    for (size_t j = 0; j < rows; ++j) {
+      DType sum = 0;
+      for (size_t l = 0; l < cols; ++l) {
+        sum += temp[i * cols + l] * left[j * cols + l];
+      }
+      out[i * rows + j] = sum;
+    }
+  }
+}
+
+// stride 1 3x3 convolution of NCHW input with a KCRS filter
+// workspace: [alpha^2 * K * C transformed filter]
+//   [BLITZ_NUM_THREADS * alpha^2 * (C + K) * BLITZ_WINOGRAD_TILE_BLOCK tiles]
+// flip convolves with the rotated filter and swapped channels instead,
+// which turns the same kernel into backward data
+template<typename DType>
+void ConvolutionWinogradImpl(
+  const DType* input,
+  const DType* filter,
+  DType* output,
+  DType* workspace,
+  size_t batch_size,
+  size_t input_channel,
+  size_t input_height,
+  size_t input_width,
+  size_t output_channel,
+  size_t output_height,
+  size_t output_width,
+  size_t padding_height,
+  size_t padding_width,
+  bool flip) {
+  const size_t m = BlitzWinogradOutputTile(output_height, output_width);
+  const size_t alpha = m + 2;
+  const size_t alpha2 = alpha * alpha;
+  const float* BT = m == 4 ? kWinogradBT4 : kWinogradBT2;
+  const float* G = m == 4 ? kWinogradG4 : kWinogradG2;
+  const float* AT = m == 4 ? kWinogradAT4 : kWinogradAT2;
+  const size_t C = input_channel;
+  const size_t K = output_channel;
+  const size_t KC = K * C;
+  const size_t tiles_height = (output_height + m - 1) / m;
+  const size_t tiles_width = (output_width + m - 1) / m;
+  const size_t tiles_image = tiles_height * tiles_width;
+  const size_t tiles = batch_size * tiles_image;
+  const size_t blocks = (tiles + BLITZ_WINOGRAD_TILE_BLOCK - 1) /
+    BLITZ_WINOGRAD_TILE_BLOCK;
+  const size_t HW = input_height * input_width;
+  const size_t PQ = output_height * output_width;
+  DType* transform_filter = workspace;
+  // filter transform, U = G * g * G^T
+  #pragma omp parallel for collapse(2)
+  for (size_t k = 0; k < K; ++k) {
+    for (size_t c = 0; c < C; ++c) {
+      DType g[3 * 3];
+      DType u[6 * 6];
+      for (size_t r = 0; r < 3; ++r) {
+        for (size_t s = 0; s < 3; ++s) {
+          if (flip) {
+            g[r * 3 + s] = filter[(c * K + k) * 9 + (2 - r) * 3 + (2 - s)];
+          } else {
+            g[r * 3 + s] = filter[(k * C + c) * 9 + r * 3 + s];
+          }
+        }
+      }
+      WinogradTransformImpl(G, g, u, alpha, 3);
+      for (size_t a = 0; a < alpha2; ++a) {
+        transform_filter[a * KC + k * C + c] = u[a];
+      }
+    }
+  }
+  #pragma omp parallel
+  {
+    const size_t tid = omp_get_thread_num();
+    DType* transform_input = workspace + alpha2 * KC +
+      tid * alpha2 * (C + K) * BLITZ_WINOGRAD_TILE_BLOCK;
+    DType* transform_output = transform_input +
+      alpha2 * C * BLITZ_WINOGRAD_TILE_BLOCK;
+    #pragma omp for
+    for (size_t b = 0; b < blocks; ++b) {
+      const size_t tile_begin = b * BLITZ_WINOGRAD_TILE_BLOCK;
+      const size_t tile_block = std::min(
+        static_cast<size_t>(BLITZ_WINOGRAD_TILE_BLOCK), tiles - tile_begin);
+      // input transform, V = B^T * d * B
+      for (size_t t = 0; t < tile_block; ++t) {
+        const size_t n = (tile_begin + t) / tiles_image;
+        const size_t tile_height_index = (tile_begin + t) % tiles_image /
+          tiles_width;
+        const size_t tile_width_index = (tile_begin + t) % tiles_width;
+        const size_t h_begin = tile_height_index * m;
+        const size_t w_begin = tile_width_index * m;
+        for (size_t c = 0; c < C; ++c) {
+          const DType* input_slice = input + (n * C + c) * HW;
+          DType d[6 * 6];
+          DType v[6 * 6];
+          for (size_t i = 0; i < alpha; ++i) {
+            const size_t h = h_begin + i;
+            for (size_t j = 0; j < alpha; ++j) {
+              const size_t w = w_begin + j;
+              if (h < padding_height || h >= padding_height + input_height ||
+                w < padding_width || w >= padding_width + input_width) {
+                d[i * alpha + j] = 0;
+              } else {
+                d[i * alpha + j] = input_slice[(h - padding_height) *
+                  input_width + w - padding_width];
+              }
+            }
+          }
+          WinogradTransformImpl(BT, d, v, alpha, alpha);
+          for (size_t a = 0; a < alpha2; ++a) {
+            transform_input[(a * C + c) * tile_block + t] = v[a];
+          }
+        }
+      }
+      // batched tile gemm, M = U * V
+      for (size_t a = 0; a < alpha2; ++a) {
+        BlitzCPUGemm(transform_filter + a * KC,
+          transform_input + a * C * tile_block,
+          transform_output + a * K * tile_block,
+          false, false,
+          static_cast<DType>(1), static_cast<DType>(0),
+          K, tile_block, C);
+      }
+      // output transform, Y = A^T * M * A
+      for (size_t t = 0; t < tile_block; ++t) {
+        const size_t n = (tile_begin + t) / tiles_image;
+        const size_t tile_height_index = (tile_begin + t) % tiles_image /
+          tiles_width;
+        const size_t tile_width_index = (tile_begin + t) % tiles_width;
+        const size_t p_begin = tile_height_index * m;
+        const size_t q_begin = tile_width_index * m;
+        const size_t p_end = std::min(p_begin + m, output_height);
+        const size_t q_end = std::min(q_begin + m, output_width);
+        for (size_t k = 0; k < K; ++k) {
+          DType* output_slice = output + (n * K + k) * PQ;
+          DType o[6 * 6];
+          DType y[4 * 4];
+          for (size_t a = 0; a < alpha2; ++a) {
+            o[a] = transform_output[(a * K + k) * tile_block + t];
+          }
+          WinogradTransformImpl(AT, o, y, m, alpha);
+          for (size_t p = p_begin; p < p_end; ++p) {
+            for (size_t q = q_begin; q < q_end; ++q) {
+              output_slice[p * output_width + q] =
+                y[(p - p_begin) * m + q - q_begin];
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+#endif  // SRC_BACKENDS_CPU_BACKEND_WINOGRAD_INL_H_
@@ -4,7 +4,9 @@ namespace blitz {
 
 template<typename DType>
 CPUTensor<DType>::~CPUTensor() {
-  free(this->data_);
+  if (this->owner_) {
+    free(this->data_);
+  }
 }
 
 template<typename DType>
@@ -60,6 +62,25 @@ inline void CPUTensor<DType>::OutputCSV(ofstream* ofs) const {
   }
 }
 
+template<typename DType>
+inline void CPUTensor<DType>::Relocate(DType* data) {
+  memcpy(data, this->data_, sizeof(DType) * this->size());
+  if (this->owner_) {
+    free(this->data_);
+  }
+  this->data_ = data;
+  this->owner_ = false;
+}
+
+template<typename DType>
+inline void CPUTensor<DType>::Attach(DType* data) {
+  if (this->owner_) {
+    free(this->data_);
+  }
+  this->data_ = data;
+  this->owner_ = false;
+}
+
 INSTANTIATE_TENSOR(CPUTensor);
 
 }  // namespace blitz
@@ -1,11 +1,13 @@
 #include "backends/gpu_backend.h"
 
 #include <cuda.h>
+#include <cuda_fp16.h>
 #include <cuda_runtime_api.h>
 #include <cudnn.h>
 #include <thrust/host_vector.h>
 #include <thrust/device_vector.h>
 #include <thrust/count.h>
+#include <thrust/extrema.h>
 #include <thrust/functional.h>
 #include <thrust/transform_reduce.h>
 
@@ -14,6 +16,8 @@
 
 #include "kernels/sass_function.h"
 #include "utils/blitz_gpu_function.h"
+#include "utils/blitz_profiler.h"
+#include "utils/blitz_random_function.h"
 #include "utils/blitz_shape_function.h"
 #include "utils/blitz_algorithm_function.h"
 
@@ -121,11 +121,21 @@ void Backend<GPUTensor, DType>::LogisticApplyFunc(
     input->size());
 }
 
+template<typename DType>
+__global__ void GPULogisticDerivative(const DType* input, DType* output,
+  size_t size) {
+  BLITZ_CUDA_LOOP(i, size) {
+    output[i] *= input[i] * (1 - input[i]);
+  }
+}
+
 template<typename DType>
 void Backend<GPUTensor, DType>::LogisticDerivativeFunc(
   const GPUTensor<DType>* input, GPUTensor<DType>* output) {
   CHECK_EQ(input->size(), output->size());
-  // TODO(keren) not short cut version
+  GPULogisticDerivative<DType><<<BlitzGPUGetBlocks(input->size()),
+    BLITZ_NUM_GPU_THREADS>>>(input->data(), output->data(),
+    input->size());
 }
 
 template<typename DType>
@@ -190,35 +200,140 @@ void Backend<GPUTensor, DType>::CrossEntropyMultiDerivativeFunc(
   MinusFunc(input, target, output);
 }
 
+// threads of a row kernel, a power of two
+#define BLITZ_GPU_ROW_THREADS 256
+
+// sum of value over the block, every thread gets the result
+template<typename DType>
+__device__ inline DType GPUBlockSum(DType value, DType* shared) {
+  shared[threadIdx.x] = value;
+  __syncthreads();
+  for (size_t stride = blockDim.x / 2; stride > 0; stride >>= 1) {
+    if (threadIdx.x < stride) {
+      shared[threadIdx.x] += shared[threadIdx.x + stride];
+    }
+    __syncthreads();
+  }
+  const DType sum = shared[0];
+  __syncthreads();
+  return sum;
+}
+
+// one block per row, so wide rows keep the device busy at small batches
 template<typename DType>
-__global__ void GPUBiasForward(
-  const DType* input, const DType* bias, DType* output,
+__global__ void GPUSoftmaxCrossEntropyMulti(
+  const DType* input, const DType* target,
+  DType* output, DType* gradient, DType* loss, DType* correct,
   size_t num_sample, size_t dim) {
-  BLITZ_CUDA_LOOP(i, num_sample) {
-    for (size_t j = 0; j < dim; ++j) {
-      output[i * dim + j] = input[i * dim + j] + bias[j];
+  __shared__ DType values[BLITZ_GPU_ROW_THREADS];
+  __shared__ size_t indices[BLITZ_GPU_ROW_THREADS];
+  for (size_t i = blockIdx.x; i < num_sample; i += gridDim.x) {
+    const DType* input_slice = input + i * dim;
+    const DType* target_slice = target + i * dim;
+    DType* output_slice = output + i * dim;
+
+    // argmax, the first of equal maxima as on the host
+    DType max = input_slice[0];
+    size_t max_index = 0;
+    for (size_t j = threadIdx.x; j < dim; j += blockDim.x) {
+      if (max < input_slice[j]) {
+        max = input_slice[j];
+        max_index = j;
+      }
+    }
+    values[threadIdx.x] = max;
+    indices[threadIdx.x] = max_index;
+    __syncthreads();
+    for (size_t stride = blockDim.x / 2; stride > 0; stride >>= 1) {
+      if (threadIdx.x < stride) {
+        const DType other = values[threadIdx.x + stride];
+        const size_t other_index = indices[threadIdx.x + stride];
+        if (values[threadIdx.x] < other || (values[threadIdx.x] == other &&
+          other_index < indices[threadIdx.x])) {
+          values[threadIdx.x] = other;
+          indices[threadIdx.x] = other_index;
+        }
+      }
+      __syncthreads();
+    }
+    max = values[0];
+    max_index = indices[0];
+    __syncthreads();
+
+    // output may alias input, each thread rewrites only what it read
+    DType sum = 0;
+    DType dot = 0;
+    DType mass = 0;
+    for (size_t j = threadIdx.x; j < dim; j += blockDim.x) {
+      const DType value = input_slice[j] - max;
+      const DType probability = exp(value);
+      dot += target_slice[j] * value;
+      mass += target_slice[j];
+      output_slice[j] = probability;
+      sum += probability;
+    }
+    sum = GPUBlockSum(sum, values);
+    dot = GPUBlockSum(dot, values);
+    mass = GPUBlockSum(mass, values);
+
+    for (size_t j = threadIdx.x; j < dim; j += blockDim.x) {
+      output_slice[j] /= sum;
+      if (gradient != NULL) {
+        gradient[i * dim + j] = output_slice[j] - target_slice[j];
+      }
+    }
+    if (threadIdx.x == 0) {
+      correct[i] = target_slice[max_index] == (DType)1.0 ? 1 : 0;
+      loss[i] = mass * log(sum) - dot;
     }
   }
 }
 
 template<typename DType>
-void Backend<GPUTensor, DType>::BiasForwardFunc(
-  const GPUTensor<DType>* input, const GPUTensor<DType>* bias,
-  GPUTensor<DType>* output) {
+DType Backend<GPUTensor, DType>::SoftmaxCrossEntropyMultiFunc(
+  const GPUTensor<DType>* input, const GPUTensor<DType>* target,
+  GPUTensor<DType>* output, GPUTensor<DType>* gradient, float* accuracy) {
+  CHECK_EQ(input->size(), target->size());
   CHECK_EQ(input->size(), output->size());
   size_t num_sample = input->shape()[0];
   size_t dim = input->size() / num_sample;
-  GPUBiasForward<DType><<<BlitzGPUGetBlocks(num_sample),
-    BLITZ_NUM_GPU_THREADS>>>(input->data(), bias->data(), output->data(),
-    num_sample, dim);
+  Shape shape(1);
+  shape[0] = num_sample;
+  GPUTensor<DType> loss(shape);
+  GPUTensor<DType> correct(shape);
+  GPUSoftmaxCrossEntropyMulti<DType><<<num_sample,
+    BLITZ_GPU_ROW_THREADS>>>(input->data(), target->data(),
+    output->data(), gradient != NULL ? gradient->data() : NULL,
+    loss.data(), correct.data(), num_sample, dim);
+  if (accuracy != NULL) {
+    thrust::device_ptr<DType> cptr =
+      thrust::device_pointer_cast(correct.data());
+    *accuracy = thrust::reduce(cptr, cptr + correct.size()) / num_sample;
+  }
+  thrust::device_ptr<DType> lptr = thrust::device_pointer_cast(loss.data());
+  return thrust::reduce(lptr, lptr + loss.size()) / num_sample;
+}
+
+// element k of channel c in a N x C x S or N x S x C buffer
+__device__ inline size_t GPUChannelIndex(size_t c, size_t k,
+  size_t C, size_t S, bool channel_last) {
+  return channel_last ? k * C + c : (k / S * C + c) * S + k % S;
+}
+
+template<typename DType>
+void Backend<GPUTensor, DType>::BiasForwardFunc(
+  const GPUTensor<DType>* input, const GPUTensor<DType>* bias,
+  GPUTensor<DType>* output) {
+  EpilogueForwardFunc(input, bias, NULL, NULL, output,
+    BLITZ_ACTIVATION_NONE, static_cast<DType>(0));
 }
 
 template<typename DType>
 __global__ void GPUBiasBackwardUpdate(const DType* input, DType* update,
-  size_t dim, size_t num_sample) {
-  BLITZ_CUDA_LOOP(i, dim) {
-    for (size_t j = 0; j < num_sample; ++j) {
-      update[i] += input[j * dim + i];
+  size_t C, size_t S, size_t count, bool channel_last) {
+  BLITZ_CUDA_LOOP(c, C) {
+    for (size_t k = 0; k < count; ++k) {
+      update[c] += input[GPUChannelIndex(c, k, C, S, channel_last)];
     }
   }
 }
@@ -226,11 +341,132 @@ __global__ void GPUBiasBackwardUpdate(const DType* input, DType* update,
 template<typename DType>
 void Backend<GPUTensor, DType>::BiasBackwardUpdateFunc(
   const GPUTensor<DType>* input, GPUTensor<DType>* update) {
-  size_t num_sample = input->shape()[0];
-  size_t dim = input->size() / num_sample;
-  GPUBiasBackwardUpdate<DType><<<BlitzGPUGetBlocks(dim),
+  size_t N, C, S;
+  const bool channel_last = BlitzChannelView(&(input->shape()),
+    &N, &C, &S);
+  GPUBiasBackwardUpdate<DType><<<BlitzGPUGetBlocks(C),
     BLITZ_NUM_GPU_THREADS>>>(input->data(), update->data(),
-    num_sample, dim);
+    C, S, N * S, channel_last);
+}
+
+template<typename DType>
+__global__ void GPUEpilogueForward(
+  const DType* input, const DType* bias,
+  const DType* scale, const DType* shift,
+  DType* output, BLITZ_ACTIVATION activation, DType slope,
+  size_t num_sample, size_t dim, size_t C, size_t S, bool channel_last) {
+  BLITZ_CUDA_LOOP(i, num_sample * dim) {
+    const size_t j = i % dim;
+    DType value = input[i];
+    if (bias != NULL) {
+      value += bias[channel_last ? j % C : j / S];
+    }
+    if (scale != NULL) {
+      value = scale[j] * value + shift[j];
+    }
+    if (activation == BLITZ_ACTIVATION_RECTLIN) {
+      value = value > 0 ? value : slope * value;
+    } else if (activation == BLITZ_ACTIVATION_LOGISTIC) {
+      value = 1 / (exp(-value) + 1);
+    }
+    output[i] = value;
+  }
+}
+
+template<typename DType>
+void Backend<GPUTensor, DType>::EpilogueForwardFunc(
+  const GPUTensor<DType>* input,
+  const GPUTensor<DType>* bias,
+  const GPUTensor<DType>* scale,
+  const GPUTensor<DType>* shift,
+  GPUTensor<DType>* output,
+  BLITZ_ACTIVATION activation,
+  DType slope) {
+  CHECK_EQ(input->size(), output->size());
+  size_t num_sample, C, S;
+  const bool channel_last = BlitzChannelView(&(input->shape()),
+    &num_sample, &C, &S);
+  size_t dim = input->size() / num_sample;
+  GPUEpilogueForward<DType><<<BlitzGPUGetBlocks(input->size()),
+    BLITZ_NUM_GPU_THREADS>>>(input->data(),
+    bias != NULL ? bias->data() : NULL,
+    scale != NULL ? scale->data() : NULL,
+    shift != NULL ? shift->data() : NULL,
+    output->data(), activation, slope, num_sample, dim,
+    C, S, channel_last);
+}
+
+template<typename DType>
+__global__ void GPUEpilogueBackward(
+  const DType* forward_output, DType* backward_input,
+  DType* bias_update, BLITZ_ACTIVATION activation, DType slope,
+  size_t C, size_t S, size_t count, bool channel_last) {
+  BLITZ_CUDA_LOOP(c, C) {
+    for (size_t k = 0; k < count; ++k) {
+      const size_t index = GPUChannelIndex(c, k, C, S, channel_last);
+      DType value = backward_input[index];
+      if (activation == BLITZ_ACTIVATION_RECTLIN) {
+        value *= forward_output[index] > 0 ? 1 : slope;
+      } else if (activation == BLITZ_ACTIVATION_LOGISTIC) {
+        value *= forward_output[index] * (1 - forward_output[index]);
+      }
+      backward_input[index] = value;
+      if (bias_update != NULL) {
+        bias_update[c] += value;
+      }
+    }
+  }
+}
+
+template<typename DType>
+void Backend<GPUTensor, DType>::EpilogueBackwardFunc(
+  const GPUTensor<DType>* forward_output,
+  GPUTensor<DType>* backward_input,
+  GPUTensor<DType>* bias_update,
+  BLITZ_ACTIVATION activation,
+  DType slope) {
+  CHECK_EQ(forward_output->size(), backward_input->size());
+  size_t N, C, S;
+  const bool channel_last = BlitzChannelView(&(backward_input->shape()),
+    &N, &C, &S);
+  GPUEpilogueBackward<DType><<<BlitzGPUGetBlocks(C),
+    BLITZ_NUM_GPU_THREADS>>>(forward_output->data(),
+    backward_input->data(),
+    bias_update != NULL ? bias_update->data() : NULL,
+    activation, slope, C, S, N * S, channel_last);
+}
+
+template<typename DType>
+__global__ void GPUBatchNormForward(
+  const DType* input, const DType* gamma, const DType* beta,
+  DType* input_var, DType* input_hat, DType* output,
+  DType* running_mean, DType* running_var,
+  DType momentum, DType epsilon,
+  size_t C, size_t S, size_t count, bool channel_last) {
+  BLITZ_CUDA_LOOP(c, C) {
+    DType mean = 0;
+    for (size_t k = 0; k < count; ++k) {
+      mean += input[GPUChannelIndex(c, k, C, S, channel_last)];
+    }
+    mean /= count;
+    DType var = 0;
+    for (size_t k = 0; k < count; ++k) {
+      const DType diff = input[GPUChannelIndex(c, k, C, S,
+        channel_last)] - mean;
+      var += diff * diff;
+    }
+    var /= count;
+    input_var[c] = var;
+    running_mean[c] = momentum * running_mean[c] + (1 - momentum) * mean;
+    running_var[c] = momentum * running_var[c] +
+      (1 - momentum) * (count > 1 ? var * count / (count - 1) : var);
+    const DType divider = sqrt(var + epsilon);
+    for (size_t k = 0; k < count; ++k) {
+      const size_t index = GPUChannelIndex(c, k, C, S, channel_last);
+      input_hat[index] = (input[index] - mean) / divider;
+      output[index] = gamma[c] * input_hat[index] + beta[c];
+    }
+  }
 }
 
 template<typename DType>
@@ -241,7 +477,41 @@ void Backend<GPUTensor, DType>::BatchNormForwardFunc(
   GPUTensor<DType>* input_var,
   GPUTensor<DType>* input_hat,
   GPUTensor<DType>* output,
-  DType epsilon) {}
+  GPUTensor<DType>* running_mean,
+  GPUTensor<DType>* running_var,
+  DType momentum,
+  DType epsilon) {
+  size_t N, C, S;
+  const bool channel_last = BlitzChannelView(&(input->shape()),
+    &N, &C, &S);
+  GPUBatchNormForward<DType><<<BlitzGPUGetBlocks(C),
+    BLITZ_NUM_GPU_THREADS>>>(input->data(), gamma->data(), beta->data(),
+    input_var->data(), input_hat->data(), output->data(),
+    running_mean->data(), running_var->data(), momentum, epsilon,
+    C, S, N * S, channel_last);
+}
+
+template<typename DType>
+__global__ void GPUBatchNormBackward(
+  const DType* backward_input, const DType* forward_input_hat,
+  const DType* forward_input_var, const DType* gamma,
+  DType* gamma_update, DType* beta_update, DType* output,
+  DType epsilon, size_t C, size_t S, size_t count, bool channel_last) {
+  BLITZ_CUDA_LOOP(c, C) {
+    for (size_t k = 0; k < count; ++k) {
+      const size_t index = GPUChannelIndex(c, k, C, S, channel_last);
+      gamma_update[c] += forward_input_hat[index] * backward_input[index];
+      beta_update[c] += backward_input[index];
+    }
+    const DType scale = gamma[c] / sqrt(forward_input_var[c] + epsilon);
+    for (size_t k = 0; k < count; ++k) {
+      const size_t index = GPUChannelIndex(c, k, C, S, channel_last);
+      const DType xhat = (forward_input_hat[index] * gamma_update[c] +
+        beta_update[c]) / count;
+      output[index] = scale * (backward_input[index] - xhat);
+    }
+  }
+}
 
 template<typename DType>
 void Backend<GPUTensor, DType>::BatchNormBackwardFunc(
@@ -252,7 +522,47 @@ void Backend<GPUTensor, DType>::BatchNormBackwardFunc(
   GPUTensor<DType>* gamma_update,
   GPUTensor<DType>* beta_update,
   GPUTensor<DType>* output,
-  DType epsilon) {}
+  DType epsilon) {
+  size_t N, C, S;
+  const bool channel_last = BlitzChannelView(&(backward_input->shape()),
+    &N, &C, &S);
+  GPUBatchNormBackward<DType><<<BlitzGPUGetBlocks(C),
+    BLITZ_NUM_GPU_THREADS>>>(backward_input->data(),
+    forward_input_hat->data(), forward_input_var->data(), gamma->data(),
+    gamma_update->data(), beta_update->data(), output->data(),
+    epsilon, C, S, N * S, channel_last);
+}
+
+template<typename DType>
+__global__ void GPUBatchNormScaleShift(
+  const DType* gamma, const DType* beta,
+  const DType* running_mean, const DType* running_var,
+  DType* scale, DType* shift, DType epsilon,
+  size_t C, size_t S, bool channel_last, size_t size) {
+  BLITZ_CUDA_LOOP(i, size) {
+    const size_t c = channel_last ? i % C : (i / S) % C;
+    scale[i] = gamma[c] / sqrt(running_var[c] + epsilon);
+    shift[i] = beta[c] - running_mean[c] * scale[i];
+  }
+}
+
+template<typename DType>
+void Backend<GPUTensor, DType>::BatchNormScaleShiftFunc(
+  const GPUTensor<DType>* gamma,
+  const GPUTensor<DType>* beta,
+  const GPUTensor<DType>* running_mean,
+  const GPUTensor<DType>* running_var,
+  GPUTensor<DType>* scale,
+  GPUTensor<DType>* shift,
+  DType epsilon) {
+  size_t N, C, S;
+  const bool channel_last = BlitzChannelView(&(scale->shape()),
+    &N, &C, &S);
+  GPUBatchNormScaleShift<DType><<<BlitzGPUGetBlocks(scale->size()),
+    BLITZ_NUM_GPU_THREADS>>>(gamma->data(), beta->data(),
+    running_mean->data(), running_var->data(), scale->data(),
+    shift->data(), epsilon, C, S, channel_last, scale->size());
+}
 
 template<typename DType>
 __global__ void GPUGradientdescent(
@@ -285,6 +595,106 @@ void Backend<GPUTensor, DType>::GradientdescentFunc(
     batch_size, gradient->size());
 }
 
+template<typename DType>
+__global__ void GPUNesterov(
+  DType* weight, const DType* gradient, DType* velocity,
+  DType momentum_coef, DType learning_rate,
+  DType decay, size_t batch_size, size_t size) {
+  BLITZ_CUDA_LOOP(i, size) {
+    DType g = gradient[i] / batch_size + decay * weight[i];
+    DType v = velocity[i] * momentum_coef - learning_rate * g;
+    weight[i] += v + momentum_coef * (v - velocity[i]);
+    velocity[i] = v;
+  }
+}
+
+template<typename DType>
+void Backend<GPUTensor, DType>::NesterovFunc(
+  GPUTensor<DType>* weight,
+  GPUTensor<DType>* gradient,
+  GPUTensor<DType>* velocity,
+  DType momentum_coef,
+  DType learning_rate,
+  DType decay,
+  size_t batch_size) {
+  CHECK_EQ(weight->size(), gradient->size());
+  CHECK_EQ(gradient->size(), velocity->size());
+  GPUNesterov<DType><<<BlitzGPUGetBlocks(gradient->size()),
+    BLITZ_NUM_GPU_THREADS>>>(
+    weight->data(), gradient->data(), velocity->data(),
+    momentum_coef, learning_rate, decay,
+    batch_size, gradient->size());
+}
+
+template<typename DType>
+__global__ void GPURMSProp(
+  DType* weight, const DType* gradient, DType* mean_square,
+  DType rho, DType epsilon, DType learning_rate,
+  DType decay, size_t batch_size, size_t size) {
+  BLITZ_CUDA_LOOP(i, size) {
+    DType g = gradient[i] / batch_size + decay * weight[i];
+    DType s = rho * mean_square[i] + (1 - rho) * g * g;
+    weight[i] -= learning_rate * g / (sqrt(s) + epsilon);
+    mean_square[i] = s;
+  }
+}
+
+template<typename DType>
+void Backend<GPUTensor, DType>::RMSPropFunc(
+  GPUTensor<DType>* weight,
+  GPUTensor<DType>* gradient,
+  GPUTensor<DType>* mean_square,
+  DType rho,
+  DType epsilon,
+  DType learning_rate,
+  DType decay,
+  size_t batch_size) {
+  CHECK_EQ(weight->size(), gradient->size());
+  CHECK_EQ(gradient->size(), mean_square->size());
+  GPURMSProp<DType><<<BlitzGPUGetBlocks(gradient->size()),
+    BLITZ_NUM_GPU_THREADS>>>(
+    weight->data(), gradient->data(), mean_square->data(),
+    rho, epsilon, learning_rate, decay,
+    batch_size, gradient->size());
+}
+
+template<typename DType>
+__global__ void GPUAdam(
+  DType* weight, const DType* gradient, DType* first_moment,
+  DType* second_moment, DType beta1, DType beta2, DType epsilon,
+  DType learning_rate, DType decay, size_t batch_size, size_t size) {
+  BLITZ_CUDA_LOOP(i, size) {
+    DType g = gradient[i] / batch_size + decay * weight[i];
+    DType m = beta1 * first_moment[i] + (1 - beta1) * g;
+    DType v = beta2 * second_moment[i] + (1 - beta2) * g * g;
+    weight[i] -= learning_rate * m / (sqrt(v) + epsilon);
+    first_moment[i] = m;
+    second_moment[i] = v;
+  }
+}
+
+template<typename DType>
+void Backend<GPUTensor, DType>::AdamFunc(
+  GPUTensor<DType>* weight,
+  GPUTensor<DType>* gradient,
+  GPUTensor<DType>* first_moment,
+  GPUTensor<DType>* second_moment,
+  DType beta1,
+  DType beta2,
+  DType epsilon,
+  DType learning_rate,
+  DType decay,
+  size_t batch_size) {
+  CHECK_EQ(weight->size(), gradient->size());
+  CHECK_EQ(gradient->size(), first_moment->size());
+  CHECK_EQ(first_moment->size(), second_moment->size());
+  GPUAdam<DType><<<BlitzGPUGetBlocks(gradient->size()),
+    BLITZ_NUM_GPU_THREADS>>>(
+    weight->data(), gradient->data(), first_moment->data(),
+    second_moment->data(), beta1, beta2, epsilon,
+    learning_rate, decay, batch_size, gradient->size());
+}
+
 template<typename DType>
 void Backend<GPUTensor, DType>::MatrixMultiplyFunc(
   const GPUTensor<DType>* left,
@@ -330,11 +740,7 @@ void Backend<GPUTensor, DType>::MatrixMultiplyFunc(
       break;
   }
   BLITZ_GPU_TIMER_END(elapsed_time, event_start, event_stop);
-  #ifdef BLITZ_PERFORMANCE
-  double computations = static_cast<double>(2 * dim_right) * static_cast<double>(dim_left) * static_cast<double>(dim_common_left);
-  LOG(INFO) << "GEMM time: " << elapsed_time;
-  LOG(INFO) << "GEMM gflops: " << computations / (elapsed_time * 1e9);
-  #endif  // BLITZ_PERFORMANCE
+  BlitzProfilerStage("gemm", elapsed_time);
 }
 
 template<typename DType>
@@ -348,6 +754,293 @@ void Backend<GPUTensor, DType>::Transpose2DFunc(
     output->data(), dim_left, dim_right); 
 }
 
+template<typename DType>
+__global__ void GPUTransposeBatch(
+  const DType* input, DType* output,
+  size_t batch, size_t rows, size_t cols,
+  size_t input_ld, size_t output_ld,
+  size_t input_stride, size_t output_stride) {
+  BLITZ_CUDA_LOOP(index, batch * rows * cols) {
+    const size_t b = index / (rows * cols);
+    const size_t j = (index / rows) % cols;
+    const size_t i = index % rows;
+    output[b * output_stride + j * output_ld + i] =
+      input[b * input_stride + i * input_ld + j];
+  }
+}
+
+template<typename DType>
+void Backend<GPUTensor, DType>::TransformLayoutFunc(
+  const GPUTensor<DType>* input, GPUTensor<DType>* output) {
+  size_t batch, rows, cols;
+  size_t input_ld, output_ld, input_stride, output_stride;
+  if (!BlitzTransposeView(input->shape_ptr(), output->shape_ptr(),
+    &batch, &rows, &cols, &input_ld, &output_ld,
+    &input_stride, &output_stride)) {
+    cudaMemcpy(output->data(), input->data(),
+      input->size() * sizeof(DType), cudaMemcpyDeviceToDevice);
+    return;
+  }
+  GPUTransposeBatch<DType><<<BlitzGPUGetBlocks(input->size()),
+    BLITZ_NUM_GPU_THREADS>>>(input->data(), output->data(),
+    batch, rows, cols, input_ld, output_ld,
+    input_stride, output_stride);
+}
+
+template<typename DType>
+__global__ void GPUCompress(
+  const DType* input, unsigned short* output,
+  bool half, size_t size) {
+  BLITZ_CUDA_LOOP(i, size) {
+    const float value = static_cast<float>(input[i]);
+    if (half) {
+      output[i] = __half_as_ushort(__float2half_rn(value));
+    } else {
+      const unsigned int bits = __float_as_uint(value);
+      output[i] = isnan(value) ? (bits >> 16) | 0x40 :
+        (bits + 0x7FFF + ((bits >> 16) & 1)) >> 16;
+    }
+  }
+}
+
+template<typename DType>
+__global__ void GPUDecompress(
+  const unsigned short* input, DType* output,
+  bool half, size_t size) {
+  BLITZ_CUDA_LOOP(i, size) {
+    if (half) {
+      output[i] = __half2float(__ushort_as_half(input[i]));
+    } else {
+      output[i] = __uint_as_float(static_cast<unsigned int>(input[i]) << 16);
+    }
+  }
+}
+
+template<typename DType>
+void Backend<GPUTensor, DType>::CompressFunc(
+  const GPUTensor<DType>* input,
+  GPUTensor<unsigned short>* output,
+  BLITZ_PRECISION precision) {
+  CHECK_EQ(input->size(), output->size());
+  if (precision != BLITZ_PRECISION_HALF &&
+    precision != BLITZ_PRECISION_BFLOAT) {
+    LOG(FATAL) << "Unsupported storage precision: " << precision;
+  }
+  GPUCompress<DType><<<BlitzGPUGetBlocks(input->size()),
+    BLITZ_NUM_GPU_THREADS>>>(input->data(), output->data(),
+    precision == BLITZ_PRECISION_HALF, input->size());
+}
+
+template<typename DType>
+void Backend<GPUTensor, DType>::DecompressFunc(
+  const GPUTensor<unsigned short>* input,
+  GPUTensor<DType>* output,
+  BLITZ_PRECISION precision) {
+  CHECK_EQ(input->size(), output->size());
+  if (precision != BLITZ_PRECISION_HALF &&
+    precision != BLITZ_PRECISION_BFLOAT) {
+    LOG(FATAL) << "Unsupported storage precision: " << precision;
+  }
+  GPUDecompress<DType><<<BlitzGPUGetBlocks(input->size()),
+    BLITZ_NUM_GPU_THREADS>>>(input->data(), output->data(),
+    precision == BLITZ_PRECISION_HALF, input->size());
+}
+
+template<typename DType>
+void Backend<GPUTensor, DType>::RangeFunc(
+  const GPUTensor<DType>* input,
+  DType* minimum,
+  DType* maximum) {
+  thrust::device_ptr<DType> ptr = thrust::device_pointer_cast(
+    const_cast<DType*>(input->data()));
+  thrust::pair<thrust::device_ptr<DType>, thrust::device_ptr<DType> >
+    range = thrust::minmax_element(ptr, ptr + input->size());
+  *minimum = *range.first;
+  *maximum = *range.second;
+}
+
+template<typename DType>
+__global__ void GPUQuantizeWeight(
+  const DType* weight, signed char* quantized_weight,
+  DType* weight_scale, int* weight_sum,
+  size_t N, size_t K, size_t ldw, bool transpose) {
+  BLITZ_CUDA_LOOP(n, N) {
+    const DType* column = weight + (transpose ? n * K : n);
+    const size_t ldk = transpose ? 1 : N;
+    DType maximum = 0;
+    for (size_t k = 0; k < K; ++k) {
+      maximum = max(maximum, fabs(column[k * ldk]));
+    }
+    const DType scale = maximum > 0 ? maximum / 127 : 1;
+    int sum = 0;
+    for (size_t k = 0; k < K; ++k) {
+      const int level = max(-127, min(127,
+        static_cast<int>(rint(column[k * ldk] / scale))));
+      quantized_weight[((k / BLITZ_QUANTIZE_GROUP) * ldw + n) *
+        BLITZ_QUANTIZE_GROUP + k % BLITZ_QUANTIZE_GROUP] = level;
+      sum += level;
+    }
+    weight_scale[n] = scale;
+    weight_sum[n] = sum;
+  }
+}
+
+template<typename DType>
+void Backend<GPUTensor, DType>::QuantizeWeightFunc(
+  const GPUTensor<DType>* weight,
+  GPUTensor<signed char>* quantized_weight,
+  GPUTensor<DType>* weight_scale,
+  GPUTensor<int>* weight_sum,
+  bool transpose) {
+  const Shape& shape = weight->shape();
+  const size_t N = transpose ? shape[0] : shape[shape.dimension() - 1];
+  const size_t K = weight->size() / N;
+  CHECK_EQ(quantized_weight->size(), BlitzQuantizedWeightSize(K, N));
+  CHECK_EQ(weight_scale->size(), N);
+  CHECK_EQ(weight_sum->size(), N);
+  quantized_weight->Fill(0);
+  GPUQuantizeWeight<DType><<<BlitzGPUGetBlocks(N),
+    BLITZ_NUM_GPU_THREADS>>>(weight->data(), quantized_weight->data(),
+    weight_scale->data(), weight_sum->data(),
+    N, K, BlitzQuantizeColumns(N), transpose);
+}
+
+// one thread per output element, activations are rounded on the fly
+// so the workspace is left unused
+template<typename DType>
+__device__ int GPUQuantizeLevel(DType value, DType inverse_scale,
+  int zero_point) {
+  return max(0, min(255,
+    static_cast<int>(rint(value * inverse_scale)) + zero_point));
+}
+
+template<typename DType>
+__global__ void GPUQuantizedMatrixMultiply(
+  const DType* input, const signed char* quantized_weight,
+  const DType* weight_scale, const int* weight_sum,
+  DType* output, DType input_scale, int zero_point,
+  size_t M, size_t N, size_t K, size_t ldw) {
+  BLITZ_CUDA_LOOP(index, M * N) {
+    const size_t m = index / N;
+    const size_t n = index % N;
+    const DType inverse_scale = 1 / input_scale;
+    int sum = 0;
+    for (size_t k = 0; k < K; ++k) {
+      sum += GPUQuantizeLevel(input[m * K + k], inverse_scale, zero_point) *
+        quantized_weight[((k / BLITZ_QUANTIZE_GROUP) * ldw + n) *
+        BLITZ_QUANTIZE_GROUP + k % BLITZ_QUANTIZE_GROUP];
+    }
+    output[index] = (sum - zero_point * weight_sum[n]) *
+      input_scale * weight_scale[n];
+  }
+}
+
+template<typename DType>
+void Backend<GPUTensor, DType>::QuantizedMatrixMultiplyFunc(
+  const GPUTensor<DType>* input,
+  const GPUTensor<signed char>* quantized_weight,
+  const GPUTensor<DType>* weight_scale,
+  const GPUTensor<int>* weight_sum,
+  GPUTensor<DType>* output,
+  GPUTensor<unsigned char>* workspace,
+  DType input_scale,
+  unsigned char zero_point) {
+  const size_t M = (input->shape())[0];
+  const size_t K = input->size() / M;
+  const size_t N = output->size() / M;
+  CHECK_EQ(quantized_weight->size(), BlitzQuantizedWeightSize(K, N));
+  GPUQuantizedMatrixMultiply<DType><<<BlitzGPUGetBlocks(M * N),
+    BLITZ_NUM_GPU_THREADS>>>(input->data(), quantized_weight->data(),
+    weight_scale->data(), weight_sum->data(), output->data(),
+    input_scale, zero_point, M, N, K, BlitzQuantizeColumns(N));
+}
+
+template<typename DType>
+__global__ void GPUQuantizedConvolution(
+  const DType* input, const signed char* quantized_weight,
+  const DType* weight_scale, const int* weight_sum,
+  DType* output, DType input_scale, int zero_point,
+  size_t size, size_t C, size_t H, size_t W,
+  size_t R, size_t S, size_t K, size_t P, size_t Q,
+  size_t pad_h, size_t pad_w, size_t str_h, size_t str_w,
+  size_t ldw, bool nchw) {
+  BLITZ_CUDA_LOOP(index, size) {
+    size_t n, k, p, q;
+    if (nchw) {
+      q = index % Q;
+      p = (index / Q) % P;
+      k = (index / (P * Q)) % K;
+      n = index / (K * P * Q);
+    } else {
+      k = index % K;
+      q = (index / K) % Q;
+      p = (index / (K * Q)) % P;
+      n = index / (K * P * Q);
+    }
+    const DType inverse_scale = 1 / input_scale;
+    const DType* input_slice = input + n * C * H * W;
+    int sum = 0;
+    for (size_t r = 0; r < R; ++r) {
+      const size_t h = p * str_h + r - pad_h;
+      for (size_t s = 0; s < S; ++s) {
+        const size_t w = q * str_w + s - pad_w;
+        const bool inside = h < H && w < W;
+        for (size_t c = 0; c < C; ++c) {
+          // CRS rows for NCHW, RSC rows for NHWC
+          const size_t row = nchw ? (c * R + r) * S + s : (r * S + s) * C + c;
+          const int level = inside ? GPUQuantizeLevel(nchw ?
+            input_slice[(c * H + h) * W + w] :
+            input_slice[(h * W + w) * C + c],
+            inverse_scale, zero_point) : zero_point;
+          sum += level * quantized_weight[((row / BLITZ_QUANTIZE_GROUP) *
+            ldw + k) * BLITZ_QUANTIZE_GROUP + row % BLITZ_QUANTIZE_GROUP];
+        }
+      }
+    }
+    output[index] = (sum - zero_point * weight_sum[k]) *
+      input_scale * weight_scale[k];
+  }
+}
+
+template<typename DType>
+void Backend<GPUTensor, DType>::QuantizedConvolution2DForwardFunc(
+  const GPUTensor<DType>* input,
+  const GPUTensor<signed char>* quantized_weight,
+  const GPUTensor<DType>* weight_scale,
+  const GPUTensor<int>* weight_sum,
+  GPUTensor<DType>* output,
+  GPUTensor<unsigned char>* workspace,
+  DType input_scale,
+  unsigned char zero_point,
+  size_t filter_height,
+  size_t filter_width,
+  size_t padding_height,
+  size_t padding_width,
+  size_t stride_height,
+  size_t stride_width) {
+  // shape decode
+  size_t NIN, C, H, W;
+  size_t NOUT, K, P, Q;
+  CHECK_EQ(input->data_layout(), output->data_layout());
+  Blitz2DBuffer(input->data_layout(), input->shape_ptr(), &NIN, &C, &H, &W);
+  Blitz2DBuffer(output->data_layout(), output->shape_ptr(), &NOUT, &K, &P, &Q);
+  CHECK_EQ(NIN, NOUT);
+  if (input->data_layout() != BLITZ_BUFFER_NCHW &&
+    input->data_layout() != BLITZ_BUFFER_NHWC) {
+    LOG(FATAL) << "Blitz not support int8 convolution format: " <<
+      input->data_layout();
+  }
+  CHECK_EQ(quantized_weight->size(),
+    BlitzQuantizedWeightSize(C * filter_height * filter_width, K));
+  GPUQuantizedConvolution<DType><<<BlitzGPUGetBlocks(output->size()),
+    BLITZ_NUM_GPU_THREADS>>>(input->data(), quantized_weight->data(),
+    weight_scale->data(), weight_sum->data(), output->data(),
+    input_scale, zero_point, output->size(),
+    C, H, W, filter_height, filter_width, K, P, Q,
+    padding_height, padding_width, stride_height, stride_width,
+    BlitzQuantizeColumns(K), input->data_layout() == BLITZ_BUFFER_NCHW);
+}
+
 template<typename DType>
 void Backend<GPUTensor, DType>::MaximumFunc(
   const GPUTensor<DType>* left, const GPUTensor<DType>* right,
@@ -438,10 +1131,10 @@ void Backend<GPUTensor, DType>::ConstantDistributionFunc(
 template<typename DType>
 void Backend<GPUTensor, DType>::NormalDistributionFunc(
   GPUTensor<DType>* output, DType loc, DType scale) {
-  static unsigned int seed = 0;
   curandGenerator_t gen;
-  curandCreateGenerator(&gen, CURAND_RNG_PSEUDO_DEFAULT);
-  curandSetPseudoRandomGeneratorSeed(gen, (++seed)+time(NULL));
+  curandCreateGenerator(&gen, CURAND_RNG_PSEUDO_PHILOX4_32_10);
+  curandSetPseudoRandomGeneratorSeed(gen, BlitzRandomSeed());
+  curandSetGeneratorOffset(gen, BlitzRandomNextStream() << 32);
   BlitzGenerateNormal(&gen, output->data(), loc, scale, output->size());
 }
 
@@ -456,10 +1149,10 @@ __global__ void GPUUniformTransform(DType* output, DType low, DType high,
 template<typename DType>
 void Backend<GPUTensor, DType>::UniformDistributionFunc(
   GPUTensor<DType>* output, DType low, DType high) {
-  static unsigned int seed = 0;
   curandGenerator_t gen;
-  curandCreateGenerator(&gen, CURAND_RNG_PSEUDO_DEFAULT);
-  curandSetPseudoRandomGeneratorSeed(gen, (++seed)+time(NULL));
+  curandCreateGenerator(&gen, CURAND_RNG_PSEUDO_PHILOX4_32_10);
+  curandSetPseudoRandomGeneratorSeed(gen, BlitzRandomSeed());
+  curandSetGeneratorOffset(gen, BlitzRandomNextStream() << 32);
   BlitzGenerateUniform(&gen, output->data(), output->size());
   GPUUniformTransform<DType><<<BlitzGPUGetBlocks(output->size()),
     BLITZ_NUM_GPU_THREADS>>>(output->data(), low, high, output->size());
@@ -471,6 +1164,12 @@ void Backend<GPUTensor, DType>::HostCopyToFunc(
   cudaMemcpy(target, source, size * sizeof(DType), cudaMemcpyHostToDevice);
 }
 
+template<typename DType>
+void Backend<GPUTensor, DType>::HostCopyFromFunc(
+  const DType* source, DType* target, size_t size) {
+  cudaMemcpy(target, source, size * sizeof(DType), cudaMemcpyDeviceToHost);
+}
+
 template<typename DType>
 __global__ void GPUEvaluateClass(
   const DType* output, const DType* target, DType* correct,
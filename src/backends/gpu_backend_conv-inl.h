@@ -121,13 +121,8 @@ void Backend<GPUTensor, DType>::Convolution2DForwardFunc(
       LOG(FATAL) << "Unsupported algorithm type: " << algorithm;
       break;
   }
-  #ifdef BLITZ_PERFORMANCE
-  double computations = static_cast<double>(KPQ) * static_cast<double>(CRS) * static_cast<double>(2 * NIN);
-  LOG(INFO) << "Forward convolution compute: " << compute_time;
-  LOG(INFO) << "Forward convolution transform: " << transform_time;
-  LOG(INFO) << "Forward convolution compute gflops: " << computations / (compute_time * 1e9);
-  LOG(INFO) << "Forward convolution total gflops: " << computations / ((transform_time + compute_time) * 1e9);
-  #endif  // BLITZ_PERFORMANCE
+  BlitzProfilerStage("unpack", transform_time);
+  BlitzProfilerStage("gemm", compute_time);
 }
 
 template<typename DType>
@@ -273,13 +268,8 @@ void Backend<GPUTensor, DType>::Convolution2DBackwardFunc(
       LOG(FATAL) << "Unsupported algorithm type: " << algorithm;
       break;
   }
-  #ifdef BLITZ_PERFORMANCE
-  double computations = static_cast<double>(KPQ) * static_cast<double>(CRS) * static_cast<double>(2 * NIN);
-  LOG(INFO) << "Backward convolution compute: " << compute_time;
-  LOG(INFO) << "Backward convolution transform: " << transform_time;
-  LOG(INFO) << "Backward convolution compute gflops: " << computations / (compute_time * 1e9);
-  LOG(INFO) << "Backward convolution total gflops: " << computations / ((transform_time + compute_time) * 1e9);
-  #endif  // BLITZ_PERFORMANCE
+  BlitzProfilerStage("gemm", compute_time);
+  BlitzProfilerStage("pack", transform_time);
 }
 
 template<typename DType>
@@ -404,10 +394,8 @@ void Backend<GPUTensor, DType>::Convolution2DUpdateFunc(
       LOG(FATAL) << "Unsupported algorithm type: " << algorithm;
       break;
   }
-  #ifdef BLITZ_PERFORMANCE
-  LOG(INFO) << "Backward convolution filter gemm: " << compute_time;
-  LOG(INFO) << "Backward convolution filter unpack: " << transform_time;
-  #endif  // BLITZ_PERFORMANCE
+  BlitzProfilerStage("unpack", transform_time);
+  BlitzProfilerStage("gemm", compute_time);
 }
 
 #endif  // SRC_BACKENDS_GPU_BACKEND_CONV_INL_H_
@@ -1,11 +1,14 @@
 #ifndef SRC_BACKEND_GPU_BACKEND_POOL_INL_H_
 #define SRC_BACKEND_GPU_BACKEND_POOL_INL_H_
 
+// max_index keeps the window-local argmax r * filter_width + s, backward
+// gathers over every window containing an input element so overlapping
+// windows add up without atomics. Inference may pass a NULL max_index
 template<typename DType>
 __global__ void GPUMaxPoolingForward(
   const DType* input,
   DType* output,
-  size_t* max_index, 
+  unsigned char* max_index,
   size_t size,
   size_t channel,
   size_t input_height,
@@ -21,32 +24,32 @@ __global__ void GPUMaxPoolingForward(
     size_t output_height_index = (index / output_width) % output_height;
     size_t channel_index = (index / (output_width * output_height)) % channel;
     size_t batch_index = index / (output_width * output_height * channel);
-    size_t height_start = output_height_index * stride_height;
-    size_t width_start = output_width_index * stride_width;
-    size_t height_end = height_start + filter_height;
-    size_t width_end = width_start + filter_width;
-    size_t max_idx = height_start * input_width + width_start;
-    const DType* input_slice = input +
-      (batch_index * channel + channel_index) *
-      input_height * input_width;
-    for (size_t i = height_start; i < height_end; ++i) {
-      for (size_t j = width_start; j < width_end; ++j) {
-        if (input_slice[i * input_width + j] > input_slice[max_idx]) {
-          max_idx = i * input_width + j;
+    const DType* window = input +
+      ((batch_index * channel + channel_index) * input_height +
+      output_height_index * stride_height) * input_width +
+      output_width_index * stride_width;
+    size_t max_idx = 0;
+    DType max = window[0];
+    for (size_t i = 0; i < filter_height; ++i) {
+      for (size_t j = 0; j < filter_width; ++j) {
+        if (window[i * input_width + j] > max) {
+          max = window[i * input_width + j];
+          max_idx = i * filter_width + j;
         }
       }
     }
-    output[index] = input_slice[max_idx];
-    max_index[index] = max_idx;
+    output[index] = max;
+    if (max_index != NULL) {
+      max_index[index] = max_idx;
+    }
   }
 }
 
-
 template<typename DType>
 void Backend<GPUTensor, DType>::MaxPooling2DForwardFunc(
   const GPUTensor<DType>* input,
   GPUTensor<DType>* output,
-  GPUTensor<size_t>* max_index, 
+  GPUTensor<unsigned char>* max_index,
   size_t filter_height,
   size_t filter_width,
   size_t stride_height,
@@ -63,11 +66,11 @@ void Backend<GPUTensor, DType>::MaxPooling2DForwardFunc(
   size_t output_height = output_shape[2];
   size_t output_width = output_shape[3];
   CHECK_EQ(channel, output_channel);
-  // set min
-  output->Fill(std::numeric_limits<DType>::min());
+  CHECK_LE(filter_height * filter_width, 256);
   GPUMaxPoolingForward<DType>
     <<<BlitzGPUGetBlocks(output->size()), BLITZ_NUM_GPU_THREADS>>>(
-    input->data(), output->data(), max_index->data(),
+    input->data(), output->data(),
+    max_index != NULL ? max_index->data() : NULL,
     output->size(), channel, input_height, input_width,
     output_height, output_width,
     filter_height, filter_width,
@@ -78,7 +81,7 @@ template<typename DType>
 __global__ void GPUMaxPoolingBackward(
   const DType* output,
   DType* input,
-  const size_t* max_index,
+  const unsigned char* max_index,
   size_t size,
   size_t channel,
   size_t input_height,
@@ -89,13 +92,31 @@ __global__ void GPUMaxPoolingBackward(
   size_t filter_width,
   size_t stride_height,
   size_t stride_width) {
-  BLITZ_CUDA_LOOP(i, size) {
-    size_t channel_index = (i / (output_width * output_height)) % channel;
-    size_t batch_index = i / (output_width * output_height * channel);
-    DType* input_slice = input +
-      (batch_index * channel + channel_index) *
-      input_height * input_width;
-    input_slice[max_index[i]] = output[i];
+  BLITZ_CUDA_LOOP(index, size) {
+    size_t w = index % input_width;
+    size_t h = (index / input_width) % input_height;
+    size_t plane = index / (input_width * input_height);
+    // windows p with p * stride <= h < p * stride + filter
+    size_t p_start = h < filter_height ? 0 :
+      (h - filter_height) / stride_height + 1;
+    size_t p_end = min(h / stride_height + 1, output_height);
+    size_t q_start = w < filter_width ? 0 :
+      (w - filter_width) / stride_width + 1;
+    size_t q_end = min(w / stride_width + 1, output_width);
+    const DType* output_slice = output + plane * output_height * output_width;
+    const unsigned char* max_index_slice = max_index +
+      plane * output_height * output_width;
+    DType gradient = 0;
+    for (size_t p = p_start; p < p_end; ++p) {
+      for (size_t q = q_start; q < q_end; ++q) {
+        size_t max_idx = max_index_slice[p * output_width + q];
+        if (p * stride_height + max_idx / filter_width == h &&
+          q * stride_width + max_idx % filter_width == w) {
+          gradient += output_slice[p * output_width + q];
+        }
+      }
+    }
+    input[index] = gradient;
   }
 }
 
@@ -103,7 +124,7 @@ template<typename DType>
 void Backend<GPUTensor, DType>::MaxPooling2DBackwardFunc(
   const GPUTensor<DType>* output,
   GPUTensor<DType>* input,
-  const GPUTensor<size_t>* max_index,
+  const GPUTensor<unsigned char>* max_index,
   size_t filter_height,
   size_t filter_width,
   size_t stride_height,
@@ -118,16 +139,133 @@ void Backend<GPUTensor, DType>::MaxPooling2DBackwardFunc(
   const Shape& output_shape = output->shape();
   size_t output_height = output_shape[2];
   size_t output_width = output_shape[3];
-  // set zero
-  input->Fill(0);
   GPUMaxPoolingBackward<DType>
-    <<<BlitzGPUGetBlocks(output->size()), BLITZ_NUM_GPU_THREADS>>>(
+    <<<BlitzGPUGetBlocks(input->size()), BLITZ_NUM_GPU_THREADS>>>(
     output->data(), input->data(), max_index->data(),
-    output->size(), channel, input_height, input_width,
+    input->size(), channel, input_height, input_width,
     output_height, output_width,
     filter_height, filter_width,
     stride_height, stride_width);
 }
 
+template<typename DType>
+__global__ void GPUAvgPoolingForward(
+  const DType* input,
+  DType* output,
+  size_t size,
+  size_t input_height,
+  size_t input_width,
+  size_t output_height,
+  size_t output_width,
+  size_t filter_height,
+  size_t filter_width,
+  size_t stride_height,
+  size_t stride_width) {
+  BLITZ_CUDA_LOOP(index, size) {
+    size_t output_width_index = index % output_width;
+    size_t output_height_index = (index / output_width) % output_height;
+    size_t plane = index / (output_width * output_height);
+    const DType* window = input +
+      (plane * input_height + output_height_index * stride_height) *
+      input_width + output_width_index * stride_width;
+    DType sum = 0;
+    for (size_t i = 0; i < filter_height; ++i) {
+      for (size_t j = 0; j < filter_width; ++j) {
+        sum += window[i * input_width + j];
+      }
+    }
+    output[index] = sum / (filter_height * filter_width);
+  }
+}
+
+template<typename DType>
+void Backend<GPUTensor, DType>::AvgPooling2DForwardFunc(
+  const GPUTensor<DType>* input,
+  GPUTensor<DType>* output,
+  GPUTensor<DType>* workspace,
+  size_t filter_height,
+  size_t filter_width,
+  size_t stride_height,
+  size_t stride_width) {
+  // shape decode
+  // input
+  const Shape& input_shape = input->shape();
+  size_t channel = input_shape[1];
+  size_t input_height = input_shape[2];
+  size_t input_width = input_shape[3];
+  // output
+  const Shape& output_shape = output->shape();
+  size_t output_channel = output_shape[1];
+  size_t output_height = output_shape[2];
+  size_t output_width = output_shape[3];
+  CHECK_EQ(channel, output_channel);
+  GPUAvgPoolingForward<DType>
+    <<<BlitzGPUGetBlocks(output->size()), BLITZ_NUM_GPU_THREADS>>>(
+    input->data(), output->data(),
+    output->size(), input_height, input_width,
+    output_height, output_width,
+    filter_height, filter_width,
+    stride_height, stride_width);
+}
+
+template<typename DType>
+__global__ void GPUAvgPoolingBackward(
+  const DType* output,
+  DType* input,
+  size_t size,
+  size_t input_height,
+  size_t input_width,
+  size_t output_height,
+  size_t output_width,
+  size_t filter_height,
+  size_t filter_width,
+  size_t stride_height,
+  size_t stride_width) {
+  BLITZ_CUDA_LOOP(index, size) {
+    size_t w = index % input_width;
+    size_t h = (index / input_width) % input_height;
+    size_t plane = index / (input_width * input_height);
+    size_t p_start = h < filter_height ? 0 :
+      (h - filter_height) / stride_height + 1;
+    size_t p_end = min(h / stride_height + 1, output_height);
+    size_t q_start = w < filter_width ? 0 :
+      (w - filter_width) / stride_width + 1;
+    size_t q_end = min(w / stride_width + 1, output_width);
+    const DType* output_slice = output + plane * output_height * output_width;
+    DType gradient = 0;
+    for (size_t p = p_start; p < p_end; ++p) {
+      for (size_t q = q_start; q < q_end; ++q) {
+        gradient += output_slice[p * output_width + q];
+      }
+    }
+    input[index] = gradient / (filter_height * filter_width);
+  }
+}
+
+template<typename DType>
+void Backend<GPUTensor, DType>::AvgPooling2DBackwardFunc(
+  const GPUTensor<DType>* output,
+  GPUTensor<DType>* input,
+  size_t filter_height,
+  size_t filter_width,
+  size_t stride_height,
+  size_t stride_width) {
+  // shape decode
+  // input
+  const Shape& input_shape = input->shape();
+  size_t input_height = input_shape[2];
+  size_t input_width = input_shape[3];
+  // output
+  const Shape& output_shape = output->shape();
+  size_t output_height = output_shape[2];
+  size_t output_width = output_shape[3];
+  GPUAvgPoolingBackward<DType>
+    <<<BlitzGPUGetBlocks(input->size()), BLITZ_NUM_GPU_THREADS>>>(
+    output->data(), input->data(),
+    input->size(), input_height, input_width,
+    output_height, output_width,
+    filter_height, filter_width,
+    stride_height, stride_width);
+}
 
 #endif  // SRC_BACKEND_GPU_BACKEND_POOL_INL_H_
@@ -9,7 +9,9 @@ namespace blitz {
 
 template<typename DType>
 GPUTensor<DType>::~GPUTensor() {
-  cudaFree(this->data_);
+  if (this->owner_) {
+    cudaFree(this->data_);
+  }
 }
 
 template<typename DType>
@@ -43,6 +45,23 @@ template<typename DType>
 inline void GPUTensor<DType>::OutputCSV(ofstream* ofs) const {
 }
 
+template<typename DType>
+inline void GPUTensor<DType>::Relocate(DType* data) {
+  cudaMemcpy(data, this->data_, sizeof(DType) * this->size(),
+    cudaMemcpyDeviceToDevice);
+  if (this->owner_) {
+    cudaFree(this->data_);
+  }
+  this->data_ = data;
+  this->owner_ = false;
+}
+
+template<typename DType>
+inline void GPUTensor<DType>::Attach(DType* data) {
+  cudaMemcpy(this->data_, data, sizeof(DType) * this->size(),
+    cudaMemcpyHostToDevice);
+}
+
 INSTANTIATE_TENSOR(GPUTensor);
 
 }  // namespace blitz
@@ -2,7 +2,11 @@
 
 #include <omp.h>
 
+#include <algorithm>
+
 #include "utils/blitz_cpu_function.h"
+#include "utils/blitz_profiler.h"
+#include "utils/blitz_random_function.h"
 #include "utils/blitz_shape_function.h"
 #include "kernels/xsmm_function.h"
 
@@ -45,7 +45,10 @@ template<typename DType>
 void Backend<MICTensor, DType>::LogisticDerivativeFunc(
   const MICTensor<DType>* input, MICTensor<DType>* output) {
   CHECK_EQ(input->size(), output->size());
-  // TODO(keren) not short cut version
+  #pragma omp parallel for
+  for (size_t i = 0; i < input->size(); ++i) {
+    (*output)[i] *= (*input)[i] * (1 - (*input)[i]);
+  }
 }
 
 template<typename DType>
@@ -217,34 +220,186 @@ void Backend<MICTensor, DType>::CrossEntropyMultiDerivativeFunc(
 }
 
 template<typename DType>
-void Backend<MICTensor, DType>::BiasForwardFunc(
-  const MICTensor<DType>* input, const MICTensor<DType>* bias,
-  MICTensor<DType>* output) {
+DType Backend<MICTensor, DType>::SoftmaxCrossEntropyMultiFunc(
+  const MICTensor<DType>* input, const MICTensor<DType>* target,
+  MICTensor<DType>* output, MICTensor<DType>* gradient, float* accuracy) {
+  CHECK_EQ(input->size(), target->size());
   CHECK_EQ(input->size(), output->size());
   size_t num_sample = input->shape()[0];
   size_t dim = input->size() / num_sample;
+  DType loss = 0;
+  float correct = 0.0f;
 
   #pragma omp parallel for
   for (size_t i = 0; i < num_sample; ++i) {
+    const DType* input_slice = input->Slice(i * dim);
+    const DType* target_slice = target->Slice(i * dim);
+    DType* output_slice = output->Slice(i * dim);
+    size_t max_index = 0;
+    for (size_t j = 1; j < dim; ++j) {
+      if (input_slice[max_index] < input_slice[j]) {
+        max_index = j;
+      }
+    }
+    const DType max = input_slice[max_index];
+    const bool hit = target_slice[max_index] == static_cast<DType>(1);
+
+    DType sum = 0;
+    DType dot = 0;
+    DType mass = 0;
+    for (size_t j = 0; j < dim; ++j) {
+      const DType value = input_slice[j] - max;
+      dot += target_slice[j] * value;
+      mass += target_slice[j];
+      output_slice[j] = exp(value);
+      sum += output_slice[j];
+    }
+
     for (size_t j = 0; j < dim; ++j) {
-      (*output)[i * dim + j] = (*input)[i * dim + j] + (*bias)[j];
+      output_slice[j] /= sum;
+      if (gradient != NULL) {
+        (*gradient)[i * dim + j] = output_slice[j] - target_slice[j];
+      }
     }
+
+    #pragma omp atomic
+    loss += mass * log(sum) - dot;
+    if (hit) {
+      #pragma omp atomic
+      correct += 1.0f;
+    }
+  }
+
+  if (accuracy != NULL) {
+    *accuracy = correct / num_sample;
   }
+  return loss / num_sample;
+}
+
+// element k of channel c in a N x C x S or N x S x C buffer
+inline size_t ChannelIndex(size_t c, size_t k, size_t C, size_t S,
+  bool channel_last) {
+  return channel_last ? k * C + c : (k / S * C + c) * S + k % S;
+}
+
+template<typename DType>
+void Backend<MICTensor, DType>::BiasForwardFunc(
+  const MICTensor<DType>* input, const MICTensor<DType>* bias,
+  MICTensor<DType>* output) {
+  EpilogueForwardFunc(input, bias, NULL, NULL, output,
+    BLITZ_ACTIVATION_NONE, static_cast<DType>(0));
 }
 
 template<typename DType>
 void Backend<MICTensor, DType>::BiasBackwardUpdateFunc(
   const MICTensor<DType>* input, MICTensor<DType>* update) {
-  size_t num_sample = input->shape()[0];
+  size_t N, C, S;
+  const bool channel_last = BlitzChannelView(&(input->shape()),
+    &N, &C, &S);
+  #pragma omp parallel for
+  for (size_t c = 0; c < C; ++c) {
+    for (size_t k = 0; k < N * S; ++k) {
+      (*update)[c] += (*input)[ChannelIndex(c, k, C, S, channel_last)];
+    }
+  }
+}
+
+template<typename DType>
+inline DType EpilogueActivationApply(DType value,
+  BLITZ_ACTIVATION activation, DType slope) {
+  switch (activation) {
+    case BLITZ_ACTIVATION_RECTLIN:
+      return std::max(value, static_cast<DType>(0)) +
+        slope * std::min(value, static_cast<DType>(0));
+    case BLITZ_ACTIVATION_LOGISTIC:
+      return 1 / (exp(-value) + 1);
+    default:
+      return value;
+  }
+}
+
+template<typename DType>
+inline DType EpilogueActivationDerivative(DType output,
+  BLITZ_ACTIVATION activation, DType slope) {
+  switch (activation) {
+    case BLITZ_ACTIVATION_RECTLIN:
+      return output > 0 ? 1 : slope;
+    case BLITZ_ACTIVATION_LOGISTIC:
+      return output * (1 - output);
+    default:
+      return 1;
+  }
+}
+
+template<typename DType>
+void Backend<MICTensor, DType>::EpilogueForwardFunc(
+  const MICTensor<DType>* input,
+  const MICTensor<DType>* bias,
+  const MICTensor<DType>* scale,
+  const MICTensor<DType>* shift,
+  MICTensor<DType>* output,
+  BLITZ_ACTIVATION activation,
+  DType slope) {
+  CHECK_EQ(input->size(), output->size());
+  size_t num_sample, C, S;
+  const bool channel_last = BlitzChannelView(&(input->shape()),
+    &num_sample, &C, &S);
   size_t dim = input->size() / num_sample;
+  const DType* bias_data = bias != NULL ? bias->data() : NULL;
+  const DType* scale_data = scale != NULL ? scale->data() : NULL;
+  const DType* shift_data = shift != NULL ? shift->data() : NULL;
+  // one pass per sample: bias, then scale & shift, then activation
   #pragma omp parallel for
-  for (size_t i = 0; i < dim; ++i) {
-    for (size_t j = 0; j < num_sample; ++j) {
-      (*update)[i] += (*input)[j * dim + i];
+  for (size_t i = 0; i < num_sample; ++i) {
+    const DType* input_slice = input->Slice(i * dim);
+    DType* output_slice = output->Slice(i * dim);
+    #pragma simd
+    for (size_t j = 0; j < dim; ++j) {
+      DType value = input_slice[j];
+      if (bias_data != NULL) {
+        value += bias_data[channel_last ? j % C : j / S];
+      }
+      if (scale_data != NULL) {
+        value = scale_data[j] * value + shift_data[j];
+      }
+      output_slice[j] = EpilogueActivationApply(value, activation, slope);
     }
   }
 }
 
+template<typename DType>
+void Backend<MICTensor, DType>::EpilogueBackwardFunc(
+  const MICTensor<DType>* forward_output,
+  MICTensor<DType>* backward_input,
+  MICTensor<DType>* bias_update,
+  BLITZ_ACTIVATION activation,
+  DType slope) {
+  CHECK_EQ(forward_output->size(), backward_input->size());
+  size_t N, C, S;
+  const bool channel_last = BlitzChannelView(&(backward_input->shape()),
+    &N, &C, &S);
+  if (bias_update != NULL) {
+    // a thread per channel accumulates the bias gradient
+    #pragma omp parallel for
+    for (size_t c = 0; c < C; ++c) {
+      for (size_t k = 0; k < N * S; ++k) {
+        const size_t index = ChannelIndex(c, k, C, S, channel_last);
+        DType value = (*backward_input)[index] *
+          EpilogueActivationDerivative((*forward_output)[index],
+          activation, slope);
+        (*backward_input)[index] = value;
+        (*bias_update)[c] += value;
+      }
+    }
+    return;
+  }
+  #pragma omp parallel for
+  for (size_t i = 0; i < backward_input->size(); ++i) {
+    (*backward_input)[i] *= EpilogueActivationDerivative(
+      (*forward_output)[i], activation, slope);
+  }
+}
+
 template<typename DType>
 void Backend<MICTensor, DType>::BatchNormForwardFunc(
   const MICTensor<DType>* input,
@@ -253,36 +408,42 @@ void Backend<MICTensor, DType>::BatchNormForwardFunc(
   MICTensor<DType>* input_var,
   MICTensor<DType>* input_hat,
   MICTensor<DType>* output,
+  MICTensor<DType>* running_mean,
+  MICTensor<DType>* running_var,
+  DType momentum,
   DType epsilon) {
-  size_t num_sample = input->shape()[0];
-  size_t dim = input->size() / num_sample;
-  input_var->Fill(0);
-  input_hat->Fill(0);
+  size_t N, C, S;
+  const bool channel_last = BlitzChannelView(&(input->shape()),
+    &N, &C, &S);
+  const size_t count = N * S;
 
   #pragma omp parallel for
-  for (size_t i = 0; i < dim; ++i) {
+  for (size_t c = 0; c < C; ++c) {
     DType mean = 0.0;
-    for (size_t j = 0; j < num_sample; ++j) {
-      mean += (*input)[j * dim + i];
+    for (size_t k = 0; k < count; ++k) {
+      mean += (*input)[ChannelIndex(c, k, C, S, channel_last)];
     }
-    mean /= num_sample;
+    mean /= count;
 
-    DType var;
-    for (size_t j = 0; j < num_sample; ++j) {
-      var = (*input)[j * dim + i] - mean;
-      (*input_var)[i] += var * var;
+    DType var = 0.0;
+    for (size_t k = 0; k < count; ++k) {
+      const DType diff = (*input)[ChannelIndex(c, k, C, S,
+        channel_last)] - mean;
+      var += diff * diff;
     }
-    (*input_var)[i] /= num_sample;
-
-    DType divider = sqrt((*input_var)[i] + epsilon);
-
-    size_t index = 0;
-    for (size_t j = 0; j < num_sample; ++j) {
-      index = j * dim + i;
-      (*input_hat)[index] = ((*input)[index] -
-        mean) / divider;
-      (*output)[index] = (*gamma)[i] * (*input_hat)[index] +
-        (*beta)[i];
+    var /= count;
+    (*input_var)[c] = var;
+    (*running_mean)[c] = momentum * (*running_mean)[c] +
+      (1 - momentum) * mean;
+    (*running_var)[c] = momentum * (*running_var)[c] +
+      (1 - momentum) * (count > 1 ? var * count / (count - 1) : var);
+
+    DType divider = sqrt(var + epsilon);
+
+    for (size_t k = 0; k < count; ++k) {
+      const size_t index = ChannelIndex(c, k, C, S, channel_last);
+      (*input_hat)[index] = ((*input)[index] - mean) / divider;
+      (*output)[index] = (*gamma)[c] * (*input_hat)[index] + (*beta)[c];
     }
   }
 }
@@ -297,29 +458,51 @@ void Backend<MICTensor, DType>::BatchNormBackwardFunc(
   MICTensor<DType>* beta_update,
   MICTensor<DType>* output,
   DType epsilon) {
-  size_t num_sample = backward_input->shape()[0];
-  size_t dim = backward_input->size() / num_sample;
+  size_t N, C, S;
+  const bool channel_last = BlitzChannelView(&(backward_input->shape()),
+    &N, &C, &S);
+  const size_t count = N * S;
 
   #pragma omp parallel for
-  for (size_t i = 0; i < dim; ++i) {
-    for (size_t j = 0; j < num_sample; ++j) {
-      const size_t index = j * dim + i;
-      (*gamma_update)[i] += (*forward_input_hat)[index] *
+  for (size_t c = 0; c < C; ++c) {
+    for (size_t k = 0; k < count; ++k) {
+      const size_t index = ChannelIndex(c, k, C, S, channel_last);
+      (*gamma_update)[c] += (*forward_input_hat)[index] *
         (*backward_input)[index];
-      (*beta_update)[i] += (*backward_input)[index];
+      (*beta_update)[c] += (*backward_input)[index];
     }
 
     DType xhat;
-    for (size_t j = 0; j < num_sample; ++j) {
-      const size_t index = j * dim + i;
-      xhat = ((*forward_input_hat)[index] * (*gamma_update)[i] +
-        (*beta_update)[i]) / num_sample;
-      (*output)[index] = (*gamma)[i] * ((*backward_input)[index] -
-        xhat) / sqrt((*forward_input_var)[i] + epsilon);
+    for (size_t k = 0; k < count; ++k) {
+      const size_t index = ChannelIndex(c, k, C, S, channel_last);
+      xhat = ((*forward_input_hat)[index] * (*gamma_update)[c] +
+        (*beta_update)[c]) / count;
+      (*output)[index] = (*gamma)[c] * ((*backward_input)[index] -
+        xhat) / sqrt((*forward_input_var)[c] + epsilon);
     }
   }
 }
 
+template<typename DType>
+void Backend<MICTensor, DType>::BatchNormScaleShiftFunc(
+  const MICTensor<DType>* gamma,
+  const MICTensor<DType>* beta,
+  const MICTensor<DType>* running_mean,
+  const MICTensor<DType>* running_var,
+  MICTensor<DType>* scale,
+  MICTensor<DType>* shift,
+  DType epsilon) {
+  size_t N, C, S;
+  const bool channel_last = BlitzChannelView(&(scale->shape()),
+    &N, &C, &S);
+  #pragma omp parallel for
+  for (size_t i = 0; i < scale->size(); ++i) {
+    const size_t c = channel_last ? i % C : (i / S) % C;
+    (*scale)[i] = (*gamma)[c] / sqrt((*running_var)[c] + epsilon);
+    (*shift)[i] = (*beta)[c] - (*running_mean)[c] * (*scale)[i];
+  }
+}
+
 template<typename DType>
 void Backend<MICTensor, DType>::GradientdescentFunc(
   MICTensor<DType>* weight,
@@ -348,6 +531,75 @@ void Backend<MICTensor, DType>::GradientdescentFunc(
   }
 }
 
+template<typename DType>
+void Backend<MICTensor, DType>::NesterovFunc(
+  MICTensor<DType>* weight,
+  MICTensor<DType>* gradient,
+  MICTensor<DType>* velocity,
+  DType momentum_coef,
+  DType learning_rate,
+  DType decay,
+  size_t batch_size) {
+  CHECK_EQ(weight->size(), gradient->size());
+  CHECK_EQ(gradient->size(), velocity->size());
+
+  #pragma omp parallel for
+  for (size_t i = 0; i < velocity->size(); ++i) {
+    DType g = (*gradient)[i] / batch_size + decay * (*weight)[i];
+    DType v = (*velocity)[i] * momentum_coef - learning_rate * g;
+    (*weight)[i] += v + momentum_coef * (v - (*velocity)[i]);
+    (*velocity)[i] = v;
+  }
+}
+
+template<typename DType>
+void Backend<MICTensor, DType>::RMSPropFunc(
+  MICTensor<DType>* weight,
+  MICTensor<DType>* gradient,
+  MICTensor<DType>* mean_square,
+  DType rho,
+  DType epsilon,
+  DType learning_rate,
+  DType decay,
+  size_t batch_size) {
+  CHECK_EQ(weight->size(), gradient->size());
+  CHECK_EQ(gradient->size(), mean_square->size());
+
+  #pragma omp parallel for
+  for (size_t i = 0; i < mean_square->size(); ++i) {
+    DType g = (*gradient)[i] / batch_size + decay * (*weight)[i];
+    (*mean_square)[i] = rho * (*mean_square)[i] + (1 - rho) * g * g;
+    (*weight)[i] -= learning_rate * g /
+      (sqrt((*mean_square)[i]) + epsilon);
+  }
+}
+
+template<typename DType>
+void Backend<MICTensor, DType>::AdamFunc(
+  MICTensor<DType>* weight,
+  MICTensor<DType>* gradient,
+  MICTensor<DType>* first_moment,
+  MICTensor<DType>* second_moment,
+  DType beta1,
+  DType beta2,
+  DType epsilon,
+  DType learning_rate,
+  DType decay,
+  size_t batch_size) {
+  CHECK_EQ(weight->size(), gradient->size());
+  CHECK_EQ(gradient->size(), first_moment->size());
+  CHECK_EQ(first_moment->size(), second_moment->size());
+
+  #pragma omp parallel for
+  for (size_t i = 0; i < first_moment->size(); ++i) {
+    DType g = (*gradient)[i] / batch_size + decay * (*weight)[i];
+    (*first_moment)[i] = beta1 * (*first_moment)[i] + (1 - beta1) * g;
+    (*second_moment)[i] = beta2 * (*second_moment)[i] + (1 - beta2) * g * g;
+    (*weight)[i] -= learning_rate * (*first_moment)[i] /
+      (sqrt((*second_moment)[i]) + epsilon);
+  }
+}
+
 template<typename DType>
 void Backend<MICTensor, DType>::MatrixMultiplyFunc(
   const MICTensor<DType>* left,
@@ -391,6 +643,235 @@ void Backend<MICTensor, DType>::Transpose2DFunc(
   }
 }
 
+template<typename DType>
+void Backend<MICTensor, DType>::TransformLayoutFunc(
+  const MICTensor<DType>* input, MICTensor<DType>* output) {
+  size_t batch, rows, cols;
+  size_t input_ld, output_ld, input_stride, output_stride;
+  if (!BlitzTransposeView(input->shape_ptr(), output->shape_ptr(),
+    &batch, &rows, &cols, &input_ld, &output_ld,
+    &input_stride, &output_stride)) {
+    BlitzCPUCopy(input->data(), output->data(), input->size());
+    return;
+  }
+  #pragma omp parallel for collapse(3)
+  for (size_t b = 0; b < batch; ++b) {
+    for (size_t j = 0; j < cols; ++j) {
+      for (size_t i = 0; i < rows; ++i) {
+        (*output)[b * output_stride + j * output_ld + i] =
+          (*input)[b * input_stride + i * input_ld + j];
+      }
+    }
+  }
+}
+
+template<typename DType>
+void Backend<MICTensor, DType>::CompressFunc(
+  const MICTensor<DType>* input,
+  MICTensor<unsigned short>* output,
+  BLITZ_PRECISION precision) {
+  CHECK_EQ(input->size(), output->size());
+  if (precision == BLITZ_PRECISION_HALF) {
+    #pragma omp parallel for
+    for (size_t i = 0; i < input->size(); ++i) {
+      (*output)[i] = BlitzFloatToHalf(static_cast<float>((*input)[i]));
+    }
+  } else if (precision == BLITZ_PRECISION_BFLOAT) {
+    #pragma omp parallel for
+    for (size_t i = 0; i < input->size(); ++i) {
+      (*output)[i] = BlitzFloatToBFloat(static_cast<float>((*input)[i]));
+    }
+  } else {
+    LOG(FATAL) << "Unsupported storage precision: " << precision;
+  }
+}
+
+template<typename DType>
+void Backend<MICTensor, DType>::DecompressFunc(
+  const MICTensor<unsigned short>* input,
+  MICTensor<DType>* output,
+  BLITZ_PRECISION precision) {
+  CHECK_EQ(input->size(), output->size());
+  if (precision == BLITZ_PRECISION_HALF) {
+    #pragma omp parallel for
+    for (size_t i = 0; i < input->size(); ++i) {
+      (*output)[i] = BlitzHalfToFloat((*input)[i]);
+    }
+  } else if (precision == BLITZ_PRECISION_BFLOAT) {
+    #pragma omp parallel for
+    for (size_t i = 0; i < input->size(); ++i) {
+      (*output)[i] = BlitzBFloatToFloat((*input)[i]);
+    }
+  } else {
+    LOG(FATAL) << "Unsupported storage precision: " << precision;
+  }
+}
+
+template<typename DType>
+void Backend<MICTensor, DType>::RangeFunc(
+  const MICTensor<DType>* input,
+  DType* minimum,
+  DType* maximum) {
+  DType low = (*input)[0];
+  DType high = (*input)[0];
+  for (size_t i = 0; i < input->size(); ++i) {
+    low = std::min(low, (*input)[i]);
+    high = std::max(high, (*input)[i]);
+  }
+  *minimum = low;
+  *maximum = high;
+}
+
+template<typename DType>
+void Backend<MICTensor, DType>::QuantizeWeightFunc(
+  const MICTensor<DType>* weight,
+  MICTensor<signed char>* quantized_weight,
+  MICTensor<DType>* weight_scale,
+  MICTensor<int>* weight_sum,
+  bool transpose) {
+  const Shape& shape = weight->shape();
+  const size_t N = transpose ? shape[0] : shape[shape.dimension() - 1];
+  const size_t K = weight->size() / N;
+  CHECK_EQ(quantized_weight->size(), BlitzQuantizedWeightSize(K, N));
+  CHECK_EQ(weight_scale->size(), N);
+  CHECK_EQ(weight_sum->size(), N);
+  const size_t ldw = BlitzQuantizeColumns(N);
+  const size_t ldk = transpose ? 1 : N;
+  quantized_weight->Fill(0);
+  #pragma omp parallel for
+  for (size_t n = 0; n < N; ++n) {
+    const DType* column = weight->data() + (transpose ? n * K : n);
+    DType maximum = 0;
+    for (size_t k = 0; k < K; ++k) {
+      maximum = std::max(maximum, static_cast<DType>(fabs(column[k * ldk])));
+    }
+    const DType scale = maximum > 0 ? maximum / 127 : 1;
+    int sum = 0;
+    for (size_t k = 0; k < K; ++k) {
+      const int level = std::min(127, std::max(-127,
+        static_cast<int>(nearbyint(column[k * ldk] / scale))));
+      (*quantized_weight)[((k / BLITZ_QUANTIZE_GROUP) * ldw + n) *
+        BLITZ_QUANTIZE_GROUP + k % BLITZ_QUANTIZE_GROUP] = level;
+      sum += level;
+    }
+    (*weight_scale)[n] = scale;
+    (*weight_sum)[n] = sum;
+  }
+}
+
+template<typename DType>
+void Backend<MICTensor, DType>::QuantizedMatrixMultiplyFunc(
+  const MICTensor<DType>* input,
+  const MICTensor<signed char>* quantized_weight,
+  const MICTensor<DType>* weight_scale,
+  const MICTensor<int>* weight_sum,
+  MICTensor<DType>* output,
+  MICTensor<unsigned char>* workspace,
+  DType input_scale,
+  unsigned char zero_point) {
+  const size_t M = (input->shape())[0];
+  const size_t K = input->size() / M;
+  const size_t N = output->size() / M;
+  CHECK_EQ(quantized_weight->size(), BlitzQuantizedWeightSize(K, N));
+  CHECK_GE(workspace->size(), M * K);
+  unsigned char* levels = workspace->data();
+  const DType inverse_scale = 1 / input_scale;
+  #pragma omp parallel for
+  for (size_t i = 0; i < M * K; ++i) {
+    levels[i] = BlitzQuantize((*input)[i], inverse_scale, zero_point);
+  }
+  const size_t ldw = BlitzQuantizeColumns(N);
+  #pragma omp parallel for
+  for (size_t m = 0; m < M; ++m) {
+    for (size_t n = 0; n < N; ++n) {
+      int sum = 0;
+      for (size_t k = 0; k < K; ++k) {
+        sum += levels[m * K + k] *
+          (*quantized_weight)[((k / BLITZ_QUANTIZE_GROUP) * ldw + n) *
+          BLITZ_QUANTIZE_GROUP + k % BLITZ_QUANTIZE_GROUP];
+      }
+      (*output)[m * N + n] = (sum - zero_point * (*weight_sum)[n]) *
+        input_scale * (*weight_scale)[n];
+    }
+  }
+}
+
+template<typename DType>
+void Backend<MICTensor, DType>::QuantizedConvolution2DForwardFunc(
+  const MICTensor<DType>* input,
+  const MICTensor<signed char>* quantized_weight,
+  const MICTensor<DType>* weight_scale,
+  const MICTensor<int>* weight_sum,
+  MICTensor<DType>* output,
+  MICTensor<unsigned char>* workspace,
+  DType input_scale,
+  unsigned char zero_point,
+  size_t filter_height,
+  size_t filter_width,
+  size_t padding_height,
+  size_t padding_width,
+  size_t stride_height,
+  size_t stride_width) {
+  // shape decode
+  size_t NIN, C, H, W;
+  size_t NOUT, K, P, Q;
+  CHECK_EQ(input->data_layout(), output->data_layout());
+  Blitz2DBuffer(input->data_layout(), input->shape_ptr(), &NIN, &C, &H, &W);
+  Blitz2DBuffer(output->data_layout(), output->shape_ptr(), &NOUT, &K, &P, &Q);
+  CHECK_EQ(NIN, NOUT);
+  if (input->data_layout() != BLITZ_BUFFER_NCHW &&
+    input->data_layout() != BLITZ_BUFFER_NHWC) {
+    LOG(FATAL) << "Blitz not support int8 convolution format: " <<
+      input->data_layout();
+  }
+  const size_t R = filter_height;
+  const size_t S = filter_width;
+  CHECK_EQ(quantized_weight->size(), BlitzQuantizedWeightSize(C * R * S, K));
+  CHECK_GE(workspace->size(), input->size());
+  unsigned char* levels = workspace->data();
+  const DType inverse_scale = 1 / input_scale;
+  #pragma omp parallel for
+  for (size_t i = 0; i < input->size(); ++i) {
+    levels[i] = BlitzQuantize((*input)[i], inverse_scale, zero_point);
+  }
+  const bool nchw = input->data_layout() == BLITZ_BUFFER_NCHW;
+  const size_t ldw = BlitzQuantizeColumns(K);
+  #pragma omp parallel for collapse(2)
+  for (size_t n = 0; n < NIN; ++n) {
+    for (size_t k = 0; k < K; ++k) {
+      const unsigned char* levels_slice = levels + n * C * H * W;
+      for (size_t p = 0; p < P; ++p) {
+        for (size_t q = 0; q < Q; ++q) {
+          int sum = 0;
+          for (size_t r = 0; r < R; ++r) {
+            // unsigned wrap around puts the padding above H and W
+            const size_t h = p * stride_height + r - padding_height;
+            for (size_t s = 0; s < S; ++s) {
+              const size_t w = q * stride_width + s - padding_width;
+              const bool inside = h < H && w < W;
+              for (size_t c = 0; c < C; ++c) {
+                // CRS rows for NCHW, RSC rows for NHWC
+                const size_t row = nchw ? (c * R + r) * S + s :
+                  (r * S + s) * C + c;
+                const int level = !inside ? zero_point : (nchw ?
+                  levels_slice[(c * H + h) * W + w] :
+                  levels_slice[(h * W + w) * C + c]);
+                sum += level * (*quantized_weight)[
+                  ((row / BLITZ_QUANTIZE_GROUP) * ldw + k) *
+                  BLITZ_QUANTIZE_GROUP + row % BLITZ_QUANTIZE_GROUP];
+              }
+            }
+          }
+          const size_t index = nchw ? ((n * K + k) * P + p) * Q + q :
+            ((n * P + p) * Q + q) * K + k;
+          (*output)[index] = (sum - zero_point * (*weight_sum)[k]) *
+            input_scale * (*weight_scale)[k];
+        }
+      }
+    }
+  }
+}
+
 template<typename DType>
 void Backend<MICTensor, DType>::MaximumFunc(
   const MICTensor<DType>* left, const MICTensor<DType>* right,
@@ -467,15 +948,23 @@ void Backend<MICTensor, DType>::MakeBinaryMaskFunc(
   MICTensor<DType>* output,
   DType low,
   DType high,
-  DType keep) { 
-  UniformDistributionFunc(output, low, high);
-
+  DType keep) {
+  const uint64_t seed = BlitzRandomSeed();
+  const uint64_t stream = BlitzRandomNextStream();
+  const size_t size = output->size();
+  const size_t block_size = BlitzRandomBlock<DType>::size();
+  const size_t blocks = (size + block_size - 1) / block_size;
+  DType* data = output->data();
+
+  // draw and threshold in the same pass
   #pragma omp parallel for
-  for (size_t i = 0; i < output->size(); ++i) {
-    if ((*output)[i] < keep) {
-      (*output)[i] = DType(1);
-    } else {
-      (*output)[i] = DType(0);
+  for (size_t i = 0; i < blocks; ++i) {
+    DType value[4];
+    BlitzRandomUniform(seed, stream, i, low, high, value);
+    const size_t begin = i * block_size;
+    const size_t end = std::min(begin + block_size, size);
+    for (size_t j = begin; j < end; ++j) {
+      data[j] = value[j - begin] < keep ? DType(1) : DType(0);
     }
   }
 }
@@ -489,34 +978,44 @@ void Backend<MICTensor, DType>::ConstantDistributionFunc(
 template<typename DType>
 void Backend<MICTensor, DType>::NormalDistributionFunc(
   MICTensor<DType>* output, DType loc, DType scale) {
-  // TODO(keren) synchronized seed
-  static unsigned int seed = 0;
-  boost::mt19937 rng((++seed) + time(NULL));
-  boost::normal_distribution<DType> nd(loc, scale);  // convert to DType
-  boost::variate_generator<boost::mt19937&,
-    boost::normal_distribution<DType> > var_nor(rng, nd);
-  var_nor.distribution().reset();
+  const uint64_t seed = BlitzRandomSeed();
+  const uint64_t stream = BlitzRandomNextStream();
+  const size_t size = output->size();
+  const size_t block_size = BlitzRandomBlock<DType>::size();
+  const size_t blocks = (size + block_size - 1) / block_size;
+  DType* data = output->data();
 
-  size_t size = output->size();
-  for (size_t i = 0; i < size; ++i) {
-    (*output)[i] = var_nor();
+  #pragma omp parallel for
+  for (size_t i = 0; i < blocks; ++i) {
+    DType value[4];
+    BlitzRandomNormal(seed, stream, i, loc, scale, value);
+    const size_t begin = i * block_size;
+    const size_t end = std::min(begin + block_size, size);
+    for (size_t j = begin; j < end; ++j) {
+      data[j] = value[j - begin];
+    }
   }
 }
 
 template<typename DType>
 void Backend<MICTensor, DType>::UniformDistributionFunc(
   MICTensor<DType>* output, DType low, DType high) {
-  // TODO(keren) synchronized seed
-  static unsigned int seed = 0;
-  boost::mt19937 rng((++seed) + time(NULL));
-  boost::uniform_real<DType> ur(low, high);  // convert to DType
-  boost::variate_generator<boost::mt19937&,
-    boost::uniform_real<DType> > var_uni(rng, ur);
-  var_uni.distribution().reset();
+  const uint64_t seed = BlitzRandomSeed();
+  const uint64_t stream = BlitzRandomNextStream();
+  const size_t size = output->size();
+  const size_t block_size = BlitzRandomBlock<DType>::size();
+  const size_t blocks = (size + block_size - 1) / block_size;
+  DType* data = output->data();
 
-  size_t size = output->size();
-  for (size_t i = 0; i < size; ++i) {
-    (*output)[i] = var_uni();
+  #pragma omp parallel for
+  for (size_t i = 0; i < blocks; ++i) {
+    DType value[4];
+    BlitzRandomUniform(seed, stream, i, low, high, value);
+    const size_t begin = i * block_size;
+    const size_t end = std::min(begin + block_size, size);
+    for (size_t j = begin; j < end; ++j) {
+      data[j] = value[j - begin];
+    }
   }
 }
 
@@ -526,6 +1025,12 @@ void Backend<MICTensor, DType>::HostCopyToFunc(
   BlitzCPUCopy(source, target, size);
 }
 
+template<typename DType>
+void Backend<MICTensor, DType>::HostCopyFromFunc(
+  const DType* source, DType* target, size_t size) {
+  BlitzCPUCopy(source, target, size);
+}
+
 template<typename DType>
 float Backend<MICTensor, DType>::EvaluateClassifyFunc(
   const MICTensor<DType>* output, const MICTensor<DType>* target) {
@@ -24,14 +24,8 @@ void Backend<MICTensor, DType>::Convolution2DForwardFunc(
   CHECK_EQ(KF, K);
   CHECK_EQ(CF, C);
 
-  // time counter
-  #ifdef BLITZ_PERFORMANCE
-  time_point<system_clock> start, end;
-  duration<double> gemm_time = duration<double>::zero();
-  duration<double> unpack_time = duration<double>::zero();
-  double total_gemm_time = 0.0;
-  double total_unpack_time = 0.0;
-  #endif  // BLITZ_PERFORMANCE
+  // xsmm unpacks inside its kernel, the whole call is one stage
+  BlitzProfileStageTimer stage("gemm");
   switch (algorithm) {
     case BLITZ_CONVOLUTION_XSMM_DIRECT:
       // NOTE(keren): it only support output padding
@@ -56,10 +50,6 @@ void Backend<MICTensor, DType>::Convolution2DForwardFunc(
       LOG(FATAL) << "Unupported algorithm type: " << algorithm;
       break;
   }
-  #ifdef BLITZ_PERFORMANCE
-  LOG(INFO) << "Forward convolution gemm: " << total_gemm_time;
-  LOG(INFO) << "Forward convolution unpack: " << total_unpack_time;
-  #endif  // BLITZ_PERFORMANCE
 }
 
 template<typename DType>
@@ -85,13 +75,8 @@ void Backend<MICTensor, DType>::Convolution2DBackwardFunc(
   CHECK_EQ(KF, K);
   CHECK_EQ(CF, C);
 
-  #ifdef BLITZ_PERFORMANCE
-  time_point<system_clock> start, end;
-  duration<double> gemm_time = duration<double>::zero();
-  duration<double> unpack_time = duration<double>::zero();
-  double total_gemm_time = 0.0;
-  double total_unpack_time = 0.0;
-  #endif  // BLITZ_PERFORMANCE
+  // xsmm unpacks inside its kernel, the whole call is one stage
+  BlitzProfileStageTimer stage("gemm");
   switch (algorithm) {
     case BLITZ_CONVOLUTION_XSMM_DIRECT:
       // NOTE(keren): it only support output padding
@@ -115,10 +100,6 @@ void Backend<MICTensor, DType>::Convolution2DBackwardFunc(
       LOG(FATAL) << "Unupported algorithm type: " << algorithm;
       break;
   }
-  #ifdef BLITZ_PERFORMANCE
-  LOG(INFO) << "Forward convolution gemm: " << total_gemm_time;
-  LOG(INFO) << "Forward convolution unpack: " << total_unpack_time;
-  #endif  // BLITZ_PERFORMANCE
 }
 
 template<typename DType>
@@ -143,13 +124,8 @@ void Backend<MICTensor, DType>::Convolution2DUpdateFunc(
   CHECK_EQ(KF, K);
   CHECK_EQ(CF, C);
 
-  #ifdef BLITZ_PERFORMANCE
-  time_point<system_clock> start, end;
-  duration<double> gemm_time = duration<double>::zero();
-  duration<double> unpack_time = duration<double>::zero();
-  double total_gemm_time = 0.0;
-  double total_unpack_time = 0.0;
-  #endif  // BLITZ_PERFORMANCE
+  // xsmm unpacks inside its kernel, the whole call is one stage
+  BlitzProfileStageTimer stage("gemm");
   switch (algorithm) {
     case BLITZ_CONVOLUTION_XSMM_DIRECT:
       // NOTE(keren): it only support output padding
@@ -172,10 +148,6 @@ void Backend<MICTensor, DType>::Convolution2DUpdateFunc(
       LOG(FATAL) << "Unupported algorithm type: " << algorithm;
       break;
   }
-  #ifdef BLITZ_PERFORMANCE
-  LOG(INFO) << "Forward convolution gemm: " << total_gemm_time;
-  LOG(INFO) << "Forward convolution unpack: " << total_unpack_time;
-  #endif  // BLITZ_PERFORMANCE
 }
 
 
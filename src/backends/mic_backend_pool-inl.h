@@ -5,7 +5,7 @@ template<typename DType>
 void MaxPoolingForwardNCHWImpl(
   const DType* I,
   DType* O,
-  size_t* max_index,
+  unsigned char* max_index,
   size_t N,
   size_t C, size_t H, size_t W,
   size_t K, size_t P, size_t Q,
@@ -21,24 +21,22 @@ void MaxPoolingForwardNCHWImpl(
     for (size_t c = 0; c < C; ++c) {
       const DType* input_slice = I + n * CHW + c * HW;
       DType* output_slice = O + n * KPQ + c * PQ;
-      size_t* max_index_slice = max_index + n * KPQ + c * PQ;
       for (size_t oh = 0; oh < P; ++oh) {
         for (size_t ow = 0; ow < Q; ++ow) {
-          size_t hs = oh * str_h;
-          size_t ws = ow * str_w;
-          size_t he = hs + R;
-          size_t we = ws + S;
+          const DType* window = input_slice + oh * str_h * W + ow * str_w;
           size_t pool_index = oh * Q + ow;
-          max_index_slice[pool_index] = hs * W + ws;
-          for (size_t h = hs; h < he; ++h) {
-            for (size_t w = ws; w < we; ++w) {
-              size_t index = h * W + w;
-              if (input_slice[index] > input_slice[max_index_slice[pool_index]]) {
-                max_index_slice[pool_index] = index;
+          size_t max = 0;
+          for (size_t r = 0; r < R; ++r) {
+            for (size_t s = 0; s < S; ++s) {
+              if (window[r * W + s] > window[(max / S) * W + max % S]) {
+                max = r * S + s;
               }
             }
           }
-          output_slice[pool_index] = input_slice[max_index_slice[pool_index]];
+          output_slice[pool_index] = window[(max / S) * W + max % S];
+          if (max_index != NULL) {
+            max_index[n * KPQ + c * PQ + pool_index] = max;
+          }
         }
       }
     }
@@ -49,7 +47,7 @@ template<typename DType>
 void MaxPoolingForwardNHWCImpl(
   const DType* I,
   DType* O,
-  size_t* max_index,
+  unsigned char* max_index,
   size_t N,
   size_t C, size_t H, size_t W,
   size_t K, size_t P, size_t Q,
@@ -61,30 +59,31 @@ void MaxPoolingForwardNHWCImpl(
   for (size_t n = 0; n < N; ++n) {
     const DType* input_slice = I + n * HWC;
     DType* output_slice = O + n * PQK;
-    size_t* max_index_slice = max_index + n * PQK;
+    // inference passes a NULL max_index and keeps only the maximum
+    unsigned char* max_index_slice = max_index != NULL ?
+      max_index + n * PQK : NULL;
     for (size_t oh = 0; oh < P; ++oh) {
       for (size_t ow = 0; ow < Q; ++ow) {
-        const size_t hs = oh * str_h;
-        const size_t ws = ow * str_w;
-        const size_t he = hs + R;
-        const size_t we = ws + S;
+        const DType* window = input_slice + (oh * str_h * W + ow * str_w) * C;
         const size_t pool_index = (oh * Q + ow) * C;
         for (size_t c = 0; c < C; ++c) {
-          max_index_slice[pool_index + c] = (hs * W + ws) * C + c;
+          output_slice[pool_index + c] = window[c];
+          if (max_index_slice != NULL) {
+            max_index_slice[pool_index + c] = 0;
+          }
         }
-        for (size_t h = hs; h < he; ++h) {
-          for (size_t w = ws; w < we; ++w) {
+        for (size_t r = 0; r < R; ++r) {
+          for (size_t s = 0; s < S; ++s) {
             for (size_t c = 0; c < C; ++c) {
-              size_t index = (h * W + w) * C + c;
-              if (input_slice[index] > input_slice[max_index_slice[pool_index + c]]) {
-                max_index_slice[pool_index + c] = index;
+              if (window[(r * W + s) * C + c] > output_slice[pool_index + c]) {
+                output_slice[pool_index + c] = window[(r * W + s) * C + c];
+                if (max_index_slice != NULL) {
+                  max_index_slice[pool_index + c] = r * S + s;
+                }
               }
             }
           }
         }
-        for (size_t c = 0; c < C; ++c) {
-          output_slice[pool_index + c] = input_slice[max_index_slice[pool_index + c]];
-        }
       }
     }
   }
@@ -94,11 +93,11 @@ template<typename DType>
 void Backend<MICTensor, DType>::MaxPooling2DForwardFunc(
   const MICTensor<DType>* input,
   MICTensor<DType>* output,
-  MICTensor<size_t>* max_index, 
+  MICTensor<unsigned char>* max_index, 
   size_t filter_height,
   size_t filter_width,
-  size_t stride_width,
-  size_t stride_height) {
+  size_t stride_height,
+  size_t stride_width) {
   // shape init
   size_t IN, C, H, W;
   size_t ON, K, P, Q;
@@ -108,12 +107,13 @@ void Backend<MICTensor, DType>::MaxPooling2DForwardFunc(
   Blitz2DBuffer(output->data_layout(), output->shape_ptr(), &ON, &K, &P, &Q);
   CHECK_EQ(IN, ON);
   CHECK_EQ(C, K);
+  CHECK_LE(filter_height * filter_width, 256);
   switch (input->data_layout()) {
     case BLITZ_BUFFER_NCHW:
       MaxPoolingForwardNCHWImpl(
         input->data(),
         output->data(),
-        max_index->data(),
+        max_index != NULL ? max_index->data() : NULL,
         IN,
         C, H, W,
         K, P, Q,
@@ -124,7 +124,7 @@ void Backend<MICTensor, DType>::MaxPooling2DForwardFunc(
       MaxPoolingForwardNHWCImpl(
         input->data(),
         output->data(),
-        max_index->data(),
+        max_index != NULL ? max_index->data() : NULL,
         IN,
         C, H, W,
         K, P, Q,
@@ -141,10 +141,12 @@ template<typename DType>
 void MaxPoolingBackwardNCHWImpl(
   const DType* O,
   DType* I,
-  const size_t* max_index,
+  const unsigned char* max_index,
   size_t N,
   size_t C, size_t H, size_t W,
-  size_t K, size_t P, size_t Q) {
+  size_t K, size_t P, size_t Q,
+  size_t R, size_t S,
+  size_t str_h, size_t str_w) {
   const size_t HW = H * W;
   const size_t CHW = C * HW;
   const size_t PQ = P * Q;
@@ -154,10 +156,12 @@ void MaxPoolingBackwardNCHWImpl(
     for (size_t c = 0; c < C; ++c) {
       DType* input_slice = I + n * CHW + c * HW;
       const DType* output_slice = O + n * KPQ + c * PQ;
-      const size_t* max_index_slice = max_index + n * KPQ + c * PQ;
+      const unsigned char* max_index_slice = max_index + n * KPQ + c * PQ;
       for (size_t oh = 0; oh < P; ++oh) {
         for (size_t ow = 0; ow < Q; ++ow) {
-          input_slice[max_index_slice[oh * Q + ow]] = output_slice[oh * Q + ow];
+          const size_t max = max_index_slice[oh * Q + ow];
+          input_slice[(oh * str_h + max / S) * W + ow * str_w + max % S] +=
+            output_slice[oh * Q + ow];
         }
       }
     }
@@ -168,21 +172,26 @@ template<typename DType>
 void MaxPoolingBackwardNHWCImpl(
   const DType* O,
   DType* I,
-  const size_t* max_index,
+  const unsigned char* max_index,
   size_t N,
   size_t C, size_t H, size_t W,
-  size_t K, size_t P, size_t Q) {
+  size_t K, size_t P, size_t Q,
+  size_t R, size_t S,
+  size_t str_h, size_t str_w) {
   const size_t CHW = C * H * W;
   const size_t KPQ = K * P * Q;
   #pragma omp parallel for
   for (size_t n = 0; n < N; ++n) {
     DType* input_slice = I + n * CHW;
     const DType* output_slice = O + n * KPQ;
-    const size_t* max_index_slice = max_index + n * KPQ;
+    const unsigned char* max_index_slice = max_index + n * KPQ;
     for (size_t oh = 0; oh < P; ++oh) {
       for (size_t ow = 0; ow < Q; ++ow) {
         for (size_t c = 0; c < C; ++c) {
-          input_slice[max_index_slice[(oh * Q + ow) * C + c]] = output_slice[(oh * Q + ow) * C + c];
+          const size_t pool_index = (oh * Q + ow) * C + c;
+          const size_t max = max_index_slice[pool_index];
+          input_slice[((oh * str_h + max / S) * W + ow * str_w + max % S) * C + c] +=
+            output_slice[pool_index];
         }
       }
     }
@@ -193,7 +202,7 @@ template<typename DType>
 void Backend<MICTensor, DType>::MaxPooling2DBackwardFunc(
   const MICTensor<DType>* output,
   MICTensor<DType>* input,
-  const MICTensor<size_t>* max_index,
+  const MICTensor<unsigned char>* max_index,
   size_t filter_height,
   size_t filter_width,
   size_t stride_height,
@@ -218,7 +227,9 @@ void Backend<MICTensor, DType>::MaxPooling2DBackwardFunc(
         max_index->data(),
         IN,
         C, H, W,
-        K, P, Q);
+        K, P, Q,
+        filter_height, filter_width,
+        stride_height, stride_width);
       break;
     case BLITZ_BUFFER_NHWC:
       MaxPoolingBackwardNHWCImpl(
@@ -227,7 +238,223 @@ void Backend<MICTensor, DType>::MaxPooling2DBackwardFunc(
         max_index->data(),
         IN,
         C, H, W,
-        K, P, Q);
+        K, P, Q,
+        filter_height, filter_width,
+        stride_height, stride_width);
+      break;
+    default:
+      LOG(FATAL) << "Blitz not support pooling format: " << input->data_layout();
+      break;
+  }
+}
+
+template<typename DType>
+void AvgPoolingForwardNCHWImpl(
+  const DType* I,
+  DType* O,
+  size_t N,
+  size_t C, size_t H, size_t W,
+  size_t P, size_t Q,
+  size_t R, size_t S,
+  size_t str_h, size_t str_w) {
+  const DType scale = static_cast<DType>(1) / (R * S);
+  #pragma omp parallel for
+  for (size_t n = 0; n < N; ++n) {
+    for (size_t c = 0; c < C; ++c) {
+      const DType* input_slice = I + (n * C + c) * H * W;
+      DType* output_slice = O + (n * C + c) * P * Q;
+      for (size_t oh = 0; oh < P; ++oh) {
+        for (size_t ow = 0; ow < Q; ++ow) {
+          const DType* window = input_slice + oh * str_h * W + ow * str_w;
+          DType sum = 0;
+          for (size_t r = 0; r < R; ++r) {
+            for (size_t s = 0; s < S; ++s) {
+              sum += window[r * W + s];
+            }
+          }
+          output_slice[oh * Q + ow] = sum * scale;
+        }
+      }
+    }
+  }
+}
+
+template<typename DType>
+void AvgPoolingForwardNHWCImpl(
+  const DType* I,
+  DType* O,
+  size_t N,
+  size_t C, size_t H, size_t W,
+  size_t P, size_t Q,
+  size_t R, size_t S,
+  size_t str_h, size_t str_w) {
+  const DType scale = static_cast<DType>(1) / (R * S);
+  #pragma omp parallel for
+  for (size_t n = 0; n < N; ++n) {
+    for (size_t oh = 0; oh < P; ++oh) {
+      for (size_t ow = 0; ow < Q; ++ow) {
+        const DType* window = I + ((n * H + oh * str_h) * W + ow * str_w) * C;
+        DType* output_slice = O + ((n * P + oh) * Q + ow) * C;
+        for (size_t c = 0; c < C; ++c) {
+          output_slice[c] = 0;
+        }
+        for (size_t r = 0; r < R; ++r) {
+          for (size_t s = 0; s < S; ++s) {
+            for (size_t c = 0; c < C; ++c) {
+              output_slice[c] += window[(r * W + s) * C + c];
+            }
+          }
+        }
+        for (size_t c = 0; c < C; ++c) {
+          output_slice[c] *= scale;
+        }
+      }
+    }
+  }
+}
+
+template<typename DType>
+void AvgPoolingBackwardNCHWImpl(
+  const DType* O,
+  DType* I,
+  size_t N,
+  size_t C, size_t H, size_t W,
+  size_t P, size_t Q,
+  size_t R, size_t S,
+  size_t str_h, size_t str_w) {
+  const DType scale = static_cast<DType>(1) / (R * S);
+  #pragma omp parallel for
+  for (size_t n = 0; n < N; ++n) {
+    for (size_t c = 0; c < C; ++c) {
+      DType* input_slice = I + (n * C + c) * H * W;
+      const DType* output_slice = O + (n * C + c) * P * Q;
+      for (size_t oh = 0; oh < P; ++oh) {
+        for (size_t ow = 0; ow < Q; ++ow) {
+          DType* window = input_slice + oh * str_h * W + ow * str_w;
+          const DType gradient = output_slice[oh * Q + ow] * scale;
+          for (size_t r = 0; r < R; ++r) {
+            for (size_t s = 0; s < S; ++s) {
+              window[r * W + s] += gradient;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+template<typename DType>
+void AvgPoolingBackwardNHWCImpl(
+  const DType* O,
+  DType* I,
+  size_t N,
+  size_t C, size_t H, size_t W,
+  size_t P, size_t Q,
+  size_t R, size_t S,
+  size_t str_h, size_t str_w) {
+  const DType scale = static_cast<DType>(1) / (R * S);
+  #pragma omp parallel for
+  for (size_t n = 0; n < N; ++n) {
+    for (size_t oh = 0; oh < P; ++oh) {
+      for (size_t ow = 0; ow < Q; ++ow) {
+        DType* window = I + ((n * H + oh * str_h) * W + ow * str_w) * C;
+        const DType* output_slice = O + ((n * P + oh) * Q + ow) * C;
+        for (size_t r = 0; r < R; ++r) {
+          for (size_t s = 0; s < S; ++s) {
+            for (size_t c = 0; c < C; ++c) {
+              window[(r * W + s) * C + c] += output_slice[c] * scale;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+template<typename DType>
+void Backend<MICTensor, DType>::AvgPooling2DForwardFunc(
+  const MICTensor<DType>* input,
+  MICTensor<DType>* output,
+  MICTensor<DType>* workspace,
+  size_t filter_height,
+  size_t filter_width,
+  size_t stride_height,
+  size_t stride_width) {
+  // shape init
+  size_t IN, C, H, W;
+  size_t ON, K, P, Q;
+  // shape decode
+  CHECK_EQ(input->data_layout(), output->data_layout());
+  Blitz2DBuffer(input->data_layout(), input->shape_ptr(), &IN, &C, &H, &W);
+  Blitz2DBuffer(output->data_layout(), output->shape_ptr(), &ON, &K, &P, &Q);
+  CHECK_EQ(IN, ON);
+  CHECK_EQ(C, K);
+  switch (input->data_layout()) {
+    case BLITZ_BUFFER_NCHW:
+      AvgPoolingForwardNCHWImpl(
+        input->data(),
+        output->data(),
+        IN,
+        C, H, W,
+        P, Q,
+        filter_height, filter_width,
+        stride_height, stride_width);
+      break;
+    case BLITZ_BUFFER_NHWC:
+      AvgPoolingForwardNHWCImpl(
+        input->data(),
+        output->data(),
+        IN,
+        C, H, W,
+        P, Q,
+        filter_height, filter_width,
+        stride_height, stride_width);
+      break;
+    default:
+      LOG(FATAL) << "Blitz not support pooling format: " << input->data_layout();
+      break;
+  }
+}
+
+template<typename DType>
+void Backend<MICTensor, DType>::AvgPooling2DBackwardFunc(
+  const MICTensor<DType>* output,
+  MICTensor<DType>* input,
+  size_t filter_height,
+  size_t filter_width,
+  size_t stride_height,
+  size_t stride_width) {
+  // shape init
+  size_t IN, C, H, W;
+  size_t ON, K, P, Q;
+  // shape decode
+  CHECK_EQ(input->data_layout(), output->data_layout());
+  Blitz2DBuffer(input->data_layout(), input->shape_ptr(), &IN, &C, &H, &W);
+  Blitz2DBuffer(output->data_layout(), output->shape_ptr(), &ON, &K, &P, &Q);
+  CHECK_EQ(IN, ON);
+  CHECK_EQ(C, K);
+  // set zero
+  input->Fill(0);
+  switch (input->data_layout()) {
+    case BLITZ_BUFFER_NCHW:
+      AvgPoolingBackwardNCHWImpl(
+        output->data(),
+        input->data(),
+        IN,
+        C, H, W,
+        P, Q,
+        filter_height, filter_width,
+        stride_height, stride_width);
+      break;
+    case BLITZ_BUFFER_NHWC:
+      AvgPoolingBackwardNHWCImpl(
+        output->data(),
+        input->data(),
+        IN,
+        C, H, W,
+        P, Q,
+        filter_height, filter_width,
+        stride_height, stride_width);
       break;
     default:
       LOG(FATAL) << "Blitz not support pooling format: " << input->data_layout();
@@ -4,7 +4,9 @@ namespace blitz {
 
 template<typename DType>
 MICTensor<DType>::~MICTensor() {
-  free(this->data_);
+  if (this->owner_) {
+    free(this->data_);
+  }
 }
 
 template<typename DType>
@@ -60,6 +62,25 @@ inline void MICTensor<DType>::OutputCSV(ofstream* ofs) const {
   }
 }
 
+template<typename DType>
+inline void MICTensor<DType>::Relocate(DType* data) {
+  memcpy(data, this->data_, sizeof(DType) * this->size());
+  if (this->owner_) {
+    free(this->data_);
+  }
+  this->data_ = data;
+  this->owner_ = false;
+}
+
+template<typename DType>
+inline void MICTensor<DType>::Attach(DType* data) {
+  if (this->owner_) {
+    free(this->data_);
+  }
+  this->data_ = data;
+  this->owner_ = false;
+}
+
 INSTANTIATE_TENSOR(MICTensor);
 
 }  // namespace blitz
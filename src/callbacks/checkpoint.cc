@@ -0,0 +1,25 @@
+#include "callbacks/checkpoint.h"
+
+#include "backends/backends.h"
+
+namespace blitz {
+
+template<template <typename> class TensorType, typename DType>
+void Checkpoint<TensorType, DType>::OnEpochEnd(const size_t index) {
+  const size_t epoch = index + 1;
+  if (step_ != 0 && epoch % step_ == 0) {
+    stringstream path;
+    path << path_ << "_" << epoch << ".blitz";
+    serializer_->Save(path.str(), epoch);
+  }
+}
+
+INSTANTIATE_CLASS_CPU(Checkpoint);
+#ifdef BLITZ_USE_MIC
+  INSTANTIATE_CLASS_MIC(Checkpoint);
+#endif
+#ifdef BLITZ_USE_GPU
+  INSTANTIATE_CLASS_GPU(Checkpoint);
+#endif
+
+}  // namespace blitz
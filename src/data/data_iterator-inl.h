@@ -0,0 +1,65 @@
+#ifndef SRC_DATA_DATA_ITERATOR_INL_H_
+#define SRC_DATA_DATA_ITERATOR_INL_H_
+
+// host tensors are read in place, device tensors through a staging buffer
+template<typename TensorType>
+inline bool DataIteratorHostTensor(const TensorType* tensor) {
+  return false;
+}
+
+template<typename DType>
+inline bool DataIteratorHostTensor(const CPUTensor<DType>* tensor) {
+  return true;
+}
+
+#ifdef BLITZ_USE_MIC
+template<typename DType>
+inline bool DataIteratorHostTensor(const MICTensor<DType>* tensor) {
+  return true;
+}
+#endif
+
+// output = (input - mean[c]) * scale[c] for batch * channel * spatial,
+// or batch * spatial * channel if channel_last
+template<typename DType>
+inline void DataIteratorNormalize(
+  const uint8_t* input,
+  DType* output,
+  size_t batch,
+  size_t channel,
+  size_t spatial,
+  bool channel_last,
+  const DType* mean,
+  const DType* scale) {
+  if (channel_last) {
+    #pragma omp parallel for collapse(2)
+    for (size_t i = 0; i < batch; ++i) {
+      for (size_t k = 0; k < spatial; ++k) {
+        const uint8_t* input_slice = input + (i * spatial + k) * channel;
+        DType* output_slice = output + (i * spatial + k) * channel;
+        #pragma simd
+        for (size_t j = 0; j < channel; ++j) {
+          output_slice[j] = (static_cast<DType>(input_slice[j]) -
+            mean[j]) * scale[j];
+        }
+      }
+    }
+    return;
+  }
+  #pragma omp parallel for collapse(2)
+  for (size_t i = 0; i < batch; ++i) {
+    for (size_t j = 0; j < channel; ++j) {
+      const uint8_t* input_slice = input + (i * channel + j) * spatial;
+      DType* output_slice = output + (i * channel + j) * spatial;
+      const DType channel_mean = mean[j];
+      const DType channel_scale = scale[j];
+      #pragma simd
+      for (size_t k = 0; k < spatial; ++k) {
+        output_slice[k] = (static_cast<DType>(input_slice[k]) -
+          channel_mean) * channel_scale;
+      }
+    }
+  }
+}
+
+#endif  // SRC_DATA_DATA_ITERATOR_INL_H_
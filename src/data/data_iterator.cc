@@ -1,13 +1,54 @@
 #include "data/data_iterator.h"
 
-#include <hdf5.h>
+#include <algorithm>
 #include <fstream>
 
 #include "backends/backends.h"
-#include "utils/blitz_cpu_function.h"
 
 namespace blitz {
 
+#include "data_iterator-inl.h"
+
+// hdf5 is not built thread safe, loaders of all iterators share this lock
+static boost::mutex hdf5_mutex;
+
+// hdf5 converts the stored type into DType while reading
+template<typename DType>
+inline hid_t DataIteratorHDF5Type();
+
+template<>
+inline hid_t DataIteratorHDF5Type<float>() {
+  return H5T_NATIVE_FLOAT;
+}
+
+template<>
+inline hid_t DataIteratorHDF5Type<double>() {
+  return H5T_NATIVE_DOUBLE;
+}
+
+template<>
+inline hid_t DataIteratorHDF5Type<uint8_t>() {
+  return H5T_NATIVE_UCHAR;
+}
+
+template<template <typename> class TensorType, typename DType>
+DataIterator<TensorType, DType>::~DataIterator() {
+  if (loader_) {
+    {
+      boost::lock_guard<boost::mutex> lock(prefetch_mutex_);
+      stop_ = true;
+    }
+    prefetch_cond_.notify_all();
+    loader_->join();
+  }
+
+  boost::lock_guard<boost::mutex> hdf5_lock(hdf5_mutex);
+  for (size_t i = 0; i < file_ids_.size(); ++i) {
+    H5Dclose(data_ids_[i]);
+    H5Fclose(file_ids_[i]);
+  }
+}
+
 template<template <typename> class TensorType, typename DType>
 void DataIterator<TensorType, DType>::Init() {
   std::ifstream hdf5_files(data_path_.c_str());
@@ -21,12 +62,15 @@ void DataIterator<TensorType, DType>::Init() {
   }
   hdf5_files.close();
 
-  // reading file indices
+  // reading file indices, data handles stay open across windows
   int num_sample;
   herr_t status;
+  boost::unique_lock<boost::mutex> hdf5_lock(hdf5_mutex);
   for (size_t i = 0; i < files_.size(); ++i) {
-    int file_id = H5Fopen(files_[i].c_str(), H5F_ACC_RDWR, H5P_DEFAULT);
-    int sample_id = H5Dopen2(file_id, "sample_num", H5P_DEFAULT);
+    hid_t file_id = H5Fopen(files_[i].c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    CHECK_GE(file_id, 0);
+    hid_t sample_id = H5Dopen2(file_id, "sample_num", H5P_DEFAULT);
+    CHECK_GE(sample_id, 0);
 
     status = H5Dread(sample_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &num_sample);
     CHECK_GE(status, 0);
@@ -34,146 +78,316 @@ void DataIterator<TensorType, DType>::Init() {
     status = H5Dclose(sample_id);
     CHECK_GE(status, 0);
 
-    status = H5Fclose(file_id);
-    CHECK_GE(status, 0);
+    hid_t data_id = H5Dopen2(file_id, "data", H5P_DEFAULT);
+    CHECK_GE(data_id, 0);
+
+    // one byte unsigned integers stay uint8 in the pool
+    hid_t type_id = H5Dget_type(data_id);
+    const bool uint8 = H5Tget_class(type_id) == H5T_INTEGER &&
+      H5Tget_size(type_id) == 1;
+    const bool sign = uint8 && H5Tget_sign(type_id) != H5T_SGN_NONE;
+    H5Tclose(type_id);
+    if (sign) {
+      LOG(FATAL) << "Unsupported signed int8 data in: " << files_[i];
+    }
+    if (i == 0) {
+      uint8_ = uint8;
+    } else if (uint8 != uint8_) {
+      LOG(FATAL) << "Mixed uint8 and float data in: " << data_path_;
+    }
 
+    file_ids_.push_back(file_id);
+    data_ids_.push_back(data_id);
     file_row_mapping_.push_back(total_);
     total_ += num_sample;
   }
   file_row_mapping_.push_back(total_);
+  hdf5_lock.unlock();
+
+  // full batches only, the remainder would change the input shape
+  if (shuffle_) {
+    sampler_ = make_shared<Sampler>(total_ / batch_size_, pool_size_, seed_);
+    current_begin_index_ = sampler_->Window(0, 0) * pool_size_;
+  }
 
   tensor_pool_.resize(pool_size_);
   // init copy
-  CopyFileBuffer(0);
+  byte_pool_.resize(pool_size_);
+  CopyFileBuffer(current_begin_index_ * batch_size_, &tensor_pool_,
+    &byte_pool_);
+
+  // a single window never has to be reloaded
+  if (prefetch_depth_ > 0 && pool_size_ * batch_size_ < total_) {
+    next_epoch_ = 0;
+    next_begin_index_ = NextBeginIndex(current_begin_index_, &next_epoch_);
+    loader_ = make_shared<boost::thread>(
+      &DataIterator<TensorType, DType>::Prefetch, this);
+  }
 }
 
 template<template <typename> class TensorType, typename DType>
-void DataIterator<TensorType, DType>::CopyFileBuffer(size_t begin_offset) {
-  vector<string> current_files;
-  vector<size_t> current_files_row_mapping;
-  size_t end_offset = begin_offset + pool_size_ * batch_size_;
-  size_t begin_file_offset = 0;
-  size_t end_file_offset = 0;
-  size_t cur_file_offset = 0;
-  size_t accumulate = 0;
-
-  bool find_begin = false, find_end = false;
-  size_t exit_index = 0;
-  // find all files in the interval [begin_offset, end_offset]
-  // end_offset maybe greater than total_
-  // otherwise record the last file
-  // TODO(keren): binary search optimization
-  for (size_t i = 0; i < file_row_mapping_.size() - 1; ++i) {
-    if (begin_offset >= file_row_mapping_[i] &&
-      begin_offset < file_row_mapping_[i + 1] && !find_begin) {
-      find_begin = true;
-      begin_file_offset = begin_offset - file_row_mapping_[i];
-      cur_file_offset = begin_file_offset;
-    } else {
-      cur_file_offset = 0;
+size_t DataIterator<TensorType, DType>::NextBeginIndex(
+  size_t begin_index, size_t* epoch) const {
+  if (sampler_) {
+    const size_t position = sampler_->WindowPosition(*epoch,
+      begin_index / pool_size_) + 1;
+    if (position < sampler_->num_windows()) {
+      return sampler_->Window(*epoch, position) * pool_size_;
     }
+    ++(*epoch);
+    return sampler_->Window(*epoch, 0) * pool_size_;
+  }
+  size_t next_begin_index = begin_index + pool_size_;
+  if (next_begin_index * batch_size_ >= total_) {
+    next_begin_index = 0;
+  }
+  return next_begin_index;
+}
 
-    if (find_begin) {
-      current_files_row_mapping.push_back(file_row_mapping_[i + 1] - file_row_mapping_[i]);
-      accumulate += *(current_files_row_mapping.rbegin()) - cur_file_offset;
-      current_files.push_back(files_[i]);
+template<template <typename> class TensorType, typename DType>
+void DataIterator<TensorType, DType>::Prefetch() {
+  while (true) {
+    size_t begin_index;
+    size_t generation;
+    {
+      boost::unique_lock<boost::mutex> lock(prefetch_mutex_);
+      while (!stop_ && prefetch_pool_.size() >= prefetch_depth_) {
+        prefetch_cond_.wait(lock);
+      }
+      if (stop_) {
+        return;
+      }
+      begin_index = next_begin_index_;
+      generation = generation_;
     }
 
-    if (end_offset >= file_row_mapping_[i] &&
-      end_offset < file_row_mapping_[i + 1] && !find_end) {
-      find_end = true;
-      end_file_offset = end_offset - file_row_mapping_[i];
-    }
+    PrefetchWindow window;
+    window.begin_index = begin_index;
+    window.tensors.resize(pool_size_);
+    window.bytes.resize(pool_size_);
+    CopyFileBuffer(begin_index * batch_size_, &(window.tensors),
+      &(window.bytes));
 
-    if (find_begin && find_end) {
-      exit_index = i;
-      break;
+    {
+      boost::lock_guard<boost::mutex> lock(prefetch_mutex_);
+      if (stop_) {
+        return;
+      }
+      // drop the window if the consumer jumped elsewhere meanwhile
+      if (generation == generation_) {
+        prefetch_pool_.push_back(window);
+        next_begin_index_ = NextBeginIndex(begin_index, &next_epoch_);
+      }
     }
+    prefetch_cond_.notify_all();
   }
-  // there are at least two indice in file_row_mapping:
-  // the first file and its index
-  if (find_end) {
-    accumulate -= file_row_mapping_[exit_index + 1] - end_offset;
-  } else {
-    end_file_offset = total_ - file_row_mapping_[file_row_mapping_.size() - 2];
-  }
-
-  // create a temporary buffer to copy into memory
-  size_t input_size = input_shape_.size() / input_shape_[0];
-  size_t file_data_offset = 0;
-  // boost shared_ptr syntax
-  shared_ptr<DType[]> file_data(new DType[accumulate * input_size]);
-  for (size_t i = 0; i < current_files.size(); ++i) {
-    int file_id = H5Fopen(current_files[i].c_str(), H5F_ACC_RDWR, H5P_DEFAULT);
-    int data_id = H5Dopen2(file_id, "data", H5P_DEFAULT);
-    size_t file_size = current_files_row_mapping[i] * input_size;
-    shared_ptr<DType[]> current_files_data(new DType[file_size]);
-
-    herr_t status;
-    status = H5Dread(data_id, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, current_files_data.get());
+}
+
+template<template <typename> class TensorType, typename DType>
+template<typename BufferType>
+void DataIterator<TensorType, DType>::ReadRows(size_t begin_row,
+  size_t end_row, BufferType* buffer) {
+  const size_t input_size = input_shape_.size() / input_shape_[0];
+  // first file that holds begin_row
+  size_t file_index = std::upper_bound(file_row_mapping_.begin(),
+    file_row_mapping_.end(), begin_row) - file_row_mapping_.begin() - 1;
+  boost::lock_guard<boost::mutex> hdf5_lock(hdf5_mutex);
+  while (begin_row < end_row) {
+    const size_t file_begin_row = begin_row - file_row_mapping_[file_index];
+    const size_t file_end_row = std::min(end_row,
+      file_row_mapping_[file_index + 1]) - file_row_mapping_[file_index];
+    const hsize_t rows = file_end_row - file_begin_row;
+
+    // select [file_begin_row, file_end_row) of the leading dimension
+    hid_t file_space = H5Dget_space(data_ids_[file_index]);
+    CHECK_GE(file_space, 0);
+    const int rank = H5Sget_simple_extent_ndims(file_space);
+    CHECK_GT(rank, 0);
+    vector<hsize_t> dims(rank);
+    H5Sget_simple_extent_dims(file_space, &dims[0], NULL);
+    vector<hsize_t> offset(rank, 0);
+    vector<hsize_t> count(dims);
+    offset[0] = file_begin_row;
+    count[0] = rows;
+    herr_t status = H5Sselect_hyperslab(file_space, H5S_SELECT_SET,
+      &offset[0], NULL, &count[0], NULL);
     CHECK_GE(status, 0);
 
-    status = H5Dclose(data_id);
+    const hsize_t memory_size = rows * input_size;
+    hid_t memory_space = H5Screate_simple(1, &memory_size, NULL);
+    CHECK_GE(memory_space, 0);
+
+    status = H5Dread(data_ids_[file_index], DataIteratorHDF5Type<BufferType>(),
+      memory_space, file_space, H5P_DEFAULT, buffer);
     CHECK_GE(status, 0);
 
-    status = H5Fclose(file_id);
+    status = H5Sclose(memory_space);
     CHECK_GE(status, 0);
 
-    size_t copy_size = 0;
-    size_t current_files_data_offset = 0;
-    // calculate copy_size
-    if (i == 0) {
-      current_files_data_offset = begin_file_offset;
-      if (current_files.size() == 1) {
-        copy_size = (end_file_offset - begin_file_offset) * input_size;
-      } else {
-        copy_size = (current_files_row_mapping[i] - begin_file_offset) * input_size;
-      }
-    } else if (current_files.size() - 1 == i) {
-      copy_size = end_file_offset * input_size;
-    }
+    status = H5Sclose(file_space);
+    CHECK_GE(status, 0);
 
-    BlitzCPUCopy(current_files_data.get() + current_files_data_offset * input_size,
-      file_data.get() + file_data_offset, copy_size);
-    file_data_offset += copy_size;
-  }
-  // construct tensor
-  size_t tensor_offset_size = 0;
-  size_t last_index = accumulate / batch_size_;
-  // only in the last pool_size_, remaining samples are ignored
-  for (size_t j = 0; j < last_index; ++j) {
-    shared_ptr<TensorType<DType> > tensor = make_shared<TensorType<DType> >(input_shape_);
-    Backend<TensorType, DType>::HostCopyToFunc(file_data.get() + tensor_offset_size,
-      tensor->data(), input_shape_.size());
-    tensor_pool_[j] = tensor;
-    tensor_offset_size += input_shape_.size();
-  }
-  // remainder
-  if (accumulate % batch_size_) {
+    buffer += memory_size;
+    begin_row += rows;
+    ++file_index;
+  }
+}
+
+template<template <typename> class TensorType, typename DType>
+void DataIterator<TensorType, DType>::CopyFileBuffer(size_t begin_offset,
+  vector<shared_ptr<TensorType<DType> > >* tensor_pool,
+  vector<shared_ptr<vector<uint8_t> > >* byte_pool) {
+  // end_offset maybe greater than total_
+  const size_t end_offset = std::min(begin_offset + pool_size_ * batch_size_,
+    total_);
+  const size_t input_size = input_shape_.size() / input_shape_[0];
+  // staging buffer for one batch, only for device tensors
+  vector<DType> staging;
+  size_t j = 0;
+  for (size_t row = begin_offset; row < end_offset; row += batch_size_, ++j) {
+    // only in the last pool_size_, remaining samples are a smaller tensor
+    const size_t rows = std::min(batch_size_, end_offset - row);
+    if (uint8_) {
+      shared_ptr<vector<uint8_t> > bytes =
+        make_shared<vector<uint8_t> >(rows * input_size);
+      ReadRows(row, row + rows, &(*bytes)[0]);
+      (*byte_pool)[j] = bytes;
+      continue;
+    }
     Shape shape = input_shape_;
-    shape[0] = accumulate % batch_size_;
-    shared_ptr<TensorType<DType> > tensor = make_shared<TensorType<DType> >(shape);
-    Backend<TensorType, DType>::HostCopyToFunc(file_data.get() + input_shape_.size() * last_index,
-      tensor->data(), shape.size());
-    tensor_pool_[last_index] = tensor;
-  }  
+    shape[0] = rows;
+    shared_ptr<TensorType<DType> > tensor =
+      make_shared<TensorType<DType> >(shape);
+    if (DataIteratorHostTensor(tensor.get())) {
+      ReadRows(row, row + rows, tensor->data());
+    } else {
+      staging.resize(rows * input_size);
+      ReadRows(row, row + rows, &staging[0]);
+      Backend<TensorType, DType>::HostCopyToFunc(&staging[0],
+        tensor->data(), shape.size());
+    }
+    (*tensor_pool)[j] = tensor;
+  }
 }
 
 template<template <typename> class TensorType, typename DType>
 shared_ptr<TensorType<DType> > DataIterator<TensorType, DType>::GenerateTensor(size_t index) {
-  if (index >= total_) {
+  if (sampler_) {
+    index = sampler_->Index(epoch_, index);
+  }
+  if (index * batch_size_ >= total_) {
     LOG(FATAL) << "Index out of range: " << "index " << index << " total " << total_;
   } else if (index >= current_begin_index_ && index < current_begin_index_ + pool_size_) {
   } else {
+    time_point<system_clock> start, end;
+    start = system_clock::now();
+    // windows are aligned to pool_size_ so shuffled batches stay inside
+    const size_t begin_index = index / pool_size_ * pool_size_;
+    if (!loader_) {
+      CopyFileBuffer(begin_index * batch_size_, &tensor_pool_, &byte_pool_);
+    } else {
+      boost::unique_lock<boost::mutex> lock(prefetch_mutex_);
+      const size_t expect_index = prefetch_pool_.empty() ?
+        next_begin_index_ : prefetch_pool_.front().begin_index;
+      if (expect_index != begin_index) {
+        // out of order access, restart the loader from begin_index
+        prefetch_pool_.clear();
+        next_begin_index_ = begin_index;
+        next_epoch_ = epoch_;
+        ++generation_;
+        prefetch_cond_.notify_all();
+      }
+      while (prefetch_pool_.empty()) {
+        prefetch_cond_.wait(lock);
+      }
+      tensor_pool_.swap(prefetch_pool_.front().tensors);
+      byte_pool_.swap(prefetch_pool_.front().bytes);
+      prefetch_pool_.pop_front();
+      lock.unlock();
+      prefetch_cond_.notify_all();
+    }
     // udpate current_begin_index_;
-    CopyFileBuffer(index * batch_size_);
-    current_begin_index_ = index;
-    LOG(INFO) << "Update tensor index to: " << index;
-  } 
+    current_begin_index_ = begin_index;
+    end = system_clock::now();
+    duration<double> wait_time = end - start;
+    wait_time_ += wait_time.count();
+    LOG(INFO) << "Update tensor index to: " << begin_index;
+  }
 
+  if (uint8_) {
+    const vector<uint8_t>& bytes = *(byte_pool_[index - current_begin_index_]);
+    return NormalizeBatch(&bytes[0],
+      bytes.size() / (input_shape_.size() / input_shape_[0]));
+  }
   return tensor_pool_[index - current_begin_index_];
 }
 
+template<template <typename> class TensorType, typename DType>
+bool DataIterator<TensorType, DType>::ChannelView(size_t* channel,
+  size_t* spatial) const {
+  if (input_shape_.dimension() == 4) {
+    size_t N, C, H, W;
+    Blitz2DBuffer(input_shape_.data_layout(), &input_shape_, &N, &C, &H, &W);
+    *channel = C;
+    *spatial = H * W;
+    return input_shape_.data_layout() == BLITZ_BUFFER_NHWC;
+  }
+  *channel = input_shape_.dimension() > 1 ? input_shape_[1] : 1;
+  *spatial = input_shape_.size() / input_shape_[0] / *channel;
+  return false;
+}
+
+template<template <typename> class TensorType, typename DType>
+void DataIterator<TensorType, DType>::set_normalization(
+  const vector<DType>& mean, const vector<DType>& scale) {
+  size_t channel, spatial;
+  ChannelView(&channel, &spatial);
+  if (mean.size() > 1 && mean.size() != channel) {
+    LOG(FATAL) << "Mean size " << mean.size() << " mismatches channel " <<
+      channel;
+  }
+  if (scale.size() > 1 && scale.size() != channel) {
+    LOG(FATAL) << "Scale size " << scale.size() << " mismatches channel " <<
+      channel;
+  }
+  mean_ = mean;
+  scale_ = scale;
+}
+
+template<template <typename> class TensorType, typename DType>
+shared_ptr<TensorType<DType> > DataIterator<TensorType, DType>::NormalizeBatch(
+  const uint8_t* bytes, size_t rows) {
+  Shape shape = input_shape_;
+  shape[0] = rows;
+  // the previous batch is consumed before the next one is requested
+  if (!output_ || output_->size() != shape.size()) {
+    output_ = make_shared<TensorType<DType> >(shape);
+  }
+  size_t channel, spatial;
+  const bool channel_last = ChannelView(&channel, &spatial);
+  vector<DType> mean(channel, 0);
+  vector<DType> scale(channel, 1);
+  for (size_t i = 0; i < channel; ++i) {
+    if (!mean_.empty()) {
+      mean[i] = mean_[mean_.size() == 1 ? 0 : i];
+    }
+    if (!scale_.empty()) {
+      scale[i] = scale_[scale_.size() == 1 ? 0 : i];
+    }
+  }
+  if (DataIteratorHostTensor(output_.get())) {
+    DataIteratorNormalize(bytes, output_->data(), rows, channel, spatial,
+      channel_last, &mean[0], &scale[0]);
+  } else {
+    staging_.resize(shape.size());
+    DataIteratorNormalize(bytes, &staging_[0], rows, channel, spatial,
+      channel_last, &mean[0], &scale[0]);
+    Backend<TensorType, DType>::HostCopyToFunc(&staging_[0],
+      output_->data(), shape.size());
+  }
+  return output_;
+}
+
 INSTANTIATE_CLASS_CPU(DataIterator);
 #ifdef BLITZ_USE_MIC
   INSTANTIATE_CLASS_MIC(DataIterator);
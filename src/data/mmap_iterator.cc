@@ -0,0 +1,149 @@
+#include "data/mmap_iterator.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "backends/backends.h"
+
+namespace blitz {
+
+#include "data_iterator-inl.h"
+
+// float records can be viewed in place only as float tensors
+template<typename DType>
+inline bool MmapIteratorZeroCopy(uint32_t data_type) {
+  return false;
+}
+
+template<>
+inline bool MmapIteratorZeroCopy<float>(uint32_t data_type) {
+  return data_type == BLITZ_BINARY_FLOAT;
+}
+
+template<typename DType>
+inline void MmapIteratorConvert(const float* records, size_t size,
+  DType* output) {
+  #pragma omp parallel for
+  for (size_t i = 0; i < size; ++i) {
+    output[i] = static_cast<DType>(records[i]);
+  }
+}
+
+template<template <typename> class TensorType, typename DType>
+MmapDataIterator<TensorType, DType>::~MmapDataIterator() {
+  if (mapping_ != NULL) {
+    munmap(mapping_, mapping_size_);
+  }
+}
+
+template<template <typename> class TensorType, typename DType>
+void MmapDataIterator<TensorType, DType>::Init() {
+  int fd = open(this->data_path_.c_str(), O_RDONLY);
+  if (fd < 0) {
+    LOG(FATAL) << "Binary file open error: " << this->data_path_;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) < 0 ||
+    static_cast<size_t>(file_stat.st_size) < sizeof(BlitzBinaryHeader)) {
+    LOG(FATAL) << "Binary file too small: " << this->data_path_;
+  }
+  mapping_size_ = file_stat.st_size;
+  // private writable mapping, layers never write back to the file
+  void* mapping = mmap(NULL, mapping_size_, PROT_READ | PROT_WRITE,
+    MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    LOG(FATAL) << "Binary file mmap error: " << this->data_path_;
+  }
+  mapping_ = static_cast<char*>(mapping);
+  madvise(mapping_, mapping_size_, MADV_SEQUENTIAL);
+
+  memcpy(&header_, mapping_, sizeof(BlitzBinaryHeader));
+  if (strncmp(header_.magic, BLITZ_BINARY_MAGIC, sizeof(header_.magic)) ||
+    header_.version != BLITZ_BINARY_VERSION) {
+    LOG(FATAL) << "Not a blitz binary file: " << this->data_path_;
+  }
+  if (header_.data_type != BLITZ_BINARY_FLOAT &&
+    header_.data_type != BLITZ_BINARY_UINT8) {
+    LOG(FATAL) << "Unknown binary data type: " << header_.data_type;
+  }
+  const size_t input_size = this->input_shape_.size() /
+    this->input_shape_[0];
+  if (header_.sample_size != input_size) {
+    LOG(FATAL) << "Binary sample size " << header_.sample_size <<
+      " mismatches input size " << input_size;
+  }
+  const size_t record_size = header_.data_type == BLITZ_BINARY_FLOAT ?
+    sizeof(float) : sizeof(uint8_t);
+  if (sizeof(BlitzBinaryHeader) + header_.num_samples *
+    header_.sample_size * record_size > mapping_size_) {
+    LOG(FATAL) << "Binary file truncated: " << this->data_path_;
+  }
+  this->total_ = header_.num_samples;
+
+  // batches are read in place, a single window covers the whole file
+  if (this->shuffle_) {
+    const size_t num_batches = this->total_ / this->batch_size_;
+    this->sampler_ = make_shared<Sampler>(num_batches, num_batches,
+      this->seed_);
+  }
+}
+
+template<template <typename> class TensorType, typename DType>
+shared_ptr<TensorType<DType> > MmapDataIterator<TensorType, DType>::
+  GenerateTensor(size_t index) {
+  if (this->sampler_) {
+    index = this->sampler_->Index(this->epoch_, index);
+  }
+  const size_t begin_row = index * this->batch_size_;
+  if (begin_row >= this->total_) {
+    LOG(FATAL) << "Index out of range: " << "index " << index <<
+      " total " << this->total_;
+  }
+  // the last batch may be a smaller tensor
+  Shape shape = this->input_shape_;
+  shape[0] = std::min(this->batch_size_, this->total_ - begin_row);
+  const size_t record_size = header_.data_type == BLITZ_BINARY_FLOAT ?
+    sizeof(float) : sizeof(uint8_t);
+  char* records = mapping_ + sizeof(BlitzBinaryHeader) +
+    begin_row * header_.sample_size * record_size;
+
+  if (header_.data_type == BLITZ_BINARY_UINT8) {
+    return this->NormalizeBatch(reinterpret_cast<const uint8_t*>(records),
+      shape[0]);
+  }
+
+  shared_ptr<TensorType<DType> > tensor;
+  if (DataIteratorHostTensor(static_cast<TensorType<DType>*>(NULL)) &&
+    MmapIteratorZeroCopy<DType>(header_.data_type)) {
+    tensor = make_shared<TensorType<DType> >(
+      reinterpret_cast<DType*>(records), shape);
+  } else {
+    tensor = make_shared<TensorType<DType> >(shape);
+    if (DataIteratorHostTensor(tensor.get())) {
+      MmapIteratorConvert(reinterpret_cast<const float*>(records),
+        shape.size(), tensor->data());
+    } else {
+      vector<DType> staging(shape.size());
+      MmapIteratorConvert(reinterpret_cast<const float*>(records),
+        shape.size(), &staging[0]);
+      Backend<TensorType, DType>::HostCopyToFunc(&staging[0],
+        tensor->data(), shape.size());
+    }
+  }
+  return tensor;
+}
+
+INSTANTIATE_CLASS_CPU(MmapDataIterator);
+#ifdef BLITZ_USE_MIC
+  INSTANTIATE_CLASS_MIC(MmapDataIterator);
+#endif
+#ifdef BLITZ_USE_GPU
+  INSTANTIATE_CLASS_GPU(MmapDataIterator);
+#endif
+
+}  // namespace blitz
@@ -0,0 +1,55 @@
+#include "data/sampler.h"
+
+#include <algorithm>
+
+namespace blitz {
+
+void Sampler::Permutation(size_t epoch, size_t stream, size_t size,
+  vector<size_t>* permutation) const {
+  boost::mt19937 rng(static_cast<boost::uint32_t>(seed_ * 2654435761u ^
+    epoch * 40503u ^ (stream + 1) * 2246822519u));
+  permutation->resize(size);
+  for (size_t i = 0; i < size; ++i) {
+    (*permutation)[i] = i;
+  }
+  // fisher-yates
+  for (size_t i = size; i > 1; --i) {
+    std::swap((*permutation)[i - 1], (*permutation)[rng() % i]);
+  }
+}
+
+size_t Sampler::Window(size_t epoch, size_t position) const {
+  vector<size_t> windows;
+  Permutation(epoch, 0, num_windows_, &windows);
+  return windows[position];
+}
+
+size_t Sampler::WindowPosition(size_t epoch, size_t window) const {
+  vector<size_t> windows;
+  Permutation(epoch, 0, num_windows_, &windows);
+  return std::find(windows.begin(), windows.end(), window) - windows.begin();
+}
+
+size_t Sampler::Index(size_t epoch, size_t position) const {
+  if (position >= num_batches_) {
+    LOG(FATAL) << "Sampler position out of range: " << position <<
+      " total " << num_batches_;
+  }
+  vector<size_t> windows;
+  Permutation(epoch, 0, num_windows_, &windows);
+  // the last window may be short, walk the window sizes
+  for (size_t i = 0; i < num_windows_; ++i) {
+    const size_t window_begin = windows[i] * window_size_;
+    const size_t window_batches = std::min(window_size_,
+      num_batches_ - window_begin);
+    if (position < window_batches) {
+      vector<size_t> batches;
+      Permutation(epoch, windows[i] + 1, window_batches, &batches);
+      return window_begin + batches[position];
+    }
+    position -= window_batches;
+  }
+  return 0;
+}
+
+}  // namespace blitz
@@ -1,8 +1,13 @@
 #include "initializer/initializer.h"
 
+#include "callbacks/checkpoint.h"
 #include "initializer/parser.h"
 #include "model/model.h"
+#include "model/seralize.h"
 #include "backends/backends.h"
+#include "utils/blitz_cpu_reduce.h"
+#include "utils/blitz_profiler.h"
+#include "utils/blitz_random_function.h"
 
 namespace blitz {
 
@@ -19,6 +24,13 @@ void Initializer::Initialize(const Parser& parser) {
   LOG(INFO) << "Label size: " << parser.label_size();
   LOG(INFO) << "Batch size: " << parser.batch_size();
   LOG(INFO) << "Epoches: " << parser.epoches();
+  LOG(INFO) << "Random seed: " << parser.random_seed();
+  LOG(INFO) << "Deterministic: " << parser.deterministic();
+  LOG(INFO) << "Profile: " << parser.profile();
+
+  BlitzRandomSetSeed(parser.random_seed());
+  BlitzReduceSetDeterministic(parser.deterministic());
+  BlitzProfilerSetEnabled(parser.profile(), !parser.profile_path().empty());
 
   const int epoches = parser.epoches();
   Model<TensorType, DType> model(epoches);
@@ -32,11 +44,24 @@ void Initializer::Initialize(const Parser& parser) {
     parser.layer_wrapper<TensorType, DType>();
   shared_ptr<CallbackWrapper> callback_wrapper =
     parser.callback_wrapper();
+  // mapped weights live as long as the serializer
+  shared_ptr<Serializer<TensorType, DType> > serializer;
 
   if (parser.model_type() == "train") {
     LOG(INFO) << "Training";
     shared_ptr<Scheduler<TensorType, DType> > scheduler =
       parser.scheduler<TensorType, DType>();
+    serializer = make_shared<Serializer<TensorType, DType> >(
+      layer_wrapper, scheduler);
+    if (!parser.checkpoint_path().empty()) {
+      LOG(INFO) << "Checkpoint path: " << parser.checkpoint_path();
+      callback_wrapper->push_back(static_pointer_cast<Callback>(
+        make_shared<Checkpoint<TensorType, DType> >(serializer,
+        parser.checkpoint_path(), parser.checkpoint_step())));
+    }
+    if (!parser.load_path().empty()) {
+      model.set_resume(serializer, parser.load_path());
+    }
 
     if (parser.eval() == true) {
       shared_ptr<DataIterator<TensorType, DType> > eval_set =
@@ -53,6 +78,18 @@ void Initializer::Initialize(const Parser& parser) {
     }
   }
 
+  if (parser.model_type() == "inference") {
+    LOG(INFO) << "Inference only";
+    layer_wrapper->InitInference(parser.input_shape(), filler_wrapper);
+    if (parser.load_path().empty()) {
+      filler_wrapper->Fill();
+    } else {
+      serializer = make_shared<Serializer<TensorType, DType> >(
+        layer_wrapper);
+      serializer->Map(parser.load_path());
+    }
+  }
+
   if (parser.inference() == true) {
     LOG(INFO) << "Inference";
     shared_ptr<DataIterator<TensorType, DType> > inference_set =
@@ -62,7 +99,12 @@ void Initializer::Initialize(const Parser& parser) {
     const string& eval_type = parser.eval_type();
 
     model.Inference(inference_set, inference_label, layer_wrapper,
-      eval_type);
+      eval_type, parser.quantize(), parser.calibration_batches());
+  }
+
+  BlitzProfilerReport();
+  if (parser.profile() && !parser.profile_path().empty()) {
+    BlitzProfilerExportTrace(parser.profile_path());
   }
 }
 
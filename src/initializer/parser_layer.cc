@@ -7,6 +7,7 @@
 #include "layers/dropout.h"
 #include "layers/param_layer.h"
 #include "utils/blitz_algorithm_function.h"
+#include "utils/blitz_precision_function.h"
 
 namespace blitz {
 
@@ -134,30 +135,36 @@ shared_ptr<Layer<TensorType, DType> > Parser::SetLayer(const YAML::Node& node) c
         as<string>();
       string gamma_optimizer_name = batch_norm_node["gamma_optimizer"].
         as<string>();
+      // decay of the running statistics used for inference
+      DType momentum = batch_norm_node["momentum"] ?
+        batch_norm_node["momentum"].as<DType>() : static_cast<DType>(0.9);
       shared_ptr<BatchNorm> batch_norm = make_shared<BatchNorm>(
         batch_norm_name, gamma_filler_name, gamma_optimizer_name,
-        beta_filler_name, beta_optimizer_name);
+        beta_filler_name, beta_optimizer_name, momentum);
       param_layer->set_batch_norm(batch_norm);
     }
 
     layer = static_pointer_cast<Layer<TensorType, DType> >(param_layer);
   } else if (type == "Pooling") {
-    if (!node["fshape"])
+    // a global window covers the whole input
+    bool global = node["global"] ? node["global"].as<bool>() : false;
+
+    if (!global && !node["fshape"])
       LOG(FATAL) << "'fshape' parameter missing";
 
-    if (!node["stride"])
+    if (!global && !node["stride"])
       LOG(FATAL) << "'stride' parameter missing";
 
     if (!node["op"])
       LOG(FATAL) << "'op' parameter missing";
 
-    int shape = node["fshape"].as<int>();
-    int stride = node["stride"].as<int>();
+    int shape = global ? 0 : node["fshape"].as<int>();
+    int stride = global ? 1 : node["stride"].as<int>();
     string op = node["op"].as<string>();
 
     layer = static_pointer_cast<Layer<TensorType, DType> >(
       make_shared<Pooling<TensorType, DType> >(name,
-        shape, stride, op));
+        shape, stride, op, global));
   } else if (type == "Dropout") {
     if (!node["keep"])
       LOG(FATAL) << "'keep' parameter missing";
@@ -170,6 +177,14 @@ shared_ptr<Layer<TensorType, DType> > Parser::SetLayer(const YAML::Node& node) c
     LOG(FATAL) << "Unkown layer type: " << type;
   }
 
+  // storage of the output kept for backward, float by default
+  if (node["precision"]) {
+    string precision = node["precision"].as<string>();
+    if (BlitzParsePrecision(precision) == BLITZ_PRECISION_UNDEFINED)
+      LOG(FATAL) << "Unkown precision: " << precision;
+    layer->set_precision(BlitzParsePrecision(precision));
+  }
+
   return layer;
 }
 
@@ -1,7 +1,10 @@
 #include "initializer/parser.h"
 
 #include "backends/backends.h"
+#include "scheduler/adam.h"
 #include "scheduler/gradientdescent.h"
+#include "scheduler/nesterov.h"
+#include "scheduler/rmsprop.h"
 
 namespace blitz {
 
@@ -38,6 +41,40 @@ shared_ptr<Optimizer<TensorType, DType> > Parser::SetOptimizer(const YAML::Node&
     optimizer = static_pointer_cast<Optimizer<TensorType, DType> >(
       make_shared<Gradientdescent<TensorType, DType> >(name,
         learning_rate, change, step, momentum_coef, decay));
+  } else if (type == "Nesterov" || type == "RMSProp" || type == "Adam") {
+    if (!node["learning_rate"])
+      LOG(FATAL) << "'learning_rate' parameter missing";
+
+    if (!node["step"])
+      LOG(FATAL) << "'step' parameter missing";
+
+    if (!node["change"])
+      LOG(FATAL) << "'change' parameter missing";
+
+    DType learning_rate = node["learning_rate"].as<DType>();
+    DType change = node["change"].as<DType>();
+    int step = node["step"].as<int>();
+    // the remaining hyperparameters have the usual defaults
+    DType decay = node["decay"] ? node["decay"].as<DType>() : 0.0;
+    DType epsilon = node["epsilon"] ? node["epsilon"].as<DType>() : 1e-8;
+    if (type == "Nesterov") {
+      DType momentum_coef = node["momentum_coef"] ?
+        node["momentum_coef"].as<DType>() : 0.9;
+      optimizer = static_pointer_cast<Optimizer<TensorType, DType> >(
+        make_shared<Nesterov<TensorType, DType> >(name,
+          learning_rate, change, step, momentum_coef, decay));
+    } else if (type == "RMSProp") {
+      DType rho = node["rho"] ? node["rho"].as<DType>() : 0.9;
+      optimizer = static_pointer_cast<Optimizer<TensorType, DType> >(
+        make_shared<RMSProp<TensorType, DType> >(name,
+          learning_rate, change, step, rho, epsilon, decay));
+    } else {
+      DType beta1 = node["beta1"] ? node["beta1"].as<DType>() : 0.9;
+      DType beta2 = node["beta2"] ? node["beta2"].as<DType>() : 0.999;
+      optimizer = static_pointer_cast<Optimizer<TensorType, DType> >(
+        make_shared<Adam<TensorType, DType> >(name,
+          learning_rate, change, step, beta1, beta2, epsilon, decay));
+    }
   } else {
     LOG(FATAL) << "Unkown optimizer type: " << type;
   }
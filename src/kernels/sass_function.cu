@@ -7,6 +7,7 @@
 #include "utils/blitz_math_function.h"
 #include "utils/blitz_gpu_function.h"
 #include "utils/blitz_cpu_function.h"
+#include "utils/blitz_profiler.h"
 
 namespace blitz {
 
@@ -24,13 +25,6 @@ void BlitzSassGemm(
   CUfunction function;
   size_t lda, ldb, ldc = N;
 
-#ifdef BLITZ_PERFORMANCE
-  float elapsed_time = 0.0f;
-  CUevent event_start, event_stop;
-  cuEventCreate(&event_start, CU_EVENT_BLOCKING_SYNC);
-  cuEventCreate(&event_stop, CU_EVENT_BLOCKING_SYNC);
-  cuEventRecord(event_start, NULL);
-#endif  // BLITZ_PERFORMANCE
   // create kernel
   string kernel;
   if (transa == true && transb == false) {
@@ -62,15 +56,11 @@ void BlitzSassGemm(
   }
 
   // kernel call, asynrhonize
-  function = CubinModule::GetFunction(kernel);
-
-#ifdef BLITZ_PERFORMANCE
-  cuEventRecord(event_stop, NULL);
-  cuEventSynchronize(event_stop);
-  cuEventElapsedTime(&elapsed_time, event_start, event_stop);
-  LOG(INFO) << "Load kernel: " << kernel;
-  LOG(INFO) << "Load kernel time: " << elapsed_time / 1000.0;
-#endif  // BLITZ_PERFORMANCE
+  {
+    // the first call of a kernel loads its cubin
+    BlitzProfileStageTimer stage("load");
+    function = CubinModule::GetFunction(kernel);
+  }
 
   void* params[] = {&A, &B, &C, &alpha, &beta, &lda, &ldb, &ldc,
     (void*)&M, (void*)&N, (void*)&K};
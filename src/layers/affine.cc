@@ -16,7 +16,9 @@ void Affine<TensorType, DType>::InitImpl(const Shape& input_shape) {
 
   // forward and backward output
   this->forward_output_ = make_shared<TensorType<DType> >(output_shape);
-  this->backward_output_ = make_shared<TensorType<DType> >(input_shape);
+  if (!this->inference_only_) {
+    this->backward_output_ = make_shared<TensorType<DType> >(input_shape);
+  }
 
   // weight and update
   Shape shape_weight(2);
@@ -24,7 +26,9 @@ void Affine<TensorType, DType>::InitImpl(const Shape& input_shape) {
   shape_weight[1] = nout_;
 
   this->weight_ = make_shared<TensorType<DType> >(shape_weight);
-  this->update_ = make_shared<TensorType<DType> >(shape_weight);
+  if (!this->inference_only_) {
+    this->update_ = make_shared<TensorType<DType> >(shape_weight);
+  }
 
   LOG(INFO) << "Affine Layer: " << this->name_;
   LOG(INFO) << "nin: " << nin;
@@ -35,24 +39,28 @@ void Affine<TensorType, DType>::InitImpl(const Shape& input_shape) {
 template<template <typename> class TensorType, typename DType>
 void Affine<TensorType, DType>::ForwardPropImpl(
   shared_ptr<TensorType<DType> > forward_input) {
+  if (!this->train_ && this->quantized_) {
+    Backend<TensorType, DType>::QuantizedMatrixMultiplyFunc(
+      forward_input.get(),
+      (this->quantized_weight_).get(),
+      (this->weight_scale_).get(),
+      (this->weight_sum_).get(),
+      (this->forward_output_).get(),
+      (this->quantized_workspace_).get(),
+      this->input_scale_, this->zero_point_);
+    return;
+  }
   Backend<TensorType, DType>::MatrixMultiplyFunc(
     forward_input.get(),
     (this->weight_).get(),
     (this->forward_output_).get(),
-    false, false, 1, 0,
+    false, false, alpha_, 0,
     this->algorithm_);
 }
 
 template<template <typename> class TensorType, typename DType>
 void Affine<TensorType, DType>::BackwardPropImpl(
   shared_ptr<TensorType<DType> > backward_input) {
-  #ifdef BLITZ_PERFORMANCE
-  time_point<system_clock> start;
-  time_point<system_clock> end;
-  duration<double> time =
-    duration<double>::zero();
-  start = system_clock::now();
-  #endif  // BLITZ_PERFORMANCE
   if (this->backward_prop_) {
     Backend<TensorType, DType>::MatrixMultiplyFunc(
       backward_input.get(),
@@ -61,26 +69,26 @@ void Affine<TensorType, DType>::BackwardPropImpl(
       false, true, 1, 0,
       this->algorithm_);
   }
-  #ifdef BLITZ_PERFORMANCE
-  end = system_clock::now();
-  time = end - start;
-  LOG(INFO) << "Backward affine time: " << time.count();
-  #endif  // BLITZ_PERFORMANCE
-
-  #ifdef BLITZ_PERFORMANCE
-  start = system_clock::now();
-  #endif  // BLITZ_PERFORMANCE
+  BlitzProfileScope scope(this->name_, "update",
+    this->update_computations());
   Backend<TensorType, DType>::MatrixMultiplyFunc(
     (this->forward_input_).get(),
     backward_input.get(),
     (this->update_).get(),
     true, false, 1, 0,
     this->algorithm_);
-  #ifdef BLITZ_PERFORMANCE
-  end = system_clock::now();
-  time = end - start;
-  LOG(INFO) << "Backward affine weight time: " << time.count();
-  #endif  // BLITZ_PERFORMANCE
+}
+
+template<template <typename> class TensorType, typename DType>
+void Affine<TensorType, DType>::Quantize() {
+  // input rows are rounded to levels padded to the weight group
+  const size_t batch_size = (this->forward_input_)->shape()[0];
+  const size_t nin = (this->weight_)->shape()[0];
+  this->QuantizeWeight(false, batch_size * BlitzQuantizeRows(nin));
+  if (alpha_ != 1) {
+    Backend<TensorType, DType>::MultiplyFunc((this->weight_scale_).get(),
+      (this->weight_scale_).get(), alpha_);
+  }
 }
 
 INSTANTIATE_CLASS_CPU(Affine);
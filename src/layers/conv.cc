@@ -40,7 +40,9 @@ void Conv<TensorType, DType>::InitImpl(const Shape& input_shape) {
   output_shape[3] = output_width;
   // forward and backward output
   this->forward_output_ = make_shared<TensorType<DType> >(output_shape);
-  this->backward_output_ = make_shared<TensorType<DType> >(input_shape);
+  if (!this->inference_only_) {
+    this->backward_output_ = make_shared<TensorType<DType> >(input_shape);
+  }
   // weight
   Shape weight_shape(4, BLITZ_FILTER_KCRS);
   weight_shape[0] = output_channel;
@@ -48,7 +50,9 @@ void Conv<TensorType, DType>::InitImpl(const Shape& input_shape) {
   weight_shape[2] = filter_height;
   weight_shape[3] = filter_width;
   this->weight_ = make_shared<TensorType<DType> >(weight_shape);
-  this->update_ = make_shared<TensorType<DType> >(weight_shape);
+  if (!this->inference_only_) {
+    this->update_ = make_shared<TensorType<DType> >(weight_shape);
+  }
   // unpack one image in every iteration
   Shape workspace_shape(1);
   this->backward_computations_ = this->backward_update_computations_ =
@@ -63,9 +67,24 @@ void Conv<TensorType, DType>::InitImpl(const Shape& input_shape) {
     this->algorithm_ == BLITZ_CONVOLUTION_XSMM_DIRECT) {  //xsmm kernel fallback to blas_batch in backward phase
     size_t workspace_unpack_size = BLITZ_NUM_THREADS * input_channel *
       filter_height * filter_width * output_height * output_width;
-    size_t workspace_update_size = BLITZ_NUM_THREADS * output_channel *
+    // per thread updates are only reduced while training
+    size_t workspace_update_size = this->inference_only_ ? 0 :
+      BLITZ_NUM_THREADS * output_channel *
       input_channel * filter_height * filter_width;
     workspace_shape[0] = workspace_unpack_size + workspace_update_size;
+  } else if (this->algorithm_ == BLITZ_CONVOLUTION_DIRECT) {
+    // direct kernels read input and filter in place, no unpack buffer
+    workspace_shape[0] = 1;
+  } else if (this->algorithm_ == BLITZ_CONVOLUTION_WINOGRAD) {
+    // transformed filter and per-thread tiles, or one unpacked image
+    // when the layer falls back to blas gemm
+    size_t workspace_winograd_size = 6 * 6 * (input_channel * output_channel +
+      BLITZ_NUM_THREADS * (input_channel + output_channel) *
+      BLITZ_WINOGRAD_TILE_BLOCK);
+    size_t workspace_unpack_size = input_channel *
+      filter_height * filter_width * output_height * output_width;
+    workspace_shape[0] = std::max(workspace_winograd_size,
+      workspace_unpack_size);
   } else if (this->algorithm_ == BLITZ_CONVOLUTION_SASS_DIRECT) {
     size_t workspace_size = input_shape.size() +
       output_shape.size() + weight_shape.size();
@@ -113,6 +132,20 @@ void Conv<TensorType, DType>::InitImpl(const Shape& input_shape) {
 template<template <typename> class TensorType, typename DType>
 void Conv<TensorType, DType>::ForwardPropImpl(
   shared_ptr<TensorType<DType> > forward_input) {
+  if (!this->train_ && this->quantized_) {
+    Backend<TensorType, DType>::QuantizedConvolution2DForwardFunc(
+      forward_input.get(),
+      (this->quantized_weight_).get(),
+      (this->weight_scale_).get(),
+      (this->weight_sum_).get(),
+      (this->forward_output_).get(),
+      (this->quantized_workspace_).get(),
+      this->input_scale_, this->zero_point_,
+      filter_shape_[2], filter_shape_[3],
+      padding_height_, padding_width_,
+      stride_height_, stride_width_);
+    return;
+  }
   // TODO(keren) fusing
   #ifdef BLITZ_USE_GPU
   if (this->algorithm_ == BLITZ_CONVOLUTION_CUDNN) {
@@ -180,6 +213,8 @@ void Conv<TensorType, DType>::BackwardPropImpl(
       this->algorithm_);
 #endif
   }
+  BlitzProfileScope scope(this->name_, "update",
+    this->update_computations());
 #ifdef BLITZ_USE_GPU
   if (this->algorithm_ == BLITZ_CONVOLUTION_CUDNN) {
     cudnnConvolutionBackwardFilter(cudnn_handle_,
@@ -211,6 +246,23 @@ void Conv<TensorType, DType>::BackwardPropImpl(
 #endif
 }
 
+template<template <typename> class TensorType, typename DType>
+void Conv<TensorType, DType>::Quantize() {
+  if (this->algorithm_ == BLITZ_CONVOLUTION_XSMM_DIRECT) {
+    // the xsmm output carries its own padding
+    LOG(WARNING) << "Conv Layer: " << this->name_ <<
+      " keeps the xsmm kernel instead of int8";
+    return;
+  }
+  // KCRS filters are quantized per K, the levels of the whole batch
+  // are followed by the unpacked windows of one image
+  const Shape& output_shape = (this->forward_output_)->shape();
+  const size_t CRS = (this->weight_)->size() / filter_shape_[0];
+  const size_t PQ = output_shape[2] * output_shape[3];
+  this->QuantizeWeight(true, (this->forward_input_)->size() +
+    PQ * BlitzQuantizeRows(CRS));
+}
+
 INSTANTIATE_CLASS_CPU(Conv);
 #ifdef BLITZ_USE_MIC
   INSTANTIATE_CLASS_MIC(Conv);
@@ -8,10 +8,11 @@ template<template <typename> class TensorType, typename DType>
 void Dropout<TensorType, DType>::InitImpl(const Shape& input_shape) {
   // forward and backward output
   this->forward_output_ = make_shared<TensorType<DType> >(input_shape);
-  this->backward_output_ = make_shared<TensorType<DType> >(input_shape);
-
-  // mask
-  mask_ = make_shared<TensorType<DType> >(input_shape);
+  if (!this->inference_only_) {
+    this->backward_output_ = make_shared<TensorType<DType> >(input_shape);
+    // mask
+    mask_ = make_shared<TensorType<DType> >(input_shape);
+  }
 
   LOG(INFO) << "Dropout Layer: " << this->name_;
   LOG(INFO) << "Keep: " << keep_;
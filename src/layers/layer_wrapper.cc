@@ -1,7 +1,9 @@
 #include "layers/layer_wrapper.h"
 
+#include <algorithm>
 #include <list>
 #include <string>
+#include <vector>
 
 #include "backends/backends.h"
 
@@ -32,16 +34,259 @@ void LayerWrapper<TensorType, DType>::Init(const Shape& input_shape,
 
   // set first layer not bprop
   (*layers_.begin())->set_backward_prop(false);
+
+  softmax_cost_fused_ = cost_->softmax_fusible() &&
+    (*layers_.rbegin())->FuseSoftmaxCost();
+  if (softmax_cost_fused_) {
+    LOG(INFO) << "Fuse softmax into cost";
+  }
+
+  PlanMemory();
+}
+
+template<template <typename> class TensorType, typename DType>
+void LayerWrapper<TensorType, DType>::InitInference(const Shape& input_shape,
+  shared_ptr<FillerWrapper<TensorType, DType> > filler_wrapper) {
+  inference_only_ = true;
+  train_ = false;
+  LayerIterator layer_it = begin();
+  while (layer_it != end()) {
+    (*layer_it)->set_inference_only(true);
+    (*layer_it)->SetInferenceMode();
+    ++layer_it;
+  }
+
+  // drop constant scales, e.g. dropout, that the next layer absorbs
+  layer_it = begin();
+  while (layer_it != end()) {
+    LayerIterator next_it = layer_it;
+    ++next_it;
+    DType scale;
+    if (next_it != end() && (*layer_it)->InferenceScale(&scale) &&
+      (*next_it)->FoldInputScale(scale)) {
+      LOG(INFO) << "Fold scale " << scale << " into the next layer";
+      layer_it = layers_.erase(layer_it);
+    } else {
+      ++layer_it;
+    }
+  }
+
+  Init(input_shape, filler_wrapper,
+    shared_ptr<Scheduler<TensorType, DType> >());
+}
+
+template<typename MemoryBlock>
+inline bool MemoryBlockLarger(const MemoryBlock& a, const MemoryBlock& b) {
+  return a.size > b.size;
+}
+
+template<typename MemoryBlock>
+inline bool MemoryBlockLower(const MemoryBlock* a, const MemoryBlock* b) {
+  return a->offset < b->offset;
+}
+
+template<typename MemoryBlock>
+inline bool MemoryBlockOverlap(const MemoryBlock& a, const MemoryBlock& b) {
+  if (a.end < b.begin || b.end < a.begin) {
+    return false;
+  }
+  // one lifetime lies inside the gap of the other
+  if (a.gap_begin < b.begin && b.end < a.gap_end) {
+    return false;
+  }
+  if (b.gap_begin < a.begin && a.end < b.gap_end) {
+    return false;
+  }
+  return true;
+}
+
+template<template <typename> class TensorType, typename DType>
+void LayerWrapper<TensorType, DType>::PlanMemory() {
+  #ifdef BLITZ_ALIGNMENT_SIZE
+  const size_t alignment = std::max(
+    static_cast<size_t>(BLITZ_ALIGNMENT_SIZE / sizeof(DType)),
+    static_cast<size_t>(1));
+  #else
+  const size_t alignment = 1;
+  #endif
+  // forward of layer i at step i, cost at step L, backward of layer i
+  // at step 2L - i. forward_output i is read by the backward of layers
+  // i + 1 and i, backward_output i only by the backward of layer i - 1.
+  // A reduced precision forward_output i is stashed after the forward
+  // of layer i + 1 and restored before its backward, which frees the
+  // buffer in between
+  const size_t num_layers = layers_.size();
+  vector<MemoryBlock> blocks;
+  size_t index = 0;
+  size_t stash_size = 0;
+  for (LayerIterator it = begin(); it != end(); ++it, ++index) {
+    const size_t forward_size = (*it)->forward_output()->size();
+    if (inference_only_) {
+      // only read by the forward of the next layer, or the cost
+      MemoryBlock forward_block = { *it, true,
+        index, index + 1, 0, 0, forward_size, 0 };
+      blocks.push_back(forward_block);
+      continue;
+    }
+    size_t gap_begin = 0, gap_end = 0;
+    if ((*it)->precision() != BLITZ_PRECISION_FLOAT &&
+      index + 3 <= 2 * num_layers - index) {
+      gap_begin = index + 1;
+      gap_end = 2 * num_layers - index - 1;
+      (*it)->set_stash(make_shared<TensorType<unsigned short> >(
+        (*it)->forward_output_shape()));
+      stash_size += forward_size;
+    }
+    MemoryBlock forward_block = { *it, true,
+      index, 2 * num_layers - index, gap_begin, gap_end, forward_size, 0 };
+    MemoryBlock backward_block = { *it, false,
+      2 * num_layers - index, 2 * num_layers - index + 1, 0, 0,
+      (*it)->backward_output()->size(), 0 };
+    blocks.push_back(forward_block);
+    blocks.push_back(backward_block);
+  }
+  MemoryBlock error_block = { shared_ptr<Layer<TensorType, DType> >(), false,
+    num_layers, num_layers + 1, 0, 0, error_->size(), 0 };
+  blocks.push_back(error_block);
+
+  // greedy first fit, largest buffers first
+  std::stable_sort(blocks.begin(), blocks.end(),
+    MemoryBlockLarger<MemoryBlock>);
+  size_t original_size = 0;
+  size_t arena_size = 0;
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    MemoryBlock& block = blocks[i];
+    original_size += block.size;
+    vector<const MemoryBlock*> conflicts;
+    for (size_t j = 0; j < i; ++j) {
+      if (MemoryBlockOverlap(blocks[j], block)) {
+        conflicts.push_back(&blocks[j]);
+      }
+    }
+    std::sort(conflicts.begin(), conflicts.end(),
+      MemoryBlockLower<MemoryBlock>);
+    const size_t aligned_size = (block.size + alignment - 1) /
+      alignment * alignment;
+    size_t offset = 0;
+    for (size_t j = 0; j < conflicts.size(); ++j) {
+      if (offset + aligned_size <= conflicts[j]->offset) {
+        break;
+      }
+      const size_t conflict_end = conflicts[j]->offset +
+        (conflicts[j]->size + alignment - 1) / alignment * alignment;
+      offset = std::max(offset, conflict_end);
+    }
+    block.offset = offset;
+    arena_size = std::max(arena_size, offset + aligned_size);
+  }
+
+  // rebind every buffer as a view into the arena
+  Shape arena_shape(1);
+  arena_shape[0] = arena_size;
+  arena_ = make_shared<TensorType<DType> >(arena_shape);
+  arena_->Fill(0);
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    const MemoryBlock& block = blocks[i];
+    if (!block.layer) {
+      error_ = make_shared<TensorType<DType> >(arena_->Slice(block.offset),
+        error_->shape());
+    } else if (block.forward) {
+      block.layer->set_forward_output(make_shared<TensorType<DType> >(
+        arena_->Slice(block.offset), block.layer->forward_output_shape()));
+    } else {
+      block.layer->set_backward_output(make_shared<TensorType<DType> >(
+        arena_->Slice(block.offset), block.layer->backward_output_shape()));
+    }
+  }
+
+  // layers run one at a time, so a single workspace of the largest size
+  // serves all of them
+  size_t original_workspace_size = 0;
+  size_t workspace_size = 0;
+  for (LayerIterator it = begin(); it != end(); ++it) {
+    shared_ptr<TensorType<DType> > workspace = (*it)->workspace();
+    if (workspace) {
+      original_workspace_size += workspace->size();
+      workspace_size = std::max(workspace_size, workspace->size());
+    }
+  }
+  if (workspace_size > 0) {
+    Shape workspace_shape(1);
+    workspace_shape[0] = workspace_size;
+    workspace_ = make_shared<TensorType<DType> >(workspace_shape);
+    for (LayerIterator it = begin(); it != end(); ++it) {
+      shared_ptr<TensorType<DType> > workspace = (*it)->workspace();
+      if (workspace) {
+        (*it)->set_workspace(make_shared<TensorType<DType> >(
+          workspace_->data(), workspace->shape()));
+      }
+    }
+  }
+
+  // InitImpl has already allocated every buffer on its own, so the plan
+  // shrinks the footprint after Init, not the peak during it
+  const double megabyte = 1024.0 * 1024.0;
+  LOG(INFO) << "Activation memory: " <<
+    original_size * sizeof(DType) / megabyte << " MB -> " <<
+    arena_size * sizeof(DType) / megabyte << " MB";
+  LOG(INFO) << "Stash memory: " <<
+    stash_size * sizeof(unsigned short) / megabyte << " MB";
+  LOG(INFO) << "Workspace memory: " <<
+    original_workspace_size * sizeof(DType) / megabyte << " MB -> " <<
+    workspace_size * sizeof(DType) / megabyte << " MB";
+  LOG(INFO) << "Steady-state memory: " << (arena_size + workspace_size) *
+    sizeof(DType) / megabyte << " MB";
 }
 
 template<template <typename> class TensorType, typename DType>
 void LayerWrapper<TensorType, DType>::ForwardProp(
   shared_ptr<TensorType<DType> > input) {
   LayerIterator it = begin();
+  shared_ptr<Layer<TensorType, DType> > prev_layer;
   while (it != end()) {
     (*it)->ForwardProp(input);
+    // the input is not read again until the backward of this layer
+    if (train_ && prev_layer && prev_layer->stash()) {
+      prev_layer->CompressOutput();
+    }
     input = (*it)->forward_output();
+    prev_layer = *it;
+    ++it;
+  }
+}
+
+template<template <typename> class TensorType, typename DType>
+void LayerWrapper<TensorType, DType>::Predict(
+  shared_ptr<TensorType<DType> > input) {
+  ForwardProp(input);
+  if (softmax_cost_fused_) {
+    shared_ptr<TensorType<DType> > output =
+      (*layers_.rbegin())->forward_output();
+    Backend<TensorType, DType>::SoftmaxApplyFunc(output.get(), output.get());
+  }
+}
+
+template<template <typename> class TensorType, typename DType>
+void LayerWrapper<TensorType, DType>::ShareWeights(
+  const LayerWrapper<TensorType, DType>& layer_wrapper) {
+  CHECK_EQ(layers_.size(), layer_wrapper.layers_.size());
+  LayerIterator it = begin();
+  typename list<shared_ptr<Layer<TensorType, DType> > >::const_iterator
+    source_it = layer_wrapper.layers_.begin();
+  while (it != end()) {
+    (*it)->ShareWeights(**source_it);
     ++it;
+    ++source_it;
+  }
+}
+
+template<template <typename> class TensorType, typename DType>
+void LayerWrapper<TensorType, DType>::CollectParams(
+  map<string, shared_ptr<TensorType<DType> > >* params) const {
+  typename list<shared_ptr<Layer<TensorType, DType> > >::const_iterator
+    it = layers_.begin();
+  for (; it != layers_.end(); ++it) {
+    (*it)->CollectParams(params);
   }
 }
 
@@ -50,22 +295,58 @@ void LayerWrapper<TensorType, DType>::BackwardProp() {
   LayerReverseIterator it = rbegin();
   shared_ptr<TensorType<DType> > input = error_;
   while (it != rend()) {
+    LayerReverseIterator prev_it = it;
+    ++prev_it;
+    if (prev_it != rend() && (*prev_it)->stash()) {
+      (*prev_it)->DecompressOutput();
+    }
     (*it)->BackwardProp(input);
     input = (*it)->backward_output();
     ++it;
   }
 }
 
+template<template <typename> class TensorType, typename DType>
+void LayerWrapper<TensorType, DType>::Calibrate(
+  shared_ptr<TensorType<DType> > input) {
+  LayerIterator it = begin();
+  while (it != end()) {
+    (*it)->Calibrate(input);
+    (*it)->ForwardProp(input);
+    input = (*it)->forward_output();
+    ++it;
+  }
+}
+
+template<template <typename> class TensorType, typename DType>
+void LayerWrapper<TensorType, DType>::Quantize() {
+  LayerIterator it = begin();
+  while (it != end()) {
+    (*it)->Quantize();
+    ++it;
+  }
+}
+
 template<template <typename> class TensorType, typename DType>
 DType LayerWrapper<TensorType, DType>::ApplyCost(
     const shared_ptr<TensorType<DType> > target) {
   shared_ptr<TensorType<DType> > output = (*layers_.rbegin())->forward_output();
+  if (softmax_cost_fused_) {
+    // logits are replaced by the probabilities in place, the gradient
+    // is only stored for training
+    return Backend<TensorType, DType>::SoftmaxCrossEntropyMultiFunc(
+      output.get(), target.get(), output.get(),
+      train_ ? error_.get() : NULL, &accuracy_);
+  }
   return cost_->Apply(output, target);
 }
 
 template<template <typename> class TensorType, typename DType>
 void LayerWrapper<TensorType, DType>::DerivativeCost(
     const shared_ptr<TensorType<DType> > target) {
+  if (softmax_cost_fused_) {
+    return;
+  }
   shared_ptr<TensorType<DType> > output = (*layers_.rbegin())->forward_output();
   cost_->Derivative(output, target, error_);
 }
@@ -75,7 +356,9 @@ DType LayerWrapper<TensorType, DType>::Evaluate(
     const shared_ptr<TensorType<DType> > target, const string& eval_type) {
   shared_ptr<TensorType<DType> > output = (*layers_.rbegin())->forward_output();
   DType accuracy = 0.0;
-  if (eval_type == "classify") {
+  if (eval_type == "classify" && softmax_cost_fused_) {
+    accuracy = accuracy_;
+  } else if (eval_type == "classify") {
     accuracy = Backend<TensorType, DType>::EvaluateClassifyFunc(
       output.get(), target.get());
   } else if (eval_type == "regress") {
@@ -87,6 +370,7 @@ DType LayerWrapper<TensorType, DType>::Evaluate(
 
 template<template <typename> class TensorType, typename DType>
 void LayerWrapper<TensorType, DType>::SetTrainMode() {
+  train_ = true;
   LayerIterator it = begin();
   while (it != end()) {
     (*it)->SetTrainMode();
@@ -96,6 +380,7 @@ void LayerWrapper<TensorType, DType>::SetTrainMode() {
 
 template<template <typename> class TensorType, typename DType>
 void LayerWrapper<TensorType, DType>::SetInferenceMode() {
+  train_ = false;
   LayerIterator it = begin();
   while (it != end()) {
     (*it)->SetInferenceMode();
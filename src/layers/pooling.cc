@@ -1,38 +1,71 @@
 #include "layers/pooling.h"
 
 #include "backends/backends.h"
+#include "utils/blitz_cpu_reduce.h"
 
 namespace blitz {
 
 template<template <typename> class TensorType, typename DType>
 void Pooling<TensorType, DType>::InitImpl(const Shape& input_shape) {
-  // input shape decode
+  // input shape decode, NCHW unless the input is NHWC
+  const bool channel_last =
+    input_shape.data_layout() == BLITZ_BUFFER_NHWC;
   size_t batch_size = input_shape[0];
-  size_t input_channel = input_shape[1];
-  size_t input_height = input_shape[2];
-  size_t input_width = input_shape[3];
+  size_t input_channel = channel_last ? input_shape[3] : input_shape[1];
+  size_t input_height = channel_last ? input_shape[1] : input_shape[2];
+  size_t input_width = channel_last ? input_shape[2] : input_shape[3];
+  if (global_) {
+    filter_height_ = input_height;
+    filter_width_ = input_width;
+  }
   // output shape encode
   size_t output_channel = input_channel;
-  size_t output_height = (input_height - filter_) / stride_ + 1;
-  size_t output_width = (input_width - filter_) / stride_ + 1;
+  size_t output_height = (input_height - filter_height_) / stride_ + 1;
+  size_t output_width = (input_width - filter_width_) / stride_ + 1;
 
-  Shape output_shape(4, BLITZ_BUFFER_NCHW);
+  Shape output_shape(4,
+    channel_last ? BLITZ_BUFFER_NHWC : BLITZ_BUFFER_NCHW);
   output_shape[0] = batch_size;
-  output_shape[1] = output_channel;
-  output_shape[2] = output_height;
-  output_shape[3] = output_width;
+  if (channel_last) {
+    output_shape[1] = output_height;
+    output_shape[2] = output_width;
+    output_shape[3] = output_channel;
+  } else {
+    output_shape[1] = output_channel;
+    output_shape[2] = output_height;
+    output_shape[3] = output_width;
+  }
 
   // forward and backward output
   this->forward_output_ = make_shared<TensorType<DType> >(output_shape);
-  this->backward_output_ = make_shared<TensorType<DType> >(input_shape);
+  if (!this->inference_only_) {
+    this->backward_output_ = make_shared<TensorType<DType> >(input_shape);
+  }
 
-  if (op_ == "max") {
-    this->max_index_ = make_shared<TensorType<size_t> >(output_shape);
-  } else {
+  // the argmax is only read by backward
+  if (op_ == "max" && !this->inference_only_) {
+    this->max_index_ = make_shared<TensorType<unsigned char> >(output_shape);
+  } else if (op_ != "max" && op_ != "avg") {
     LOG(ERROR) << "Pooling type: " << op_ << " not exist";
   }
 
+  // global average pooling reduces channels on CPU, its partials are
+  // kept here instead of being allocated on every forward
+  if (op_ == "avg" && global_) {
+    const size_t scratch_size = channel_last ?
+      BlitzReduceScratchSize(input_height * input_width, input_channel, 1,
+      false) :
+      BlitzReduceScratchSize(1, batch_size * input_channel,
+      input_height * input_width, false);
+    if (scratch_size > 0) {
+      Shape workspace_shape(1);
+      workspace_shape[0] = scratch_size;
+      this->workspace_ = make_shared<TensorType<DType> >(workspace_shape);
+    }
+  }
+
   LOG(INFO) << "Pooling Layer: " << this->name_;
+  LOG(INFO) << "op: " << op_ << (global_ ? " global" : "");
   LOG(INFO) << "input shape: " << input_channel << " * " <<
     input_height << " * " << input_width;
   LOG(INFO) << "output shape: " << output_channel << " * " <<
@@ -47,7 +80,14 @@ void Pooling<TensorType, DType>::ForwardPropImpl(
       forward_input.get(),
       (this->forward_output_).get(),
       max_index_.get(),
-      filter_, filter_,
+      filter_height_, filter_width_,
+      stride_, stride_);
+  } else if (op_ == "avg") {
+    Backend<TensorType, DType>::AvgPooling2DForwardFunc(
+      forward_input.get(),
+      (this->forward_output_).get(),
+      (this->workspace_).get(),
+      filter_height_, filter_width_,
       stride_, stride_);
   } else {
     LOG(ERROR) << "Pooling type: " << op_ << " not exist";
@@ -63,7 +103,13 @@ void Pooling<TensorType, DType>::BackwardPropImpl(
         backward_input.get(),
         (this->backward_output_).get(),
         max_index_.get(),
-        filter_, filter_,
+        filter_height_, filter_width_,
+        stride_, stride_);
+    } else if (op_ == "avg") {
+      Backend<TensorType, DType>::AvgPooling2DBackwardFunc(
+        backward_input.get(),
+        (this->backward_output_).get(),
+        filter_height_, filter_width_,
         stride_, stride_);
     } else {
       LOG(ERROR) << "Pooling type: " << op_ << " not exist";
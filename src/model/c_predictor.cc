@@ -0,0 +1,67 @@
+#include "model/c_predictor.h"
+
+#include <exception>
+
+#include "backends/cpu_tensor.h"
+#include "model/predictor.h"
+
+using blitz::CPUTensor;
+using blitz::Predictor;
+
+struct BlitzPredictor {
+  boost::shared_ptr<Predictor<CPUTensor, float> > predictor;
+};
+
+BlitzPredictor* BlitzPredictorCreate(const char* config_path) {
+  try {
+    boost::shared_ptr<Predictor<CPUTensor, float> > instance =
+      boost::make_shared<Predictor<CPUTensor, float> >(
+      std::string(config_path));
+    BlitzPredictor* handle = new BlitzPredictor;
+    handle->predictor = instance;
+    return handle;
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Create predictor failed: " << e.what();
+    return NULL;
+  }
+}
+
+BlitzPredictor* BlitzPredictorClone(const BlitzPredictor* predictor) {
+  try {
+    boost::shared_ptr<Predictor<CPUTensor, float> > instance =
+      predictor->predictor->Clone();
+    BlitzPredictor* handle = new BlitzPredictor;
+    handle->predictor = instance;
+    return handle;
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Clone predictor failed: " << e.what();
+    return NULL;
+  }
+}
+
+int BlitzPredictorPredict(BlitzPredictor* predictor,
+  const float* input, size_t n, float* output) {
+  try {
+    predictor->predictor->Predict(input, n, output);
+    return 0;
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Predict failed: " << e.what();
+    return -1;
+  }
+}
+
+size_t BlitzPredictorBatchSize(const BlitzPredictor* predictor) {
+  return predictor->predictor->batch_size();
+}
+
+size_t BlitzPredictorInputSize(const BlitzPredictor* predictor) {
+  return predictor->predictor->input_size();
+}
+
+size_t BlitzPredictorOutputSize(const BlitzPredictor* predictor) {
+  return predictor->predictor->output_size();
+}
+
+void BlitzPredictorDestroy(BlitzPredictor* predictor) {
+  delete predictor;
+}
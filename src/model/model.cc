@@ -1,8 +1,10 @@
 #include "model/model.h"
 
+#include <algorithm>
 #include <string>
 
 #include "backends/backends.h"
+#include "utils/blitz_profiler.h"
 
 namespace blitz {
 
@@ -11,34 +13,76 @@ void Model<TensorType, DType>::Inference(
   shared_ptr<DataIterator<TensorType, DType> > inference_set,
   shared_ptr<DataIterator<TensorType, DType> > inference_label,
   shared_ptr<LayerWrapper<TensorType, DType> > layer_wrapper,
-  const string& eval_type) {
+  const string& eval_type,
+  bool quantize,
+  size_t calibration_batches) {
   inference_set->Init();
   inference_label->Init();
   layer_wrapper->SetInferenceMode();
 
-  size_t niteration = inference_set->total() / inference_set->batch_size();
-  DType accuracy = 0.0;
-
   ptime todayUtc(day_clock::universal_day(),
     second_clock::universal_time().time_of_day());
-  string output_file = "./result/" + to_simple_string(todayUtc) + ".csv";
+  const string output_prefix = "./result/" + to_simple_string(todayUtc);
+
+  double elapsed_seconds = 0.0;
+  DType accuracy = InferenceEpoch(inference_set, inference_label,
+    layer_wrapper, eval_type, output_prefix + ".csv", &elapsed_seconds);
+  LOG(INFO) << "Accuracy: " << accuracy;
+  LOG(INFO) << "Elapsed second: " << elapsed_seconds;
+
+  if (quantize) {
+    // activation ranges from the first batches, then int8 weights
+    size_t niteration = inference_set->total() / inference_set->batch_size();
+    calibration_batches = std::min(calibration_batches, niteration);
+    for (size_t i = 0; i < calibration_batches; ++i) {
+      layer_wrapper->Calibrate(inference_set->GenerateTensor(i));
+    }
+    layer_wrapper->Quantize();
+
+    double quantized_seconds = 0.0;
+    DType quantized_accuracy = InferenceEpoch(inference_set,
+      inference_label, layer_wrapper, eval_type,
+      output_prefix + "_int8.csv", &quantized_seconds);
+    LOG(INFO) << "Int8 accuracy: " << quantized_accuracy;
+    LOG(INFO) << "Int8 accuracy difference: " <<
+      quantized_accuracy - accuracy;
+    LOG(INFO) << "Int8 elapsed second: " << quantized_seconds;
+    LOG(INFO) << "Int8 speedup: " << elapsed_seconds / quantized_seconds;
+  }
+}
+
+template<template <typename> class TensorType, typename DType>
+DType Model<TensorType, DType>::InferenceEpoch(
+  shared_ptr<DataIterator<TensorType, DType> > inference_set,
+  shared_ptr<DataIterator<TensorType, DType> > inference_label,
+  shared_ptr<LayerWrapper<TensorType, DType> > layer_wrapper,
+  const string& eval_type,
+  const string& output_file,
+  double* elapsed_seconds) {
+  size_t niteration = inference_set->total() / inference_set->batch_size();
+  DType accuracy = 0.0;
   ofstream os(output_file.c_str(), ofstream::out);
+  time_point<system_clock> start, end;
+  duration<double> core_time = duration<double>::zero();
 
   for (size_t i = 0; i < niteration; ++i) {
     shared_ptr<TensorType<DType> > input = inference_set->GenerateTensor(i);
     shared_ptr<TensorType<DType> > target = inference_label->GenerateTensor(i);
 
+    start = system_clock::now();
     ForwardProp(layer_wrapper, input, target);
+    end = system_clock::now();
+    core_time += end - start;
+    BlitzProfilerBatchEnd();
 
     accuracy += layer_wrapper->Evaluate(target, eval_type);
 
     (layer_wrapper->forward_output())->OutputCSV(&os);
   }
 
-  accuracy /= niteration;
-  LOG(INFO) << "Accuracy: " << accuracy;
-
   os.close();
+  *elapsed_seconds = core_time.count();
+  return accuracy / niteration;
 }
 
 template<template <typename> class TensorType, typename DType>
@@ -59,10 +103,11 @@ void Model<TensorType, DType>::Fit(
   eval_label->Init();
   const Shape& input_shape = data_set->input_shape();
   layer_wrapper->Init(input_shape, filler_wrapper, scheduler);
+  scheduler->Init();
 
   filler_wrapper->Fill();
 
-  for (size_t i = 0; i < epoches_; ++i) {
+  for (size_t i = Resume(); i < epoches_; ++i) {
     layer_wrapper->SetTrainMode();
 
     callback_wrapper->OnEpochBegin(i);
@@ -90,11 +135,12 @@ void Model<TensorType, DType>::Fit(
   data_label->Init();
   const Shape& input_shape = data_set->input_shape();
   layer_wrapper->Init(input_shape, filler_wrapper, scheduler);
+  scheduler->Init();
   layer_wrapper->SetTrainMode();
 
   filler_wrapper->Fill();
 
-  for (size_t i = 0; i < epoches_; ++i) {
+  for (size_t i = Resume(); i < epoches_; ++i) {
     callback_wrapper->OnEpochBegin(i);
 
     EpochFit(i, data_set, data_label, layer_wrapper,
@@ -104,6 +150,15 @@ void Model<TensorType, DType>::Fit(
   }
 }
 
+template<template <typename> class TensorType, typename DType>
+size_t Model<TensorType, DType>::Resume() {
+  if (resume_serializer_ == 0) {
+    return 0;
+  }
+  const size_t epoch = resume_serializer_->Load(resume_path_);
+  LOG(INFO) << "Resume from epoch: " << epoch;
+  return epoch;
+}
 
 template<template <typename> class TensorType, typename DType>
 void Model<TensorType, DType>::EpochFit(
@@ -116,6 +171,8 @@ void Model<TensorType, DType>::EpochFit(
   size_t niteration = data_set->total() / data_set->batch_size();
   time_point<system_clock> start, end;
   start = system_clock::now();
+  data_set->set_epoch(epoch);
+  data_label->set_epoch(epoch);
 
   for (size_t i = 0; i < niteration; ++i) {
     callback_wrapper->OnBatchBegin(i);
@@ -128,6 +185,7 @@ void Model<TensorType, DType>::EpochFit(
     BackwardProp(layer_wrapper, target);
 
     scheduler->Run(epoch, data_set->batch_size());
+    BlitzProfilerBatchEnd();
 
     callback_wrapper->OnBatchEnd(i, loss);
   }
@@ -135,6 +193,10 @@ void Model<TensorType, DType>::EpochFit(
 
   duration<double> elapsed_seconds = end-start;
   LOG(INFO) << "Elapsed second: " << elapsed_seconds.count();
+  LOG(INFO) << "Data wait second: " <<
+    data_set->wait_time() + data_label->wait_time();
+  data_set->ResetWaitTime();
+  data_label->ResetWaitTime();
 }
 
 template<template <typename> class TensorType, typename DType>
@@ -151,6 +213,7 @@ void Model<TensorType, DType>::Evaluate(
     shared_ptr<TensorType<DType> > target = eval_label->GenerateTensor(i);
 
     ForwardProp(layer_wrapper, input, target);
+    BlitzProfilerBatchEnd();
 
     accuracy += layer_wrapper->Evaluate(target, eval_type);
   }
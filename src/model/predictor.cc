@@ -0,0 +1,82 @@
+#include "model/predictor.h"
+
+#include <yaml-cpp/yaml.h>
+
+#include <algorithm>
+#include <string>
+
+#include "backends/backends.h"
+#include "initializer/parser.h"
+
+namespace blitz {
+
+template<template <typename> class TensorType, typename DType>
+Predictor<TensorType, DType>::Predictor(const string& config_path) {
+  LOG(INFO) << "Load predictor from: " << config_path;
+  parser_ = make_shared<Parser>(YAML::LoadFile(config_path));
+  parser_->SetDefaultArgs();
+  Init();
+  shared_ptr<FillerWrapper<TensorType, DType> > filler_wrapper =
+    parser_->filler_wrapper<TensorType, DType>();
+  layer_wrapper_->InitInference(parser_->input_shape(), filler_wrapper);
+  if (parser_->load_path().empty()) {
+    filler_wrapper->Fill();
+  } else {
+    serializer_ = make_shared<Serializer<TensorType, DType> >(
+      layer_wrapper_);
+    serializer_->Map(parser_->load_path());
+  }
+}
+
+template<template <typename> class TensorType, typename DType>
+Predictor<TensorType, DType>::Predictor(shared_ptr<Parser> parser) :
+  parser_(parser) {
+  Init();
+}
+
+template<template <typename> class TensorType, typename DType>
+void Predictor<TensorType, DType>::Init() {
+  const Shape& input_shape = parser_->input_shape();
+  batch_size_ = input_shape[0];
+  input_ = make_shared<TensorType<DType> >(input_shape);
+  input_->Fill(0);
+  layer_wrapper_ = parser_->layer_wrapper<TensorType, DType>();
+}
+
+template<template <typename> class TensorType, typename DType>
+shared_ptr<Predictor<TensorType, DType> >
+Predictor<TensorType, DType>::Clone() const {
+  shared_ptr<Predictor<TensorType, DType> > predictor(
+    new Predictor<TensorType, DType>(parser_));
+  // the weights allocated here are dropped again by ShareWeights
+  predictor->layer_wrapper_->InitInference(parser_->input_shape(),
+    parser_->filler_wrapper<TensorType, DType>());
+  predictor->layer_wrapper_->ShareWeights(*layer_wrapper_);
+  predictor->serializer_ = serializer_;
+  return predictor;
+}
+
+template<template <typename> class TensorType, typename DType>
+void Predictor<TensorType, DType>::Predict(
+  const DType* input, size_t n, DType* output) {
+  const size_t input_size = this->input_size();
+  const size_t output_size = this->output_size();
+  for (size_t i = 0; i < n; i += batch_size_) {
+    // a short last batch leaves the rest of input_ as it was
+    const size_t batch = std::min(batch_size_, n - i);
+    memcpy(input_->data(), input + i * input_size,
+      sizeof(DType) * batch * input_size);
+    layer_wrapper_->Predict(input_);
+    memcpy(output + i * output_size,
+      (layer_wrapper_->forward_output())->data(),
+      sizeof(DType) * batch * output_size);
+  }
+}
+
+// caller buffers are copied with memcpy, so host tensors only
+INSTANTIATE_CLASS_CPU(Predictor);
+#ifdef BLITZ_USE_MIC
+  INSTANTIATE_CLASS_MIC(Predictor);
+#endif
+
+}  // namespace blitz
@@ -0,0 +1,275 @@
+#include "model/seralize.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "backends/backends.h"
+
+namespace blitz {
+
+inline size_t BlitzCheckpointAlign(size_t offset) {
+  return (offset + BLITZ_CHECKPOINT_ALIGNMENT - 1) /
+    BLITZ_CHECKPOINT_ALIGNMENT * BLITZ_CHECKPOINT_ALIGNMENT;
+}
+
+template<template <typename> class TensorType, typename DType>
+Serializer<TensorType, DType>::~Serializer() {
+  Wait();
+  UnmapFile();
+}
+
+template<template <typename> class TensorType, typename DType>
+void Serializer<TensorType, DType>::Collect() {
+  layer_wrapper_->CollectParams(&tensors_);
+  if (scheduler_ != 0) {
+    scheduler_->CollectStates(&tensors_);
+  }
+}
+
+template<template <typename> class TensorType, typename DType>
+void Serializer<TensorType, DType>::Save(const string& path, size_t epoch) {
+  // the staging buffer is still being written
+  Wait();
+  if (tensors_.empty()) {
+    Collect();
+  }
+  time_point<system_clock> start, end;
+  start = system_clock::now();
+
+  // header and sections, then the aligned data of each section
+  const size_t num_sections = tensors_.size();
+  size_t offset = BlitzCheckpointAlign(sizeof(BlitzCheckpointHeader) +
+    num_sections * sizeof(BlitzCheckpointSection));
+  typename map<string, shared_ptr<TensorType<DType> > >::iterator
+    tensor_it = tensors_.begin();
+  for (; tensor_it != tensors_.end(); ++tensor_it) {
+    offset = BlitzCheckpointAlign(offset +
+      (tensor_it->second)->size() * sizeof(DType));
+  }
+  staging_.resize(offset);
+
+  BlitzCheckpointHeader* header =
+    reinterpret_cast<BlitzCheckpointHeader*>(&staging_[0]);
+  memset(header, 0, sizeof(BlitzCheckpointHeader));
+  memcpy(header->magic, BLITZ_CHECKPOINT_MAGIC, sizeof(header->magic));
+  header->version = BLITZ_CHECKPOINT_VERSION;
+  header->element_size = sizeof(DType);
+  header->num_sections = num_sections;
+  header->epoch = epoch;
+  header->iteration = scheduler_ != 0 ? scheduler_->iteration() : 0;
+
+  BlitzCheckpointSection* section = reinterpret_cast<BlitzCheckpointSection*>(
+    &staging_[0] + sizeof(BlitzCheckpointHeader));
+  offset = BlitzCheckpointAlign(sizeof(BlitzCheckpointHeader) +
+    num_sections * sizeof(BlitzCheckpointSection));
+  for (tensor_it = tensors_.begin(); tensor_it != tensors_.end();
+    ++tensor_it, ++section) {
+    const string& name = tensor_it->first;
+    shared_ptr<TensorType<DType> > tensor = tensor_it->second;
+    if (name.size() >= BLITZ_CHECKPOINT_NAME_SIZE) {
+      LOG(FATAL) << "Checkpoint section name too long: " << name;
+    }
+    memset(section, 0, sizeof(BlitzCheckpointSection));
+    memcpy(section->name, name.c_str(), name.size());
+    section->size = tensor->size();
+    section->offset = offset;
+    Backend<TensorType, DType>::HostCopyFromFunc(tensor->data(),
+      reinterpret_cast<DType*>(&staging_[0] + offset), tensor->size());
+    offset = BlitzCheckpointAlign(offset + tensor->size() * sizeof(DType));
+  }
+
+  end = system_clock::now();
+  duration<double> staging_time = end - start;
+  LOG(INFO) << "Checkpoint staging second: " << staging_time.count();
+
+  // training goes on while the file is written
+  writer_ = make_shared<boost::thread>(
+    &Serializer<TensorType, DType>::Write, this, path);
+}
+
+template<template <typename> class TensorType, typename DType>
+void Serializer<TensorType, DType>::Wait() {
+  if (writer_) {
+    writer_->join();
+    writer_.reset();
+  }
+}
+
+template<template <typename> class TensorType, typename DType>
+void Serializer<TensorType, DType>::Write(const string& path) {
+  // a crash during the write leaves an older checkpoint at path intact
+  const string temp_path = path + ".tmp";
+  FILE* file = fopen(temp_path.c_str(), "wb");
+  if (file == NULL) {
+    LOG(ERROR) << "Checkpoint open error: " << temp_path;
+    return;
+  }
+  const size_t written = fwrite(&staging_[0], 1, staging_.size(), file);
+  if (fclose(file) != 0 || written != staging_.size()) {
+    LOG(ERROR) << "Checkpoint write error: " << temp_path;
+    remove(temp_path.c_str());
+    return;
+  }
+  if (rename(temp_path.c_str(), path.c_str()) != 0) {
+    LOG(ERROR) << "Checkpoint rename error: " << path;
+    return;
+  }
+  LOG(INFO) << "Checkpoint saved: " << path;
+}
+
+template<template <typename> class TensorType, typename DType>
+size_t Serializer<TensorType, DType>::Load(const string& path) {
+  if (tensors_.empty()) {
+    Collect();
+  }
+  MapFile(path);
+  map<string, const BlitzCheckpointSection*> sections;
+  Sections(&sections);
+
+  typename map<string, shared_ptr<TensorType<DType> > >::iterator
+    tensor_it = tensors_.begin();
+  for (; tensor_it != tensors_.end(); ++tensor_it) {
+    shared_ptr<TensorType<DType> > tensor = tensor_it->second;
+    const BlitzCheckpointSection* section = sections[tensor_it->first];
+    Backend<TensorType, DType>::HostCopyToFunc(
+      reinterpret_cast<const DType*>(mapping_ + section->offset),
+      tensor->data(), tensor->size());
+  }
+
+  const BlitzCheckpointHeader* header =
+    reinterpret_cast<const BlitzCheckpointHeader*>(mapping_);
+  const size_t epoch = header->epoch;
+  if (scheduler_ != 0) {
+    scheduler_->set_iteration(header->iteration);
+  }
+  UnmapFile();
+  LOG(INFO) << "Checkpoint loaded: " << path << " epoch: " << epoch;
+  return epoch;
+}
+
+template<template <typename> class TensorType, typename DType>
+void Serializer<TensorType, DType>::Map(const string& path) {
+  if (tensors_.empty()) {
+    Collect();
+  }
+  MapFile(path);
+  map<string, const BlitzCheckpointSection*> sections;
+  Sections(&sections);
+
+  typename map<string, shared_ptr<TensorType<DType> > >::iterator
+    tensor_it = tensors_.begin();
+  for (; tensor_it != tensors_.end(); ++tensor_it) {
+    shared_ptr<TensorType<DType> > tensor = tensor_it->second;
+    const BlitzCheckpointSection* section = sections[tensor_it->first];
+#ifdef BLITZ_ALIGNMENT_SIZE
+    // kernels expect aligned tensors, the sections are only 64-byte aligned
+    if (section->offset % BLITZ_ALIGNMENT_SIZE != 0) {
+      Backend<TensorType, DType>::HostCopyToFunc(
+        reinterpret_cast<const DType*>(mapping_ + section->offset),
+        tensor->data(), tensor->size());
+      continue;
+    }
+#endif
+    tensor->Attach(reinterpret_cast<DType*>(mapping_ + section->offset));
+  }
+  LOG(INFO) << "Checkpoint mapped: " << path;
+}
+
+template<template <typename> class TensorType, typename DType>
+void Serializer<TensorType, DType>::MapFile(const string& path) {
+  if (mapping_ != NULL) {
+    LOG(FATAL) << "Checkpoint already mapped";
+  }
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    LOG(FATAL) << "Checkpoint open error: " << path;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) < 0 ||
+    static_cast<size_t>(file_stat.st_size) < sizeof(BlitzCheckpointHeader)) {
+    LOG(FATAL) << "Checkpoint too small: " << path;
+  }
+  mapping_size_ = file_stat.st_size;
+  // private writable mapping, layers never write back to the file
+  void* mapping = mmap(NULL, mapping_size_, PROT_READ | PROT_WRITE,
+    MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    LOG(FATAL) << "Checkpoint mmap error: " << path;
+  }
+  mapping_ = static_cast<char*>(mapping);
+
+  const BlitzCheckpointHeader* header =
+    reinterpret_cast<const BlitzCheckpointHeader*>(mapping_);
+  if (strncmp(header->magic, BLITZ_CHECKPOINT_MAGIC, sizeof(header->magic)) ||
+    header->version != BLITZ_CHECKPOINT_VERSION) {
+    LOG(FATAL) << "Not a blitz checkpoint: " << path;
+  }
+  if (header->element_size != sizeof(DType)) {
+    LOG(FATAL) << "Checkpoint element size " << header->element_size <<
+      " mismatches data type size " << sizeof(DType);
+  }
+  if (sizeof(BlitzCheckpointHeader) + header->num_sections *
+    sizeof(BlitzCheckpointSection) > mapping_size_) {
+    LOG(FATAL) << "Checkpoint truncated: " << path;
+  }
+}
+
+template<template <typename> class TensorType, typename DType>
+void Serializer<TensorType, DType>::UnmapFile() {
+  if (mapping_ != NULL) {
+    munmap(mapping_, mapping_size_);
+    mapping_ = NULL;
+    mapping_size_ = 0;
+  }
+}
+
+template<template <typename> class TensorType, typename DType>
+void Serializer<TensorType, DType>::Sections(
+  map<string, const BlitzCheckpointSection*>* sections) const {
+  const BlitzCheckpointHeader* header =
+    reinterpret_cast<const BlitzCheckpointHeader*>(mapping_);
+  const BlitzCheckpointSection* section =
+    reinterpret_cast<const BlitzCheckpointSection*>(
+    mapping_ + sizeof(BlitzCheckpointHeader));
+  for (size_t i = 0; i < header->num_sections; ++i, ++section) {
+    if (section->offset % BLITZ_CHECKPOINT_ALIGNMENT != 0 ||
+      section->offset + section->size * sizeof(DType) > mapping_size_) {
+      LOG(FATAL) << "Checkpoint section out of range: " << i;
+    }
+    const string name(section->name,
+      strnlen(section->name, BLITZ_CHECKPOINT_NAME_SIZE));
+    (*sections)[name] = section;
+  }
+
+  // sections without a tensor, e.g. optimizer states at inference, are
+  // skipped
+  typename map<string, shared_ptr<TensorType<DType> > >::const_iterator
+    tensor_it = tensors_.begin();
+  for (; tensor_it != tensors_.end(); ++tensor_it) {
+    typename map<string, const BlitzCheckpointSection*>::const_iterator
+      section_it = sections->find(tensor_it->first);
+    if (section_it == sections->end()) {
+      LOG(FATAL) << "Checkpoint section missing: " << tensor_it->first;
+    }
+    if ((section_it->second)->size != (tensor_it->second)->size()) {
+      LOG(FATAL) << "Checkpoint section " << tensor_it->first << " size " <<
+        (section_it->second)->size << " mismatches tensor size " <<
+        (tensor_it->second)->size();
+    }
+  }
+}
+
+INSTANTIATE_CLASS_CPU(Serializer);
+#ifdef BLITZ_USE_MIC
+  INSTANTIATE_CLASS_MIC(Serializer);
+#endif
+#ifdef BLITZ_USE_GPU
+  INSTANTIATE_CLASS_GPU(Serializer);
+#endif
+
+}  // namespace blitz
@@ -0,0 +1,35 @@
+#include "scheduler/adam.h"
+#include "backends/backends.h"
+
+namespace blitz {
+
+template<template <typename> class TensorType, typename DType>
+void Adam<TensorType, DType>::OptimizeImpl(
+  const size_t epoch, const size_t batch_size,
+  const DType learning_rate) {
+#ifdef BLITZ_DEVELOP
+  LOG(INFO) << "Optimize: " << this->name_;
+  LOG(INFO) << "batch_size: " << batch_size;
+  LOG(INFO) << "epoch: " << epoch;
+  LOG(INFO) << "learning_rate: " << learning_rate;
+#endif
+  ++iteration_;
+  const DType corrected_learning_rate = learning_rate *
+    sqrt(1 - pow(beta2_, static_cast<DType>(iteration_))) /
+    (1 - pow(beta1_, static_cast<DType>(iteration_)));
+  Backend<TensorType, DType>::AdamFunc(
+    (this->weight_).get(), (this->update_).get(), (this->state_).get(),
+    (this->second_state_).get(), beta1_, beta2_, epsilon_,
+    corrected_learning_rate, decay_, batch_size);
+}
+
+INSTANTIATE_CLASS_CPU(Adam);
+#ifdef BLITZ_USE_MIC
+  INSTANTIATE_CLASS_MIC(Adam);
+#endif
+#ifdef BLITZ_USE_GPU
+  INSTANTIATE_CLASS_GPU(Adam);
+#endif
+
+}  // namespace blitz
+
@@ -0,0 +1,30 @@
+#include "scheduler/nesterov.h"
+#include "backends/backends.h"
+
+namespace blitz {
+
+template<template <typename> class TensorType, typename DType>
+void Nesterov<TensorType, DType>::OptimizeImpl(
+  const size_t epoch, const size_t batch_size,
+  const DType learning_rate) {
+#ifdef BLITZ_DEVELOP
+  LOG(INFO) << "Optimize: " << this->name_;
+  LOG(INFO) << "batch_size: " << batch_size;
+  LOG(INFO) << "epoch: " << epoch;
+  LOG(INFO) << "learning_rate: " << learning_rate;
+#endif
+  Backend<TensorType, DType>::NesterovFunc(
+    (this->weight_).get(), (this->update_).get(), (this->state_).get(),
+    momentum_coef_, learning_rate, decay_, batch_size);
+}
+
+INSTANTIATE_CLASS_CPU(Nesterov);
+#ifdef BLITZ_USE_MIC
+  INSTANTIATE_CLASS_MIC(Nesterov);
+#endif
+#ifdef BLITZ_USE_GPU
+  INSTANTIATE_CLASS_GPU(Nesterov);
+#endif
+
+}  // namespace blitz
+
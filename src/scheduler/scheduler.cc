@@ -1,8 +1,21 @@
 #include "scheduler/scheduler.h"
+
+#include <algorithm>
+
 #include "backends/backends.h"
 
 namespace blitz {
 
+template<template <typename> class TensorType, typename DType>
+void Scheduler<TensorType, DType>::Init() {
+  typename map<string, shared_ptr<Optimizer<TensorType, DType> > >::iterator
+    optimizer_it = optimizers_.begin();
+
+  for (; optimizer_it != optimizers_.end(); ++optimizer_it) {
+    (optimizer_it->second)->Init();
+  }
+}
+
 template<template <typename> class TensorType, typename DType>
 void Scheduler<TensorType, DType>::Run(const size_t epoch, const size_t batch_size) {
   typename map<string, shared_ptr<Optimizer<TensorType, DType> > >::iterator
@@ -11,22 +24,10 @@ void Scheduler<TensorType, DType>::Run(const size_t epoch, const size_t batch_si
   for (; optimizer_it != optimizers_.end(); ++optimizer_it) {
 #ifdef BLITZ_DEVELOP
     LOG(INFO) << optimizer_it->first;
-#endif
-#ifdef BLITZ_PERFORMANCE
-    LOG(INFO) << optimizer_it->first;
-    time_point<system_clock> start, end;
-    duration<double> core_time = duration<double>::zero();
-    start = system_clock::now();
 #endif
     shared_ptr<Optimizer<TensorType, DType> > optimizer =
       optimizer_it->second;
     optimizer->Optimize(epoch, batch_size);
-#ifdef BLITZ_PERFORMANCE
-    end = system_clock::now();
-    core_time = end - start;
-    LOG(INFO) << "Optimize time: " <<
-      core_time.count();
-#endif
   }
 }
 
@@ -42,6 +43,39 @@ void Scheduler<TensorType, DType>::AddLayer(const string& optimizer_name,
   optimizer->AddLayer(layer_name, weight, update);
 }
 
+template<template <typename> class TensorType, typename DType>
+void Scheduler<TensorType, DType>::CollectStates(
+  map<string, shared_ptr<TensorType<DType> > >* states) {
+  typename map<string, shared_ptr<Optimizer<TensorType, DType> > >::iterator
+    optimizer_it = optimizers_.begin();
+
+  for (; optimizer_it != optimizers_.end(); ++optimizer_it) {
+    (optimizer_it->second)->CollectStates(states);
+  }
+}
+
+template<template <typename> class TensorType, typename DType>
+size_t Scheduler<TensorType, DType>::iteration() const {
+  typename map<string, shared_ptr<Optimizer<TensorType, DType> > >::
+    const_iterator optimizer_it = optimizers_.begin();
+
+  size_t iteration = 0;
+  for (; optimizer_it != optimizers_.end(); ++optimizer_it) {
+    iteration = std::max(iteration, (optimizer_it->second)->iteration());
+  }
+  return iteration;
+}
+
+template<template <typename> class TensorType, typename DType>
+void Scheduler<TensorType, DType>::set_iteration(size_t iteration) {
+  typename map<string, shared_ptr<Optimizer<TensorType, DType> > >::iterator
+    optimizer_it = optimizers_.begin();
+
+  for (; optimizer_it != optimizers_.end(); ++optimizer_it) {
+    (optimizer_it->second)->set_iteration(iteration);
+  }
+}
+
 INSTANTIATE_CLASS_CPU(Scheduler);
 #ifdef BLITZ_USE_MIC
   INSTANTIATE_CLASS_MIC(Scheduler);
@@ -0,0 +1,294 @@
+#include "utils/blitz_profiler.h"
+
+#include <algorithm>
+#include <string>
+
+namespace blitz {
+
+// keeps a trace of a long run bounded, later events are dropped
+#define BLITZ_PROFILER_MAX_EVENTS (1 << 20)
+
+struct BlitzProfileFrame {
+  string key;
+  string name;
+  string phase;
+  double computations;
+  time_point<system_clock> start;
+  // inclusive time of the nested scopes
+  double child_time;
+};
+
+// one scope or stage, sums of the open batch and one time per closed batch
+struct BlitzProfileStat {
+  BlitzProfileStat() : batch_time(0), batch_calls(0), calls(0),
+    computations(0), time(0), imbalance(0), imbalance_calls(0) {}
+
+  double batch_time;
+  size_t batch_calls;
+  size_t calls;
+  double computations;
+  double time;
+  double imbalance;
+  size_t imbalance_calls;
+  vector<double> times;
+};
+
+struct BlitzProfileEvent {
+  string name;
+  string category;
+  // microseconds since the profiler was enabled
+  double begin;
+  double duration;
+  size_t tid;
+};
+
+struct BlitzProfilerState {
+  BlitzProfilerState() : trace(false), dropped(false) {}
+
+  bool trace;
+  bool dropped;
+  time_point<system_clock> origin;
+  vector<BlitzProfileFrame> frames;
+  map<string, BlitzProfileStat> stats;
+  // keys in the order they were first seen, which is the network order
+  vector<string> keys;
+  vector<BlitzProfileEvent> events;
+};
+
+static BlitzProfilerState& BlitzProfilerGetState() {
+  static BlitzProfilerState state;
+  return state;
+}
+
+static BlitzProfileStat& BlitzProfilerGetStat(const string& key) {
+  BlitzProfilerState& state = BlitzProfilerGetState();
+  map<string, BlitzProfileStat>::iterator stat_it = state.stats.find(key);
+  if (stat_it == state.stats.end()) {
+    state.keys.push_back(key);
+    return state.stats[key];
+  }
+  return stat_it->second;
+}
+
+static double BlitzProfilerMicroseconds(const time_point<system_clock>& time) {
+  duration<double> elapsed = time - BlitzProfilerGetState().origin;
+  return elapsed.count() * 1e6;
+}
+
+static void BlitzProfilerAddEvent(const string& name, const string& category,
+  double begin, double duration, size_t tid) {
+  BlitzProfilerState& state = BlitzProfilerGetState();
+  if (!state.trace) {
+    return;
+  }
+  if (state.events.size() >= BLITZ_PROFILER_MAX_EVENTS) {
+    if (!state.dropped) {
+      LOG(WARNING) << "Profiler trace full, later events are dropped";
+      state.dropped = true;
+    }
+    return;
+  }
+  BlitzProfileEvent event;
+  event.name = name;
+  event.category = category;
+  event.begin = begin;
+  event.duration = duration;
+  event.tid = tid;
+  state.events.push_back(event);
+}
+
+// the p-th percentile of sorted times, nearest rank
+static double BlitzProfilerPercentile(const vector<double>& times, double p) {
+  size_t rank = static_cast<size_t>(ceil(p * times.size()));
+  rank = std::max(rank, static_cast<size_t>(1));
+  return times[std::min(rank, times.size()) - 1];
+}
+
+static string BlitzProfilerEscape(const string& text) {
+  string escaped;
+  for (size_t i = 0; i < text.size(); ++i) {
+    if (text[i] == '"' || text[i] == '\\') {
+      escaped.push_back('\\');
+    }
+    escaped.push_back(text[i]);
+  }
+  return escaped;
+}
+
+void BlitzProfilerSetEnabled(bool enabled, bool trace) {
+  BlitzProfilerState& state = BlitzProfilerGetState();
+  state.trace = enabled && trace;
+  state.origin = system_clock::now();
+  BlitzProfilerEnabled() = enabled;
+}
+
+void BlitzProfilerBatchEnd() {
+  if (!BlitzProfilerEnabled()) {
+    return;
+  }
+  BlitzProfilerState& state = BlitzProfilerGetState();
+  map<string, BlitzProfileStat>::iterator stat_it = state.stats.begin();
+  for (; stat_it != state.stats.end(); ++stat_it) {
+    BlitzProfileStat& stat = stat_it->second;
+    if (stat.batch_calls != 0) {
+      stat.times.push_back(stat.batch_time);
+      stat.batch_time = 0;
+      stat.batch_calls = 0;
+    }
+  }
+}
+
+void BlitzProfilerStage(const char* stage, double seconds) {
+  if (!BlitzProfilerEnabled()) {
+    return;
+  }
+  BlitzProfilerThreadStage(stage, &seconds, 1);
+}
+
+void BlitzProfilerThreadStage(const char* stage, const double* seconds,
+  size_t num_threads) {
+  if (!BlitzProfilerEnabled() || num_threads == 0) {
+    return;
+  }
+  BlitzProfilerState& state = BlitzProfilerGetState();
+  const string key = state.frames.empty() ? string(stage) :
+    state.frames.back().key + "/" + stage;
+  double slowest = 0;
+  double mean = 0;
+  for (size_t i = 0; i < num_threads; ++i) {
+    slowest = std::max(slowest, seconds[i]);
+    mean += seconds[i];
+  }
+  mean /= num_threads;
+
+  BlitzProfileStat& stat = BlitzProfilerGetStat(key);
+  stat.batch_time += slowest;
+  stat.time += slowest;
+  ++stat.batch_calls;
+  ++stat.calls;
+  if (num_threads > 1 && mean > 0) {
+    stat.imbalance += slowest / mean;
+    ++stat.imbalance_calls;
+  }
+
+  // the stage has just ended, every thread started on it together
+  const double end = BlitzProfilerMicroseconds(system_clock::now());
+  for (size_t i = 0; i < num_threads; ++i) {
+    BlitzProfilerAddEvent(stage, key, end - slowest * 1e6,
+      seconds[i] * 1e6, num_threads > 1 ? i + 1 : 0);
+  }
+}
+
+void BlitzProfilerReport() {
+  if (!BlitzProfilerEnabled()) {
+    return;
+  }
+  BlitzProfilerBatchEnd();
+  BlitzProfilerState& state = BlitzProfilerGetState();
+  for (size_t i = 0; i < state.keys.size(); ++i) {
+    const string& key = state.keys[i];
+    const BlitzProfileStat& stat = state.stats[key];
+    if (stat.times.empty()) {
+      continue;
+    }
+    vector<double> times(stat.times);
+    std::sort(times.begin(), times.end());
+    stringstream line;
+    line << "Profile " << key << " batches: " << times.size() <<
+      " calls: " << stat.calls <<
+      " p50: " << BlitzProfilerPercentile(times, 0.5) <<
+      " p90: " << BlitzProfilerPercentile(times, 0.9) <<
+      " p99: " << BlitzProfilerPercentile(times, 0.99) <<
+      " max: " << times.back();
+    if (stat.computations > 0 && stat.time > 0) {
+      line << " GFLOP/s: " << stat.computations / (stat.time * 1e9);
+    }
+    if (stat.imbalance_calls > 0) {
+      line << " imbalance: " << stat.imbalance / stat.imbalance_calls;
+    }
+    LOG(INFO) << line.str();
+  }
+}
+
+void BlitzProfilerExportTrace(const string& path) {
+  BlitzProfilerState& state = BlitzProfilerGetState();
+  ofstream ofs(path.c_str(), ofstream::out);
+  if (!ofs) {
+    LOG(ERROR) << "Profiler trace open error: " << path;
+    return;
+  }
+  ofs << "{\"traceEvents\": [" << std::endl;
+  for (size_t i = 0; i < state.events.size(); ++i) {
+    const BlitzProfileEvent& event = state.events[i];
+    ofs << "{\"name\": \"" << BlitzProfilerEscape(event.name) <<
+      "\", \"cat\": \"" << BlitzProfilerEscape(event.category) <<
+      "\", \"ph\": \"X\", \"ts\": " << event.begin <<
+      ", \"dur\": " << event.duration <<
+      ", \"pid\": 0, \"tid\": " << event.tid << "}";
+    if (i + 1 != state.events.size()) {
+      ofs << ",";
+    }
+    ofs << std::endl;
+  }
+  ofs << "]}" << std::endl;
+  ofs.close();
+  LOG(INFO) << "Profiler trace saved: " << path;
+}
+
+BlitzProfileScope::BlitzProfileScope(const string& name, const char* phase,
+  double computations) : active_(BlitzProfilerEnabled()) {
+  if (!active_) {
+    return;
+  }
+  BlitzProfilerState& state = BlitzProfilerGetState();
+  BlitzProfileFrame frame;
+  frame.key = name + "/" + phase;
+  frame.name = name;
+  frame.phase = phase;
+  frame.computations = computations;
+  frame.child_time = 0;
+  state.frames.push_back(frame);
+  // last, so the bookkeeping above is not timed
+  state.frames.back().start = system_clock::now();
+}
+
+BlitzProfileScope::~BlitzProfileScope() {
+  if (!active_) {
+    return;
+  }
+  const time_point<system_clock> end = system_clock::now();
+  BlitzProfilerState& state = BlitzProfilerGetState();
+  const BlitzProfileFrame& frame = state.frames.back();
+  duration<double> elapsed = end - frame.start;
+  const double self_time = elapsed.count() - frame.child_time;
+
+  BlitzProfileStat& stat = BlitzProfilerGetStat(frame.key);
+  stat.batch_time += self_time;
+  stat.time += self_time;
+  stat.computations += frame.computations;
+  ++stat.batch_calls;
+  ++stat.calls;
+  BlitzProfilerAddEvent(frame.name, frame.phase,
+    BlitzProfilerMicroseconds(frame.start), elapsed.count() * 1e6, 0);
+
+  state.frames.pop_back();
+  if (!state.frames.empty()) {
+    state.frames.back().child_time += elapsed.count();
+  }
+}
+
+BlitzProfileStageTimer::BlitzProfileStageTimer(const char* stage) :
+  stage_(stage), active_(BlitzProfilerEnabled()) {
+  if (active_) {
+    start_ = system_clock::now();
+  }
+}
+
+BlitzProfileStageTimer::~BlitzProfileStageTimer() {
+  if (active_) {
+    duration<double> elapsed = system_clock::now() - start_;
+    BlitzProfilerStage(stage_, elapsed.count());
+  }
+}
+
+}  // namespace blitz